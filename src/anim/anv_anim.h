@@ -41,7 +41,11 @@ namespace anv::anim
         .SetTitle("anim-vk")
         .Build();
 
-      Context.RenderSystem->Init(Context.MainWindow->GetRawHandle());
+      Context.RenderSystem->Init(Context.MainWindow->GetRawHandle(), Context.MainWindow->GetInput().Extent);
+      Context.MainWindow->SetResizeCallback([RenderSystem = Context.RenderSystem]( extent2 NewExtent )
+        {
+          RenderSystem->Resize(NewExtent);
+        });
     } /* system */
 
     /**
@@ -58,6 +62,7 @@ namespace anv::anim
     */
     VOID Close( VOID )
     {
+      Context.MainWindow->SetResizeCallback({});
       Context.RenderSystem->Close();
       Context.WindowSystem->Close();
     } /* WaitClose */
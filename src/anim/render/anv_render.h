@@ -20,13 +20,214 @@ namespace anv::render
     /**
      * @brief Initialization function
      * @param RawWindowHandle Raw window handle
+     * @param Extent Window extent
      * @return 
     */
-    VOID Init( window::raw_handle RawWindowHandle )
+    VOID Init( window::raw_handle RawWindowHandle, extent2 Extent )
     {
-      Core = new core::system(RawWindowHandle);
+      Core = new core::system(RawWindowHandle, Extent);
     } /* End of 'Init' funciton */
 
+    /**
+     * @brief Headless initialization function
+     * @param Headless Offscreen output description
+    */
+    VOID InitHeadless( const core::headless_output &Headless )
+    {
+      Core = new core::system(Headless);
+    } /* InitHeadless */
+
+    /**
+     * @brief Last read back output getting function (headless mode with readback only)
+     * @param Pixels Vector to write tightly packed R8G8B8A8 sRGB pixels to
+     * @param Extent Output extent
+     * @return Output frame number (starting from 1), 0 if no output is read back yet
+    */
+    UINT64 ReadOutput( std::vector<BYTE> &Pixels, extent2 &Extent )
+    {
+      return Core->ReadOutput(Pixels, Extent);
+    } /* ReadOutput */
+
+    /**
+     * @brief Frame completion waiting function
+     * @param FrameCount Count of frames to wait for
+    */
+    VOID WaitFrames( UINT64 FrameCount )
+    {
+      Core->WaitFrames(FrameCount);
+    } /* WaitFrames */
+
+    /**
+     * @brief Continuous frame readback setting function
+     * @param Targets Images to copy every frame, empty to disable readback
+     * @param Callback Callback, called from readback thread for every captured frame
+    */
+    VOID SetReadback( core::readback_target_flags Targets, core::readback_callback Callback )
+    {
+      Core->SetReadback(Targets, std::move(Callback));
+    } /* SetReadback */
+
+    /**
+     * @brief Culling camera setting function, may be called from any thread
+     * @param Matrices Camera matrices to build culling frustum from, empty to disable frustum culling
+    */
+    VOID SetCullingCamera( const std::optional<math::util::camera::projection_matrices> &Matrices )
+    {
+      Core->SetCullingCamera(Matrices);
+    } /* SetCullingCamera */
+
+    /**
+     * @brief Culling statistics getting function
+     * @return Culling statistics of last rendered frame
+    */
+    core::culling_stats GetCullingStats( VOID ) const
+    {
+      return Core->GetCullingStats();
+    } /* GetCullingStats */
+
+    /**
+     * @brief GPU (compute queue) culling enabling function, may be called from any thread
+     * @param Enable TRUE to cull indexed primitives on GPU by frustum and depth pyramid, FALSE to cull on CPU
+    */
+    VOID SetGpuCulling( BOOL Enable )
+    {
+      Core->SetGpuCulling(Enable);
+    } /* SetGpuCulling */
+
+    /**
+     * @brief Scene lights setting function, may be called from any thread
+     * @param Lights Point lights to shade G-buffer with (in culling camera view)
+     * @param Ambient Ambient light color
+    */
+    VOID SetLights( std::span<const core::point_light> Lights, const vec3 &Ambient = vec3(0.03F) )
+    {
+      Core->SetLights(Lights, Ambient);
+    } /* SetLights */
+
+    /**
+     * @brief Directional light setting function, may be called from any thread
+     * @param Light Directional light to shade G-buffer with, empty to disable it
+    */
+    VOID SetDirectionalLight( const std::optional<core::directional_light> &Light )
+    {
+      Core->SetDirectionalLight(Light);
+    } /* SetDirectionalLight */
+
+    /**
+     * @brief Shadow cascade caching enabling function, may be called from any thread
+     * @param Enable TRUE to re-render cascades only when they are moved or their casters change, FALSE to render them every frame
+    */
+    VOID SetShadowCaching( BOOL Enable )
+    {
+      Core->SetShadowCaching(Enable);
+    } /* SetShadowCaching */
+
+    /**
+     * @brief Shadow statistics getting function
+     * @return Shadow statistics of last rendered frame
+    */
+    core::shadow_stats GetShadowStats( VOID ) const
+    {
+      return Core->GetShadowStats();
+    } /* GetShadowStats */
+
+    /**
+     * @brief Transient G-buffer and depth attachments enabling function, may be called from any thread
+     * @param Enable TRUE to keep attachments, that don't leave output render pass, in lazily allocated memory
+    */
+    VOID SetTransientAttachments( BOOL Enable )
+    {
+      Core->SetTransientAttachments(Enable);
+    } /* SetTransientAttachments */
+
+    /**
+     * @brief Depth pre-pass enabling function, may be called from any thread
+     * @param Enable TRUE to draw depth of pre-passed geometry in marker pass, so G-buffer is written once per pixel
+    */
+    VOID SetDepthPrepass( BOOL Enable )
+    {
+      Core->SetDepthPrepass(Enable);
+    } /* SetDepthPrepass */
+
+    /**
+     * @brief Format support getting function, may be called from any thread
+     * @param Format Format to query device for (e.g. block compressed texture format)
+     * @return Image and vertex buffer usages, supported by device for format
+    */
+    core::format_support GetFormatSupport( core::format Format ) const
+    {
+      return Core->GetFormatSupport(Format);
+    } /* GetFormatSupport */
+
+    /**
+     * @brief Frame pacing policy setting function, may be called from any thread
+     * @param Pacing New present mode, frame rate cap and queued frame limit
+    */
+    VOID SetFramePacing( const core::frame_pacing &Pacing )
+    {
+      Core->SetFramePacing(Pacing);
+    } /* SetFramePacing */
+
+    /**
+     * @brief Frame pacing statistics getting function
+     * @return Frame time statistics of last frames
+    */
+    core::frame_pacing_stats GetFramePacingStats( VOID ) const
+    {
+      return Core->GetFramePacingStats();
+    } /* GetFramePacingStats */
+
+    /**
+     * @brief Frame profiling enabling function, may be called from any thread
+     * @param Enable TRUE to measure render thread zones and GPU pass times of every frame
+    */
+    VOID SetProfiling( BOOL Enable )
+    {
+      Core->SetProfiling(Enable);
+    } /* SetProfiling */
+
+    /**
+     * @brief Profiled frames Chrome trace export function, may be called from any thread
+     * @return Trace event JSON document, viewable in chrome://tracing or Perfetto
+    */
+    std::string ExportChromeTrace( VOID )
+    {
+      return Core->ExportChromeTrace();
+    } /* ExportChromeTrace */
+
+    /**
+     * @brief Instance box-level picking function, may be called from any thread.
+     *        Ray is tested against world bounding boxes of instances, not against their triangles (primitives keep no CPU copy of geometry),
+     *        so picked instance is the one with the nearest box and ray may pass by its geometry.
+     * @param Ray World space ray
+     * @param MaxDistance Maximal distance along ray
+     * @return Instance with the nearest world bounds, hit by ray, and distance to box entry point
+    */
+    std::optional<std::pair<core::primitive::instance *, FLOAT>> PickInstance( const math::ray &Ray, FLOAT MaxDistance = FLT_MAX )
+    {
+      return Core->PickInstance(Ray, MaxDistance);
+    } /* PickInstance */
+
+    /**
+     * @brief Instances, overlapping box, querying function, may be called from any thread
+     * @param Box World space box
+     * @return Instances of primitives with bounds, whose world bounds overlap box
+    */
+    std::vector<core::primitive::instance *> QueryInstances( const math::aabb &Box )
+    {
+      return Core->QueryInstances(Box);
+    } /* QueryInstances */
+
+    /**
+     * @brief Output resize notification function, may be called from any thread
+     * @param NewExtent New output extent
+    */
+    VOID Resize( extent2 NewExtent )
+    {
+      if (Core != nullptr)
+        Core->Resize(NewExtent);
+    } /* Resize */
+
     VOID Close( VOID )
     {
       delete Core;
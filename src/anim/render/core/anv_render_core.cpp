@@ -31,20 +31,64 @@ namespace anv::render::core
     return vk::False;
   } /* static DebugCallback */
 
-  system::system( window::raw_handle &Window )
+  system::system( window::raw_handle &Window, extent2 Extent, render_graph::mode GraphMode, gbuffer_layout GBufferLayout ) :
+    GraphMode(GraphMode),
+    GBufferLayout(GBufferLayout)
   {
-    EnabledInstanceExtensions = GetRequiredSurfaceExtensions(Window);
-    EnabledInstanceExtensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+    // Surface may leave extent to swapchain, so first one is created with window size
+    RequestedExtentW = (UINT32)Extent.W;
+    RequestedExtentH = (UINT32)Extent.H;
+    Init(&Window);
+  } /* system */
+
+  system::system( const headless_output &Headless ) :
+    IsHeadless(TRUE),
+    HeadlessImageCount(std::max(Headless.ImageCount, 1U)),
+    GraphMode(Headless.GraphMode),
+    GBufferLayout(Headless.GBufferLayout)
+  {
+    RequestedExtentW = (UINT32)Headless.Extent.W;
+    RequestedExtentH = (UINT32)Headless.Extent.H;
+    Init(nullptr);
 
-    EnabledDeviceExtensions =
-    {
-      VK_KHR_SWAPCHAIN_EXTENSION_NAME
-    };
-    EnabledInstanceLayers =
-    {
-      "VK_LAYER_KHRONOS_validation",
-      "VK_LAYER_RENDERDOC_Capture",
-    };
+    // Keep last output for ReadOutput
+    if (Headless.Readback)
+      SetReadback(readback_target::eOutput, [this]( const readback_frame &Frame )
+        {
+          const readback_image &Image = Frame.Images[0];
+
+          OutputMutex.lock();
+          OutputPixels.assign(Image.Data.begin(), Image.Data.end());
+          OutputPixelsExtent = Image.Extent;
+          OutputPixelsFrameIndex = Frame.FrameIndex;
+          OutputMutex.unlock();
+        });
+  } /* system */
+
+  VOID system::Init( window::raw_handle *Window )
+  {
+    if (Window != nullptr)
+      EnabledInstanceExtensions = GetRequiredSurfaceExtensions(*Window);
+
+    // Debug utils and validation layers are optional (e.g. CI machines with software driver only)
+    auto AvailableInstanceExtensions = vk::enumerateInstanceExtensionProperties();
+    BOOL IsDebugUtilsAvailable = std::ranges::any_of(AvailableInstanceExtensions, []( const vk::ExtensionProperties &Props )
+      {
+        return std::string_view(Props.extensionName) == VK_EXT_DEBUG_UTILS_EXTENSION_NAME;
+      });
+    if (IsDebugUtilsAvailable)
+      EnabledInstanceExtensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+
+    if (Window != nullptr)
+      EnabledDeviceExtensions =
+      {
+        VK_KHR_SWAPCHAIN_EXTENSION_NAME
+      };
+
+    auto AvailableInstanceLayers = vk::enumerateInstanceLayerProperties();
+    for (const CHAR *Layer : {"VK_LAYER_KHRONOS_validation", "VK_LAYER_RENDERDOC_Capture"})
+      if (std::ranges::any_of(AvailableInstanceLayers, [Layer]( const vk::LayerProperties &Props ) { return std::string_view(Props.layerName) == Layer; }))
+        EnabledInstanceLayers.push_back(Layer);
 
     vk::ApplicationInfo AppInfo;
     AppInfo
@@ -68,22 +112,26 @@ namespace anv::render::core
       .setPApplicationInfo(&AppInfo)
       .setPEnabledLayerNames(EnabledInstanceLayers)
       .setPEnabledExtensionNames(EnabledInstanceExtensions)
-      .setPNext(&DebugMessengerCreateInfo)
+      .setPNext(IsDebugUtilsAvailable ? &DebugMessengerCreateInfo : nullptr)
     );
 
-    DynamicFunctions.vkCreateDebugUtilsMessengerEXT = reinterpret_cast<PFN_vkCreateDebugUtilsMessengerEXT>(Instance.getProcAddr("vkCreateDebugUtilsMessengerEXT"));
-    DynamicFunctions.vkDestroyDebugUtilsMessengerEXT = reinterpret_cast<PFN_vkDestroyDebugUtilsMessengerEXT>(Instance.getProcAddr("vkDestroyDebugUtilsMessengerEXT"));
-
-    VkDebugUtilsMessengerEXT CDebugMessenger;
-    DynamicFunctions.vkCreateDebugUtilsMessengerEXT(
-      Instance,
-      &(const VkDebugUtilsMessengerCreateInfoEXT &)DebugMessengerCreateInfo,
-      nullptr,
-      &CDebugMessenger
-    );
-    DebugMessenger = CDebugMessenger;
+    if (IsDebugUtilsAvailable)
+    {
+      DynamicFunctions.vkCreateDebugUtilsMessengerEXT = reinterpret_cast<PFN_vkCreateDebugUtilsMessengerEXT>(Instance.getProcAddr("vkCreateDebugUtilsMessengerEXT"));
+      DynamicFunctions.vkDestroyDebugUtilsMessengerEXT = reinterpret_cast<PFN_vkDestroyDebugUtilsMessengerEXT>(Instance.getProcAddr("vkDestroyDebugUtilsMessengerEXT"));
+
+      VkDebugUtilsMessengerEXT CDebugMessenger;
+      DynamicFunctions.vkCreateDebugUtilsMessengerEXT(
+        Instance,
+        &(const VkDebugUtilsMessengerCreateInfoEXT &)DebugMessengerCreateInfo,
+        nullptr,
+        &CDebugMessenger
+      );
+      DebugMessenger = CDebugMessenger;
+    }
 
-    InitSurface(Window);
+    if (Window != nullptr)
+      InitSurface(*Window);
 
     vk::PhysicalDeviceFeatures
       RequiredFeatures,
@@ -108,9 +156,20 @@ namespace anv::render::core
       if (GraphicsQueueFamilyIndex == INVALID_QUEUE_FAMILY_INDEX && (QueueFamilyProperties[i].queueFlags & vk::QueueFlagBits::eGraphics) == vk::QueueFlagBits::eGraphics)
         GraphicsQueueFamilyIndex = i;
 
-      if (PresentQueueFamilyIndex == INVALID_QUEUE_FAMILY_INDEX && PhysicalDevice.getSurfaceSupportKHR(i, Surface))
+      if (!IsHeadless && PresentQueueFamilyIndex == INVALID_QUEUE_FAMILY_INDEX && PhysicalDevice.getSurfaceSupportKHR(i, Surface))
         PresentQueueFamilyIndex = i;
+
+      // Dedicated (async) compute family runs culling beside graphics work
+      if (ComputeQueueFamilyIndex == INVALID_QUEUE_FAMILY_INDEX && (QueueFamilyProperties[i].queueFlags & (vk::QueueFlagBits::eCompute | vk::QueueFlagBits::eGraphics)) == vk::QueueFlagBits::eCompute)
+        ComputeQueueFamilyIndex = i;
     }
+    const BOOL IsComputeFamilyDedicated = ComputeQueueFamilyIndex != INVALID_QUEUE_FAMILY_INDEX;
+    if (!IsComputeFamilyDedicated)
+      ComputeQueueFamilyIndex = GraphicsQueueFamilyIndex;
+
+    // Software drivers may expose single queue only, so compute and present queues are aliased to graphics one then
+    UINT32 GraphicsQueueCount = std::min(1U + (IsComputeFamilyDedicated ? 0U : 1U) + (GraphicsQueueFamilyIndex == PresentQueueFamilyIndex ? 1U : 0U),
+      QueueFamilyProperties[GraphicsQueueFamilyIndex].queueCount);
 
     FLOAT QueuePriorities[] {1.0F, 0.5F, 0.25F};
     std::vector<vk::DeviceQueueCreateInfo> QueueCreateInfos
@@ -118,33 +177,55 @@ namespace anv::render::core
       vk::DeviceQueueCreateInfo()
         .setQueueFamilyIndex(GraphicsQueueFamilyIndex)
         .setPQueuePriorities(QueuePriorities)
-        .setQueueCount(2)
+        .setQueueCount(GraphicsQueueCount)
     };
-    if (GraphicsQueueFamilyIndex == PresentQueueFamilyIndex)
-      QueueCreateInfos[0].queueCount++;
-    else
+    if (!IsHeadless && GraphicsQueueFamilyIndex != PresentQueueFamilyIndex)
       QueueCreateInfos.push_back(vk::DeviceQueueCreateInfo()
         .setQueueFamilyIndex(PresentQueueFamilyIndex)
         .setPQueuePriorities(QueuePriorities)
         .setQueueCount(1)
       );
+    if (IsComputeFamilyDedicated)
+      QueueCreateInfos.push_back(vk::DeviceQueueCreateInfo()
+        .setQueueFamilyIndex(ComputeQueueFamilyIndex)
+        .setPQueuePriorities(QueuePriorities)
+        .setQueueCount(1)
+      );
+
+    // Timeline semaphores and buffer device addresses are core in Vulkan 1.2, synchronization2 and dynamic rendering - in 1.3, but must be enabled explicitly
+    vk::PhysicalDeviceVulkan13Features DeviceFeatures13 = vk::PhysicalDeviceVulkan13Features()
+      .setSynchronization2(vk::True)
+      .setDynamicRendering(vk::True)
+      ;
+    vk::PhysicalDeviceVulkan12Features DeviceFeatures12 = vk::PhysicalDeviceVulkan12Features()
+      .setPNext(&DeviceFeatures13)
+      .setTimelineSemaphore(vk::True)
+      .setBufferDeviceAddress(vk::True)
+      ;
 
     Device = PhysicalDevice.createDevice(vk::DeviceCreateInfo()
+      .setPNext(&DeviceFeatures12)
       .setPEnabledFeatures(&DeviceFeatures)
       .setPEnabledExtensionNames(EnabledDeviceExtensions)
       .setQueueCreateInfos(QueueCreateInfos)
     );
     GraphicsQueue = Device.getQueue(GraphicsQueueFamilyIndex, 0);
-    ComputeQueue = Device.getQueue(GraphicsQueueFamilyIndex, 1);
+    UINT32 NextGraphicsQueueIndex = 1;
 
-    if (GraphicsQueueFamilyIndex == PresentQueueFamilyIndex)
-      PresentQueue = Device.getQueue(GraphicsQueueFamilyIndex, 2);
+    if (IsComputeFamilyDedicated)
+      ComputeQueue = Device.getQueue(ComputeQueueFamilyIndex, 0);
     else
+      ComputeQueue = Device.getQueue(GraphicsQueueFamilyIndex, std::min(NextGraphicsQueueIndex++, GraphicsQueueCount - 1));
+
+    if (GraphicsQueueFamilyIndex == PresentQueueFamilyIndex)
+      PresentQueue = Device.getQueue(GraphicsQueueFamilyIndex, std::min(NextGraphicsQueueIndex, GraphicsQueueCount - 1));
+    else if (!IsHeadless)
       PresentQueue = Device.getQueue(PresentQueueFamilyIndex, 0);
 
     /* Create memory allocator */
     VmaAllocatorCreateInfo AllocatorCreateInfo
     {
+      .flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT,
       .physicalDevice = PhysicalDevice,
       .device = Device,
       .instance = Instance,
@@ -155,252 +236,358 @@ namespace anv::render::core
       vk::detail::throwResultException(vk::Result(Result), "vmaCreateAllocator");
 
 
-    auto SurfaceCapabilities = PhysicalDevice.getSurfaceCapabilitiesKHR(Surface);
-    SwapchainImageExtent = SurfaceCapabilities.currentExtent;
-
-    Swapchain = Device.createSwapchainKHR(vk::SwapchainCreateInfoKHR()
-      .setSurface(Surface)
-      .setMinImageCount(SurfaceCapabilities.maxImageCount == UINT32_MAX ? SurfaceCapabilities.minImageCount + 1 : SurfaceCapabilities.maxImageCount)
-      .setImageArrayLayers(1)
-      .setImageFormat([this]() -> vk::Format
+    /* Select swapchain surface format, it stays same during swapchain recreation. Present mode is selected by pacing policy. */
+    if (IsHeadless)
+      SwapchainImageFormat = vk::Format::eR8G8B8A8Srgb;
+    else
+    {
+      auto SurfaceFormats = PhysicalDevice.getSurfaceFormatsKHR(Surface);
+      SwapchainColorSpace = SurfaceFormats[0].colorSpace;
+      SwapchainImageFormat = SurfaceFormats[0].format;
+      for (auto Format : SurfaceFormats)
+        if (Format.colorSpace == vk::ColorSpaceKHR::eSrgbNonlinear && Format.format == vk::Format::eB8G8R8A8Srgb)
         {
-          auto SurfaceFormats = PhysicalDevice.getSurfaceFormatsKHR(Surface);
-          SwapchainColorSpace = SurfaceFormats[0].colorSpace;
-          SwapchainImageFormat = SurfaceFormats[0].format;
-          for (auto Format : SurfaceFormats)
-            if (Format.colorSpace == vk::ColorSpaceKHR::eSrgbNonlinear && Format.format == vk::Format::eB8G8R8A8Srgb)
-            {
-              SwapchainColorSpace = Format.colorSpace;
-              SwapchainImageFormat = Format.format;
-            }
+          SwapchainColorSpace = Format.colorSpace;
+          SwapchainImageFormat = Format.format;
+        }
+    }
 
-          return SwapchainImageFormat;
-        }())
-      .setImageColorSpace(SwapchainColorSpace)
-      .setImageExtent(SwapchainImageExtent)
-      .setImageUsage(vk::ImageUsageFlagBits::eColorAttachment)
-      .setImageSharingMode(vk::SharingMode::eExclusive)
-      .setPresentMode([this]( VOID ) -> vk::PresentModeKHR
-        {
-          auto SurfacePresentModes = PhysicalDevice.getSurfacePresentModesKHR(Surface);
-          vk::PresentModeKHR PresentMode = SurfacePresentModes[0];
-          for (auto Mode : SurfacePresentModes)
-            if (Mode == vk::PresentModeKHR::eMailbox)
-              PresentMode = Mode;
-          return PresentMode;
-        }())
-      .setPreTransform(SurfaceCapabilities.currentTransform)
-    );
+    if (!InitSwapchain())
+      throw std::runtime_error("Can't create swapchain for zero-sized surface");
 
     RenderCommandPool = Device.createCommandPool(vk::CommandPoolCreateInfo()
       .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer)
       .setQueueFamilyIndex(GraphicsQueueFamilyIndex)
     );
 
-    /* Initailize FirstTriangle-level render pass */
-
-    constexpr UINT32 MarkerSubpass = 0;   //      -> Output, Depth
-    constexpr UINT32 GeometrySubpass = 1; //      -> GBuf, Depth
-    constexpr UINT32 ShadingSubpass = 2;  // GBuf -> Output
-    constexpr UINT32 OverlaySubpass = 3;  //      -> Output
+    /* Initailize frame render graph */
 
     DepthAttachmentFormat = vk::Format::eD32Sfloat;
+    PositionObjectIDAttachmentFormat = GBufferLayout == gbuffer_layout::eWide ? vk::Format::eR32G32B32A32Sfloat : vk::Format::eR32Uint;
     OutputAttachmentFormat = SwapchainImageFormat;
 
-    vk::AttachmentDescription AttachmentDescriptions[6]
-    {
-      /* Position, ObjectID */ vk::AttachmentDescription()
-        .setLoadOp(vk::AttachmentLoadOp::eDontCare)
-        .setStoreOp(vk::AttachmentStoreOp::eStore)
-        .setFormat(PositionObjectIDAttachmentFormat)
-        .setInitialLayout(vk::ImageLayout::eUndefined)
-        .setFinalLayout(vk::ImageLayout::eShaderReadOnlyOptimal),
-      /* NormalXY */ vk::AttachmentDescription()
-        .setLoadOp(vk::AttachmentLoadOp::eDontCare)
-        .setStoreOp(vk::AttachmentStoreOp::eStore)
-        .setFormat(NormalAttachmentFormat)
-        .setInitialLayout(vk::ImageLayout::eUndefined)
-        .setFinalLayout(vk::ImageLayout::eShaderReadOnlyOptimal),
-      /* BaseColorXYZ, AO */ vk::AttachmentDescription()
-        .setLoadOp(vk::AttachmentLoadOp::eDontCare)
-        .setStoreOp(vk::AttachmentStoreOp::eStore)
-        .setFormat(BaseColorAmbientOcclusionAttachmentFormat)
-        .setInitialLayout(vk::ImageLayout::eUndefined)
-        .setFinalLayout(vk::ImageLayout::eShaderReadOnlyOptimal),
-      /* Metallic, Roughness, Instance */ vk::AttachmentDescription()
-        .setLoadOp(vk::AttachmentLoadOp::eDontCare)
-        .setStoreOp(vk::AttachmentStoreOp::eStore)
-        .setFormat(MetallicRoughnessInstanceAttachmentFormat)
-        .setInitialLayout(vk::ImageLayout::eUndefined)
-        .setFinalLayout(vk::ImageLayout::eShaderReadOnlyOptimal),
-      /* Depth */ vk::AttachmentDescription()
-        .setLoadOp(vk::AttachmentLoadOp::eClear)
-        .setStoreOp(vk::AttachmentStoreOp::eStore)
-        .setFormat(DepthAttachmentFormat)
-        .setInitialLayout(vk::ImageLayout::eUndefined)
-        .setFinalLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal),
-      /* Output */ vk::AttachmentDescription()
-        .setLoadOp(vk::AttachmentLoadOp::eClear)
-        .setStoreOp(vk::AttachmentStoreOp::eStore)
-        .setInitialLayout(vk::ImageLayout::eUndefined)
-        .setFormat(OutputAttachmentFormat)
-        .setFinalLayout(vk::ImageLayout::ePresentSrcKHR),
-    }; /* AttachmentDescriptions */
-
-    vk::AttachmentReference OutputColorAttachmentReference {OutputAttachmentIndex, vk::ImageLayout::eColorAttachmentOptimal};
-    vk::AttachmentReference DepthAttachmentReference {DepthAttachmentIndex, vk::ImageLayout::eDepthStencilAttachmentOptimal};
-
-    vk::AttachmentReference GeometryColorAttachmentReferences[]
-    {
-      {PositionObjectIDAttachmentIndex, vk::ImageLayout::eColorAttachmentOptimal},
-      {NormalAttachmentIndex, vk::ImageLayout::eColorAttachmentOptimal},
-      {BaseColorAmbientOcclusionAttachmentIndex, vk::ImageLayout::eColorAttachmentOptimal},
-      {MetallicRoughnessInstanceAttachmentIndex, vk::ImageLayout::eColorAttachmentOptimal},
-    };
+    RenderGraph.emplace(Device, Allocator);
+    AttachmentExtent = SwapchainImageExtent;
+    BuildRenderGraph({}, FALSE, FALSE);
 
-    vk::AttachmentReference ShadingInputAttachmentReferences[]
-    {
-      {PositionObjectIDAttachmentIndex, vk::ImageLayout::eShaderReadOnlyOptimal},
-      {NormalAttachmentIndex, vk::ImageLayout::eShaderReadOnlyOptimal},
-      {BaseColorAmbientOcclusionAttachmentIndex, vk::ImageLayout::eShaderReadOnlyOptimal},
-      {MetallicRoughnessInstanceAttachmentIndex, vk::ImageLayout::eShaderReadOnlyOptimal},
-    };
+    InitTimeline();
+    InitFrames();
+    InitFrameSlots();
+    InitGpuCulling();
+    InitDraws();
+    InitShadows();
+    InitLighting();
+    InitProfiler();
 
-    vk::SubpassDescription Subpasses[]
-    {
-      /* Marker */ vk::SubpassDescription()
-        .setColorAttachments(OutputColorAttachmentReference)
-        .setPDepthStencilAttachment(&DepthAttachmentReference),
-      /* Geometry */ vk::SubpassDescription()
-        .setColorAttachments(GeometryColorAttachmentReferences)
-        .setPDepthStencilAttachment(&DepthAttachmentReference),
-      /* Shading */ vk::SubpassDescription()
-        .setInputAttachments(ShadingInputAttachmentReferences)
-        .setColorAttachments(OutputColorAttachmentReference),
-      /* Overlay */ vk::SubpassDescription()
-        .setColorAttachments(OutputColorAttachmentReference),
-    };
+    // Start readback thread
+    DoReadback = TRUE;
+    ReadbackThread = std::thread([this]( VOID ) { ReadbackThreadMain(); });
+
+    // Start rendering
+    DoRender = TRUE;
+    RenderThread = std::thread([this]( VOID ) { StartRendering(); });
+  } /* Init */
+
+  system::~system( VOID )
+  {
+    DoRender = FALSE;
+    DoRender.notify_one();
+    RenderThread.join();
+
+    Device.waitIdle();
+
+    // Deferred destroys release pooled resources, so they are done before pools are cleared
+    while (!DeferredDestroys.empty())
+      CollectDeferredDestroys(TRUE);
 
-    vk::SubpassDependency SubpassDependencies[]
+    DoReadback = FALSE;
+    ReadyReadbackCounter++;
+    ReadyReadbackCounter.notify_one();
+    ReadbackThread.join();
+    DestroyReadback();
+
+    PrimitivePool.Clear();
+    ResourcePool.Clear();
+
+    DestroyProfiler();
+    DestroyLighting();
+    DestroyShadows();
+    DestroyDraws();
+    DestroyGpuCulling();
+    DestroyFrameSlots();
+    DestroyFrames();
+    RenderGraph.reset();
+    DestroyTimeline();
+
+    Device.destroyCommandPool(RenderCommandPool);
+
+    vmaDestroyAllocator(Allocator);
+
+    if (Swapchain)
+      Device.destroySwapchainKHR(Swapchain);
+    Device.destroy();
+    if (Surface)
+      Instance.destroySurfaceKHR(Surface);
+    if (DebugMessenger)
+      DynamicFunctions.vkDestroyDebugUtilsMessengerEXT(Instance, DebugMessenger, nullptr);
+    Instance.destroy();
+  } /* ~system */
+
+  /**
+   * @brief Swapchain (re)creation function. Current swapchain (if any) is passed as old one and destroyed.
+   * @return TRUE if swapchain is created, FALSE if surface has zero extent (e.g. window is minimized)
+  */
+  BOOL system::InitSwapchain( VOID )
+  {
+    // Offscreen images are created with frames, so only extent is updated
+    if (IsHeadless)
     {
-      /* Marker -> Geometry */ vk::SubpassDependency()
-        .setSrcSubpass(MarkerSubpass)
-        .setDstSubpass(GeometrySubpass)
-        .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite)
-        .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentRead)
-        .setSrcStageMask(vk::PipelineStageFlagBits::eAllGraphics)
-        .setDstStageMask(vk::PipelineStageFlagBits::eAllGraphics),
-      /* Geometry -> Shading */ vk::SubpassDependency()
-        .setSrcSubpass(GeometrySubpass)
-        .setDstSubpass(ShadingSubpass)
-        .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentRead)
-        .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eColorAttachmentRead)
-        .setSrcStageMask(vk::PipelineStageFlagBits::eAllGraphics)
-        .setDstStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eFragmentShader),
-      /* Shading -> Overlay */ vk::SubpassDependency()
-        .setSrcSubpass(ShadingSubpass)
-        .setDstSubpass(OverlaySubpass)
-        .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eColorAttachmentRead)
-        .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
-        .setSrcStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput)
-        .setDstStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput),
-    };
+      if (RequestedExtentW == 0 || RequestedExtentH == 0)
+        return FALSE;
+      SwapchainImageExtent = vk::Extent2D(RequestedExtentW, RequestedExtentH);
+      return TRUE;
+    }
+
+    auto SurfaceCapabilities = PhysicalDevice.getSurfaceCapabilitiesKHR(Surface);
+    vk::Extent2D Extent = SurfaceCapabilities.currentExtent;
 
-    OutputRenderPass = Device.createRenderPass(vk::RenderPassCreateInfo()
-      .setAttachments(AttachmentDescriptions)
-      .setSubpasses(Subpasses)
-      .setDependencies(SubpassDependencies)
+    // Surface extent is defined by swapchain, so use last requested one
+    if (Extent.width == UINT32_MAX)
+      Extent = vk::Extent2D(
+        std::clamp(RequestedExtentW.load(), SurfaceCapabilities.minImageExtent.width, SurfaceCapabilities.maxImageExtent.width),
+        std::clamp(RequestedExtentH.load(), SurfaceCapabilities.minImageExtent.height, SurfaceCapabilities.maxImageExtent.height)
+      );
+
+    if (Extent.width == 0 || Extent.height == 0)
+      return FALSE;
+
+    // Transfer source usage is required for output readback only
+    vk::ImageUsageFlags SwapchainImageUsage = vk::ImageUsageFlagBits::eColorAttachment;
+    IsOutputReadbackSupported = (BOOL)(SurfaceCapabilities.supportedUsageFlags & vk::ImageUsageFlagBits::eTransferSrc);
+    if (IsOutputReadbackSupported)
+      SwapchainImageUsage |= vk::ImageUsageFlagBits::eTransferSrc;
+
+    PacingMutex.lock();
+    frame_pacing SwapchainPacing = Pacing;
+    PacingMutex.unlock();
+
+    SwapchainPresentMode = SelectPresentMode(SwapchainPacing.PresentMode);
+
+    // One image is on screen, the rest may wait for presentation. Zero maximal image count means no limit.
+    UINT32 ImageCount = std::max(SurfaceCapabilities.minImageCount, SwapchainPacing.MaxQueuedFrames + 1);
+    if (SurfaceCapabilities.maxImageCount != 0)
+      ImageCount = std::min(ImageCount, SurfaceCapabilities.maxImageCount);
+
+    vk::SwapchainKHR OldSwapchain = Swapchain;
+
+    Swapchain = Device.createSwapchainKHR(vk::SwapchainCreateInfoKHR()
+      .setSurface(Surface)
+      .setMinImageCount(ImageCount)
+      .setImageArrayLayers(1)
+      .setImageFormat(SwapchainImageFormat)
+      .setImageColorSpace(SwapchainColorSpace)
+      .setImageExtent(Extent)
+      .setImageUsage(SwapchainImageUsage)
+      .setImageSharingMode(vk::SharingMode::eExclusive)
+      .setPresentMode(SwapchainPresentMode)
+      .setPreTransform(SurfaceCapabilities.currentTransform)
+      .setClipped(vk::True)
+      .setOldSwapchain(OldSwapchain)
     );
+    SwapchainImageExtent = Extent;
+
+    if (OldSwapchain)
+      Device.destroySwapchainKHR(OldSwapchain);
+
+    return TRUE;
+  } /* InitSwapchain */
+
+  /**
+   * @brief Render graph (re)building function. Graph images mustn't be in use by device.
+   * @param ReadbackTargets Images to copy every frame
+   * @param IsGpuCulled Depth pyramid is built for GPU culling
+   * @param IsTransient G-buffer and depth images are requested transient
+  */
+  VOID system::BuildRenderGraph( readback_target_flags ReadbackTargets, BOOL IsGpuCulled, BOOL IsTransient )
+  {
+    using access = render_graph::access;
 
+    const BOOL IsVisibility = GBufferLayout == gbuffer_layout::eVisibility;
 
-    /* Setup attachment images */
-    struct
+    RenderGraphMutex.lock();
+    RenderGraph->Reset();
+
+    // Graph keeps images regular, if they are used outside of output render pass. Visibility buffer layout has ID image only.
+    PositionObjectID = RenderGraph->CreateImage(IsVisibility ? "Visibility" : "PositionObjectID", {.Format = PositionObjectIDAttachmentFormat, .IsTransient = IsTransient});
+    if (!IsVisibility)
+    {
+      Normal = RenderGraph->CreateImage("Normal", {.Format = NormalAttachmentFormat, .IsTransient = IsTransient});
+      BaseColorAmbientOcclusion = RenderGraph->CreateImage("BaseColorAmbientOcclusion", {.Format = BaseColorAmbientOcclusionAttachmentFormat, .IsTransient = IsTransient});
+      MetallicRoughnessInstance = RenderGraph->CreateImage("MetallicRoughnessInstance", {.Format = MetallicRoughnessInstanceAttachmentFormat, .IsTransient = IsTransient});
+    }
+    Depth = RenderGraph->CreateImage("Depth", {.Format = DepthAttachmentFormat, .IsTransient = IsTransient});
+    Output = RenderGraph->ImportImage("Output", OutputAttachmentFormat, IsHeadless ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::ePresentSrcKHR);
+
+    // Lights are binned before rendering, bins are made visible to shading by pass itself
+    RenderGraph->AddPass(
+      {
+        .Name = "LightCulling",
+        .Type = render_graph::pass_type::eCompute,
+        .Record = [this]( vk::CommandBuffer CommandBuffer ) { RecordLightCulling(CommandBuffer); },
+      });
+    MarkerGraphPass = RenderGraph->AddPass(
+      {
+        .Name = "Marker",
+        .Accesses =
+        {
+          {Output, access::eColorWrite, vk::ClearColorValue(std::array {0.30F, 0.47F, 0.80F, 1.00F})},
+          {Depth, access::eDepthWrite, vk::ClearDepthStencilValue(1.0F, 0)},
+        },
+        .IsSecondary = TRUE,
+        .Record = [this]( vk::CommandBuffer CommandBuffer ) { CommandBuffer.executeCommands(FrameSlot->MarkerCommandBuffer); },
+      });
+
+    render_graph::pass_description GeometryPass
     {
-      attachment_image &Result;
-      vk::Format Format;
-      vk::ImageUsageFlagBits Usage;
-    } AttachmentBuildDescriptions[]
+      .Name = "Geometry",
+      .Accesses = {{PositionObjectID, access::eColorWrite}},
+      .IsSecondary = TRUE,
+      .Record = [this]( vk::CommandBuffer CommandBuffer ) { CommandBuffer.executeCommands(FrameSlot->GeometryCommandBuffer); },
+    };
+    render_graph::pass_description ShadingPass
     {
-      {PositionObjectID,          PositionObjectIDAttachmentFormat         , vk::ImageUsageFlagBits::eColorAttachment       },
-      {Normal,                    NormalAttachmentFormat                   , vk::ImageUsageFlagBits::eColorAttachment       },
-      {BaseColorAmbientOcclusion, BaseColorAmbientOcclusionAttachmentFormat, vk::ImageUsageFlagBits::eColorAttachment       },
-      {MetallicRoughnessInstance, MetallicRoughnessInstanceAttachmentFormat, vk::ImageUsageFlagBits::eColorAttachment       },
-      {Depth,                     DepthAttachmentFormat                    , vk::ImageUsageFlagBits::eDepthStencilAttachment},
+      .Name = "Shading",
+      .Accesses = {{PositionObjectID, access::eInputRead}},
+      .Record = [this]( vk::CommandBuffer CommandBuffer )
+      {
+        RecordShading(CommandBuffer);
+        RecordProfileTimestamp(CommandBuffer, (UINT32)profile_pass::eShading + 1);
+      },
     };
 
-    for (auto [Result, Format, Usage] : AttachmentBuildDescriptions)
+    // Background texels are told from drawn ones by cleared object ID
+    if (GBufferLayout == gbuffer_layout::eWide)
+      GeometryPass.Accesses[0].Clear = vk::ClearColorValue(std::array {0.0F, 0.0F, 0.0F, -1.0F});
+    else
     {
-      vk::ImageCreateInfo ImageCreateInfo;
-      ImageCreateInfo
-        .setExtent(vk::Extent3D(SwapchainImageExtent, 1))
-        .setFormat(Format)
-        .setUsage(Usage | vk::ImageUsageFlagBits::eInputAttachment)
-        .setSharingMode(vk::SharingMode::eExclusive)
-        .setImageType(vk::ImageType::e2D)
-        .setTiling(vk::ImageTiling::eOptimal)
-        .setMipLevels(1)
-        .setArrayLayers(1)
-        ;
+      const UINT32 Background = visibility_id::BACKGROUND;
+      GeometryPass.Accesses[0].Clear = vk::ClearColorValue(std::array {Background, Background, Background, Background});
+    }
 
-      VmaAllocationCreateInfo AllocationCreateInfo
+    ShadingInputs = {PositionObjectID};
+    if (!IsVisibility)
+      for (render_graph::resource Resource : {Normal, BaseColorAmbientOcclusion, MetallicRoughnessInstance})
       {
-        .usage = VMA_MEMORY_USAGE_GPU_ONLY,
-        .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-      };
-
-      VkImage CImage;
-      VmaAllocation Allocation;
-      auto ImageCreateResult = vmaCreateImage(Allocator, &(VkImageCreateInfo &)ImageCreateInfo, &AllocationCreateInfo, &CImage, &Allocation, nullptr);
+        GeometryPass.Accesses.push_back({Resource, access::eColorWrite});
+        ShadingPass.Accesses.push_back({Resource, access::eInputRead});
+        ShadingInputs.push_back(Resource);
+      }
+    GeometryPass.Accesses.push_back({Depth, access::eDepthWrite});
+    ShadingPass.Accesses.push_back({Output, access::eColorWrite});
 
-      Result.Image = CImage;
-      Result.Allocation = Allocation;
+    // Compact and visibility layouts don't store position, shading reconstructs it from depth (last input attachment) and inverse projection
+    if (GBufferLayout != gbuffer_layout::eWide)
+    {
+      ShadingPass.Accesses.push_back({Depth, access::eInputRead});
+      ShadingInputs.push_back(Depth);
+    }
+    GeometryGraphPass = RenderGraph->AddPass(std::move(GeometryPass));
+    ShadingGraphPass = RenderGraph->AddPass(std::move(ShadingPass));
+    OverlayGraphPass = RenderGraph->AddPass(
+      {
+        .Name = "Overlay",
+        .Accesses = {{Output, access::eColorWrite}},
+        .IsSecondary = TRUE,
+        .Record = [this]( vk::CommandBuffer CommandBuffer ) { CommandBuffer.executeCommands(FrameSlot->OverlayCommandBuffer); },
+      });
+
+    // Copy output to readback ring
+    if (ReadbackTargets)
+    {
+      const std::pair<readback_target, render_graph::resource> ReadbackSources[]
+      {
+        {readback_target::eOutput,                    Output},
+        {readback_target::ePositionObjectID,          PositionObjectID},
+        {readback_target::eNormal,                    Normal},
+        {readback_target::eBaseColorAmbientOcclusion, BaseColorAmbientOcclusion},
+        {readback_target::eMetallicRoughnessInstance, MetallicRoughnessInstance},
+        {readback_target::eDepth,                     Depth},
+      };
+      render_graph::pass_description ReadbackPass
+      {
+        .Name = "Readback",
+        .Type = render_graph::pass_type::eTransfer,
+        .Record = [this]( vk::CommandBuffer CommandBuffer ) { RecordReadback(CommandBuffer, *Recording.Frame, Recording.FrameIndex); },
+      };
 
-      vk::ImageViewCreateInfo ImageViewCreateInfo;
-      ImageViewCreateInfo
-        .setFormat(Format)
-        .setImage(Result.Image)
-        .setViewType(vk::ImageViewType::e2D)
-        .setSubresourceRange(vk::ImageSubresourceRange()
-          .setLevelCount(1)
-          .setLayerCount(1)
-          .setAspectMask(Usage == vk::ImageUsageFlagBits::eDepthStencilAttachment
-            ? vk::ImageAspectFlagBits::eDepth
-            : vk::ImageAspectFlagBits::eColor)
-        )
-        ;
-      Result.View = Device.createImageView(ImageViewCreateInfo);
+      for (auto [Target, Resource] : ReadbackSources)
+        if (ReadbackTargets & Target)
+          ReadbackPass.Accesses.push_back({Resource, access::eTransferRead});
+      RenderGraph->AddPass(std::move(ReadbackPass));
     }
 
+    // Build depth pyramid for next frame occlusion culling
+    if (IsGpuCulled)
+      RenderGraph->AddPass(
+        {
+          .Name = "DepthPyramid",
+          .Type = render_graph::pass_type::eCompute,
+          .Accesses = {{Depth, access::eComputeSampled}},
+          .Record = [this]( vk::CommandBuffer CommandBuffer ) { RecordDepthPyramid(CommandBuffer, Recording.Frustum, Recording.ViewProjection); },
+        });
 
-    auto SwapchainImages = Device.getSwapchainImagesKHR(Swapchain);
-    Frames.resize(SwapchainImages.size());
+    RenderGraph->Compile(GraphMode, AttachmentExtent);
+    RenderGraphMutex.unlock();
 
-    // Allocate main command buffer
-    MainCommandBuffer = Device.allocateCommandBuffers(vk::CommandBufferAllocateInfo()
-      .setCommandPool(RenderCommandPool)
-      .setCommandBufferCount(1)
-    )[0];
+    GraphReadbackTargets = ReadbackTargets;
+    IsGraphGpuCulled = IsGpuCulled;
+    IsGraphTransient = IsTransient;
 
-    // Allocate subpass command buffers
-    std::vector<vk::CommandBuffer> SubpassCommandBuffers = Device.allocateCommandBuffers(vk::CommandBufferAllocateInfo()
-      .setCommandPool(RenderCommandPool)
-      .setCommandBufferCount(3)
-      .setLevel(vk::CommandBufferLevel::eSecondary)
-    );
-    MarkerCommandBuffer = SubpassCommandBuffers[0];
-    GeometryCommandBuffer = SubpassCommandBuffers[1];
-    OverlayCommandBuffer = SubpassCommandBuffers[2];
+    // View handle may be reused by new depth image, so pyramid sets are rewritten anyway
+    DepthPyramidSourceView = nullptr;
+  } /* BuildRenderGraph */
 
-    SwapchainOutputSemaphore = Device.createSemaphore(vk::SemaphoreCreateInfo());
-    RenderFinishedFence = Device.createFence(vk::FenceCreateInfo()
-      .setFlags(vk::FenceCreateFlagBits::eSignaled)
-    );
-    ImageAckquiredSemaphore = Device.createSemaphore(vk::SemaphoreCreateInfo());
+  /**
+   * @brief Frame contexts (output images and views) initialization function
+  */
+  VOID system::InitFrames( VOID )
+  {
+    std::vector<vk::Image> SwapchainImages;
+    if (IsHeadless)
+      SwapchainImages.resize(HeadlessImageCount);
+    else
+      SwapchainImages = Device.getSwapchainImagesKHR(Swapchain);
+    Frames.resize(SwapchainImages.size());
+    OutputImageCount = (UINT32)Frames.size();
 
     for (UINT32 i = 0; i < Frames.size(); i++)
     {
       auto &Frame = Frames[i];
 
+      if (IsHeadless)
+      {
+        // Offscreen output image
+        VkImageCreateInfo ImageCreateInfo = vk::ImageCreateInfo()
+          .setExtent(vk::Extent3D(SwapchainImageExtent, 1))
+          .setFormat(SwapchainImageFormat)
+          .setUsage(vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc)
+          .setSharingMode(vk::SharingMode::eExclusive)
+          .setImageType(vk::ImageType::e2D)
+          .setTiling(vk::ImageTiling::eOptimal)
+          .setMipLevels(1)
+          .setArrayLayers(1)
+          ;
+        VmaAllocationCreateInfo AllocationCreateInfo
+        {
+          .usage = VMA_MEMORY_USAGE_GPU_ONLY,
+        };
+
+        VkImage CImage;
+        if (auto Result = vmaCreateImage(Allocator, &ImageCreateInfo, &AllocationCreateInfo, &CImage, &Frame.OutputAllocation, nullptr); Result != VK_SUCCESS)
+          vk::detail::throwResultException(vk::Result(Result), "vmaCreateImage");
+        SwapchainImages[i] = CImage;
+      }
+
       Frame.SwapchainImage = SwapchainImages[i];
       Frame.SwapchainImageView = Device.createImageView(vk::ImageViewCreateInfo()
         .setFormat(SwapchainImageFormat)
@@ -412,150 +599,459 @@ namespace anv::render::core
           .setLevelCount(1)
         )
       );
-      vk::ImageView ImageViews[]
-      {
-        PositionObjectID.View,
-        Normal.View,
-        BaseColorAmbientOcclusion.View,
-        MetallicRoughnessInstance.View,
-        Depth.View,
-        Frame.SwapchainImageView,
-      };
+    }
+  } /* InitFrames */
 
-      Frame.Framebuffer = Device.createFramebuffer(vk::FramebufferCreateInfo()
-        .setAttachments(ImageViews)
-        .setHeight(SwapchainImageExtent.height)
-        .setWidth(SwapchainImageExtent.width)
-        .setRenderPass(OutputRenderPass)
-        .setLayers(1)
-      );
+  /**
+   * @brief Frame contexts destroy function
+  */
+  VOID system::DestroyFrames( VOID )
+  {
+    // Graph framebuffers reference output image views
+    RenderGraph->ReleaseFramebuffers();
+
+    for (auto &Frame : Frames)
+    {
+      Device.destroyImageView(Frame.SwapchainImageView);
+
+      if (Frame.OutputAllocation != nullptr)
+        vmaDestroyImage(Allocator, Frame.SwapchainImage, Frame.OutputAllocation);
     }
+    Frames.clear();
+  } /* DestroyFrames */
 
-    // Start rendering
-    DoRender = TRUE;
-    RenderThread = std::thread([this]( VOID ) { StartRendering(); });
-  } /* kernel */
+  /**
+   * @brief Frame slot initialization function, allocates command buffers and semaphores of every slot.
+   *        Buffers and sets are initialized by their subsystems.
+  */
+  VOID system::InitFrameSlots( VOID )
+  {
+    std::vector<vk::CommandBuffer> MainCommandBuffers = Device.allocateCommandBuffers(vk::CommandBufferAllocateInfo()
+      .setCommandPool(RenderCommandPool)
+      .setCommandBufferCount(FRAMES_IN_FLIGHT)
+    );
+    std::vector<vk::CommandBuffer> SubpassCommandBuffers = Device.allocateCommandBuffers(vk::CommandBufferAllocateInfo()
+      .setCommandPool(RenderCommandPool)
+      .setCommandBufferCount(FRAMES_IN_FLIGHT * 3)
+      .setLevel(vk::CommandBufferLevel::eSecondary)
+    );
 
-  system::~system( VOID )
+    for (UINT32 i = 0; i < FRAMES_IN_FLIGHT; i++)
+    {
+      frame_slot &Slot = FrameSlots[i];
+
+      Slot.MainCommandBuffer = MainCommandBuffers[i];
+      Slot.MarkerCommandBuffer = SubpassCommandBuffers[i * 3 + 0];
+      Slot.GeometryCommandBuffer = SubpassCommandBuffers[i * 3 + 1];
+      Slot.OverlayCommandBuffer = SubpassCommandBuffers[i * 3 + 2];
+      Slot.SwapchainOutputSemaphore = Device.createSemaphore(vk::SemaphoreCreateInfo());
+      Slot.ImageAckquiredSemaphore = Device.createSemaphore(vk::SemaphoreCreateInfo());
+    }
+    FrameSlot = &FrameSlots[0];
+  } /* InitFrameSlots */
+
+  /**
+   * @brief Frame slot destroy function. Device must be idle.
+  */
+  VOID system::DestroyFrameSlots( VOID )
   {
-    DoRender = FALSE;
-    DoRender.notify_one();
-    RenderThread.join();
+    // Command buffers are freed with their pool
+    for (frame_slot &Slot : FrameSlots)
+    {
+      Device.destroySemaphore(Slot.ImageAckquiredSemaphore);
+      Device.destroySemaphore(Slot.SwapchainOutputSemaphore);
+    }
+  } /* DestroyFrameSlots */
 
+  /**
+   * @brief Swapchain and dependent resources recreation function. Called from render thread only.
+   * @return TRUE if recreated, FALSE if surface has zero extent
+  */
+  BOOL system::RecreateSwapchain( VOID )
+  {
+    // Frames in flight, their culling passes on compute queue and pending presentation may use swapchain images and attachments.
+    // Queues are used by render thread only, so device may be waited for.
     Device.waitIdle();
 
-    PrimitivePool.Clear();
-    ResourcePool.Clear();
+    DestroyFrames();
 
-    /* Destroy frame contexts */
-    for (auto &Frame : Frames)
+    if (!InitSwapchain())
+      return FALSE;
+
+    // Graph images grow to cover new extent, but shrink to it only if it uses less than half of their area,
+    // so interactive resizing doesn't reallocate them every frame
+    if (SwapchainImageExtent.width > AttachmentExtent.width || SwapchainImageExtent.height > AttachmentExtent.height)
     {
-      Device.destroyFramebuffer(Frame.Framebuffer);
-      Device.destroyImageView(Frame.SwapchainImageView);
+      AttachmentExtent = vk::Extent2D(
+        std::max(SwapchainImageExtent.width, AttachmentExtent.width),
+        std::max(SwapchainImageExtent.height, AttachmentExtent.height)
+      );
+      BuildRenderGraph(GraphReadbackTargets, IsGraphGpuCulled, IsGraphTransient);
     }
-
-    // Destory target
-    attachment_image * AttachmentImages[]
+    else if ((UINT64)SwapchainImageExtent.width * SwapchainImageExtent.height * 2 < (UINT64)AttachmentExtent.width * AttachmentExtent.height)
     {
-      &PositionObjectID,
-      &Normal,
-      &BaseColorAmbientOcclusion,
-      &MetallicRoughnessInstance,
-      &Depth,
-    };
-    for (auto &Img : AttachmentImages)
+      AttachmentExtent = SwapchainImageExtent;
+      BuildRenderGraph(GraphReadbackTargets, IsGraphGpuCulled, IsGraphTransient);
+    }
+
+    InitFrames();
+
+    return TRUE;
+  } /* RecreateSwapchain */
+
+  /**
+   * @brief Output resize notification function, may be called from any thread
+   * @param NewExtent New output extent
+  */
+  VOID system::Resize( extent2 NewExtent )
+  {
+    RequestedExtentW = (UINT32)NewExtent.W;
+    RequestedExtentH = (UINT32)NewExtent.H;
+    SwapchainOutdated = TRUE;
+  } /* Resize */
+
+  /**
+   * @brief Culling camera setting function, may be called from any thread
+   * @param Matrices Camera matrices to build culling frustum from, empty to disable frustum culling
+  */
+  VOID system::SetCullingCamera( const std::optional<math::util::camera::projection_matrices> &Matrices )
+  {
+    std::optional<math::frustum> Frustum;
+    mat4x4 ViewProjection = mat4x4::Identity();
+
+    if (Matrices.has_value())
     {
-      Device.destroyImageView(Img->View);
-      vmaDestroyImage(Allocator, Img->Image, Img->Allocation);
+      Frustum = Matrices->GetFrustum();
+      ViewProjection = Matrices->View * Matrices->Projection;
     }
 
-    Device.destroySemaphore(ImageAckquiredSemaphore);
-    Device.destroyFence(RenderFinishedFence);
-    Device.destroySemaphore(SwapchainOutputSemaphore);
+    CullingMutex.lock();
+    CullingFrustum = Frustum;
+    CullingViewProjection = ViewProjection;
+    CullingCamera = Matrices;
+    CullingMutex.unlock();
+  } /* SetCullingCamera */
 
-    Device.destroyCommandPool(RenderCommandPool);
+  /**
+   * @brief Culling statistics getting function
+   * @return Culling statistics of last rendered frame
+  */
+  culling_stats system::GetCullingStats( VOID ) const
+  {
+    return culling_stats
+    {
+      .InstanceCount = CulledInstanceCount,
+      .VisibleInstanceCount = VisibleInstanceCount,
+      .VisibleIndexCount = VisibleIndexCount,
+      .DrawCount = RecordedDrawCount,
+      .PrepassDrawCount = PrepassDrawCount,
+      .VisibilityOverflowCount = VisibilityOverflowCount,
+      .LightOverflowCount = LightOverflowCount,
+    };
+  } /* GetCullingStats */
 
-    Device.destroyRenderPass(OutputRenderPass);
+  /**
+   * @brief GPU culling enabling function, may be called from any thread
+   * @param Enable TRUE to cull on GPU, FALSE to cull on CPU
+  */
+  VOID system::SetGpuCulling( BOOL Enable )
+  {
+    IsGpuCullingEnabled = Enable;
+  } /* SetGpuCulling */
 
-    vmaDestroyAllocator(Allocator);
+  /**
+   * @brief Transient attachments enabling function, may be called from any thread
+   * @param Enable TRUE to use transient attachments
+  */
+  VOID system::SetTransientAttachments( BOOL Enable )
+  {
+    IsTransientAttachmentsEnabled = Enable;
+  } /* SetTransientAttachments */
 
-    Device.destroySwapchainKHR(Swapchain);
-    Device.destroy();
-    Instance.destroySurfaceKHR(Surface);
-    DynamicFunctions.vkDestroyDebugUtilsMessengerEXT(Instance, DebugMessenger, nullptr);
-    Instance.destroy();
-  } /* ~system */
+  /**
+   * @brief Depth pre-pass enabling function, may be called from any thread
+   * @param Enable TRUE to pre-pass depth
+  */
+  VOID system::SetDepthPrepass( BOOL Enable )
+  {
+    IsDepthPrepassEnabled = Enable;
+  } /* SetDepthPrepass */
+
+  /**
+   * @brief Render graph image memory statistics getting function
+   * @return Memory statistics of G-buffer and depth images
+  */
+  render_graph::memory_stats system::GetAttachmentMemoryStats( VOID )
+  {
+    RenderGraphMutex.lock();
+    render_graph::memory_stats Stats = RenderGraph->GetMemoryStats();
+    RenderGraphMutex.unlock();
+
+    return Stats;
+  } /* GetAttachmentMemoryStats */
+
+  /**
+   * @brief Last read back output getting function (headless mode with readback only)
+   * @param Pixels Vector to write tightly packed R8G8B8A8 sRGB pixels to
+   * @param Extent Output extent
+   * @return Output frame number (starting from 1), 0 if no output is read back yet
+  */
+  UINT64 system::ReadOutput( std::vector<BYTE> &Pixels, extent2 &Extent )
+  {
+    OutputMutex.lock();
+    Pixels = OutputPixels;
+    Extent = OutputPixelsExtent;
+    UINT64 FrameIndex = OutputPixelsFrameIndex;
+    OutputMutex.unlock();
+
+    return FrameIndex;
+  } /* ReadOutput */
+
+  /**
+   * @brief Frame completion waiting function
+   * @param FrameCount Count of frames to wait for
+  */
+  VOID system::WaitFrames( UINT64 FrameCount )
+  {
+    for (UINT64 Completed = CompletedFrameCount; Completed < FrameCount; Completed = CompletedFrameCount)
+      CompletedFrameCount.wait(Completed);
+  } /* WaitFrames */
+
+  /**
+   * @brief Completed frame count getting function
+   * @return Count of frames, that finished rendering on GPU
+  */
+  UINT64 system::GetCompletedFrameCount( VOID ) const
+  {
+    return CompletedFrameCount;
+  } /* GetCompletedFrameCount */
 
   /**
     * @brief Frame rendering function, working in another thread
   */
   VOID system::StartRendering( VOID )
   {
+    LastFrameTime = NextFrameTime = std::chrono::steady_clock::now();
+
     while (DoRender)
     {
-      auto WaitResult = Device.waitForFences(RenderFinishedFence, vk::True, UINT64_MAX);
+      BeginProfileFrame();
+
+      // Slot resources are reused, so frame, submitted FRAMES_IN_FLIGHT frames ago, must be finished. Later frames stay in flight.
+      const UINT64 SubmittedValue = SubmittedTimelineValue;
+      FrameSlot = &FrameSlots[((UINT64)GlobalFrameIndex + 1) % FRAMES_IN_FLIGHT];
+      BeginProfileZone(profile_zone::eWait);
+      WaitTimelineValue(SubmittedValue >= FRAMES_IN_FLIGHT - 1 ? SubmittedValue - (FRAMES_IN_FLIGHT - 1) : 0);
+      EndProfileZone(profile_zone::eWait);
+
+      // Finished frames pass their copies to readback thread and their profiles to ring
+      if (const UINT64 CompletedValue = GetCompletedTimelineValue(); CompletedValue > CompletedFrameCount)
+      {
+        CompletedFrameCount = CompletedValue;
+        CompletedFrameCount.notify_all();
+        CompleteReadbacks(CompletedValue);
+        CompleteProfileFrames(CompletedValue);
+      }
+      CollectDeferredDestroys();
 
-      // GC pass
+      // GC pass. Frames in flight may still use released resources, so they leave pools now, but are destroyed after these frames.
       if (GlobalFrameIndex % 1000 == 0)
       {
-        Device.waitIdle();
+        auto Defer = [this]( std::function<VOID( VOID )> Destroy ) { DeferDestroy(std::move(Destroy)); };
 
-        PrimitivePool.CollectGarbage();
-        ResourcePool.CollectGarbage();
+        BeginProfileZone(profile_zone::eGarbageCollection);
+        PrimitivePool.CollectGarbage(Defer);
+        ResourcePool.CollectGarbage(Defer);
+        EndProfileZone(profile_zone::eGarbageCollection);
       }
 
-      vk::Result Result;
-      UINT32 Index;
-      try
+      // Recreate swapchain after resize or out-of-date presentation
+      if (SwapchainOutdated.exchange(FALSE) && !RecreateSwapchain())
       {
-        auto Pair = Device.acquireNextImageKHR(Swapchain, UINT64_MAX, ImageAckquiredSemaphore);
-        Result = Pair.result;
-        Index = Pair.value;
+        // Surface has zero extent (window is minimized), try later. Same frame index is profiled again, so its slot profile is overwritten before completion.
+        SwapchainOutdated = TRUE;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        EndProfileFrame();
+        continue;
       }
-      catch (vk::OutOfDateKHRError &)
+
+      BeginProfileZone(profile_zone::eAcquire);
+      UINT32 Index;
+      if (IsHeadless)
+        Index = (UINT32)GlobalFrameIndex % (UINT32)Frames.size();
+      else
       {
-        DoRender = FALSE;
-        return;
+        vk::Result Result;
+        try
+        {
+          auto Pair = Device.acquireNextImageKHR(Swapchain, UINT64_MAX, FrameSlot->ImageAckquiredSemaphore);
+          Result = Pair.result;
+          Index = Pair.value;
+        }
+        catch (vk::OutOfDateKHRError &)
+        {
+          SwapchainOutdated = TRUE;
+          EndProfileZone(profile_zone::eAcquire);
+          EndProfileFrame();
+          continue;
+        }
+        if (Result == vk::Result::eSuboptimalKHR)
+          SwapchainOutdated = TRUE;
       }
+      EndProfileZone(profile_zone::eAcquire);
       auto Frame = Frames[Index];
 
-      Device.resetFences(RenderFinishedFence);
+      BeginProfileZone(profile_zone::eRecording);
+
+      CullingMutex.lock();
+      std::optional<math::frustum> Frustum = CullingFrustum;
+      mat4x4 ViewProjection = CullingViewProjection;
+      std::optional<math::util::camera::projection_matrices> Camera = CullingCamera;
+      CullingMutex.unlock();
+
+      const math::frustum *FrustumPtr = Frustum.has_value() ? &*Frustum : nullptr;
+      const math::util::camera::projection_matrices *CameraPtr = Camera.has_value() ? &*Camera : nullptr;
+      BOOL IsGpuCulled = IsGpuCullingEnabled;
+
+      // Graph passes and images depend on readback targets, culling mode and transient attachment usage. Graph images are shared by frames in flight,
+      // so they are rebuilt after all submitted frames are finished.
+      ReadbackConfigMutex.lock();
+      readback_target_flags FrameReadbackTargets = ReadbackCallback != nullptr ? ReadbackTargets : readback_target_flags();
+      ReadbackConfigMutex.unlock();
+
+      // Visibility buffer layout has no material G-buffer images to read back
+      if (GBufferLayout == gbuffer_layout::eVisibility)
+        FrameReadbackTargets = FrameReadbackTargets & (readback_target::eOutput | readback_target::ePositionObjectID | readback_target::eDepth);
+
+      BOOL IsTransient = IsTransientAttachmentsEnabled;
+
+      if (FrameReadbackTargets.Bits != GraphReadbackTargets.Bits || IsGpuCulled != IsGraphGpuCulled || IsTransient != IsGraphTransient)
+      {
+        WaitTimelineValue(SubmittedValue);
+        BuildRenderGraph(FrameReadbackTargets, IsGpuCulled, IsTransient);
+      }
+
+      // Fill up marker, geometry and overlay command buffers of slot
+      const vk::CommandBuffer
+        MarkerCommandBuffer = FrameSlot->MarkerCommandBuffer,
+        GeometryCommandBuffer = FrameSlot->GeometryCommandBuffer,
+        OverlayCommandBuffer = FrameSlot->OverlayCommandBuffer,
+        MainCommandBuffer = FrameSlot->MainCommandBuffer;
 
-      // Fill up marker, geometry and overlay command buffers
       MarkerCommandBuffer.reset();
       GeometryCommandBuffer.reset();
       OverlayCommandBuffer.reset();
 
-      MarkerCommandBuffer.begin(vk::CommandBufferBeginInfo());
-      GeometryCommandBuffer.begin(vk::CommandBufferBeginInfo());
-      OverlayCommandBuffer.begin(vk::CommandBufferBeginInfo());
-
-      vk::CommandBuffer *CommandBuffers[]
+      auto BeginSecondary = [&]( vk::CommandBuffer CommandBuffer, UINT32 GraphPass )
       {
-        &MarkerCommandBuffer,
-        &GeometryCommandBuffer,
-        &OverlayCommandBuffer,
+        CommandBuffer.begin(vk::CommandBufferBeginInfo()
+          .setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue)
+          .setPInheritanceInfo(&RenderGraph->GetInheritanceInfo(GraphPass))
+        );
+
+        // Dynamic state isn't inherited by secondary command buffers
+        CommandBuffer.setViewport(0, vk::Viewport(0, 0, (FLOAT)SwapchainImageExtent.width, (FLOAT)SwapchainImageExtent.height, 0, 1));
+        CommandBuffer.setScissor(0, vk::Rect2D({0, 0}, SwapchainImageExtent));
       };
+      BeginSecondary(MarkerCommandBuffer, MarkerGraphPass);
+      BeginSecondary(GeometryCommandBuffer, GeometryGraphPass);
+      BeginSecondary(OverlayCommandBuffer, OverlayGraphPass);
+
+      // Instances get visibility IDs, when their culling records are written
+      LayoutVisibilityIds();
+
+      // Indexed primitives are culled on compute queue and drawn by indirect commands
+      if (IsGpuCulled)
+        SubmitGpuCulling(FrustumPtr, ViewProjection, CameraPtr);
+      else
+      {
+        for (primitive *Primitive : PrimitivePool)
+          Primitive->IndirectDrawIndex = primitive::NO_INDIRECT_DRAW;
+
+        // Pyramid semaphore must be waited before it's signaled again
+        if (IsDepthPyramidSignaled)
+        {
+          vk::PipelineStageFlags WaitStageMask = vk::PipelineStageFlagBits::eComputeShader;
+          ComputeQueue.submit(vk::SubmitInfo()
+            .setWaitSemaphores(DepthPyramidReadySemaphore)
+            .setWaitDstStageMask(WaitStageMask)
+          );
+          IsDepthPyramidSignaled = FALSE;
+        }
+        IsDepthPyramidValid = FALSE;
+        GpuVisibleInstanceCount = 0;
+        GpuVisibleIndexCount = 0;
+      }
+
+      UINT64 InstanceCount = 0, FrameVisibleInstanceCount = GpuVisibleInstanceCount, FrameVisibleIndexCount = GpuVisibleIndexCount;
+
+      BeginProfileZone(profile_zone::eCulling);
+
+      // Instances of primitives with bounds are culled by scene hierarchy query
+      if (FrustumPtr != nullptr)
+        CullScene(*FrustumPtr);
 
-      // Write pass command buffers
       for (primitive *Primitive : PrimitivePool)
         if (!Primitive->Instances.empty())
         {
+          InstanceCount += Primitive->Instances.size();
+          if (Primitive->IndirectDrawIndex != primitive::NO_INDIRECT_DRAW)
+            continue;
+
+          if (FrustumPtr == nullptr || !Primitive->Bounds.has_value())
+            Primitive->Cull(nullptr);
+          FrameVisibleInstanceCount += Primitive->VisibleInstances.size();
+          if (!Primitive->VisibleInstances.empty())
+            FrameVisibleIndexCount += Primitive->SelectVisibleLods(CameraPtr);
+        }
+
+      EndProfileZone(profile_zone::eCulling);
+
+      // Instance set of CPU culled primitives is written before any draw binds it
+      WriteDrawInstances();
+
+      // Write pass command buffers
+      const BOOL IsPrepassed = IsDepthPrepassEnabled;
+      UINT64 DrawCount = 0, FramePrepassDrawCount = 0;
 
+      for (primitive *Primitive : PrimitivePool)
+        if (!Primitive->Instances.empty())
+        {
+          if (Primitive->IndirectDrawIndex == primitive::NO_INDIRECT_DRAW && Primitive->VisibleInstances.empty())
+            continue;
 
-          switch (Primitive->Pipeline.RenderPass)
+          const pipeline &Pipeline = Primitive->Pipeline;
+          switch (Pipeline.RenderPass)
           {
           case render_pass::eMarker:
+            DrawCount += RecordDraws(MarkerCommandBuffer, *Primitive, Pipeline.Pipeline);
             break;
           case render_pass::eGeometry:
+            // Pre-passed primitive is drawn twice: depth only in marker pass from position stream, then with equal depth test and
+            // without depth writes, so its G-buffer fragments are shaded once per pixel
+            if (IsPrepassed && Pipeline.DepthPrepassPipeline)
+            {
+              FramePrepassDrawCount += RecordDraws(MarkerCommandBuffer, *Primitive, Pipeline.DepthPrepassPipeline);
+              DrawCount += RecordDraws(GeometryCommandBuffer, *Primitive, Pipeline.DepthEqualPipeline);
+            }
+            else
+              DrawCount += RecordDraws(GeometryCommandBuffer, *Primitive, Pipeline.Pipeline);
             break;
           case render_pass::eOverlay:
+            DrawCount += RecordDraws(OverlayCommandBuffer, *Primitive, Pipeline.Pipeline);
             break;
           }
-          if (Primitive->IndexBuffer != nullptr)
-            ;
         }
 
+      CulledInstanceCount = InstanceCount;
+      VisibleInstanceCount = FrameVisibleInstanceCount;
+      VisibleIndexCount = FrameVisibleIndexCount;
+      RecordedDrawCount = DrawCount + FramePrepassDrawCount;
+      PrepassDrawCount = FramePrepassDrawCount;
+
+      RecordProfileTimestamp(MarkerCommandBuffer, (UINT32)profile_pass::eMarker + 1);
+      RecordProfileTimestamp(GeometryCommandBuffer, (UINT32)profile_pass::eGeometry + 1);
+
       MarkerCommandBuffer.end();
       GeometryCommandBuffer.end();
       OverlayCommandBuffer.end();
@@ -564,84 +1060,115 @@ namespace anv::render::core
 
       MainCommandBuffer.begin(vk::CommandBufferBeginInfo());
 
-      /* Bake lighting depthmaps */
-      FLOAT Time = std::chrono::duration_cast<std::chrono::duration<FLOAT>>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
-
-      // Shadow passes somewhere here
+      // GPU only resources are shared by slots, so previous frame must finish with them
+      vk::MemoryBarrier FrameBarrier = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eMemoryWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite);
+      MainCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eAllCommands, {}, FrameBarrier, {}, {});
+      if (IsGpuCulled)
+        RecordCullingAcquire(MainCommandBuffer);
+      RecordProfileTimestamp(MainCommandBuffer, 0);
 
-      // Fill secondary command buff
-
-      vk::ClearValue OutputClearValues[]
-      {
-        /* PositionObjectID          */ {{INFINITY, INFINITY, INFINITY, INFINITY}},
-        /* Normal                    */ {{0.00F, 0.01F, 0.00F, 0.00F}},
-        /* BaseColorAmbientOcclusion */ {{0.30F, 0.47F, 0.80F, 1.0F}},
-        /* MetallicRoughnessInstance */ {{0.5F, 0.5F, 0.0F, 1.0F}},
-        /* Depth                     */ {1.0F},
-        /* Output                    */ {{0.30F, 0.47F, 0.80F, 1.00F}},
-      };
+      /* Bake lighting depthmaps */
 
-      // Marker pass
-      MainCommandBuffer.beginRenderPass(vk::RenderPassBeginInfo()
-        .setFramebuffer(Frame.Framebuffer)
-        .setRenderPass(OutputRenderPass)
-        .setClearValues(OutputClearValues)
-        .setRenderArea(vk::Rect2D({0, 0}, SwapchainImageExtent)),
-        vk::SubpassContents::eSecondaryCommandBuffers
-      );
-      MainCommandBuffer.executeCommands(MarkerCommandBuffer);
+      // Cached cascades are kept, so only cascades with moved camera slice or casters are rendered
+      RecordShadows(MainCommandBuffer, CameraPtr);
+      RecordProfileTimestamp(MainCommandBuffer, (UINT32)profile_pass::eShadow + 1);
 
-      // Geometry pass
-      MainCommandBuffer.nextSubpass(vk::SubpassContents::eSecondaryCommandBuffers);
-      MainCommandBuffer.executeCommands(GeometryCommandBuffer);
+      // Light culling, marker, geometry, shading and overlay passes, readback copy and depth pyramid building
+      Recording.Frame = &Frames[Index];
+      Recording.FrameIndex = (UINT64)GlobalFrameIndex + 1;
+      Recording.Frustum = FrustumPtr;
+      Recording.ViewProjection = ViewProjection;
 
-      // Shading pass
-      MainCommandBuffer.nextSubpass(vk::SubpassContents::eInline);
+      PrepareLighting(CameraPtr);
 
-      /* Do lighting and so on */
+      const render_graph::imported_image OutputBinding {Frame.SwapchainImage, Frame.SwapchainImageView};
+      RenderGraph->Execute(MainCommandBuffer, SwapchainImageExtent, std::span(&OutputBinding, 1));
 
-      // Overlay pass
-      MainCommandBuffer.nextSubpass(vk::SubpassContents::eSecondaryCommandBuffers);
-      MainCommandBuffer.executeCommands(OverlayCommandBuffer);
+      RecordProfileTimestamp(MainCommandBuffer, (UINT32)profile_pass::eOverlay + 1);
+      if (IsGpuCulled)
+        RecordCullingRelease(MainCommandBuffer);
+      MainCommandBuffer.end();
+      EndProfileZone(profile_zone::eRecording);
 
+      // Binary semaphore values are ignored, so they are left zero
+      vk::Semaphore WaitSemaphores[2], SignalSemaphores[3];
+      vk::PipelineStageFlags WaitStageMasks[2];
+      UINT64 WaitValues[2] {}, SignalValues[3] {};
+      UINT32 WaitSemaphoreCount = 0, SignalSemaphoreCount = 0;
 
-      MainCommandBuffer.endRenderPass();
-      MainCommandBuffer.end();
+      if (!IsHeadless)
+      {
+        WaitSemaphores[WaitSemaphoreCount] = FrameSlot->ImageAckquiredSemaphore;
+        WaitStageMasks[WaitSemaphoreCount++] = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+        SignalSemaphores[SignalSemaphoreCount++] = FrameSlot->SwapchainOutputSemaphore;
+      }
+      if (IsGpuCulled)
+      {
+        // Compute stage is waited too, so depth pyramid isn't overwritten while culling pass reads it
+        WaitSemaphores[WaitSemaphoreCount] = CullingFinishedSemaphore;
+        WaitStageMasks[WaitSemaphoreCount++] = vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eComputeShader;
+        SignalSemaphores[SignalSemaphoreCount++] = DepthPyramidReadySemaphore;
+        IsDepthPyramidSignaled = TRUE;
+      }
+      SignalValues[SignalSemaphoreCount] = (UINT64)GlobalFrameIndex + 1;
+      SignalSemaphores[SignalSemaphoreCount++] = TimelineSemaphore;
+
+      vk::TimelineSemaphoreSubmitInfo TimelineSubmitInfo = vk::TimelineSemaphoreSubmitInfo()
+        .setWaitSemaphoreValueCount(WaitSemaphoreCount)
+        .setPWaitSemaphoreValues(WaitValues)
+        .setSignalSemaphoreValueCount(SignalSemaphoreCount)
+        .setPSignalSemaphoreValues(SignalValues)
+        ;
 
-      vk::PipelineStageFlags WaitStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+      BeginProfileZone(profile_zone::eSubmit);
       GraphicsQueue.submit(vk::SubmitInfo()
+        .setPNext(&TimelineSubmitInfo)
         .setCommandBuffers(MainCommandBuffer)
-        .setWaitSemaphores(ImageAckquiredSemaphore)
-        .setWaitDstStageMask(WaitStageMask)
-        .setSignalSemaphores(SwapchainOutputSemaphore),
-        RenderFinishedFence
+        .setWaitSemaphoreCount(WaitSemaphoreCount)
+        .setPWaitSemaphores(WaitSemaphores)
+        .setPWaitDstStageMask(WaitStageMasks)
+        .setSignalSemaphoreCount(SignalSemaphoreCount)
+        .setPSignalSemaphores(SignalSemaphores)
       );
+      SubmittedTimelineValue = FrameSlot->TimelineValue = (UINT64)GlobalFrameIndex + 1;
+      EndProfileZone(profile_zone::eSubmit);
 
-      try
-      {
-        auto PresentResult = GraphicsQueue.presentKHR(vk::PresentInfoKHR()
-          .setWaitSemaphores(SwapchainOutputSemaphore)
-          .setSwapchains(Swapchain)
-          .setImageIndices(Index)
-        );
-      }
-      catch (vk::OutOfDateKHRError &)
+      if (!IsHeadless)
       {
-        DoRender = FALSE;
-        return;
+        BeginProfileZone(profile_zone::ePresent);
+        try
+        {
+          auto PresentResult = GraphicsQueue.presentKHR(vk::PresentInfoKHR()
+            .setWaitSemaphores(FrameSlot->SwapchainOutputSemaphore)
+            .setSwapchains(Swapchain)
+            .setImageIndices(Index)
+          );
+          if (PresentResult == vk::Result::eSuboptimalKHR)
+            SwapchainOutdated = TRUE;
+        }
+        catch (vk::OutOfDateKHRError &)
+        {
+          SwapchainOutdated = TRUE;
+        }
+        EndProfileZone(profile_zone::ePresent);
       }
+      EndProfileFrame();
+
+      LimitFrameRate();
 
       GlobalFrameIndex++;
     }
   } /* StartRendering */
 
   /**
-   * @brief Render pass subpass index getting function
-   * @param Pass Render pass to get subpass index of
-   * @return Subpass index
+   * @brief Render pass graph pass getting function
+   * @param Pass Render pass to get graph pass of
+   * @return Graph pass index
   */
-  UINT32 system::GetRenderPassSubpassIndex( render_pass Pass )
+  UINT32 system::GetRenderPassGraphPass( render_pass Pass )
   {
-    return std::array{0, 1, 3}[(UINT32)Pass];
-  } /* GetRenderPassSubpassIndex */
+    return std::array{MarkerGraphPass, GeometryGraphPass, OverlayGraphPass}[(UINT32)Pass];
+  } /* GetRenderPassGraphPass */
 } /* namespace anv::render::core */
@@ -18,10 +18,16 @@
 
 #include "util/resource/anv_resource_rc.h"
 #include "util/math/anv_math.h"
+#include "util/math/anv_math_bounds.h"
+#include "util/math/anv_math_bvh.h"
+#include "util/math/anv_math_camera.h"
+#include "util/thread/anv_thread_spsc_ring.h"
 
 #include <vulkan/vulkan.hpp>
 #include <vma/vk_mem_alloc.h>
 
+#include "anv_render_core_graph.h"
+
 /**
  * @brief Project namespace
 */
@@ -50,11 +56,41 @@ namespace anv::render::core
 
       eI8Norm,  // Normalized INT8
       eI16Norm, // Normalized INT16
-      eI32Norm, // Normalized INT32
+      eI32Norm, // Normalized INT32 (has no Vulkan format)
 
       eF16,     // FLOAT16
       eF32,     // FLOAT32
 
+      eD16,     // Normalized UINT16 depth (1 component)
+      eD32,     // FLOAT32 depth (1 component)
+      eD24S8,   // Normalized 24 bit depth and UINT8 stencil (2 components)
+      eD32S8,   // FLOAT32 depth and UINT8 stencil (2 components)
+
+      eBC1,         // BC1 4x4 block compression, normalized RGB (3 components) or RGB with 1 bit alpha (4 components)
+      eBC1Srgb,     // BC1 4x4 block compression, sRGB
+      eBC2,         // BC2 4x4 block compression, normalized RGBA with explicit 4 bit alpha (4 components)
+      eBC2Srgb,     // BC2 4x4 block compression, sRGB
+      eBC3,         // BC3 4x4 block compression, normalized RGBA with interpolated alpha (4 components)
+      eBC3Srgb,     // BC3 4x4 block compression, sRGB
+      eBC4,         // BC4 4x4 block compression, normalized R (1 component)
+      eBC4Norm,     // BC4 4x4 block compression, signed normalized R
+      eBC5,         // BC5 4x4 block compression, normalized RG (2 components)
+      eBC5Norm,     // BC5 4x4 block compression, signed normalized RG
+      eBC6H,        // BC6H 4x4 block compression, unsigned FLOAT16 RGB (3 components)
+      eBC6HSigned,  // BC6H 4x4 block compression, signed FLOAT16 RGB
+      eBC7,         // BC7 4x4 block compression, normalized RGBA (4 components)
+      eBC7Srgb,     // BC7 4x4 block compression, sRGB
+      eETC2,        // ETC2 4x4 block compression, normalized RGB (3 components) or RGBA (4 components)
+      eETC2Srgb,    // ETC2 4x4 block compression, sRGB
+      eEAC,         // EAC 4x4 block compression, normalized 11 bit R (1 component) or RG (2 components)
+      eEACNorm,     // EAC 4x4 block compression, signed normalized 11 bit R or RG
+      eASTC4x4,     // ASTC 4x4 block compression, normalized RGBA (4 components)
+      eASTC4x4Srgb, // ASTC 4x4 block compression, sRGB
+      eASTC6x6,     // ASTC 6x6 block compression, normalized RGBA (4 components)
+      eASTC6x6Srgb, // ASTC 6x6 block compression, sRGB
+      eASTC8x8,     // ASTC 8x8 block compression, normalized RGBA (4 components)
+      eASTC8x8Srgb, // ASTC 8x8 block compression, sRGB
+
       _eCount,  // Helper
     }; /* enum type */
 
@@ -62,13 +98,33 @@ namespace anv::render::core
     UINT8 Count = 4;           // Format component count
   }; /* struct format */
 
+  /**
+   * @brief Format support structure
+  */
+  struct format_support
+  {
+    BOOL IsSampled = FALSE;         // Images may be sampled (optimal tiling)
+    BOOL IsFiltered = FALSE;        // Sampled images may be filtered linearly
+    BOOL IsStorage = FALSE;         // Images may be used as storage ones
+    BOOL IsColorAttachment = FALSE; // Images may be rendered to as color attachments
+    BOOL IsDepthAttachment = FALSE; // Images may be rendered to as depth (stencil) attachments
+    BOOL IsVertexBuffer = FALSE;    // Vertex attributes may have format
+  }; /* struct format_support */
+
   /**
    * @brief Format translate function
    * @param Format ANV Format to translate
-   * @return Vulkan format
+   * @return Vulkan format, vk::Format::eUndefined if component type has no Vulkan format with Format.Count components
   */
   vk::Format TranslateFormat( format Format );
 
+  /**
+   * @brief Depth format checking function
+   * @param Format ANV Format to check
+   * @return TRUE if format has depth component
+  */
+  BOOL IsDepthFormat( format Format );
+
   /* Render pass indexing structure */
   enum class render_pass
   {
@@ -122,8 +178,10 @@ namespace anv::render::core
   public:
     enum class usage
     {
-      eSampled = 0x1, // Image, used as rendering attachment
-      eStorage = 0x2, // Image, used as multidimensional buffer
+      eSampled         = 0x1, // Image, sampled by shaders
+      eStorage         = 0x2, // Image, used as multidimensional buffer
+      eColorAttachment = 0x4, // Image, rendered to as color attachment
+      eDepthAttachment = 0x8, // Image, rendered to as depth attachment
 
       ANV_FLAG_BITS_SIGN
     }; /* enum usage */
@@ -361,9 +419,10 @@ namespace anv::render::core
       */
       view( buffer *Buffer, SIZE_T Offset, SIZE_T Size );
 
-      buffer &Buffer;      // Parent buffer reference
-      SIZE_T Offset, Size; // Offset and size of view
-      vk::Buffer View;     // Buffer view itself
+      buffer &Buffer;                // Parent buffer reference
+      SIZE_T Offset, Size;           // Offset and size of view
+      vk::Buffer View;               // Buffer view itself
+      vk::DeviceAddress Address = 0; // Shader device address of view start (index and vertex views only)
 
       /**
        * @brief Resource destroy callback
@@ -426,6 +485,17 @@ namespace anv::render::core
   class primitive : public rc::resource
   {
   public:
+    /**
+     * @brief Level of detail description structure
+    */
+    struct lod
+    {
+      UINT32 FirstIndex = 0;   // First index of level range in index buffer
+      UINT32 IndexCount = 0;   // Count of indices in level range
+      INT32 VertexOffset = 0;  // Value, added to level indices
+      FLOAT MinScreenSize = 0; // Minimal projected bounds diameter (relative to output height) to draw instance with this level
+    }; /* struct lod */
+
     /**
      * @brief Primitive builder representation structure
     */
@@ -433,6 +503,10 @@ namespace anv::render::core
       ANV_BUILDER_FIELD(std::span<buffer::view *>, VertexBufferViews); // Buffer views
       ANV_BUILDER_FIELD(buffer::view *, IndexBufferView) = nullptr;    // Index buffer pointer
       ANV_BUILDER_FIELD(material *, Material) = nullptr;               // Material pointer
+      ANV_BUILDER_FIELD(std::optional<math::aabb>, Bounds);            // Local space bounding box (e.g. math::aabb::FromVertices), never culled if empty
+      ANV_BUILDER_FIELD(std::span<const lod>, Lods);                   // Index ranges of levels of detail from the most detailed one, by decreasing MinScreenSize. Whole index buffer is single level if empty.
+      ANV_BUILDER_FIELD(FLOAT, LodHysteresis) = 0.1F;                  // Relative screen size band around level thresholds, inside which instance keeps its level
+      ANV_BUILDER_FIELD(BOOL, IsRigid) = FALSE;                        // Instance transforms are Scale * Rotate * Translate ones (no shear), GPU culled instances are uploaded as math::packed_trs
     ANV_BUILDER_END;
 
     /**
@@ -447,6 +521,18 @@ namespace anv::render::core
     */
     VOID SetMaterial( material *NewMaterial );
 
+    /**
+     * @brief Local space bounding box getting function
+     * @return Bounding box, empty if primitive isn't culled
+    */
+    std::optional<math::aabb> GetBounds( VOID ) const;
+
+    /**
+     * @brief Local space bounding box setting function
+     * @param NewBounds New bounding box, empty to disable culling of this primitive
+    */
+    VOID SetBounds( const std::optional<math::aabb> &NewBounds );
+
     /**
      * @brief Primitive instance representation structure
     */
@@ -466,8 +552,15 @@ namespace anv::render::core
       */
       VOID SetTransform( const mat4x4 &NewTransform );
 
+      /**
+       * @brief Index in primitive transform span getting function
+       * @return Current instance index. Changes on destruction of instances, created before this one.
+      */
+      UINT32 GetIndex( VOID ) const;
+
     private:
       friend class primitive;
+      friend class system;
 
       /**
        * @brief Instance constructor
@@ -481,6 +574,8 @@ namespace anv::render::core
 
       primitive &Primitive;     // Primitive
       UINT32 Index = 0;         // Matrix index
+      UINT32 Lod = 0;           // Current level of detail. Written by render thread only.
+      math::bvh::handle BvhHandle = math::bvh::INVALID_HANDLE; // Scene hierarchy leaf, invalid if primitive has no bounds
 
       /**
        * @brief Resource destroy callback
@@ -493,6 +588,33 @@ namespace anv::render::core
     */
     instance * Instance( const mat4x4 &Transform = mat4x4::Identity() );
 
+    /**
+     * @brief Instances bulk create function. Instances are inserted into scene hierarchy at once, so many of them rebuild it by parallel SAH builder.
+     * @param NewTransforms Transforms of instances to create
+     * @return Created instances, in transform order
+    */
+    std::vector<instance *> CreateInstances( std::span<const mat4x4> NewTransforms );
+
+    /**
+     * @brief Instance transforms getting function. Intended for bulk updates (e.g. by math::batch kernels).
+     * @return Transform span, indexed by instance::GetIndex. Valid until instance creation or destruction.
+    */
+    std::span<mat4x4> GetTransforms( VOID );
+
+    /**
+     * @brief Instance transforms bulk setting function
+     * @param FirstIndex Index of first instance to set transform of
+     * @param NewTransforms Transforms to copy, must fit in instance count
+    */
+    VOID SetTransforms( UINT32 FirstIndex, std::span<const mat4x4> NewTransforms );
+
+    /**
+     * @brief Instance world bounds updating function. Must be called after transforms are written through GetTransforms span.
+     * @param FirstIndex Index of first instance to update bounds of
+     * @param Count Count of instances to update bounds of
+    */
+    VOID UpdateInstanceBounds( UINT32 FirstIndex, UINT32 Count );
+
   public:
     pipeline &Pipeline;                         // Primitive parent pipeline, must be matched with pipeline one.
 
@@ -503,6 +625,62 @@ namespace anv::render::core
     std::vector<instance *> Instances; // Instance vector
     std::vector<mat4x4> Transforms;    // Instance trasnformation matrix
 
+    std::optional<math::aabb> Bounds;     // Local space bounding box
+    std::vector<UINT32> VisibleInstances; // Indices of instances, visible in current frame, grouped by level of detail. Written by render thread only.
+
+    std::vector<lod> Lods;                // Levels of detail, never empty
+    FLOAT LodHysteresis = 0;              // Relative screen size band around level thresholds
+    BOOL IsRigid = FALSE;                 // Instance transforms have no shear, so they are uploaded to GPU culling as 32 byte math::packed_trs
+    std::vector<UINT32> VisibleLodCounts; // Count of visible instances of every level of CPU culled primitive. Written by render thread only.
+
+    constexpr static UINT32 NO_INDIRECT_DRAW = ~0U; // Primitive isn't culled on GPU in current frame
+    UINT32 IndirectDrawIndex = NO_INDIRECT_DRAW;    // Index of first (level 0) draw command of primitive in GPU culling indirect buffer, every level has its own. Written by render thread only.
+    UINT32 FirstDrawInstance = 0;                   // Index of first visible instance of CPU culled primitive in draw instance buffer. Written by render thread only.
+    UINT32 VertexCount = 0;                         // Count of vertices of non-indexed primitive
+
+    /**
+     * @brief Instance upload state of one frame slot GPU culling instance buffer
+    */
+    struct instance_upload
+    {
+      UINT32 FirstInstance = NO_INDIRECT_DRAW; // First instance of primitive in slot buffer at last upload, NO_INDIRECT_DRAW if never uploaded
+      UINT32 FirstDrawIndex = 0;               // Level 0 draw index of primitive at last upload
+      UINT32 ChangedFirst = 0;                 // First instance, changed after last upload
+      UINT32 ChangedEnd = 0;                   // Instance after last changed one
+    }; /* struct instance_upload */
+
+    std::vector<instance_upload> InstanceUploads; // Per frame slot upload state, so only changed transforms are uploaded. Guarded by SceneBvhMutex.
+
+    /**
+     * @brief Changed instances marking function, must be called with locked SceneBvhMutex
+     * @param FirstIndex Index of first changed instance
+     * @param Count Count of changed instances
+    */
+    VOID MarkInstancesChanged( UINT32 FirstIndex, UINT32 Count );
+
+    /**
+     * @brief Instance culling function, called from render thread
+     * @param Frustum Frustum to cull by, nullptr to treat all instances as visible
+     * @return Count of visible instances
+    */
+    SIZE_T Cull( const math::frustum *Frustum );
+
+    /**
+     * @brief Instance level of detail selection function, called from render thread
+     * @param Index Instance index
+     * @param Camera Camera, instance is viewed by, nullptr to use the most detailed level
+     * @return Selected level of detail
+    */
+    UINT32 SelectLod( UINT32 Index, const math::util::camera::projection_matrices *Camera );
+
+    /**
+     * @brief Visible instances levels of detail selection function, called from render thread.
+     *        Groups visible instances by level and fills level counts.
+     * @param Camera Camera, instances are viewed by, nullptr to use the most detailed level
+     * @return Count of indices of visible instances of all levels
+    */
+    UINT64 SelectVisibleLods( const math::util::camera::projection_matrices *Camera );
+
     /**
      * @brief Instance destroy callback
     */
@@ -577,11 +755,24 @@ namespace anv::render::core
       } /* Grab */
     }; /* attr */
 
+    /**
+     * @brief Material surface description structure. Visibility G-buffer layout shading evaluates it per pixel,
+     *        other layouts take surface from geometry pass fragment shader.
+    */
+    struct surface
+    {
+      vec3 BaseColor {1, 1, 1};   // Linear base color
+      FLOAT AmbientOcclusion = 1; // Ambient light multiplier
+      FLOAT Metallic = 0;         // Metalness
+      FLOAT Roughness = 1;        // Perceptual roughness
+    }; /* struct surface */
+
     /**
      * @brief Mateiral builder class
     */
     ANV_BUILDER_HEAD(material, pipeline)
       ANV_BUILDER_FIELD(std::span<attached_resource>, AttachedResources); // Initially attached resources
+      ANV_BUILDER_FIELD(surface, Surface);                                // Surface of visibility G-buffer layout shading
     ANV_BUILDER_END;
 
     // /**
@@ -599,6 +790,7 @@ namespace anv::render::core
     vk::DescriptorSet DescriptorSet;                  // Descriptor set appended to this material
 
     std::vector<attached_resource> AttachedResources; // List of resources attached
+    surface Surface;                                  // Surface of visibility G-buffer layout shading
 
     /**
      * @brief Material constructor
@@ -656,6 +848,14 @@ namespace anv::render::core
       vertex_input_rate Rate = vertex_input_rate::eVertex; // Vertex rate
     }; /* struct vertex_buffer_layout */
 
+    /**
+     * Descriptor set of drawn instances, appended to every pipeline layout after material set. Vertex shader reads instance transform as
+     * Instances[VisibleInstances[InstanceIndex]].Transform, where binding 0 is std430 {mat4 Transform; uint DrawIndex; uint VisibilityID; uint FirstDrawIndex; uint Padding;} Instances[]
+     * and binding 1 is std430 uint VisibleInstances[]. In visibility G-buffer layout geometry pass fragment shader writes VisibilityID | SV_PrimitiveID
+     * (VisibilityID passed from vertex shader as flat output).
+    */
+    constexpr static UINT32 INSTANCE_SET = 1;
+
     /**
      * @brief Pipeline builder
     */
@@ -669,6 +869,9 @@ namespace anv::render::core
       ANV_BUILDER_FIELD(polygon_mode,                             PolygonMode) = polygon_mode::eFill;        // Polygon mode
       ANV_BUILDER_FIELD(std::span<const vertex_attribute_layout>, VertexAttributeLayouts);                   // Vertex attribute layout
       ANV_BUILDER_FIELD(std::span<const vertex_buffer_layout>,    VertexBufferLayouts);                      // Vertex buffer layout
+      ANV_BUILDER_FIELD(BOOL,                                     CastShadows) = FALSE;                      // Primitives are drawn to directional light shadow maps, first vertex attribute must be float position
+      ANV_BUILDER_FIELD(std::span<const UINT32>,                  DepthVertexSPV);                           // SPIRV of depth pre-pass vertex shader (geometry pass only), empty if primitives aren't pre-passed. Reads first vertex attribute only, must compute position by the same expressions as vertex shader does. Position of both shaders is decorated Invariant on build (as GLSL 'invariant gl_Position'), so geometry pass equal depth test passes.
+      ANV_BUILDER_FIELD(INT32,                                    NormalAttributeIndex) = -1;                // Index of F32x3 object space normal attribute, fetched by visibility G-buffer layout shading. Face normal is used, if negative.
     ANV_BUILDER_END;
 
     /**
@@ -687,6 +890,15 @@ namespace anv::render::core
     */
     material * Build( material::builder &Builder );
 
+    /**
+     * @brief Primitive builder getting function
+     * @return Primitive builder
+    */
+    primitive::builder Primitive( VOID )
+    {
+      return primitive::builder(*this);
+    } /* Primitive */
+
     /**
      * @brief Primitive building function
      * @param Builder Builder to build primitive in
@@ -715,6 +927,13 @@ namespace anv::render::core
     vk::PipelineLayout PipelineLayout;               // Layout of pipelines
     vk::DescriptorSetLayout DescriptorSetLayout;     // Layout of descriptor sets
     vk::Pipeline Pipeline;                           // Pipeline
+    vk::Pipeline ShadowPipeline;                     // Depth only shadow caster pipeline, empty if primitives don't cast shadows
+    vk::Pipeline DepthPrepassPipeline;               // Depth only marker pass pipeline, empty if primitives aren't pre-passed
+    vk::Pipeline DepthEqualPipeline;                 // Pipeline with equal depth test and without depth writes, used after depth pre-pass
+    UINT32 PositionBufferIndex = 0;                  // Index of vertex buffer with positions (used by shadow and depth pre-pass pipelines)
+    std::vector<vertex_buffer_layout> VertexBufferLayouts; // Vertex buffer layouts (vertex count of non-indexed primitives is taken from them)
+    std::vector<vertex_attribute_layout> VertexAttributeLayouts; // Vertex attribute layouts (positions and normals are fetched by visibility G-buffer layout shading)
+    INT32 NormalAttributeIndex = -1;                 // Index of normal attribute, negative if pipeline has no normals
     render_pass RenderPass;                          // Render pass index
     std::vector<shader_binding_type> ShaderBindingTypes; // Shader binding descriptions
 
@@ -731,6 +950,278 @@ namespace anv::render::core
   */
   vk::DescriptorType TranslateShaderBindingType( pipeline::shader_binding_type Type );
 
+  /**
+   * @brief Primitive topology translation function
+   * @param Topology Topology to translate
+   * @return Vulkan primitive topology
+  */
+  vk::PrimitiveTopology TranslateTopology( topology Topology );
+
+  /**
+   * @brief Cull mode translation function
+   * @param CullModeFlags Cull mode to translate
+   * @return Vulkan cull mode flags
+  */
+  vk::CullModeFlags TranslateCullMode( cull_mode_flags CullModeFlags );
+
+  /**
+   * @brief Frame readback target enumeration
+  */
+  enum class readback_target
+  {
+    eOutput                    = 0x01, // Final output (swapchain or offscreen image)
+    ePositionObjectID          = 0x02, // G-buffer position and object ID (object ID only in compact G-buffer layout, visibility_id in visibility one)
+    eNormal                    = 0x04, // G-buffer normal (absent in visibility G-buffer layout)
+    eBaseColorAmbientOcclusion = 0x08, // G-buffer base color and ambient occlusion (absent in visibility G-buffer layout)
+    eMetallicRoughnessInstance = 0x10, // G-buffer metallic, roughness and instance (absent in visibility G-buffer layout)
+    eDepth                     = 0x20, // Depth
+
+    ANV_FLAG_BITS_SIGN
+  }; /* enum readback_target */
+
+  // Readback target flags
+  using readback_target_flags = flags<readback_target>;
+
+  /**
+   * @brief Read back image representation structure
+  */
+  struct readback_image
+  {
+    readback_target Target;     // Image source
+    vk::Format Format;          // Texel format
+    extent2 Extent;             // Image extent
+    std::span<const BYTE> Data; // Tightly packed texels, valid during callback only
+  }; /* struct readback_image */
+
+  /**
+   * @brief Read back frame representation structure
+  */
+  struct readback_frame
+  {
+    UINT64 FrameIndex;                      // Frame number (starting from 1)
+    std::span<const readback_image> Images; // Read back images (in readback_target bit order)
+    UINT32 VisibilityTriangleBits = 0;      // visibility_id triangle bit count of frame (visibility G-buffer layout only)
+  }; /* struct readback_frame */
+
+  // Readback callback, called from readback thread
+  using readback_callback = std::function<VOID( const readback_frame &Frame )>;
+
+  /**
+   * @brief Readback statistics structure
+  */
+  struct readback_stats
+  {
+    UINT64 CapturedCount = 0; // Count of frames, passed to callback
+    UINT64 DroppedCount = 0;  // Count of frames, skipped because all ring slots were busy
+  }; /* struct readback_stats */
+
+  /**
+   * @brief Frustum culling statistics of last rendered frame
+  */
+  struct culling_stats
+  {
+    UINT64 InstanceCount = 0;           // Count of instances of all primitives
+    UINT64 VisibleInstanceCount = 0;    // Count of instances, passed culling
+    UINT64 VisibleIndexCount = 0;       // Count of indices of selected levels of detail of visible instances
+    UINT64 DrawCount = 0;               // Count of recorded draw commands (indirect ones and depth pre-pass ones included)
+    UINT64 PrepassDrawCount = 0;        // Count of depth pre-pass draw commands in marker pass
+    UINT64 VisibilityOverflowCount = 0; // Count of instances, left unshaded because visibility_id has no room for their index (visibility G-buffer layout only)
+    UINT64 LightOverflowCount = 0;      // Count of light to cluster assignments, dropped because cluster light list is full (lights are missing from shading there)
+  }; /* struct culling_stats */
+
+  /**
+   * @brief Point light description structure
+  */
+  struct point_light
+  {
+    vec3 Position;        // World space position
+    FLOAT Radius = 10;    // Influence radius, light doesn't affect points farther than it
+    vec3 Color {1, 1, 1}; // Linear color
+    FLOAT Intensity = 1;  // Color multiplier
+  }; /* struct point_light */
+
+  /**
+   * @brief Directional light description structure
+  */
+  struct directional_light
+  {
+    vec3 Direction {0, -1, 0}; // World space direction of light rays
+    vec3 Color {1, 1, 1};      // Linear color
+    FLOAT Intensity = 1;       // Color multiplier
+    BOOL CastShadows = TRUE;   // Light is occluded by primitives of shadow casting pipelines
+  }; /* struct directional_light */
+
+  /**
+   * @brief Shadow statistics structure
+  */
+  struct shadow_stats
+  {
+    UINT32 RenderedCascadeCount = 0; // Count of cascades, rendered in last frame (others are reused from cache)
+    UINT64 CasterInstanceCount = 0;  // Count of caster instances, drawn to rendered cascades
+  }; /* struct shadow_stats */
+
+  /**
+   * @brief G-buffer layout enumeration. Geometry pass clears object ID to visibility_id::BACKGROUND (W to -1 in wide layout),
+   *        so shading skips texels without geometry.
+  */
+  enum class gbuffer_layout
+  {
+    eWide,       // World position and object ID in F32x4 target (28 bytes per pixel)
+    eCompact,    // Object ID in U32 target, position is reconstructed from depth and inverse view projection (16 bytes per pixel)
+    eVisibility, // visibility_id in single U32 target (8 bytes per pixel), shading fetches vertex attributes and evaluates materials per pixel.
+                 // Geometry pipelines must have triangle list topology, F32x3 position (first) and normal attributes, material::surface describes surface.
+  }; /* enum class gbuffer_layout */
+
+  /**
+   * @brief Visibility buffer texel structure. Geometry pass writes instance index (pre-shifted VisibilityID of pipeline::INSTANCE_SET instance)
+   *        in high bits and triangle index (SV_PrimitiveID) in low ones, texels without geometry keep BACKGROUND value.
+   *        Triangle bit count is sized every frame by the largest level of detail of geometry pass primitives, the rest bits index instances.
+  */
+  struct visibility_id
+  {
+    constexpr static UINT32 BACKGROUND = 0xFFFFFFFF; // Value of texels, no triangle is drawn to
+
+    UINT32 Instance = 0; // Instance index (GPU culled instances, then visible CPU culled ones)
+    UINT32 Triangle = 0; // Triangle index in drawn level of detail
+
+    /**
+     * @brief Triangle bit count selection function
+     * @param MaxTriangleCount Triangle count of the largest drawn level of detail
+     * @return Count of low bits, enough for any triangle index
+    */
+    constexpr static UINT32 GetTriangleBits( UINT64 MaxTriangleCount )
+    {
+      return std::min((UINT32)std::bit_width(std::max<UINT64>(MaxTriangleCount, 1) - 1), 31U);
+    } /* GetTriangleBits */
+
+    /**
+     * @brief Instance capacity getting function
+     * @param TriangleBits Triangle bit count
+     * @return Count of instances, indices of which fit in high bits. The last index is reserved, so BACKGROUND is never packed.
+    */
+    constexpr static UINT32 GetInstanceCapacity( UINT32 TriangleBits )
+    {
+      return (UINT32)((1ULL << (32 - TriangleBits)) - 1);
+    } /* GetInstanceCapacity */
+
+    /**
+     * @brief Texel packing function
+     * @param TriangleBits Triangle bit count of frame
+     * @return Visibility buffer texel value
+    */
+    constexpr UINT32 Pack( UINT32 TriangleBits ) const
+    {
+      return (UINT32)((UINT64)Instance << TriangleBits) | (Triangle & ((1U << TriangleBits) - 1));
+    } /* Pack */
+
+    /**
+     * @brief Texel unpacking function
+     * @param Texel Visibility buffer texel value, mustn't be BACKGROUND
+     * @param TriangleBits Triangle bit count of frame (readback_frame::VisibilityTriangleBits)
+     * @return Instance and triangle indices
+    */
+    constexpr static visibility_id Unpack( UINT32 Texel, UINT32 TriangleBits )
+    {
+      return {(UINT32)((UINT64)Texel >> TriangleBits), Texel & ((1U << TriangleBits) - 1)};
+    } /* Unpack */
+  }; /* struct visibility_id */
+
+  /**
+   * @brief Headless (offscreen) output description structure
+  */
+  struct headless_output
+  {
+    extent2 Extent {800, 600}; // Output image extent
+    UINT32 ImageCount = 2;     // Offscreen output image count
+    BOOL Readback = FALSE;     // Copy every frame output to CPU memory
+    render_graph::mode GraphMode = render_graph::mode::eSubpasses; // Graphics pass execution mode
+    gbuffer_layout GBufferLayout = gbuffer_layout::eWide;           // G-buffer layout
+  }; /* struct headless_output */
+
+  /**
+   * @brief Output presentation mode
+  */
+  enum class present_mode
+  {
+    eFifo,      // Presentation is synchronized with vertical blank, supported everywhere
+    eMailbox,   // Last rendered image replaces queued one, no tearing. FIFO is used if unsupported.
+    eImmediate, // Presentation isn't synchronized, tearing is possible. Mailbox or FIFO is used if unsupported.
+  }; /* enum present_mode */
+
+  /**
+   * @brief Frame pacing policy structure
+  */
+  struct frame_pacing
+  {
+    present_mode PresentMode = present_mode::eMailbox; // Output presentation mode
+    FLOAT MaxFrameRate = 0;                            // Frame rate cap, in frames per second, 0 for no cap
+    UINT32 MaxQueuedFrames = 2;                        // Maximal count of rendered images, waiting for presentation (bounds swapchain image count)
+  }; /* struct frame_pacing */
+
+  /**
+   * @brief Frame pacing statistics of last frames
+  */
+  struct frame_pacing_stats
+  {
+    present_mode PresentMode = present_mode::eFifo; // Actually used presentation mode
+    UINT32 OutputImageCount = 0;                    // Count of swapchain (or offscreen output) images
+    UINT32 FrameCount = 0;                          // Count of frames, statistics are collected over
+    DOUBLE MeanFrameTime = 0;                       // Mean frame time, in milliseconds
+    DOUBLE FrameTimeDeviation = 0;                  // Frame time standard deviation, in milliseconds
+    DOUBLE P99FrameTime = 0;                        // 99th percentile of frame time, in milliseconds
+    DOUBLE MaxFrameTime = 0;                        // Maximal frame time, in milliseconds
+  }; /* struct frame_pacing_stats */
+
+  /**
+   * @brief Profiled CPU zone of render thread frame
+  */
+  enum class profile_zone
+  {
+    eWait,              // Previous frame completion waiting
+    eGarbageCollection, // Resource garbage collection
+    eAcquire,           // Output image acquisition
+    eRecording,         // Command buffers recording
+    eCulling,           // Instance culling and level of detail selection, inside recording
+    eSubmit,            // Graphics queue submission
+    ePresent,           // Presentation
+
+    _eCount,            // Helper
+  }; /* enum profile_zone */
+
+  /**
+   * @brief Profiled GPU render pass
+  */
+  enum class profile_pass
+  {
+    eShadow,   // Cascade shadow map render passes
+    eMarker,   // Marker subpass
+    eGeometry, // Geometry subpass
+    eShading,  // Shading subpass
+    eOverlay,  // Overlay subpass, output copies and depth pyramid building
+
+    _eCount,   // Helper
+  }; /* enum profile_pass */
+
+  /**
+   * @brief Profiled interval structure
+  */
+  struct profile_interval
+  {
+    DOUBLE Begin = 0;     // Begin time, in microseconds since system creation
+    DOUBLE Duration = -1; // Duration, in microseconds, negative if interval isn't measured
+  }; /* struct profile_interval */
+
+  /**
+   * @brief Profiled frame structure
+  */
+  struct frame_profile
+  {
+    UINT64 FrameIndex = 0;                                      // Frame number (starting from 1)
+    profile_interval Frame;                                     // Whole render thread frame
+    profile_interval CpuZones[(UINT32)profile_zone::_eCount];   // Render thread zones
+    profile_interval GpuPasses[(UINT32)profile_pass::_eCount];  // GPU pass times. GPU clock isn't calibrated with CPU one, so passes are placed after submission end.
+  }; /* struct frame_profile */
+
   /***
    * Kernel implementation
   ***/
@@ -758,6 +1249,9 @@ namespace anv::render::core
 
     VmaAllocator Allocator; // Memory allocator
 
+    BOOL IsHeadless = FALSE;       // Render to offscreen images instead of swapchain ones
+    UINT32 HeadlessImageCount = 0; // Offscreen output image count
+
 
     vk::SurfaceKHR Surface; // Rendering surface
     vk::Queue
@@ -771,12 +1265,17 @@ namespace anv::render::core
       ComputeQueueFamilyIndex = INVALID_QUEUE_FAMILY_INDEX,  // Compute queue index
       PresentQueueFamilyIndex = INVALID_QUEUE_FAMILY_INDEX;  // Present queue index
 
-    vk::RenderPass OutputRenderPass; // Output render pass
-
     vk::SwapchainKHR Swapchain;            // Swapchain
     vk::Format SwapchainImageFormat;       // Swapchain image format
     vk::ColorSpaceKHR SwapchainColorSpace; // Swapchain image color space
-    vk::Extent2D SwapchainImageExtent;     // Swapchain image extent (e.g. Dst extent)
+    vk::Extent2D SwapchainImageExtent;     // Swapchain (or offscreen output) image extent (e.g. Dst extent)
+    vk::PresentModeKHR SwapchainPresentMode; // Swapchain present mode
+    std::atomic<UINT32> OutputImageCount = 0; // Count of swapchain (or offscreen output) images
+
+    std::atomic_bool SwapchainOutdated = FALSE; // Swapchain must be recreated before next frame
+    std::atomic<UINT32>
+      RequestedExtentW = 0,                     // Last requested output width (used if surface doesn't define extent)
+      RequestedExtentH = 0;                     // Last requested output height (used if surface doesn't define extent)
 
     std::atomic_int32_t GlobalFrameIndex; // Global frame indexs
 
@@ -788,49 +1287,289 @@ namespace anv::render::core
       // Context of every frame
       vk::Image SwapchainImage;         // Swaphcain image
       vk::ImageView SwapchainImageView; // Swapchain image view
-      vk::Framebuffer Framebuffer;      // FBO
+
+      VmaAllocation OutputAllocation = nullptr; // Offscreen output image allocation (headless mode only)
     }; /* struct frame_context */
 
-    vk::CommandPool RenderCommandPool;  // Command pool
+    /**
+     * Frame readback
+    */
 
-    vk::CommandBuffer MainCommandBuffer;   // Frame-dependent command buffer ID
-    // Render pass command buffers
-    vk::CommandBuffer
-      MarkerCommandBuffer,   // Marker render subpass command buffer
-      GeometryCommandBuffer, // Geometry render subpass command buffer
-      OverlayCommandBuffer;  // Overlay render subpass command buffer
+    constexpr static UINT32 READBACK_SLOT_COUNT = 4;   // Readback ring size
+    constexpr static UINT32 READBACK_TARGET_COUNT = 6; // Count of readback_target values
 
-    vk::Semaphore SwapchainOutputSemaphore; // Swaphcain out semaphore
-    vk::Semaphore ImageAckquiredSemaphore;  // Semaphore that shows that image is ackquired from swapchain
-    vk::Fence RenderFinishedFence;          // Fence that shows that frame rendering is finished
+    /**
+     * @brief Readback ring slot structure
+    */
+    struct readback_slot
+    {
+      /* Slot state */
+      enum class state : UINT32
+      {
+        eFree,     // Slot may be used for new copy
+        eRecorded, // Copy is submitted, but frame isn't finished yet
+        eReady,    // Copy is finished, slot is passed to readback thread
+      }; /* enum class state */
 
-    // Pipeline info
+      /* Host-visible copy buffer */
+      struct buffer
+      {
+        vk::Buffer Buffer;                  // Buffer
+        VmaAllocation Allocation = nullptr; // Buffer allocation
+        VOID *Data = nullptr;               // Persistently mapped buffer data
+        SIZE_T Size = 0;                    // Buffer size
+      }; /* struct buffer */
+
+      std::atomic<state> State = state::eFree;      // Slot state, owned by render thread in eFree and eRecorded states
+      UINT64 FrameIndex = 0;                        // Copied frame number
+      std::shared_ptr<readback_callback> Callback;  // Callback, active at copy moment
+      buffer Buffers[READBACK_TARGET_COUNT];        // Copy buffers
+      readback_image Images[READBACK_TARGET_COUNT]; // Copied images
+      UINT32 ImageCount = 0;                        // Copied image count
+      UINT32 VisibilityTriangleBits = 0;            // visibility_id triangle bit count of copied frame
+    }; /* struct readback_slot */
+
+    readback_slot ReadbackSlots[READBACK_SLOT_COUNT]; // Readback ring
+    UINT32 NextReadbackSlot = 0;                      // Next slot to copy to
+
+    std::mutex ReadbackConfigMutex;                        // Readback configuration guard
+    readback_target_flags ReadbackTargets;                 // Targets to copy every frame
+    std::shared_ptr<readback_callback> ReadbackCallback;   // Readback callback
+    std::atomic_bool IsOutputReadbackSupported = TRUE;     // Output image may be used as transfer source
+
+    thread::spsc_ring<UINT32, READBACK_SLOT_COUNT> ReadyReadbackSlots; // Finished copies, passed to readback thread
+    std::atomic<UINT32> ReadyReadbackCounter = 0;                      // Count of passed copies, used for readback thread wakeup
+    std::atomic_bool DoReadback;                                       // Readback thread run flag
+    std::thread ReadbackThread;                                        // Readback thread
+
+    std::atomic<UINT64>
+      ReadbackCapturedCount = 0, // Count of frames, passed to callback
+      ReadbackDroppedCount = 0;  // Count of frames, dropped because ring is full
+
+    /**
+     * @brief Frame copy recording function, called from render graph readback pass. Graph transitions copied images.
+     * @param CommandBuffer Command buffer to record copy to
+     * @param Frame Frame context to copy output of
+     * @param FrameIndex Frame number
+    */
+    VOID RecordReadback( vk::CommandBuffer CommandBuffer, frame_context &Frame, UINT64 FrameIndex );
+
+    /**
+     * @brief Finished copies passing function, called from render thread
+     * @param CompletedFrameIndex Number of last frame, finished on GPU
+    */
+    VOID CompleteReadbacks( UINT64 CompletedFrameIndex );
+
+    /**
+     * @brief Readback thread function
+    */
+    VOID ReadbackThreadMain( VOID );
+
+    /**
+     * @brief Readback ring destroy function
+    */
+    VOID DestroyReadback( VOID );
+
+    /**
+     * GPU timeline
+    */
+
+    vk::Semaphore TimelineSemaphore;               // Device-wide timeline semaphore, signaled by every graphics queue frame submission
+    std::atomic<UINT64> SubmittedTimelineValue = 0; // Last signaled (submitted) timeline value, equal to number of last submitted frame
+    std::atomic<UINT64> CompletedTimelineValue = 0; // Last known completed timeline value
+
+    std::mutex DeferredDestroyMutex;                                       // Deferred destroy queue guard
+    std::deque<std::pair<UINT64, std::function<VOID( VOID )>>> DeferredDestroys; // Destroy callbacks with timeline values to wait for, in value order
+
+    /**
+     * @brief Timeline semaphore initialization function
+    */
+    VOID InitTimeline( VOID );
+
+    /**
+     * @brief Timeline semaphore destroy function. Device must be idle.
+    */
+    VOID DestroyTimeline( VOID );
+
+    /**
+     * @brief Deferred destroy callbacks of completed timeline values calling function
+     * @param IsDeviceIdle TRUE to call all callbacks, device must be idle then
+    */
+    VOID CollectDeferredDestroys( BOOL IsDeviceIdle = FALSE );
+
+    /**
+     * Frame pacing
+    */
+
+    constexpr static UINT32 FRAME_TIME_COUNT = 240; // Frame time ring size
+
+    std::mutex PacingMutex;                                  // Pacing policy and frame times guard
+    frame_pacing Pacing;                                     // Frame pacing policy
+    std::atomic<present_mode> ActivePresentMode = present_mode::eFifo; // Actually used presentation mode
+    std::chrono::steady_clock::time_point NextFrameTime;     // Frame rate limiter deadline of next frame. Used by render thread only.
+    std::chrono::steady_clock::time_point LastFrameTime;     // Previous frame start. Used by render thread only.
+    std::chrono::steady_clock::duration LimiterSleepMargin = std::chrono::milliseconds(1); // Time before deadline, spun instead of slept. Used by render thread only.
+    DOUBLE FrameTimes[FRAME_TIME_COUNT] {};                  // Last frame times, in milliseconds
+    UINT64 FrameTimeCount = 0;                               // Count of frame times, ever put to ring
+
+    /**
+     * @brief Present mode selection function
+     * @param Mode Requested present mode
+     * @return Supported Vulkan present mode, the nearest to requested one
+    */
+    vk::PresentModeKHR SelectPresentMode( present_mode Mode );
+
+    /**
+     * @brief Frame rate limiting function, called from render thread after frame presentation.
+     *        Sleeps till most of time till next frame deadline, then spins, because OS sleep is coarse. Records frame time.
+    */
+    VOID LimitFrameRate( VOID );
+
+    /**
+     * Frame profiling
+    */
+
+    constexpr static UINT32 PROFILE_FRAME_COUNT = 256;                                   // Profiled frame ring size
+    constexpr static UINT32 PROFILE_TIMESTAMP_COUNT = (UINT32)profile_pass::_eCount + 1; // Frame begin and pass end timestamps
+
+    std::atomic_bool IsProfilingEnabled = FALSE;      // Profile frames
+    BOOL IsFrameProfiled = FALSE;                     // Current frame is profiled. Written by render thread only.
+    std::chrono::steady_clock::time_point ProfileEpoch; // Profile time origin
+    BOOL IsTimestampSupported = FALSE;                // Graphics queue supports timestamps, so slots have timestamp query pools
+    DOUBLE TimestampPeriod = 0;                       // Timestamp tick duration, in nanoseconds
+    UINT64 TimestampMask = 0;                         // Valid timestamp bits
+    frame_profile CurrentProfile;                     // Profile of recorded frame
+
+    std::mutex ProfileMutex;                          // Profiled frame ring guard
+    frame_profile ProfileFrames[PROFILE_FRAME_COUNT]; // Profiled frame ring
+    UINT64 ProfileFrameCount = 0;                     // Count of frames, ever put to ring
+
+    /**
+     * @brief Profiler initialization function
+    */
+    VOID InitProfiler( VOID );
+
+    /**
+     * @brief Profiler destroy function
+    */
+    VOID DestroyProfiler( VOID );
+
+    /**
+     * @brief Profile time getting function
+     * @return Time since profiler initialization, in microseconds
+    */
+    DOUBLE GetProfileTime( VOID ) const;
+
+    /**
+     * @brief Frame profiling start function, called from render thread at frame begin. Discards unsubmitted frame profile.
+    */
+    VOID BeginProfileFrame( VOID );
+
+    /**
+     * @brief Frame profiling end function, called from render thread after frame presentation
+    */
+    VOID EndProfileFrame( VOID );
+
+    /**
+     * @brief Submitted frame profiles completion function, called from render thread after frames are finished on GPU
+     * @param CompletedFrameIndex Number of last finished frame
+    */
+    VOID CompleteProfileFrames( UINT64 CompletedFrameIndex );
+
+    /**
+     * @brief Render thread zone begin function
+     * @param Zone Zone to begin
+    */
+    VOID BeginProfileZone( profile_zone Zone );
+
+    /**
+     * @brief Render thread zone end function
+     * @param Zone Zone to end
+    */
+    VOID EndProfileZone( profile_zone Zone );
+
+    /**
+     * @brief Pass timestamp recording function
+     * @param CommandBuffer Command buffer to record timestamp write to
+     * @param Index Timestamp index: 0 for frame begin, pass index + 1 for pass end
+    */
+    VOID RecordProfileTimestamp( vk::CommandBuffer CommandBuffer, UINT32 Index );
+
+    std::mutex OutputMutex;              // Output pixels guard
+    std::vector<BYTE> OutputPixels;      // Last read back output pixels (headless mode only)
+    extent2 OutputPixelsExtent;          // Last read back output extent
+    UINT64 OutputPixelsFrameIndex = 0;   // Last read back output frame number (starting from 1)
+
+    std::atomic<UINT64> CompletedFrameCount = 0; // Count of frames, that finished rendering on GPU
+
+    vk::CommandPool RenderCommandPool;  // Command pool
 
-    constexpr static UINT32 PositionObjectIDAttachmentIndex = 0;          // <- F32x4
-    constexpr static UINT32 NormalAttachmentIndex = 1;                    // <- U16x2
-    constexpr static UINT32 BaseColorAmbientOcclusionAttachmentIndex = 2; // <- U8x4
-    constexpr static UINT32 MetallicRoughnessInstanceAttachmentIndex = 3; // <- U8x2, U16
-    constexpr static UINT32 DepthAttachmentIndex = 4;                     // <- D32
-    constexpr static UINT32 OutputAttachmentIndex = 5;                    // <- U8x4
+    // Pipeline info
 
-    constexpr static vk::Format PositionObjectIDAttachmentFormat = vk::Format::eR32G32B32A32Sfloat;     // Attachment format
+    vk::Format PositionObjectIDAttachmentFormat;                                                        // (Defined by G-buffer layout)
     constexpr static vk::Format NormalAttachmentFormat = vk::Format::eR16G16Snorm;                      // Attachment format
     constexpr static vk::Format BaseColorAmbientOcclusionAttachmentFormat = vk::Format::eR8G8B8A8Unorm; // Attachment format
     constexpr static vk::Format MetallicRoughnessInstanceAttachmentFormat = vk::Format::eR8G8B8A8Unorm; // Attachment format
     vk::Format DepthAttachmentFormat;                                                                   // (Defined in runtime)
     vk::Format OutputAttachmentFormat;                                                                  // (Defined by hardware)
 
-    constexpr static UINT32 MarkerSubpassIndex = 0;   //      -> Output, Depth
-    constexpr static UINT32 GeometrySubpassIndex = 1; //      -> GBuf, Depth
-    constexpr static UINT32 ShadingSubpassIndex = 2;  // GBuf -> Output
-    constexpr static UINT32 OverlaySubpassIndex = 3;  //      -> Output
+    /**
+     * Render graph
+    */
+
+    render_graph::mode GraphMode = render_graph::mode::eSubpasses; // Graphics pass execution mode, fixed, because pipelines depend on it
+    gbuffer_layout GBufferLayout = gbuffer_layout::eWide;          // G-buffer layout, fixed, because geometry shaders depend on it
+    std::mutex RenderGraphMutex;                                   // Graph render passes guard (pipelines are built from any thread)
+    std::optional<render_graph> RenderGraph;                       // Frame render graph, rebuilt by render thread
+
+    render_graph::resource
+      PositionObjectID,          // G-buffer image          <- F32x4 (U32 in compact and visibility layouts)
+      Normal,                    // G-buffer image          <- U16x2 (not created in visibility layout)
+      BaseColorAmbientOcclusion, // G-buffer image          <- U8x4  (not created in visibility layout)
+      MetallicRoughnessInstance, // G-buffer image          <- U8x2, U16 (not created in visibility layout)
+      Depth,                     // Depth image             <- D32
+      Output;                    // Imported output image   <- U8x4
+
+    UINT32
+      MarkerGraphPass,   //      -> Output, Depth
+      GeometryGraphPass, //      -> GBuf, Depth
+      ShadingGraphPass,  // GBuf (, Depth in compact and visibility layouts), Light grid -> Output
+      OverlayGraphPass;  //      -> Output
+
+    readback_target_flags GraphReadbackTargets; // Images, graph readback pass copies
+    BOOL IsGraphGpuCulled = FALSE;              // Graph builds depth pyramid
+    BOOL IsGraphTransient = FALSE;              // Graph G-buffer and depth images are requested transient
+
+    std::atomic_bool IsTransientAttachmentsEnabled = FALSE; // Request transient G-buffer and depth images
+    std::atomic_bool IsDepthPrepassEnabled = FALSE;         // Draw depth of pre-passed geometry primitives in marker pass
+
+    vk::Extent2D AttachmentExtent; // Graph image extent, may be larger than swapchain one (up to twice its area)
+
+    /**
+     * @brief Render state of recorded frame, used by graph pass callbacks. Written by render thread only.
+    */
+    struct
+    {
+      frame_context *Frame = nullptr;         // Recorded frame context
+      UINT64 FrameIndex = 0;                  // Frame number
+      const math::frustum *Frustum = nullptr; // Culling frustum, nullptr if frame isn't culled
+      mat4x4 ViewProjection;                  // View projection matrix, frustum is built from
+    } Recording;
+
+    /**
+     * @brief Render pass graph pass getting function
+     * @param Pass Render pass to get graph pass of
+     * @return Graph pass index
+    */
+    UINT32 GetRenderPassGraphPass( render_pass Pass );
 
     /**
-     * @brief Render pass subpass index getting function
-     * @param Pass Render pass to get subpass index of
-     * @return Subpass index
+     * @brief Render graph (re)building function. Graph images mustn't be in use by device.
+     * @param ReadbackTargets Images to copy every frame
+     * @param IsGpuCulled Depth pyramid is built for GPU culling
+     * @param IsTransient G-buffer and depth images are requested transient
     */
-    UINT32 GetRenderPassSubpassIndex( render_pass Pass );
+    VOID BuildRenderGraph( readback_target_flags ReadbackTargets, BOOL IsGpuCulled, BOOL IsTransient );
 
     /**
      * @brief Attachment image representation structure
@@ -842,15 +1581,510 @@ namespace anv::render::core
       VmaAllocation Allocation; // Image allocation
     }; /* struct attachment_image */
 
-    attachment_image
-      PositionObjectID,          // Attachment image
-      Normal,                    // Attachment image
-      BaseColorAmbientOcclusion, // Attachment image
-      MetallicRoughnessInstance, // Attachment image
-      Depth;                     // Attachment image
-
     std::vector<frame_context> Frames; // Frame contexts
 
+    /**
+     * GPU culling
+    */
+
+    constexpr static UINT32 GPU_CULLING_GROUP_SIZE = 64;      // Instance culling shader workgroup size
+    constexpr static UINT32 DEPTH_PYRAMID_GROUP_SIZE = 8;     // Depth pyramid shader workgroup size (in both dimensions)
+    constexpr static UINT32 DEPTH_PYRAMID_MAX_MIP_COUNT = 16; // Depth pyramid maximal mip level count
+
+    /* Persistently mapped (or device-local) GPU culling buffer */
+    struct gpu_culling_buffer
+    {
+      vk::Buffer Buffer;                  // Buffer
+      VmaAllocation Allocation = nullptr; // Buffer allocation
+      VOID *Data = nullptr;               // Persistently mapped buffer data, nullptr for device-local buffer
+      SIZE_T Size = 0;                    // Buffer size
+    }; /* struct gpu_culling_buffer */
+
+    /* Culled instance, GPU (std430) layout */
+    struct gpu_culling_instance
+    {
+      mat4x4 Transform;      // Instance transform, expanded from packed one by culling pass for rigid primitive
+      UINT32 DrawIndex;      // Index of primitive level of detail draw (in indirect and shading draw buffers), written by culling pass for GPU culled instance
+      UINT32 VisibilityID;   // Instance index, shifted to visibility_id high bits (BACKGROUND if it doesn't fit)
+      UINT32 FirstDrawIndex; // Index of level 0 draw of primitive, culling pass selects level from it
+      UINT32 Padding;        // std430 padding
+    }; /* struct gpu_culling_instance */
+
+    /* Culled primitive draw, GPU (std430) layout */
+    struct gpu_culling_draw
+    {
+      FLOAT Center[3];      // Local space bounding box center
+      UINT32 IsCulled;      // Bounding box is defined
+      FLOAT Extent[3];      // Local space bounding box half size
+      UINT32 FirstInstance; // First slot of draw in visible instance buffer
+      FLOAT MinScreenSize;  // Minimal projected bounds diameter of level (relative to output height)
+      FLOAT LodHysteresis;  // Relative screen size band around level thresholds of primitive
+      UINT32 LodCount;      // Level count of primitive
+      UINT32 IsRigid;       // Instance transforms are uploaded packed, culling pass expands them to instance buffer
+    }; /* struct gpu_culling_draw */
+
+    /* Culling pass parameters, GPU (std140) layout */
+    struct gpu_culling_params
+    {
+      mat4x4 DepthPyramidViewProjection; // View projection matrix, used to render depth pyramid source
+      FLOAT Planes[6][4];                // Frustum planes
+      UINT32 InstanceCount;              // Count of culled instances
+      UINT32 IsFrustumCulled;            // Frustum test is enabled
+      UINT32 IsOcclusionCulled;          // Depth pyramid test is enabled
+      UINT32 DepthPyramidMipCount;       // Depth pyramid mip level count
+      FLOAT DepthPyramidExtent[2];       // Depth pyramid level 0 extent
+      FLOAT LodProjectionScale;          // Vertical projection scale, screen size of unit radius sphere at unit depth
+      UINT32 LodMode;                    // Level selection mode, one of GPU_LOD_MODE_***
+      FLOAT LodViewDepth[4];             // View matrix depth column, view depth of world position is its dot product with (Position, 1)
+    }; /* struct gpu_culling_params */
+
+    constexpr static UINT32 GPU_LOD_MODE_NONE = 0;         // No camera, the most detailed levels are drawn
+    constexpr static UINT32 GPU_LOD_MODE_PERSPECTIVE = 1;  // Screen size depends on view depth
+    constexpr static UINT32 GPU_LOD_MODE_ORTHOGRAPHIC = 2; // Screen size doesn't depend on view depth
+
+    std::atomic_bool IsGpuCullingEnabled = FALSE; // Cull instances of indexed primitives on GPU instead of CPU
+
+    vk::CommandPool ComputeCommandPool;       // Compute queue command pool
+    vk::Semaphore CullingFinishedSemaphore;   // Culling pass finished, graphics queue may consume indirect commands
+    vk::Semaphore DepthPyramidReadySemaphore; // Depth pyramid is built by graphics queue
+    BOOL IsDepthPyramidSignaled = FALSE;      // DepthPyramidReadySemaphore is signaled, but isn't waited yet
+
+    vk::DescriptorPool CullingDescriptorPool;                // Culling and depth pyramid descriptor pool
+    vk::DescriptorSetLayout CullingDescriptorSetLayout;      // Culling pass set layout
+    vk::DescriptorSetLayout DepthPyramidDescriptorSetLayout; // Depth pyramid level set layout
+    vk::PipelineLayout CullingPipelineLayout;                // Culling pass pipeline layout
+    vk::PipelineLayout DepthPyramidPipelineLayout;           // Depth pyramid pipeline layout
+    vk::Pipeline CullingPipeline;                            // Culling pass pipeline
+    vk::Pipeline DepthPyramidPipeline;                       // Depth pyramid level downsample pipeline
+    vk::Sampler DepthPyramidSampler;                         // Nearest clamped sampler
+    vk::DescriptorSet DepthPyramidDescriptorSets[DEPTH_PYRAMID_MAX_MIP_COUNT]; // Per level depth pyramid sets
+
+    attachment_image DepthPyramid;                                    // Conservative (max) depth pyramid, R32 float
+    vk::ImageView DepthPyramidMipViews[DEPTH_PYRAMID_MAX_MIP_COUNT];  // Single level views
+    vk::Extent2D DepthPyramidExtent;                                  // Level 0 extent
+    UINT32 DepthPyramidMipCount = 0;                                  // Level count
+    vk::ImageView DepthPyramidSourceView;                             // Depth view, pyramid sets are written with
+    BOOL IsDepthPyramidValid = FALSE;                                 // Pyramid holds depth of previous frame, rendered with DepthPyramidViewProjection
+    mat4x4 DepthPyramidViewProjection;                                // View projection of depth in pyramid
+    UINT64 GpuVisibleInstanceCount = 0;                               // Count of visible instances in last finished culling pass
+    UINT64 GpuVisibleIndexCount = 0;                                  // Count of indices of visible instances in last finished culling pass
+    gpu_culling_buffer InstanceLodBuffer;                             // Levels of detail, selected by culling pass, kept for hysteresis. GPU only, shared by slots.
+
+    /**
+     * @brief GPU culling resources initialization function
+    */
+    VOID InitGpuCulling( VOID );
+
+    /**
+     * @brief GPU culling resources destroy function
+    */
+    VOID DestroyGpuCulling( VOID );
+
+    /**
+     * @brief Depth pyramid (re)creation function, called from render thread, if output extent or depth attachment changed
+    */
+    VOID InitDepthPyramid( VOID );
+
+    /**
+     * @brief Depth pyramid destroy function
+    */
+    VOID DestroyDepthPyramid( VOID );
+
+    /**
+     * @brief GPU culling buffer capacity ensuring function
+     * @param Buffer Buffer to (re)allocate
+     * @param Size Required buffer size
+     * @param Usage Buffer usage
+     * @param IsHostVisible Buffer must be persistently mapped
+     * @return TRUE if buffer is reallocated, so descriptor set must be updated
+    */
+    BOOL ReserveGpuCullingBuffer( gpu_culling_buffer &Buffer, SIZE_T Size, vk::BufferUsageFlags Usage, BOOL IsHostVisible );
+
+    /**
+     * @brief Culling pass submission function, called from render thread before frame recording.
+     *        Assigns indirect draw indices to indexed primitives and submits culling pass to compute queue, frame must wait for CullingFinishedSemaphore.
+     *        Levels of detail of instances are selected by culling pass, every level is drawn by separate indirect command.
+     *        Only transforms, changed after last upload to frame slot buffer, are uploaded.
+     * @param Frustum Frustum to cull by, nullptr to treat all instances as visible
+     * @param ViewProjection View projection matrix, frustum is built from
+     * @param Camera Camera, levels of detail are selected by, nullptr to use the most detailed levels
+    */
+    VOID SubmitGpuCulling( const math::frustum *Frustum, const mat4x4 &ViewProjection, const math::util::camera::projection_matrices *Camera );
+
+    /**
+     * @brief Depth pyramid building recording function, called from render graph depth pyramid pass. Graph transitions depth image.
+     * @param CommandBuffer Command buffer to record pyramid building to
+     * @param Frustum Frustum, frame is culled by. Depth pyramid is used for occlusion culling in next frame only if it's not nullptr.
+     * @param ViewProjection View projection matrix, frustum is built from
+    */
+    VOID RecordDepthPyramid( vk::CommandBuffer CommandBuffer, const math::frustum *Frustum, const mat4x4 &ViewProjection );
+
+    /**
+     * @brief Culling buffers acquisition by graphics queue family recording function. Does nothing if compute queue is taken from graphics family.
+     * @param CommandBuffer Graphics command buffer to record acquire barriers to, before culled draws
+    */
+    VOID RecordCullingAcquire( vk::CommandBuffer CommandBuffer );
+
+    /**
+     * @brief Culling buffers release to compute queue family recording function. Does nothing if compute queue is taken from graphics family.
+     * @param CommandBuffer Graphics command buffer to record release barriers to, after culled draws and shading
+    */
+    VOID RecordCullingRelease( vk::CommandBuffer CommandBuffer );
+
+    /**
+     * Draw recording
+    */
+
+    vk::DescriptorSetLayout DrawInstanceSetLayout; // Instance set layout (pipeline::INSTANCE_SET of every pipeline layout)
+    vk::DescriptorPool DrawDescriptorPool;         // Instance sets pool
+
+    /* Level of detail draw, fetched by visibility G-buffer layout shading, GPU (std430) layout */
+    struct gpu_shading_draw
+    {
+      vk::DeviceAddress IndexAddress;     // Index buffer address
+      vk::DeviceAddress PositionAddress;  // First vertex position address
+      vk::DeviceAddress NormalAddress;    // First vertex normal address
+      UINT32 PositionStride;              // Position stride in 4 byte words
+      UINT32 NormalStride;                // Normal stride in 4 byte words
+      UINT32 FirstIndex;                  // First index of level (first vertex of non-indexed primitive)
+      INT32 VertexOffset;                 // Value, added to level indices
+      UINT32 TriangleCount;               // Count of triangles of level
+      UINT32 VertexCount;                 // Count of fetchable vertices, 0 if primitive has no position stream
+      UINT32 IsIndexed;                   // Primitive has index buffer
+      UINT32 HasNormals;                  // Primitive has normal stream
+      UINT32 Padding[2];                  // std430 padding
+      FLOAT BaseColorAmbientOcclusion[4]; // Material surface base color and ambient occlusion
+      FLOAT MetallicRoughness[4];         // Material surface metallic and roughness
+    }; /* struct gpu_shading_draw */
+
+    static_assert(sizeof(gpu_shading_draw) == 96, "Shading draw must match std430 layout");
+
+    UINT32 VisibilityTriangleBits = 0;     // visibility_id triangle bit count of current frame
+    UINT32 VisibilityGpuInstanceCount = 0; // Count of GPU culled instances of current frame, visibility_id indices of CPU culled ones follow them
+
+    /**
+     * @brief Draw recording resources initialization function. Called after GPU culling initialization.
+    */
+    VOID InitDraws( VOID );
+
+    /**
+     * @brief Draw recording resources destroy function
+    */
+    VOID DestroyDraws( VOID );
+
+    /**
+     * @brief Visible instances of CPU culled primitives writing function, called from render thread after culling and before draw recording.
+     *        Assigns first draw instances to primitives and writes visible instance transforms to DrawInstanceBuffer,
+     *        in visibility G-buffer layout writes level of detail draws of all primitives to ShadingDrawBuffer.
+    */
+    VOID WriteDrawInstances( VOID );
+
+    /**
+     * @brief Visibility buffer ID layout selection function, called from render thread before culling.
+     *        Sizes visibility_id triangle bits by the largest level of detail of geometry pass primitives.
+    */
+    VOID LayoutVisibilityIds( VOID );
+
+    /**
+     * @brief Instance visibility ID getting function
+     * @param Index Instance index (GPU culled instances, then visible CPU culled ones)
+     * @return Index, shifted to visibility_id high bits, visibility_id::BACKGROUND if it doesn't fit
+    */
+    UINT32 GetVisibilityId( UINT32 Index ) const;
+
+    /**
+     * @brief Primitive draws recording function, called from render thread after culling.
+     *        GPU culled primitive is drawn by indirect command per level of detail, CPU culled one by instanced draw per level of detail.
+     * @param CommandBuffer Secondary command buffer of pass, pipeline is built for
+     * @param Primitive Primitive to draw visible instances of
+     * @param Pipeline One of primitive pipelines. Depth pre-pass pipeline is fed by position vertex buffer only.
+     * @return Count of recorded draw commands
+    */
+    UINT32 RecordDraws( vk::CommandBuffer CommandBuffer, const primitive &Primitive, vk::Pipeline Pipeline );
+
+    /**
+     * Directional light shadows
+    */
+
+    constexpr static UINT32 SHADOW_CASCADE_COUNT = 4;      // Count of shadow cascades (layers of shadow map)
+    constexpr static UINT32 SHADOW_MAP_SIZE = 2048;        // Cascade shadow map width and height
+    constexpr static FLOAT SHADOW_DISTANCE = 150;          // Maximal view distance of shadowed points
+    constexpr static FLOAT SHADOW_CASTER_DISTANCE = 500;   // Distance toward light, casters outside of view are gathered from
+    constexpr static FLOAT SHADOW_CASCADE_MARGIN = 1.25F;  // Cascade radius scale. Camera moves inside margin without cascade re-rendering.
+    constexpr static FLOAT SHADOW_SPLIT_LAMBDA = 0.75F;    // Logarithmic to uniform cascade split blend factor
+    constexpr static SIZE_T MAX_MOVED_CASTER_COUNT = 4096; // Count of moved caster boxes, after which all cascades are invalidated
+
+    /* Shadow cascade placement and cache state */
+    struct shadow_cascade
+    {
+      BOOL IsValid = FALSE;        // Shadow map layer holds casters of current placement
+      FLOAT CenterX = 0;           // Light space center X (snapped to texels)
+      FLOAT CenterY = 0;           // Light space center Y (snapped to texels)
+      FLOAT CenterDepth = 0;       // Light space center depth
+      FLOAT Radius = 0;            // Covered sphere radius
+      mat4x4 ViewProjection;       // World to cascade clip space matrix (depth in [0, 1])
+      math::frustum CasterFrustum; // World space volume, casters are gathered from
+    }; /* struct shadow_cascade */
+
+    std::mutex ShadowMutex;                            // Directional light guard
+    std::optional<directional_light> DirectionalLight; // Directional light, set by user
+    std::atomic_bool IsShadowCachingEnabled = TRUE;    // Cascades are re-rendered only if their placement changes or casters in them move
+
+    std::vector<math::aabb> MovedCasterBoxes; // World bounds (before and after) of moved, created and destroyed caster instances. Guarded by SceneBvhMutex.
+    BOOL IsShadowCacheInvalid = FALSE;        // Every cascade must be rendered (caster without bounds is changed or too many casters moved). Guarded by SceneBvhMutex.
+
+    std::vector<UINT32> ShadowVertexSPV;                      // Shadow caster vertex shader, shared by shadow pipelines
+    BOOL IsDepthClampSupported = FALSE;                       // Casters toward light are clamped to cascade near plane
+    vk::RenderPass ShadowRenderPass;                          // Depth only cascade render pass
+    vk::Image ShadowMap;                                      // Cascade shadow maps (layer per cascade)
+    VmaAllocation ShadowMapAllocation = nullptr;              // Shadow map memory
+    vk::ImageView ShadowMapView;                              // Array view of all cascades (sampled by shading)
+    vk::ImageView ShadowCascadeViews[SHADOW_CASCADE_COUNT];   // Per cascade layer views
+    vk::Framebuffer ShadowFramebuffers[SHADOW_CASCADE_COUNT]; // Per cascade framebuffers
+    vk::Sampler ShadowSampler;                                // Comparison sampler
+    vk::DescriptorSetLayout ShadowDescriptorSetLayout;        // Caster transforms set layout
+    vk::PipelineLayout ShadowPipelineLayout;                  // Shadow pipelines layout (cascade view projection is push constant)
+    vk::DescriptorPool ShadowDescriptorPool;                  // Caster transforms set pool
+    BOOL IsShadowMapInitialized = FALSE;                      // Shadow map layers are in shader read only layout
+
+    shadow_cascade ShadowCascades[SHADOW_CASCADE_COUNT];    // Cascades
+    FLOAT ShadowCascadeSplits[SHADOW_CASCADE_COUNT] {};     // View distances of cascade far bounds in recorded frame
+    vec3 ShadowLightDirection {0};                          // Normalized light direction, cascades are placed for
+    std::optional<directional_light> FrameDirectionalLight; // Directional light of recorded frame
+    BOOL IsFrameShadowed = FALSE;                           // Recorded frame samples shadow map
+
+    std::atomic<UINT32> ShadowRenderedCascadeCount = 0;     // Count of cascades, rendered in last frame
+    std::atomic<UINT64> ShadowCasterInstanceCount = 0;      // Count of caster instances, drawn in last frame
+
+    /**
+     * @brief Shadow resources initialization function. Called before lighting initialization.
+    */
+    VOID InitShadows( VOID );
+
+    /**
+     * @brief Shadow resources destroy function
+    */
+    VOID DestroyShadows( VOID );
+
+    /**
+     * @brief Shadow caster pipeline creation function, called from pipeline building
+     * @param Builder Pipeline builder with position as first vertex attribute
+     * @return Created depth only pipeline, empty if pipeline has no vertex attributes
+    */
+    vk::Pipeline CreateShadowPipeline( const pipeline::builder &Builder );
+
+    /**
+     * @brief Moved shadow caster registration function, called with SceneBvhMutex locked
+     * @param Box World bounds of instance before or after movement, empty if primitive has no bounds
+    */
+    VOID InvalidateShadowCasters( const std::optional<math::aabb> &Box );
+
+    /**
+     * @brief Cascade shadow maps recording function, called from render thread before graph execution.
+     *        Places cascades over camera view, renders only cascades with changed placement or moved casters.
+     * @param CommandBuffer Command buffer to record cascade render passes to
+     * @param Camera Camera, frame is shaded from, nullptr to disable shadows
+    */
+    VOID RecordShadows( vk::CommandBuffer CommandBuffer, const math::util::camera::projection_matrices *Camera );
+
+    /**
+     * Deferred lighting
+    */
+
+    constexpr static UINT32 LIGHT_CLUSTER_X = 16;          // View space light cluster grid width
+    constexpr static UINT32 LIGHT_CLUSTER_Y = 9;           // View space light cluster grid height
+    constexpr static UINT32 LIGHT_CLUSTER_Z = 24;          // View space light cluster grid depth slice count (exponential)
+    constexpr static UINT32 LIGHT_CLUSTER_COUNT = LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y * LIGHT_CLUSTER_Z; // Light cluster count
+    constexpr static UINT32 MAX_CLUSTER_LIGHT_COUNT = 256; // Maximal count of lights, affecting one cluster
+    constexpr static UINT32 LIGHT_CULLING_GROUP_SIZE = 64; // Light culling shader workgroup size (clusters and lights per shared memory batch)
+    constexpr static UINT32 MAX_SHADING_INPUT_COUNT = 5;   // Maximal count of shading pass input attachments
+
+    /* Point light, GPU (std430) layout */
+    struct gpu_light
+    {
+      FLOAT Position[3]; // View space position
+      FLOAT Radius;      // Influence radius
+      FLOAT Color[3];    // Color, multiplied by intensity
+      FLOAT Padding;     // std430 padding
+    }; /* struct gpu_light */
+
+    /* Light culling and shading parameters, GPU (std140) layout */
+    struct gpu_lighting_params
+    {
+      mat4x4 InverseProjection;                      // Clip to view space matrix
+      mat4x4 View;                                   // World to view space matrix
+      FLOAT Ambient[4];                              // Ambient light color
+      FLOAT OutputExtent[2];                         // Shaded output extent
+      FLOAT Near, Far;                               // Clustered depth range (view space distances)
+      FLOAT SliceScale;                              // Cluster depth slice is log(Depth) * SliceScale + SliceBias
+      FLOAT SliceBias;                               // Cluster depth slice bias
+      UINT32 LightCount;                             // Count of lights in light buffer
+      UINT32 IsLit;                                  // Lights are evaluated (camera is set)
+      mat4x4 ShadowMatrices[SHADOW_CASCADE_COUNT];   // View space to cascade shadow map (texture coordinates and depth) matrices
+      FLOAT CascadeSplits[SHADOW_CASCADE_COUNT];     // View distances of cascade far bounds
+      FLOAT CascadeTexelSizes[SHADOW_CASCADE_COUNT]; // World sizes of cascade texels (normal offset scale)
+      FLOAT SunDirection[4];                         // View space direction toward directional light
+      FLOAT SunColor[4];                             // Directional light color, multiplied by intensity (zero if there is no light), W is 1 if shadowed
+      vk::DeviceAddress ShadingDrawAddress;          // Shading draws address (visibility G-buffer layout only)
+      vk::DeviceAddress GpuInstanceAddress;          // GPU culled instances address
+      vk::DeviceAddress CpuInstanceAddress;          // CPU culled visible instances address
+      UINT32 GpuInstanceCount;                       // Count of GPU culled instances, visibility_id indices of CPU culled ones follow them
+      UINT32 TriangleBits;                           // visibility_id triangle bit count
+    }; /* struct gpu_lighting_params */
+
+    // Cascade splits and texel sizes are single std140 vec4s in shaders
+    static_assert(SHADOW_CASCADE_COUNT == 4, "Shadow cascade parameters must fill exactly one vec4");
+
+    std::mutex LightingMutex;        // Lights guard
+    std::vector<point_light> Lights; // Lights, set by user
+    vec3 AmbientLight {0.03F};       // Ambient light color, set by user
+
+    vk::DescriptorPool LightingDescriptorPool;           // Lighting descriptor pool
+    vk::DescriptorSetLayout LightingDescriptorSetLayout; // Lighting buffers set layout (culling and shading)
+    vk::DescriptorSetLayout ShadingInputSetLayout;       // Shading pass input attachments set layout
+    vk::PipelineLayout LightCullingPipelineLayout;       // Light culling pipeline layout
+    vk::PipelineLayout ShadingPipelineLayout;            // Shading pipeline layout
+    vk::Pipeline LightCullingPipeline;                   // Light culling (cluster binning) pipeline
+    vk::Pipeline ShadingPipeline;                        // Fullscreen deferred shading pipeline
+    vk::DescriptorSet ShadingInputSet;                   // Shading pass input attachments set, rewritten after graph rebuilding only
+    gpu_culling_buffer LightGridBuffer;                  // Per cluster light counts, followed by per cluster light index lists (GPU only)
+    vk::Sampler GBufferSampler;                          // Nearest clamped sampler of shading inputs (dynamic rendering only)
+
+    std::vector<render_graph::resource> ShadingInputs;        // Shading pass input attachments in binding order, set by graph building
+    vk::ImageView ShadingInputViews[MAX_SHADING_INPUT_COUNT]; // Views, shading input set is written with
+    UINT32 FrameLightCount = 0;                               // Count of lights, binned in recorded frame
+    BOOL IsFrameLit = FALSE;                                  // Recorded frame evaluates lights
+
+    /**
+     * @brief Deferred lighting resources initialization function. Called after render graph is built.
+    */
+    VOID InitLighting( VOID );
+
+    /**
+     * @brief Deferred lighting resources destroy function
+    */
+    VOID DestroyLighting( VOID );
+
+    /**
+     * @brief Lighting frame preparation function, called from render thread before graph execution.
+     *        Uploads view space lights and parameters, rewrites shading input set, if graph images are changed.
+     * @param Camera Camera, frame is shaded from, nullptr to output ambient lit base color only
+    */
+    VOID PrepareLighting( const math::util::camera::projection_matrices *Camera );
+
+    /**
+     * @brief Light culling recording function, called from render graph light culling pass.
+     *        Bins lights into view space clusters and makes bins visible to shading pass.
+     * @param CommandBuffer Command buffer to record culling to
+    */
+    VOID RecordLightCulling( vk::CommandBuffer CommandBuffer );
+
+    /**
+     * @brief Deferred shading recording function, called from render graph shading pass
+     * @param CommandBuffer Command buffer to record fullscreen shading to
+    */
+    VOID RecordShading( vk::CommandBuffer CommandBuffer );
+
+    /**
+     * Frames in flight
+    */
+
+    constexpr static UINT32 FRAMES_IN_FLIGHT = 2; // Count of frames, that may be recorded and executed at once
+
+    /**
+     * @brief Resources of frame in flight, written by host or used across queues. Slot is reused by every FRAMES_IN_FLIGHT-th frame,
+     *        after its previous frame is finished. GPU only resources (graph images, light grid, shadow map) are shared by slots,
+     *        so every frame starts with barrier against previous frame.
+    */
+    struct frame_slot
+    {
+      UINT64 TimelineValue = 0; // Timeline value of last frame, submitted with slot
+
+      vk::CommandBuffer MainCommandBuffer; // Frame primary command buffer
+      vk::CommandBuffer
+        MarkerCommandBuffer,   // Marker render subpass command buffer
+        GeometryCommandBuffer, // Geometry render subpass command buffer
+        OverlayCommandBuffer;  // Overlay render subpass command buffer
+      vk::Semaphore ImageAckquiredSemaphore;  // Semaphore that shows that image is ackquired from swapchain
+      vk::Semaphore SwapchainOutputSemaphore; // Swapchain out semaphore
+
+      vk::CommandBuffer CullingCommandBuffer; // Culling pass command buffer
+      vk::DescriptorSet CullingDescriptorSet; // Culling pass set
+      BOOL IsCullingSetOutdated = TRUE;       // Culling set must be rewritten (depth pyramid is recreated)
+      UINT32 GpuCullingDrawCount = 0;         // Count of draws, culled in last culling pass of slot
+      UINT32 CullingTriangleBits = ~0U;       // Visibility triangle bits of uploaded instances, ~0U if instance buffer must be fully rewritten
+      vk::Buffer CullingReleasedBuffers[3];   // Culling buffers, released by graphics queue family, compute one must acquire them
+      gpu_culling_buffer
+        CullingParamsBuffer,   // Culling parameters (uniform)
+        CullingInstanceBuffer, // Instance transforms and draw indices
+        CullingRigidBuffer,    // Packed transforms (math::packed_trs) of rigid primitive instances, indexed as CullingInstanceBuffer
+        CullingDrawBuffer,     // Primitive bounding boxes
+        IndirectCommandBuffer, // Compacted indexed indirect draw commands, one per primitive
+        VisibleInstanceBuffer; // Indices of visible instances (in CullingInstanceBuffer), grouped by draws
+
+      vk::DescriptorSet GpuDrawInstanceSet; // Instance set of GPU culled primitives, refers CullingInstanceBuffer and VisibleInstanceBuffer
+      vk::DescriptorSet CpuDrawInstanceSet; // Instance set of CPU culled primitives, refers DrawInstanceBuffer and DrawIndexBuffer
+      gpu_culling_buffer
+        DrawInstanceBuffer, // Visible instances of CPU culled primitives, grouped by primitive and level of detail
+        DrawIndexBuffer,    // Identity instance indices, written on reallocation only
+        ShadingDrawBuffer;  // Level of detail draws, fetched by visibility G-buffer layout shading (GPU culled draws, then CPU culled ones)
+
+      vk::DescriptorSet ShadowDescriptorSet; // Caster transforms set
+      gpu_culling_buffer ShadowCasterBuffer; // Caster instance transforms of rendered cascades
+
+      vk::DescriptorSet LightingDescriptorSet; // Lighting buffers set
+      gpu_culling_buffer
+        LightingParamsBuffer, // Light culling and shading parameters (uniform)
+        LightBuffer,          // View space lights
+        LightOverflowBuffer;  // Count of light to cluster assignments, dropped by light culling (single uint, reset by PrepareLighting)
+
+      vk::QueryPool TimestampQueryPool; // Pass timestamps, empty if graphics queue doesn't support timestamps
+      frame_profile SubmittedProfile;   // Profile of frame in flight
+      BOOL IsProfileSubmitted = FALSE;  // SubmittedProfile waits for frame completion
+    }; /* struct frame_slot */
+
+    frame_slot FrameSlots[FRAMES_IN_FLIGHT]; // Frames in flight resources
+    frame_slot *FrameSlot = nullptr;         // Slot of recorded frame. Written by render thread only.
+
+    /**
+     * @brief Frame slot initialization function, allocates command buffers and semaphores of every slot.
+     *        Buffers and sets are initialized by their subsystems.
+    */
+    VOID InitFrameSlots( VOID );
+
+    /**
+     * @brief Frame slot destroy function. Device must be idle.
+    */
+    VOID DestroyFrameSlots( VOID );
+
+    /**
+     * @brief System initialization function
+     * @param Window Window to render in, nullptr for headless mode
+    */
+    VOID Init( window::raw_handle *Window );
+
+    /**
+     * @brief Swapchain (re)creation function. In headless mode only updates output extent.
+     * @return TRUE if swapchain is created, FALSE if surface has zero extent
+    */
+    BOOL InitSwapchain( VOID );
+
+    /**
+     * @brief Frame contexts initialization function
+    */
+    VOID InitFrames( VOID );
+
+    /**
+     * @brief Frame contexts destroy function
+    */
+    VOID DestroyFrames( VOID );
+
+    /**
+     * @brief Swapchain and dependent resources recreation function
+     * @return TRUE if recreated, FALSE if surface has zero extent
+    */
+    BOOL RecreateSwapchain( VOID );
+
     /**
      * @brief Surface initialization function
     */
@@ -872,6 +2106,29 @@ namespace anv::render::core
     rc::pool<rc::resource> ResourcePool; // Pool of renderer resources
     rc::pool<primitive>   PrimitivePool; // Pool of primitives only
 
+    std::mutex CullingMutex;                      // Culling frustum guard
+    std::optional<math::frustum> CullingFrustum;  // Frustum to cull instances by, no culling if empty
+    mat4x4 CullingViewProjection;                 // View projection matrix, CullingFrustum is built from
+    std::optional<math::util::camera::projection_matrices> CullingCamera; // Camera, levels of detail are selected by
+    std::atomic<UINT64>
+      CulledInstanceCount = 0,                    // Count of instances of all primitives in last frame
+      VisibleInstanceCount = 0,                   // Count of visible instances in last frame
+      VisibleIndexCount = 0,                      // Count of indices of visible instances in last frame
+      RecordedDrawCount = 0,                      // Count of draw commands in last frame
+      PrepassDrawCount = 0,                       // Count of depth pre-pass draw commands in last frame
+      VisibilityOverflowCount = 0,                // Count of instances, which indices don't fit in visibility_id, in last frame
+      LightOverflowCount = 0;                     // Count of light to cluster assignments, dropped because of MAX_CLUSTER_LIGHT_COUNT, in last finished frame
+
+    std::mutex SceneBvhMutex; // Scene hierarchy guard
+    math::bvh SceneBvh;       // World bounds of instances of primitives with bounds, user data is instance pointer
+
+    /**
+     * @brief Scene hierarchy culling function, called from render thread.
+     *        Fills visible instances of CPU culled primitives with bounds.
+     * @param Frustum Frustum to cull by
+    */
+    VOID CullScene( const math::frustum &Frustum );
+
     friend class pipeline::builder;
     friend class buffer::builder;
     friend class sampler::builder;
@@ -882,6 +2139,7 @@ namespace anv::render::core
     friend class sampler;
     friend class image;
     friend class material;
+    friend class primitive;
 
     /**
      * @brief Rendering starting function
@@ -944,6 +2202,14 @@ namespace anv::render::core
       return image::builder(*this);
     } /* Image */
 
+    /**
+     * @brief Format support getting function, may be called from any thread.
+     *        Block compressed formats are supported only by devices with corresponding texture compression feature.
+     * @param Format Format to query physical device for
+     * @return Format support, nothing is supported if format has no Vulkan equivalent
+    */
+    format_support GetFormatSupport( format Format ) const;
+
     /**
      * @brief Pipeline builder getting function
      * @return Pipeline builder
@@ -956,8 +2222,222 @@ namespace anv::render::core
     /**
      * @brief System constructor
      * @param Window Window for system to render in
+     * @param Extent Window extent (used if surface doesn't define extent)
+     * @param GraphMode Graphics pass execution mode
+     * @param GBufferLayout G-buffer layout
+    */
+    system( window::raw_handle &Window, extent2 Extent, render_graph::mode GraphMode = render_graph::mode::eSubpasses, gbuffer_layout GBufferLayout = gbuffer_layout::eWide );
+
+    /**
+     * @brief Headless system constructor. Renders to offscreen images, doesn't require window or surface support.
+     * @param Headless Offscreen output description
+    */
+    system( const headless_output &Headless );
+
+    /**
+     * @brief Last read back output getting function (headless mode with readback only)
+     * @param Pixels Vector to write tightly packed R8G8B8A8 sRGB pixels to
+     * @param Extent Output extent
+     * @return Output frame number (starting from 1), 0 if no output is read back yet
+    */
+    UINT64 ReadOutput( std::vector<BYTE> &Pixels, extent2 &Extent );
+
+    /**
+     * @brief Frame completion waiting function
+     * @param FrameCount Count of frames to wait for
+    */
+    VOID WaitFrames( UINT64 FrameCount );
+
+    /**
+     * @brief Completed frame count getting function
+     * @return Count of frames, that finished rendering on GPU
+    */
+    UINT64 GetCompletedFrameCount( VOID ) const;
+
+    /**
+     * @brief Last submitted GPU timeline value getting function, may be called from any thread.
+     *        Every frame signals its number (starting from 1) on graphics queue, so value V is complete when frame V finished.
+     * @return Last submitted timeline value
+    */
+    UINT64 GetSubmittedTimelineValue( VOID ) const;
+
+    /**
+     * @brief Completed GPU timeline value getting function, may be called from any thread
+     * @return Last timeline value, whose GPU work is finished
+    */
+    UINT64 GetCompletedTimelineValue( VOID );
+
+    /**
+     * @brief Timeline value completion checking function, may be called from any thread. Doesn't query device, if value is known to be complete.
+     * @param Value Timeline value
+     * @return TRUE if GPU work, that signals value, is finished
+    */
+    BOOL IsTimelineValueComplete( UINT64 Value );
+
+    /**
+     * @brief Timeline value completion waiting function, may be called from any thread
+     * @param Value Timeline value, must be submitted or be going to be submitted
+     * @param Timeout Wait timeout, in nanoseconds
+     * @return TRUE if value is complete, FALSE if timeout elapsed
+    */
+    BOOL WaitTimelineValue( UINT64 Value, UINT64 Timeout = UINT64_MAX );
+
+    /**
+     * @brief Deferred destroy function, may be called from any thread.
+     *        Callback is called from render thread, when GPU work of all frames, submitted before the next one, is finished.
+     * @param Destroy Destroy callback
+    */
+    VOID DeferDestroy( std::function<VOID( VOID )> Destroy );
+
+    /**
+     * @brief Continuous frame readback setting function. Copies are done asynchronously into host-visible buffer ring.
+     * @param Targets Images to copy every frame, empty to disable readback
+     * @param Callback Callback, called from readback thread for every captured frame. Frames are dropped while it is busy with whole ring.
+    */
+    VOID SetReadback( readback_target_flags Targets, readback_callback Callback );
+
+    /**
+     * @brief Readback statistics getting function
+     * @return Readback statistics
+    */
+    readback_stats GetReadbackStats( VOID ) const;
+
+    /**
+     * @brief Culling camera setting function, may be called from any thread
+     * @param Matrices Camera matrices to build culling frustum from, empty to disable frustum culling
+    */
+    VOID SetCullingCamera( const std::optional<math::util::camera::projection_matrices> &Matrices );
+
+    /**
+     * @brief Culling statistics getting function
+     * @return Culling statistics of last rendered frame
+    */
+    culling_stats GetCullingStats( VOID ) const;
+
+    /**
+     * @brief Frame pacing policy setting function, may be called from any thread.
+     *        Swapchain is recreated before next frame, if present mode or queued frame count is changed.
+     * @param NewPacing New pacing policy
+    */
+    VOID SetFramePacing( const frame_pacing &NewPacing );
+
+    /**
+     * @brief Frame pacing policy getting function
+     * @return Current pacing policy
+    */
+    frame_pacing GetFramePacing( VOID );
+
+    /**
+     * @brief Frame pacing statistics getting function, may be called from any thread
+     * @return Frame time statistics of last frames
+    */
+    frame_pacing_stats GetFramePacingStats( VOID );
+
+    /**
+     * @brief Frame profiling enabling function, may be called from any thread
+     * @param Enable TRUE to measure render thread zones and GPU pass times of every frame
+    */
+    VOID SetProfiling( BOOL Enable );
+
+    /**
+     * @brief Profiled frames getting function, may be called from any thread
+     * @return Last profiled frames, whose GPU work is finished, from the oldest one
+    */
+    std::vector<frame_profile> GetFrameProfiles( VOID );
+
+    /**
+     * @brief Profiled frames Chrome trace (chrome://tracing, Perfetto) export function, may be called from any thread
+     * @return Trace event JSON document
+    */
+    std::string ExportChromeTrace( VOID );
+
+    /**
+     * @brief GPU culling enabling function, may be called from any thread.
+     *        Instances of indexed primitives are culled by frustum and previous frame depth pyramid on compute queue,
+     *        draws use compacted indirect commands then. Their visible instance count is reported with one frame latency.
+     * @param Enable TRUE to cull on GPU, FALSE to cull on CPU
+    */
+    VOID SetGpuCulling( BOOL Enable );
+
+    /**
+     * @brief Lights setting function, may be called from any thread.
+     *        Lights are binned into view space clusters of culling camera every frame, so shading evaluates only lights, affecting pixel cluster.
+     *        Without culling camera only ambient light is applied.
+     * @param NewLights Point lights
+     * @param Ambient Ambient light color
+    */
+    VOID SetLights( std::span<const point_light> NewLights, const vec3 &Ambient = vec3(0.03F) );
+
+    /**
+     * @brief Directional light setting function, may be called from any thread.
+     *        Shadows are cast by primitives of pipelines, built with CastShadows, into cascades over culling camera view.
+     * @param Light Directional light, empty to disable it
+    */
+    VOID SetDirectionalLight( const std::optional<directional_light> &Light );
+
+    /**
+     * @brief Shadow caching enabling function, may be called from any thread
+     * @param Enable TRUE to keep cascades until their placement changes or casters in them move, FALSE to render every cascade every frame
+    */
+    VOID SetShadowCaching( BOOL Enable );
+
+    /**
+     * @brief Shadow statistics getting function
+     * @return Shadow statistics of last rendered frame
+    */
+    shadow_stats GetShadowStats( VOID ) const;
+
+    /**
+     * @brief Transient attachments enabling function, may be called from any thread.
+     *        G-buffer and depth images, that don't leave output render pass, are created as transient attachments in lazily allocated memory,
+     *        so tiled GPUs keep them in tile memory only. Images, that are read back or sampled by depth pyramid building, stay regular.
+     * @param Enable TRUE to use transient attachments
+    */
+    VOID SetTransientAttachments( BOOL Enable );
+
+    /**
+     * @brief Depth pre-pass enabling function, may be called from any thread.
+     *        Primitives of geometry pipelines, built with DepthVertexSPV, are drawn depth only in marker pass by position stream,
+     *        then geometry pass draws them with equal depth test and without depth writes, so G-buffer is written once per pixel.
+     * @param Enable TRUE to pre-pass depth
+    */
+    VOID SetDepthPrepass( BOOL Enable );
+
+    /**
+     * @brief Render graph image memory statistics getting function
+     * @return Memory statistics of G-buffer and depth images
+    */
+    render_graph::memory_stats GetAttachmentMemoryStats( VOID );
+
+    /**
+     * @brief Instances, overlapping box, querying function, may be called from any thread
+     * @param Box World space box
+     * @return Instances of primitives with bounds, whose world bounds overlap box. Valid until released by owner.
+    */
+    std::vector<primitive::instance *> QueryInstances( const math::aabb &Box );
+
+    /**
+     * @brief Instances, possibly visible in frustum, querying function, may be called from any thread
+     * @param Frustum World space frustum
+     * @return Instances of primitives with bounds, whose world bounds aren't outside frustum. Valid until released by owner.
+    */
+    std::vector<primitive::instance *> QueryInstances( const math::frustum &Frustum );
+
+    /**
+     * @brief Instance box-level picking function, may be called from any thread.
+     *        Ray is tested against world bounding boxes of instances, not against their triangles (primitives keep no CPU copy of geometry),
+     *        so picked instance is the one with the nearest box and ray may pass by its geometry.
+     * @param Ray World space ray
+     * @param MaxDistance Maximal distance along ray
+     * @return Instance with the nearest world bounds, hit by ray, and distance to box entry point. Instance is valid until released by owner.
+    */
+    std::optional<std::pair<primitive::instance *, FLOAT>> PickInstance( const math::ray &Ray, FLOAT MaxDistance = FLT_MAX );
+
+    /**
+     * @brief Output resize notification function, may be called from any thread
+     * @param NewExtent New output extent
     */
-    system( window::raw_handle &Window );
+    VOID Resize( extent2 NewExtent );
 
     /**
      * @brief System destructor
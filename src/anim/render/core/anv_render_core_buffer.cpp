@@ -17,6 +17,8 @@ namespace anv::render::core
       | ((Usage & (buffer::usage_flags)buffer::usage::eVertex ) ? vk::BufferUsageFlagBits::eVertexBuffer  : vk::BufferUsageFlagBits())
       | ((Usage & (buffer::usage_flags)buffer::usage::eStorage) ? vk::BufferUsageFlagBits::eStorageBuffer : vk::BufferUsageFlagBits())
       | ((Usage & (buffer::usage_flags)buffer::usage::eUniform) ? vk::BufferUsageFlagBits::eUniformBuffer : vk::BufferUsageFlagBits())
+      // Visibility G-buffer layout shading fetches geometry by device addresses
+      | ((Usage & (buffer::usage::eIndex | buffer::usage::eVertex)) ? vk::BufferUsageFlagBits::eShaderDeviceAddress : vk::BufferUsageFlagBits())
       ;
   } /* End of 'TranslateBufferUsage' function */
 
@@ -75,6 +77,8 @@ namespace anv::render::core
     vk::Buffer Buffer;
     view *View = new view(this, Builder.Offset, Builder.Size);
     vmaCreateAliasingBuffer2(System.Allocator, Memory, Builder.Offset, &(const VkBufferCreateInfo &)BufferCreateInfo, &(VkBuffer &)View->View);
+    if (BufferCreateInfo.usage & vk::BufferUsageFlagBits::eShaderDeviceAddress)
+      View->Address = System.Device.getBufferAddress(vk::BufferDeviceAddressInfo(View->View));
 
     View->Grab();
 
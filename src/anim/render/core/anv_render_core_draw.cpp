@@ -0,0 +1,306 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/anim/render/core/anv_render_core_draw.cpp
+ * @description Render core primitive draw recording implementation module
+ * @last_update 18.10.2026
+*/
+
+#include "anv.h"
+
+namespace anv::render::core
+{
+  /**
+   * @brief Draw recording resources initialization function. Called after GPU culling initialization.
+  */
+  VOID system::InitDraws( VOID )
+  {
+    vk::DescriptorSetLayoutBinding InstanceBindings[]
+    {
+      {0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eVertex}, // Instances
+      {1, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eVertex}, // Visible instances
+    };
+    DrawInstanceSetLayout = Device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo().setBindings(InstanceBindings));
+
+    vk::DescriptorPoolSize PoolSize {vk::DescriptorType::eStorageBuffer, 4 * FRAMES_IN_FLIGHT};
+    DrawDescriptorPool = Device.createDescriptorPool(vk::DescriptorPoolCreateInfo()
+      .setMaxSets(2 * FRAMES_IN_FLIGHT)
+      .setPoolSizes(PoolSize)
+    );
+
+    // Every frame in flight binds its own instance buffers
+    vk::DescriptorSetLayout SetLayouts[] {DrawInstanceSetLayout, DrawInstanceSetLayout};
+    for (frame_slot &Slot : FrameSlots)
+    {
+      std::vector<vk::DescriptorSet> Sets = Device.allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
+        .setDescriptorPool(DrawDescriptorPool)
+        .setSetLayouts(SetLayouts)
+      );
+      Slot.GpuDrawInstanceSet = Sets[0];
+      Slot.CpuDrawInstanceSet = Sets[1];
+    }
+  } /* InitDraws */
+
+  /**
+   * @brief Draw recording resources destroy function
+  */
+  VOID system::DestroyDraws( VOID )
+  {
+    for (frame_slot &Slot : FrameSlots)
+      for (gpu_culling_buffer *Buffer : {&Slot.DrawInstanceBuffer, &Slot.DrawIndexBuffer, &Slot.ShadingDrawBuffer})
+        if (Buffer->Allocation != nullptr)
+          vmaDestroyBuffer(Allocator, Buffer->Buffer, Buffer->Allocation);
+
+    Device.destroyDescriptorPool(DrawDescriptorPool);
+    Device.destroyDescriptorSetLayout(DrawInstanceSetLayout);
+  } /* DestroyDraws */
+
+  /**
+   * @brief Visible instances of CPU culled primitives writing function, called from render thread after culling and before draw recording.
+   *        Assigns first draw instances to primitives and writes visible instance transforms to DrawInstanceBuffer,
+   *        in visibility G-buffer layout writes level of detail draws of all primitives to ShadingDrawBuffer.
+  */
+  VOID system::WriteDrawInstances( VOID )
+  {
+    // GPU culled instances and draws take first visibility instance indices and shading draws
+    UINT32 GpuInstanceCount = 0, GpuDrawCount = 0, InstanceCount = 0, DrawCount = 0;
+    for (primitive *Primitive : PrimitivePool)
+      if (Primitive->Instances.empty())
+        continue;
+      else if (Primitive->IndirectDrawIndex != primitive::NO_INDIRECT_DRAW)
+      {
+        GpuInstanceCount += (UINT32)Primitive->Instances.size();
+        GpuDrawCount = std::max(GpuDrawCount, Primitive->IndirectDrawIndex + (UINT32)Primitive->Lods.size());
+      }
+      else
+      {
+        Primitive->FirstDrawInstance = InstanceCount;
+        InstanceCount += (UINT32)Primitive->VisibleInstances.size();
+        DrawCount += (UINT32)Primitive->Lods.size();
+      }
+
+    frame_slot &Slot = *FrameSlot;
+
+    // Set must be written before it's bound by recorded draws
+    BOOL IsSetOutdated = ReserveGpuCullingBuffer(Slot.DrawInstanceBuffer, std::max(InstanceCount, 1U) * sizeof(gpu_culling_instance),
+      vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress, TRUE);
+    if (ReserveGpuCullingBuffer(Slot.DrawIndexBuffer, std::max(InstanceCount, 1U) * sizeof(UINT32), vk::BufferUsageFlagBits::eStorageBuffer, TRUE))
+    {
+      // Instances are written in draw order, so their indices are identity and are written once
+      auto *Indices = reinterpret_cast<UINT32 *>(Slot.DrawIndexBuffer.Data);
+      std::iota(Indices, Indices + Slot.DrawIndexBuffer.Size / sizeof(UINT32), 0U);
+      vmaFlushAllocation(Allocator, Slot.DrawIndexBuffer.Allocation, 0, VK_WHOLE_SIZE);
+      IsSetOutdated = TRUE;
+    }
+
+    if (IsSetOutdated)
+    {
+      vk::DescriptorBufferInfo BufferInfos[]
+      {
+        {Slot.DrawInstanceBuffer.Buffer, 0, VK_WHOLE_SIZE},
+        {Slot.DrawIndexBuffer.Buffer,    0, VK_WHOLE_SIZE},
+      };
+      vk::WriteDescriptorSet Writes[2];
+      for (UINT32 Binding = 0; Binding < 2; Binding++)
+        Writes[Binding] = vk::WriteDescriptorSet()
+          .setDstSet(Slot.CpuDrawInstanceSet)
+          .setDstBinding(Binding)
+          .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+          .setBufferInfo(BufferInfos[Binding]);
+
+      Device.updateDescriptorSets(Writes, {});
+    }
+
+    // Shading fetches geometry of level by draw index of instance, positions and normals are F32x3 (checked by pipeline building)
+    const BOOL IsVisibility = GBufferLayout == gbuffer_layout::eVisibility;
+    if (IsVisibility)
+      ReserveGpuCullingBuffer(Slot.ShadingDrawBuffer, std::max(GpuDrawCount + DrawCount, 1U) * sizeof(gpu_shading_draw),
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress, TRUE);
+
+    auto WriteShadingDraw = [&]( gpu_shading_draw &Draw, const primitive &Primitive, UINT32 Lod )
+    {
+      const pipeline &Pipeline = Primitive.Pipeline;
+      const primitive::lod &Level = Primitive.Lods[Lod];
+
+      // Vertices of stream, which are fully inside its view
+      auto GetStream = [&]( INT32 AttributeIndex, vk::DeviceAddress &Address, UINT32 &Stride ) -> UINT32
+      {
+        if (AttributeIndex < 0 || AttributeIndex >= (INT32)Pipeline.VertexAttributeLayouts.size())
+          return 0;
+
+        const pipeline::vertex_attribute_layout &Attribute = Pipeline.VertexAttributeLayouts[AttributeIndex];
+        if (Attribute.BufferIndex >= Primitive.VertexBuffers.size() || Primitive.VertexBuffers[Attribute.BufferIndex] == nullptr)
+          return 0;
+
+        const buffer::view &View = *Primitive.VertexBuffers[Attribute.BufferIndex];
+        const UINT32 VertexStride = Pipeline.VertexBufferLayouts[Attribute.BufferIndex].Stride;
+        if (View.Size < Attribute.Offset + sizeof(FLOAT) * 3)
+          return 0;
+
+        Address = View.Address + Attribute.Offset;
+        Stride = VertexStride / sizeof(UINT32);
+        return (UINT32)((View.Size - Attribute.Offset - sizeof(FLOAT) * 3) / VertexStride + 1);
+      };
+
+      Draw = gpu_shading_draw {};
+      Draw.VertexCount = GetStream(0, Draw.PositionAddress, Draw.PositionStride);
+      const UINT32 NormalCount = GetStream(Pipeline.NormalAttributeIndex, Draw.NormalAddress, Draw.NormalStride);
+      Draw.HasNormals = NormalCount != 0;
+      if (Draw.HasNormals)
+        Draw.VertexCount = std::min(Draw.VertexCount, NormalCount);
+
+      Draw.IsIndexed = Primitive.IndexBuffer != nullptr;
+      if (Draw.IsIndexed)
+      {
+        Draw.IndexAddress = Primitive.IndexBuffer->Address;
+        Draw.FirstIndex = Level.FirstIndex;
+        Draw.VertexOffset = Level.VertexOffset;
+        Draw.TriangleCount = Level.IndexCount / 3;
+      }
+      else
+        Draw.TriangleCount = Primitive.VertexCount / 3;
+
+      const material::surface Surface = Primitive.Material != nullptr ? Primitive.Material->Surface : material::surface {};
+      Draw.BaseColorAmbientOcclusion[0] = Surface.BaseColor.X;
+      Draw.BaseColorAmbientOcclusion[1] = Surface.BaseColor.Y;
+      Draw.BaseColorAmbientOcclusion[2] = Surface.BaseColor.Z;
+      Draw.BaseColorAmbientOcclusion[3] = Surface.AmbientOcclusion;
+      Draw.MetallicRoughness[0] = Surface.Metallic;
+      Draw.MetallicRoughness[1] = Surface.Roughness;
+    };
+
+    // Visible instances are grouped by level of detail, so every level takes contiguous range
+    auto *Instances = reinterpret_cast<gpu_culling_instance *>(Slot.DrawInstanceBuffer.Data);
+    auto *ShadingDraws = IsVisibility ? reinterpret_cast<gpu_shading_draw *>(Slot.ShadingDrawBuffer.Data) : nullptr;
+    UINT32 FirstDraw = GpuDrawCount;
+
+    for (primitive *Primitive : PrimitivePool)
+    {
+      if (Primitive->Instances.empty())
+        continue;
+
+      const BOOL IsGpuCulled = Primitive->IndirectDrawIndex != primitive::NO_INDIRECT_DRAW;
+      if (IsVisibility)
+        for (UINT32 Lod = 0; Lod < Primitive->Lods.size(); Lod++)
+          WriteShadingDraw(ShadingDraws[(IsGpuCulled ? Primitive->IndirectDrawIndex : FirstDraw) + Lod], *Primitive, Lod);
+      if (IsGpuCulled)
+        continue;
+
+      UINT32 Index = Primitive->FirstDrawInstance;
+      if (!Primitive->VisibleInstances.empty())
+        for (UINT32 Lod = 0; Lod < Primitive->Lods.size(); Lod++)
+          for (UINT32 i = 0; i < Primitive->VisibleLodCounts[Lod]; i++, Index++)
+            Instances[Index] = gpu_culling_instance
+            {
+              .Transform = Primitive->Transforms[Primitive->VisibleInstances[Index - Primitive->FirstDrawInstance]],
+              .DrawIndex = FirstDraw + Lod,
+              .VisibilityID = GetVisibilityId(GpuInstanceCount + Index),
+              .FirstDrawIndex = FirstDraw,
+            };
+      FirstDraw += (UINT32)Primitive->Lods.size();
+    }
+
+    if (InstanceCount != 0)
+      vmaFlushAllocation(Allocator, Slot.DrawInstanceBuffer.Allocation, 0, InstanceCount * sizeof(gpu_culling_instance));
+    if (IsVisibility)
+      vmaFlushAllocation(Allocator, Slot.ShadingDrawBuffer.Allocation, 0, VK_WHOLE_SIZE);
+
+    // Instances past capacity are drawn with background ID, so shading keeps marker pass output under them
+    const UINT32 Capacity = visibility_id::GetInstanceCapacity(VisibilityTriangleBits);
+    VisibilityOverflowCount = IsVisibility && GpuInstanceCount + InstanceCount > Capacity ? GpuInstanceCount + InstanceCount - Capacity : 0;
+    VisibilityGpuInstanceCount = GpuInstanceCount;
+  } /* WriteDrawInstances */
+
+  /**
+   * @brief Visibility buffer ID layout selection function, called from render thread before culling.
+   *        Sizes visibility_id triangle bits by the largest level of detail of geometry pass primitives.
+  */
+  VOID system::LayoutVisibilityIds( VOID )
+  {
+    UINT64 MaxTriangleCount = 1;
+
+    for (primitive *Primitive : PrimitivePool)
+      if (Primitive->Pipeline.RenderPass == render_pass::eGeometry && !Primitive->Instances.empty())
+        for (const primitive::lod &Level : Primitive->Lods)
+          MaxTriangleCount = std::max<UINT64>(MaxTriangleCount, (Primitive->IndexBuffer != nullptr ? Level.IndexCount : Primitive->VertexCount) / 3);
+
+    VisibilityTriangleBits = visibility_id::GetTriangleBits(MaxTriangleCount);
+  } /* LayoutVisibilityIds */
+
+  /**
+   * @brief Instance visibility ID getting function
+   * @param Index Instance index (GPU culled instances, then visible CPU culled ones)
+   * @return Index, shifted to visibility_id high bits, visibility_id::BACKGROUND if it doesn't fit
+  */
+  UINT32 system::GetVisibilityId( UINT32 Index ) const
+  {
+    return Index < visibility_id::GetInstanceCapacity(VisibilityTriangleBits) ? Index << VisibilityTriangleBits : visibility_id::BACKGROUND;
+  } /* GetVisibilityId */
+
+  /**
+   * @brief Primitive draws recording function, called from render thread after culling.
+   *        GPU culled primitive is drawn by indirect command per level of detail, CPU culled one by instanced draw per level of detail.
+   * @param CommandBuffer Secondary command buffer of pass, pipeline is built for
+   * @param Primitive Primitive to draw visible instances of
+   * @param Pipeline One of primitive pipelines. Depth pre-pass pipeline is fed by position vertex buffer only.
+   * @return Count of recorded draw commands
+  */
+  UINT32 system::RecordDraws( vk::CommandBuffer CommandBuffer, const primitive &Primitive, vk::Pipeline Pipeline )
+  {
+    const BOOL IsGpuCulled = Primitive.IndirectDrawIndex != primitive::NO_INDIRECT_DRAW;
+    vk::DescriptorSet Sets[] {Primitive.Material->DescriptorSet, IsGpuCulled ? FrameSlot->GpuDrawInstanceSet : FrameSlot->CpuDrawInstanceSet};
+    UINT32 DrawCount = 0;
+
+    CommandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, Pipeline);
+    CommandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, Primitive.Pipeline.PipelineLayout, 0, Sets, {});
+
+    // Views are aliasing buffers, so they are bound from their start. Depth pre-pass pipeline fetches position stream only.
+    if (Pipeline == Primitive.Pipeline.DepthPrepassPipeline)
+      CommandBuffer.bindVertexBuffers(0, Primitive.VertexBuffers[Primitive.Pipeline.PositionBufferIndex]->View, {0});
+    else if (!Primitive.VertexBuffers.empty())
+    {
+      std::vector<vk::Buffer> VertexBuffers(Primitive.VertexBuffers.size());
+      std::vector<vk::DeviceSize> VertexBufferOffsets(Primitive.VertexBuffers.size(), 0);
+
+      for (UINT32 i = 0; i < VertexBuffers.size(); i++)
+        VertexBuffers[i] = Primitive.VertexBuffers[i]->View;
+      CommandBuffer.bindVertexBuffers(0, VertexBuffers, VertexBufferOffsets);
+    }
+    if (Primitive.IndexBuffer != nullptr)
+      CommandBuffer.bindIndexBuffer(Primitive.IndexBuffer->View, 0, vk::IndexType::eUint32);
+
+    // Culling pass selects levels and writes instance count of every level command, so all level commands are drawn (empty ones are no-op)
+    if (IsGpuCulled)
+    {
+      const UINT32 LodCount = (UINT32)Primitive.Lods.size();
+
+      if (DeviceFeatures.multiDrawIndirect)
+        CommandBuffer.drawIndexedIndirect(FrameSlot->IndirectCommandBuffer.Buffer, Primitive.IndirectDrawIndex * sizeof(vk::DrawIndexedIndirectCommand), LodCount,
+          sizeof(vk::DrawIndexedIndirectCommand));
+      else
+        for (UINT32 Lod = 0; Lod < LodCount; Lod++)
+          CommandBuffer.drawIndexedIndirect(FrameSlot->IndirectCommandBuffer.Buffer, (Primitive.IndirectDrawIndex + Lod) * sizeof(vk::DrawIndexedIndirectCommand), 1,
+            sizeof(vk::DrawIndexedIndirectCommand));
+      return LodCount;
+    }
+
+    // Level L takes VisibleLodCounts[L] instances after previous levels
+    UINT32 FirstInstance = Primitive.FirstDrawInstance;
+    for (UINT32 Lod = 0; Lod < Primitive.Lods.size(); Lod++)
+    {
+      const primitive::lod &Level = Primitive.Lods[Lod];
+      const UINT32 InstanceCount = Primitive.VisibleLodCounts[Lod];
+
+      if (InstanceCount == 0)
+        continue;
+      if (Primitive.IndexBuffer != nullptr)
+        CommandBuffer.drawIndexed(Level.IndexCount, InstanceCount, Level.FirstIndex, Level.VertexOffset, FirstInstance);
+      else
+        CommandBuffer.draw(Primitive.VertexCount, InstanceCount, 0, FirstInstance);
+      FirstInstance += InstanceCount;
+      DrawCount++;
+    }
+    return DrawCount;
+  } /* RecordDraws */
+} /* namespace anv::render::core */
+
+/* file anv_render_core_draw.cpp */
@@ -0,0 +1,1009 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/anim/render/core/anv_render_core_gpu_culling.cpp
+ * @description Render core GPU (compute) culling and depth pyramid implementation module
+ * @last_update 18.10.2026
+*/
+
+#include "anv.h"
+
+#include <shaderc/shaderc.hpp>
+
+namespace anv::render::core
+{
+  /**
+   * Instance culling shader. One invocation per instance: selects level of detail by projected size of world space box,
+   * tests box against frustum and conservative depth pyramid of previous frame, appends visible instance to its level draw compacted range.
+  */
+  static const CHAR *CullingShaderSource = R"(
+    #version 450
+
+    layout(local_size_x = 64) in;
+
+    struct instance
+    {
+      mat4 Transform;
+      uint DrawIndex;
+      uint VisibilityID;
+      uint FirstDrawIndex;
+      uint Padding;
+    };
+
+    struct draw
+    {
+      vec3 Center;
+      uint IsCulled;
+      vec3 Extent;
+      uint FirstInstance;
+      float MinScreenSize;
+      float LodHysteresis;
+      uint LodCount;
+      uint IsRigid;
+    };
+
+    struct packed_trs
+    {
+      vec4 PositionScaleX;
+      uvec2 Rotation;
+      vec2 ScaleYZ;
+    };
+
+    struct draw_command
+    {
+      uint IndexCount;
+      uint InstanceCount;
+      uint FirstIndex;
+      int VertexOffset;
+      uint FirstInstance;
+    };
+
+    layout(set = 0, binding = 0, std140) uniform params
+    {
+      mat4 DepthPyramidViewProjection;
+      vec4 Planes[6];
+      uint InstanceCount;
+      uint IsFrustumCulled;
+      uint IsOcclusionCulled;
+      uint DepthPyramidMipCount;
+      vec2 DepthPyramidExtent;
+      float LodProjectionScale;
+      uint LodMode;
+      vec4 LodViewDepth;
+    } Params;
+
+    layout(set = 0, binding = 1, std430) buffer instances { instance Instances[]; };
+    layout(set = 0, binding = 2, std430) readonly buffer draws { draw Draws[]; };
+    layout(set = 0, binding = 3, std430) buffer draw_commands { draw_command DrawCommands[]; };
+    layout(set = 0, binding = 4, std430) writeonly buffer visible_instances { uint VisibleInstances[]; };
+    layout(set = 0, binding = 5) uniform sampler2D DepthPyramid;
+    layout(set = 0, binding = 6, std430) buffer instance_lods { uint InstanceLods[]; };
+    layout(set = 0, binding = 7, std430) readonly buffer rigid_transforms { packed_trs RigidTransforms[]; };
+
+    // Same as trs::ToMatrix: quaternion rotation rows, scaled per axis, and translation row
+    mat4 UnpackTransform( packed_trs Packed )
+    {
+      vec4 Q = normalize(vec4(unpackSnorm2x16(Packed.Rotation.x), unpackSnorm2x16(Packed.Rotation.y)));
+      float
+        XX = 2 * Q.x * Q.x, YY = 2 * Q.y * Q.y, ZZ = 2 * Q.z * Q.z,
+        XY = 2 * Q.x * Q.y, XZ = 2 * Q.x * Q.z, YZ = 2 * Q.y * Q.z,
+        WX = 2 * Q.w * Q.x, WY = 2 * Q.w * Q.y, WZ = 2 * Q.w * Q.z;
+
+      return mat4(
+        vec4(1 - YY - ZZ, XY + WZ, XZ - WY, 0) * Packed.PositionScaleX.w,
+        vec4(XY - WZ, 1 - XX - ZZ, YZ + WX, 0) * Packed.ScaleYZ.x,
+        vec4(XZ + WY, YZ - WX, 1 - XX - YY, 0) * Packed.ScaleYZ.y,
+        vec4(Packed.PositionScaleX.xyz, 1));
+    }
+
+    bool IsOccluded( vec3 Center, vec3 Extent )
+    {
+      vec2 MinUV = vec2(1), MaxUV = vec2(0);
+      float MinDepth = 1;
+
+      for (int i = 0; i < 8; i++)
+      {
+        vec3 Corner = Center + Extent * vec3((i & 1) != 0 ? 1 : -1, (i & 2) != 0 ? 1 : -1, (i & 4) != 0 ? 1 : -1);
+        vec4 Clip = Params.DepthPyramidViewProjection * vec4(Corner, 1);
+
+        // Box intersects camera plane
+        if (Clip.w <= 0)
+          return false;
+
+        vec3 NDC = Clip.xyz / Clip.w;
+        MinUV = min(MinUV, NDC.xy * 0.5 + 0.5);
+        MaxUV = max(MaxUV, NDC.xy * 0.5 + 0.5);
+        MinDepth = min(MinDepth, NDC.z);
+      }
+      if (MinDepth <= 0)
+        return false;
+
+      MinUV = clamp(MinUV, 0, 1);
+      MaxUV = clamp(MaxUV, 0, 1);
+
+      // Box covers at most 2x2 texels of this level
+      vec2 Size = (MaxUV - MinUV) * Params.DepthPyramidExtent;
+      float Level = clamp(ceil(log2(max(max(Size.x, Size.y), 1))), 0, float(Params.DepthPyramidMipCount - 1));
+
+      float Depth = max(
+        max(textureLod(DepthPyramid, MinUV, Level).r, textureLod(DepthPyramid, vec2(MaxUV.x, MinUV.y), Level).r),
+        max(textureLod(DepthPyramid, vec2(MinUV.x, MaxUV.y), Level).r, textureLod(DepthPyramid, MaxUV, Level).r)
+      );
+
+      return MinDepth > Depth;
+    }
+
+    // Same as primitive::SelectLod: level changes only when size crosses threshold by hysteresis band
+    uint SelectLod( uint Index, uint FirstDrawIndex, draw First, vec3 Center, vec3 Extent )
+    {
+      if (First.LodCount == 1 || First.IsCulled == 0 || Params.LodMode == 0)
+        return 0;
+
+      float Radius = length(Extent), ScreenSize = Radius * Params.LodProjectionScale;
+      if (Params.LodMode == 1)
+      {
+        float Depth = abs(dot(Params.LodViewDepth.xyz, Center) + Params.LodViewDepth.w);
+        ScreenSize = Depth <= Radius ? 3.402823466e38 : ScreenSize / Depth;
+      }
+
+      uint Lod = min(InstanceLods[Index], First.LodCount - 1);
+      while (Lod > 0 && ScreenSize >= Draws[FirstDrawIndex + Lod - 1].MinScreenSize * (1 + First.LodHysteresis))
+        Lod--;
+      while (Lod + 1 < First.LodCount && ScreenSize < Draws[FirstDrawIndex + Lod].MinScreenSize * (1 - First.LodHysteresis))
+        Lod++;
+
+      InstanceLods[Index] = Lod;
+      return Lod;
+    }
+
+    bool IsVisible( vec3 Center, vec3 Extent )
+    {
+      if (Params.IsFrustumCulled != 0)
+        for (int i = 0; i < 6; i++)
+          if (dot(Params.Planes[i].xyz, Center) + Params.Planes[i].w + dot(abs(Params.Planes[i].xyz), Extent) < 0)
+            return false;
+
+      return Params.IsOcclusionCulled == 0 || !IsOccluded(Center, Extent);
+    }
+
+    void main()
+    {
+      uint Index = gl_GlobalInvocationID.x;
+
+      if (Index >= Params.InstanceCount)
+        return;
+
+      uint FirstDrawIndex = Instances[Index].FirstDrawIndex;
+      draw First = Draws[FirstDrawIndex];
+      mat4 Transform;
+
+      // Draws read full matrix
+      if (First.IsRigid != 0)
+      {
+        Transform = UnpackTransform(RigidTransforms[Index]);
+        Instances[Index].Transform = Transform;
+      }
+      else
+        Transform = Instances[Index].Transform;
+
+      // Transforms are row-vector ones, so Transform * v here is v * Transform on CPU side
+      vec3 Center = (Transform * vec4(First.Center, 1)).xyz;
+      vec3 Extent =
+        abs(Transform[0].xyz) * First.Extent.x +
+        abs(Transform[1].xyz) * First.Extent.y +
+        abs(Transform[2].xyz) * First.Extent.z;
+
+      // Shading reads level draw of every visible instance
+      uint DrawIndex = FirstDrawIndex + SelectLod(Index, FirstDrawIndex, First, Center, Extent);
+      Instances[Index].DrawIndex = DrawIndex;
+
+      if (First.IsCulled != 0 && !IsVisible(Center, Extent))
+        return;
+
+      uint Slot = atomicAdd(DrawCommands[DrawIndex].InstanceCount, 1);
+      VisibleInstances[Draws[DrawIndex].FirstInstance + Slot] = Index;
+    }
+  )";
+
+  /**
+   * Depth pyramid level building shader. Every destination texel is maximum of source texels it covers,
+   * so non power of 2 depth is reduced conservatively to power of 2 level 0.
+  */
+  static const CHAR *DepthPyramidShaderSource = R"(
+    #version 450
+
+    layout(local_size_x = 8, local_size_y = 8) in;
+
+    layout(set = 0, binding = 0) uniform sampler2D Source;
+    layout(set = 0, binding = 1, r32f) uniform writeonly image2D Destination;
+
+    layout(push_constant) uniform extents
+    {
+      ivec2 SourceExtent;
+      ivec2 DestinationExtent;
+    };
+
+    void main()
+    {
+      ivec2 Texel = ivec2(gl_GlobalInvocationID.xy);
+
+      if (any(greaterThanEqual(Texel, DestinationExtent)))
+        return;
+
+      ivec2 First = Texel * SourceExtent / DestinationExtent;
+      ivec2 Last = min(((Texel + 1) * SourceExtent + DestinationExtent - 1) / DestinationExtent, SourceExtent) - 1;
+      float Depth = 0;
+
+      for (int y = First.y; y <= Last.y; y++)
+        for (int x = First.x; x <= Last.x; x++)
+          Depth = max(Depth, texelFetch(Source, ivec2(x, y), 0).r);
+
+      imageStore(Destination, Texel, vec4(Depth));
+    }
+  )";
+
+  /**
+   * @brief Compute pipeline creation function
+   * @param Device Device to create pipeline on
+   * @param Layout Pipeline layout
+   * @param Name Shader name (for compilation errors)
+   * @param Source GLSL compute shader source
+   * @return Created pipeline
+  */
+  static vk::Pipeline CreateComputePipeline( vk::Device Device, vk::PipelineLayout Layout, const CHAR *Name, const CHAR *Source )
+  {
+    shaderc::Compiler Compiler;
+    shaderc::CompileOptions Options;
+
+    Options.SetOptimizationLevel(shaderc_optimization_level_performance);
+    Options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_3);
+
+    shaderc::SpvCompilationResult Compiled = Compiler.CompileGlslToSpv(Source, shaderc_compute_shader, Name, Options);
+    if (Compiled.GetCompilationStatus() != shaderc_compilation_status_success)
+      throw std::runtime_error(Compiled.GetErrorMessage());
+
+    std::vector<UINT32> SPV(Compiled.cbegin(), Compiled.cend());
+    vk::ShaderModule Module = Device.createShaderModule(vk::ShaderModuleCreateInfo().setCode(SPV));
+
+    vk::Result PipelineCreateResult;
+    vk::Pipeline Pipeline;
+    std::tie(PipelineCreateResult, Pipeline) = Device.createComputePipeline(nullptr, vk::ComputePipelineCreateInfo()
+      .setStage(vk::PipelineShaderStageCreateInfo()
+        .setStage(vk::ShaderStageFlagBits::eCompute)
+        .setModule(Module)
+        .setPName("main")
+      )
+      .setLayout(Layout)
+    );
+
+    Device.destroyShaderModule(Module);
+
+    if (PipelineCreateResult != vk::Result::eSuccess)
+      vk::detail::throwResultException(PipelineCreateResult, "createComputePipeline");
+    return Pipeline;
+  } /* CreateComputePipeline */
+
+  /**
+   * @brief Buffer queue family ownership transfer recording function. Release is recorded on source queue, acquire - on destination one.
+   * @param CommandBuffer Command buffer to record barrier to
+   * @param Buffers Buffers to transfer, empty ones are skipped
+   * @param SrcQueueFamilyIndex Releasing queue family
+   * @param DstQueueFamilyIndex Acquiring queue family
+   * @param SrcStage Source stages (top of pipe for acquire)
+   * @param SrcAccess Source accesses (empty for acquire)
+   * @param DstStage Destination stages (bottom of pipe for release)
+   * @param DstAccess Destination accesses (empty for release)
+  */
+  static VOID RecordBufferOwnershipTransfer( vk::CommandBuffer CommandBuffer, std::span<const vk::Buffer> Buffers, UINT32 SrcQueueFamilyIndex, UINT32 DstQueueFamilyIndex,
+                                             vk::PipelineStageFlags SrcStage, vk::AccessFlags SrcAccess, vk::PipelineStageFlags DstStage, vk::AccessFlags DstAccess )
+  {
+    std::vector<vk::BufferMemoryBarrier> Barriers;
+
+    for (vk::Buffer Buffer : Buffers)
+      if (Buffer)
+        Barriers.push_back(vk::BufferMemoryBarrier()
+          .setBuffer(Buffer)
+          .setOffset(0)
+          .setSize(VK_WHOLE_SIZE)
+          .setSrcAccessMask(SrcAccess)
+          .setDstAccessMask(DstAccess)
+          .setSrcQueueFamilyIndex(SrcQueueFamilyIndex)
+          .setDstQueueFamilyIndex(DstQueueFamilyIndex)
+        );
+    if (!Barriers.empty())
+      CommandBuffer.pipelineBarrier(SrcStage, DstStage, {}, {}, Barriers, {});
+  } /* RecordBufferOwnershipTransfer */
+
+  /**
+   * @brief GPU culling resources initialization function
+  */
+  VOID system::InitGpuCulling( VOID )
+  {
+    // Compute queue may be from dedicated family, then culling buffers and depth pyramid are transferred between families every frame
+    ComputeCommandPool = Device.createCommandPool(vk::CommandPoolCreateInfo()
+      .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer)
+      .setQueueFamilyIndex(ComputeQueueFamilyIndex)
+    );
+    std::vector<vk::CommandBuffer> CullingCommandBuffers = Device.allocateCommandBuffers(vk::CommandBufferAllocateInfo()
+      .setCommandPool(ComputeCommandPool)
+      .setCommandBufferCount(FRAMES_IN_FLIGHT)
+    );
+    for (UINT32 Slot = 0; Slot < FRAMES_IN_FLIGHT; Slot++)
+      FrameSlots[Slot].CullingCommandBuffer = CullingCommandBuffers[Slot];
+
+    CullingFinishedSemaphore = Device.createSemaphore(vk::SemaphoreCreateInfo());
+    DepthPyramidReadySemaphore = Device.createSemaphore(vk::SemaphoreCreateInfo());
+
+    DepthPyramidSampler = Device.createSampler(vk::SamplerCreateInfo()
+      .setMinFilter(vk::Filter::eNearest)
+      .setMagFilter(vk::Filter::eNearest)
+      .setMipmapMode(vk::SamplerMipmapMode::eNearest)
+      .setAddressModeU(vk::SamplerAddressMode::eClampToEdge)
+      .setAddressModeV(vk::SamplerAddressMode::eClampToEdge)
+      .setMaxLod(VK_LOD_CLAMP_NONE)
+    );
+
+    vk::DescriptorSetLayoutBinding CullingBindings[]
+    {
+      {0, vk::DescriptorType::eUniformBuffer,        1, vk::ShaderStageFlagBits::eCompute}, // Params
+      {1, vk::DescriptorType::eStorageBuffer,        1, vk::ShaderStageFlagBits::eCompute}, // Instances
+      {2, vk::DescriptorType::eStorageBuffer,        1, vk::ShaderStageFlagBits::eCompute}, // Draws
+      {3, vk::DescriptorType::eStorageBuffer,        1, vk::ShaderStageFlagBits::eCompute}, // Indirect commands
+      {4, vk::DescriptorType::eStorageBuffer,        1, vk::ShaderStageFlagBits::eCompute}, // Visible instances
+      {5, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute}, // Depth pyramid
+      {6, vk::DescriptorType::eStorageBuffer,        1, vk::ShaderStageFlagBits::eCompute}, // Instance levels of detail
+      {7, vk::DescriptorType::eStorageBuffer,        1, vk::ShaderStageFlagBits::eCompute}, // Packed rigid instance transforms
+    };
+    vk::DescriptorSetLayoutBinding DepthPyramidBindings[]
+    {
+      {0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute}, // Source level
+      {1, vk::DescriptorType::eStorageImage,         1, vk::ShaderStageFlagBits::eCompute}, // Destination level
+    };
+    CullingDescriptorSetLayout = Device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo().setBindings(CullingBindings));
+    DepthPyramidDescriptorSetLayout = Device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo().setBindings(DepthPyramidBindings));
+
+    vk::PushConstantRange DepthPyramidPushConstantRange {vk::ShaderStageFlagBits::eCompute, 0, sizeof(UINT32) * 4};
+
+    CullingPipelineLayout = Device.createPipelineLayout(vk::PipelineLayoutCreateInfo()
+      .setSetLayouts(CullingDescriptorSetLayout)
+    );
+    DepthPyramidPipelineLayout = Device.createPipelineLayout(vk::PipelineLayoutCreateInfo()
+      .setSetLayouts(DepthPyramidDescriptorSetLayout)
+      .setPushConstantRanges(DepthPyramidPushConstantRange)
+    );
+
+    CullingPipeline = CreateComputePipeline(Device, CullingPipelineLayout, "culling.comp", CullingShaderSource);
+    DepthPyramidPipeline = CreateComputePipeline(Device, DepthPyramidPipelineLayout, "depth_pyramid.comp", DepthPyramidShaderSource);
+
+    vk::DescriptorPoolSize PoolSizes[]
+    {
+      {vk::DescriptorType::eUniformBuffer,        FRAMES_IN_FLIGHT},
+      {vk::DescriptorType::eStorageBuffer,        6 * FRAMES_IN_FLIGHT},
+      {vk::DescriptorType::eCombinedImageSampler, FRAMES_IN_FLIGHT + DEPTH_PYRAMID_MAX_MIP_COUNT},
+      {vk::DescriptorType::eStorageImage,         DEPTH_PYRAMID_MAX_MIP_COUNT},
+    };
+    CullingDescriptorPool = Device.createDescriptorPool(vk::DescriptorPoolCreateInfo()
+      .setMaxSets(FRAMES_IN_FLIGHT + DEPTH_PYRAMID_MAX_MIP_COUNT)
+      .setPoolSizes(PoolSizes)
+    );
+
+    // Every frame in flight culls to its own buffers
+    for (frame_slot &Slot : FrameSlots)
+    {
+      Slot.CullingDescriptorSet = Device.allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
+        .setDescriptorPool(CullingDescriptorPool)
+        .setSetLayouts(CullingDescriptorSetLayout)
+      )[0];
+      ReserveGpuCullingBuffer(Slot.CullingParamsBuffer, sizeof(gpu_culling_params), vk::BufferUsageFlagBits::eUniformBuffer, TRUE);
+    }
+
+    std::vector<vk::DescriptorSetLayout> DepthPyramidSetLayouts(DEPTH_PYRAMID_MAX_MIP_COUNT, DepthPyramidDescriptorSetLayout);
+    std::vector<vk::DescriptorSet> DepthPyramidSets = Device.allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
+      .setDescriptorPool(CullingDescriptorPool)
+      .setSetLayouts(DepthPyramidSetLayouts)
+    );
+    std::ranges::copy(DepthPyramidSets, DepthPyramidDescriptorSets);
+  } /* InitGpuCulling */
+
+  /**
+   * @brief GPU culling resources destroy function
+  */
+  VOID system::DestroyGpuCulling( VOID )
+  {
+    DestroyDepthPyramid();
+
+    for (frame_slot &Slot : FrameSlots)
+      for (gpu_culling_buffer *Buffer : {&Slot.CullingParamsBuffer, &Slot.CullingInstanceBuffer, &Slot.CullingRigidBuffer, &Slot.CullingDrawBuffer, &Slot.IndirectCommandBuffer, &Slot.VisibleInstanceBuffer})
+        if (Buffer->Allocation != nullptr)
+          vmaDestroyBuffer(Allocator, Buffer->Buffer, Buffer->Allocation);
+    if (InstanceLodBuffer.Allocation != nullptr)
+      vmaDestroyBuffer(Allocator, InstanceLodBuffer.Buffer, InstanceLodBuffer.Allocation);
+
+    Device.destroyDescriptorPool(CullingDescriptorPool);
+    Device.destroyPipeline(DepthPyramidPipeline);
+    Device.destroyPipeline(CullingPipeline);
+    Device.destroyPipelineLayout(DepthPyramidPipelineLayout);
+    Device.destroyPipelineLayout(CullingPipelineLayout);
+    Device.destroyDescriptorSetLayout(DepthPyramidDescriptorSetLayout);
+    Device.destroyDescriptorSetLayout(CullingDescriptorSetLayout);
+    Device.destroySampler(DepthPyramidSampler);
+
+    Device.destroySemaphore(DepthPyramidReadySemaphore);
+    Device.destroySemaphore(CullingFinishedSemaphore);
+    Device.destroyCommandPool(ComputeCommandPool);
+  } /* DestroyGpuCulling */
+
+  /**
+   * @brief Depth pyramid (re)creation function, called from render thread, if output extent or depth attachment changed
+  */
+  VOID system::InitDepthPyramid( VOID )
+  {
+    // Power of 2 level 0 makes every next level exact 2x2 reduction
+    DepthPyramidExtent = vk::Extent2D(std::bit_floor(SwapchainImageExtent.width), std::bit_floor(SwapchainImageExtent.height));
+    DepthPyramidMipCount = std::min((UINT32)std::bit_width(std::max(DepthPyramidExtent.width, DepthPyramidExtent.height)), DEPTH_PYRAMID_MAX_MIP_COUNT);
+
+    VkImageCreateInfo ImageCreateInfo = vk::ImageCreateInfo()
+      .setExtent(vk::Extent3D(DepthPyramidExtent, 1))
+      .setFormat(vk::Format::eR32Sfloat)
+      .setUsage(vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled)
+      .setSharingMode(vk::SharingMode::eExclusive)
+      .setImageType(vk::ImageType::e2D)
+      .setTiling(vk::ImageTiling::eOptimal)
+      .setMipLevels(DepthPyramidMipCount)
+      .setArrayLayers(1)
+      ;
+    VmaAllocationCreateInfo AllocationCreateInfo
+    {
+      .usage = VMA_MEMORY_USAGE_GPU_ONLY,
+    };
+
+    VkImage CImage;
+    if (auto Result = vmaCreateImage(Allocator, &ImageCreateInfo, &AllocationCreateInfo, &CImage, &DepthPyramid.Allocation, nullptr); Result != VK_SUCCESS)
+      vk::detail::throwResultException(vk::Result(Result), "vmaCreateImage");
+    DepthPyramid.Image = CImage;
+
+    auto CreateView = [&]( UINT32 BaseMipLevel, UINT32 MipLevelCount )
+    {
+      return Device.createImageView(vk::ImageViewCreateInfo()
+        .setFormat(vk::Format::eR32Sfloat)
+        .setImage(DepthPyramid.Image)
+        .setViewType(vk::ImageViewType::e2D)
+        .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, BaseMipLevel, MipLevelCount, 0, 1))
+      );
+    };
+
+    DepthPyramid.View = CreateView(0, DepthPyramidMipCount);
+    for (UINT32 Level = 0; Level < DepthPyramidMipCount; Level++)
+      DepthPyramidMipViews[Level] = CreateView(Level, 1);
+
+    // Every level is built from previous one, level 0 - from depth attachment
+    vk::DescriptorImageInfo ImageInfos[DEPTH_PYRAMID_MAX_MIP_COUNT][2];
+    vk::WriteDescriptorSet Writes[DEPTH_PYRAMID_MAX_MIP_COUNT * 2];
+
+    for (UINT32 Level = 0; Level < DepthPyramidMipCount; Level++)
+    {
+      ImageInfos[Level][0] = vk::DescriptorImageInfo(DepthPyramidSampler,
+        Level == 0 ? RenderGraph->GetImageView(Depth) : DepthPyramidMipViews[Level - 1],
+        Level == 0 ? vk::ImageLayout::eShaderReadOnlyOptimal : vk::ImageLayout::eGeneral);
+      ImageInfos[Level][1] = vk::DescriptorImageInfo(nullptr, DepthPyramidMipViews[Level], vk::ImageLayout::eGeneral);
+
+      Writes[Level * 2 + 0] = vk::WriteDescriptorSet()
+        .setDstSet(DepthPyramidDescriptorSets[Level])
+        .setDstBinding(0)
+        .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+        .setImageInfo(ImageInfos[Level][0]);
+      Writes[Level * 2 + 1] = vk::WriteDescriptorSet()
+        .setDstSet(DepthPyramidDescriptorSets[Level])
+        .setDstBinding(1)
+        .setDescriptorType(vk::DescriptorType::eStorageImage)
+        .setImageInfo(ImageInfos[Level][1]);
+    }
+    Device.updateDescriptorSets(vk::ArrayProxy<const vk::WriteDescriptorSet>(DepthPyramidMipCount * 2, Writes), {});
+
+    DepthPyramidSourceView = RenderGraph->GetImageView(Depth);
+    IsDepthPyramidValid = FALSE;
+  } /* InitDepthPyramid */
+
+  /**
+   * @brief Depth pyramid destroy function
+  */
+  VOID system::DestroyDepthPyramid( VOID )
+  {
+    if (!DepthPyramid.Image)
+      return;
+
+    for (UINT32 Level = 0; Level < DepthPyramidMipCount; Level++)
+      Device.destroyImageView(DepthPyramidMipViews[Level]);
+    Device.destroyImageView(DepthPyramid.View);
+    vmaDestroyImage(Allocator, DepthPyramid.Image, DepthPyramid.Allocation);
+
+    DepthPyramid = attachment_image {};
+    DepthPyramidMipCount = 0;
+    IsDepthPyramidValid = FALSE;
+  } /* DestroyDepthPyramid */
+
+  /**
+   * @brief GPU culling buffer capacity ensuring function
+   * @param Buffer Buffer to (re)allocate
+   * @param Size Required buffer size
+   * @param Usage Buffer usage
+   * @param IsHostVisible Buffer must be persistently mapped
+   * @return TRUE if buffer is reallocated, so descriptor set must be updated
+  */
+  BOOL system::ReserveGpuCullingBuffer( gpu_culling_buffer &Buffer, SIZE_T Size, vk::BufferUsageFlags Usage, BOOL IsHostVisible )
+  {
+    if (Buffer.Size >= Size)
+      return FALSE;
+
+    // Instance count changes often, so buffers grow geometrically
+    SIZE_T AllocationSize = std::max(Size, Buffer.Size * 2);
+
+    if (Buffer.Allocation != nullptr)
+      DeferDestroy([this, OldBuffer = Buffer.Buffer, OldAllocation = Buffer.Allocation]( VOID )
+        {
+          vmaDestroyBuffer(Allocator, OldBuffer, OldAllocation);
+        });
+    Buffer = gpu_culling_buffer {};
+
+    VkBufferCreateInfo BufferCreateInfo = vk::BufferCreateInfo()
+      .setSize(AllocationSize)
+      .setUsage(Usage)
+      .setSharingMode(vk::SharingMode::eExclusive)
+      ;
+    VmaAllocationCreateInfo AllocationCreateInfo
+    {
+      .usage = VMA_MEMORY_USAGE_AUTO,
+    };
+    if (IsHostVisible)
+      AllocationCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    VkBuffer CBuffer;
+    VmaAllocationInfo AllocationInfo;
+    if (auto Result = vmaCreateBuffer(Allocator, &BufferCreateInfo, &AllocationCreateInfo, &CBuffer, &Buffer.Allocation, &AllocationInfo); Result != VK_SUCCESS)
+      vk::detail::throwResultException(vk::Result(Result), "vmaCreateBuffer");
+
+    Buffer.Buffer = CBuffer;
+    Buffer.Data = IsHostVisible ? AllocationInfo.pMappedData : nullptr;
+    Buffer.Size = AllocationSize;
+    return TRUE;
+  } /* ReserveGpuCullingBuffer */
+
+  /**
+   * @brief Culling pass submission function, called from render thread before frame recording.
+   *        Assigns indirect draw indices to indexed primitives and submits culling pass to compute queue, frame must wait for CullingFinishedSemaphore.
+   *        Levels of detail of instances are selected by culling pass, every level is drawn by separate indirect command.
+   *        Only transforms, changed after last upload to frame slot buffer, are uploaded.
+   * @param Frustum Frustum to cull by, nullptr to treat all instances as visible
+   * @param ViewProjection View projection matrix, frustum is built from
+   * @param Camera Camera, levels of detail are selected by, nullptr to use the most detailed levels
+  */
+  VOID system::SubmitGpuCulling( const math::frustum *Frustum, const mat4x4 &ViewProjection, const math::util::camera::projection_matrices *Camera )
+  {
+    frame_slot &Slot = *FrameSlot;
+
+    // Previous pass of slot is finished (its frame timeline value is waited), so its compacted instance counts may be read
+    GpuVisibleInstanceCount = 0;
+    GpuVisibleIndexCount = 0;
+    if (Slot.GpuCullingDrawCount != 0)
+    {
+      vmaInvalidateAllocation(Allocator, Slot.IndirectCommandBuffer.Allocation, 0, VK_WHOLE_SIZE);
+
+      auto *Commands = reinterpret_cast<const vk::DrawIndexedIndirectCommand *>(Slot.IndirectCommandBuffer.Data);
+      for (UINT32 i = 0; i < Slot.GpuCullingDrawCount; i++)
+      {
+        GpuVisibleInstanceCount += Commands[i].instanceCount;
+        GpuVisibleIndexCount += (UINT64)Commands[i].instanceCount * Commands[i].indexCount;
+      }
+    }
+
+    // Output extent or depth attachment changed. Other frames in flight read pyramid too, so they are waited and their sets are rewritten later.
+    if (DepthPyramidSourceView != RenderGraph->GetImageView(Depth) ||
+        DepthPyramidExtent != vk::Extent2D(std::bit_floor(SwapchainImageExtent.width), std::bit_floor(SwapchainImageExtent.height)))
+    {
+      WaitTimelineValue(SubmittedTimelineValue);
+      DestroyDepthPyramid();
+      InitDepthPyramid();
+      for (frame_slot &OtherSlot : FrameSlots)
+        OtherSlot.IsCullingSetOutdated = TRUE;
+    }
+
+    BOOL IsDescriptorSetOutdated = Slot.IsCullingSetOutdated;
+
+    // Only indexed primitives are drawn indirectly. Culling pass selects level of every instance, so every level range may hold all instances.
+    UINT32 DrawCount = 0, InstanceCount = 0, VisibleInstanceCapacity = 0;
+    for (primitive *Primitive : PrimitivePool)
+      if (Primitive->IndexBuffer != nullptr && !Primitive->Instances.empty())
+      {
+        Primitive->IndirectDrawIndex = DrawCount;
+        DrawCount += (UINT32)Primitive->Lods.size();
+        InstanceCount += (UINT32)Primitive->Instances.size();
+        VisibleInstanceCapacity += (UINT32)(Primitive->Instances.size() * Primitive->Lods.size());
+      }
+      else
+        Primitive->IndirectDrawIndex = primitive::NO_INDIRECT_DRAW;
+
+    if (ReserveGpuCullingBuffer(Slot.CullingInstanceBuffer, std::max(InstanceCount, 1U) * sizeof(gpu_culling_instance),
+          vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress, TRUE) |
+        ReserveGpuCullingBuffer(Slot.CullingRigidBuffer, std::max(InstanceCount, 1U) * sizeof(math::packed_trs), vk::BufferUsageFlagBits::eStorageBuffer, TRUE))
+    {
+      Slot.CullingTriangleBits = ~0U;
+      IsDescriptorSetOutdated = TRUE;
+    }
+    IsDescriptorSetOutdated |= ReserveGpuCullingBuffer(Slot.CullingDrawBuffer, std::max(DrawCount, 1U) * sizeof(gpu_culling_draw),
+      vk::BufferUsageFlagBits::eStorageBuffer, TRUE);
+    IsDescriptorSetOutdated |= ReserveGpuCullingBuffer(Slot.IndirectCommandBuffer, std::max(DrawCount, 1U) * sizeof(vk::DrawIndexedIndirectCommand),
+      vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer, TRUE);
+    IsDescriptorSetOutdated |= ReserveGpuCullingBuffer(Slot.VisibleInstanceBuffer, std::max(VisibleInstanceCapacity, 1U) * sizeof(UINT32),
+      vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eVertexBuffer, FALSE);
+
+    // Level buffer is shared, so sets of other slots refer old buffer
+    if (ReserveGpuCullingBuffer(InstanceLodBuffer, std::max(InstanceCount, 1U) * sizeof(UINT32), vk::BufferUsageFlagBits::eStorageBuffer, FALSE))
+      for (frame_slot &OtherSlot : FrameSlots)
+        OtherSlot.IsCullingSetOutdated = TRUE;
+    IsDescriptorSetOutdated |= Slot.IsCullingSetOutdated;
+
+    if (IsDescriptorSetOutdated)
+    {
+      vk::DescriptorBufferInfo BufferInfos[]
+      {
+        {Slot.CullingParamsBuffer.Buffer,   0, VK_WHOLE_SIZE},
+        {Slot.CullingInstanceBuffer.Buffer, 0, VK_WHOLE_SIZE},
+        {Slot.CullingDrawBuffer.Buffer,     0, VK_WHOLE_SIZE},
+        {Slot.IndirectCommandBuffer.Buffer, 0, VK_WHOLE_SIZE},
+        {Slot.VisibleInstanceBuffer.Buffer, 0, VK_WHOLE_SIZE},
+        {InstanceLodBuffer.Buffer,          0, VK_WHOLE_SIZE},
+        {Slot.CullingRigidBuffer.Buffer,    0, VK_WHOLE_SIZE},
+      };
+      vk::DescriptorImageInfo DepthPyramidInfo {DepthPyramidSampler, DepthPyramid.View, vk::ImageLayout::eGeneral};
+
+      vk::WriteDescriptorSet Writes[10];
+      for (UINT32 Binding = 0; Binding < 5; Binding++)
+        Writes[Binding] = vk::WriteDescriptorSet()
+          .setDstSet(Slot.CullingDescriptorSet)
+          .setDstBinding(Binding)
+          .setDescriptorType(Binding == 0 ? vk::DescriptorType::eUniformBuffer : vk::DescriptorType::eStorageBuffer)
+          .setBufferInfo(BufferInfos[Binding]);
+      Writes[5] = vk::WriteDescriptorSet()
+        .setDstSet(Slot.CullingDescriptorSet)
+        .setDstBinding(5)
+        .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+        .setImageInfo(DepthPyramidInfo);
+      for (UINT32 Binding = 6; Binding < 8; Binding++)
+        Writes[Binding] = vk::WriteDescriptorSet()
+          .setDstSet(Slot.CullingDescriptorSet)
+          .setDstBinding(Binding)
+          .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+          .setBufferInfo(BufferInfos[Binding - 1]);
+
+      // Draws of culled primitives read instances and their compacted indices
+      for (UINT32 Binding = 0; Binding < 2; Binding++)
+        Writes[8 + Binding] = vk::WriteDescriptorSet()
+          .setDstSet(Slot.GpuDrawInstanceSet)
+          .setDstBinding(Binding)
+          .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+          .setBufferInfo(BufferInfos[Binding == 0 ? 1 : 4]);
+
+      Device.updateDescriptorSets(Writes, {});
+      Slot.IsCullingSetOutdated = FALSE;
+    }
+
+    // Fill draws and commands, they are small and instance counts are reset every pass
+    auto *Instances = reinterpret_cast<gpu_culling_instance *>(Slot.CullingInstanceBuffer.Data);
+    auto *Draws = reinterpret_cast<gpu_culling_draw *>(Slot.CullingDrawBuffer.Data);
+    auto *Commands = reinterpret_cast<vk::DrawIndexedIndirectCommand *>(Slot.IndirectCommandBuffer.Data);
+    auto *RigidTransforms = reinterpret_cast<math::packed_trs *>(Slot.CullingRigidBuffer.Data);
+    const UINT32 SlotIndex = (UINT32)(FrameSlot - FrameSlots);
+    UINT32 FirstInstance = 0, FirstVisibleInstance = 0, FirstChanged = InstanceCount, ChangedEnd = 0, FirstRigidChanged = InstanceCount, RigidChangedEnd = 0;
+
+    // Instance copy of slot is kept between its frames, so only instances, changed after its last upload, are written
+    const BOOL IsInstanceBufferOutdated = Slot.CullingTriangleBits != VisibilityTriangleBits;
+    Slot.CullingTriangleBits = VisibilityTriangleBits;
+
+    SceneBvhMutex.lock();
+    for (primitive *Primitive : PrimitivePool)
+    {
+      if (Primitive->IndirectDrawIndex == primitive::NO_INDIRECT_DRAW)
+        continue;
+
+      const UINT32 FirstDrawIndex = Primitive->IndirectDrawIndex, LodCount = (UINT32)Primitive->Lods.size(), PrimitiveInstanceCount = (UINT32)Primitive->Instances.size();
+
+      for (UINT32 Lod = 0; Lod < LodCount; Lod++)
+      {
+        const primitive::lod &Level = Primitive->Lods[Lod];
+        gpu_culling_draw &Draw = Draws[FirstDrawIndex + Lod];
+
+        if (Primitive->Bounds.has_value())
+          for (UINT32 i = 0; i < 3; i++)
+          {
+            Draw.Center[i] = (Primitive->Bounds->Min.Array[i] + Primitive->Bounds->Max.Array[i]) * 0.5F;
+            Draw.Extent[i] = (Primitive->Bounds->Max.Array[i] - Primitive->Bounds->Min.Array[i]) * 0.5F;
+          }
+        Draw.IsCulled = Primitive->Bounds.has_value();
+        Draw.FirstInstance = FirstVisibleInstance;
+        Draw.MinScreenSize = Level.MinScreenSize;
+        Draw.LodHysteresis = Primitive->LodHysteresis;
+        Draw.LodCount = LodCount;
+        Draw.IsRigid = Primitive->IsRigid;
+
+        // Instance count is accumulated by culling pass
+        Commands[FirstDrawIndex + Lod] = vk::DrawIndexedIndirectCommand(Level.IndexCount, 0, Level.FirstIndex, Level.VertexOffset, FirstVisibleInstance);
+        FirstVisibleInstance += PrimitiveInstanceCount;
+      }
+
+      // Moved range (instances of previous primitives are created or destroyed) is rewritten fully
+      if (Primitive->InstanceUploads.size() != FRAMES_IN_FLIGHT)
+        Primitive->InstanceUploads.resize(FRAMES_IN_FLIGHT);
+      primitive::instance_upload &Upload = Primitive->InstanceUploads[SlotIndex];
+      UINT32 UploadFirst = std::min(Upload.ChangedFirst, PrimitiveInstanceCount), UploadEnd = std::min(Upload.ChangedEnd, PrimitiveInstanceCount);
+
+      const BOOL IsFullUpload = IsInstanceBufferOutdated || Upload.FirstInstance != FirstInstance || Upload.FirstDrawIndex != FirstDrawIndex;
+      if (IsFullUpload)
+        UploadFirst = 0, UploadEnd = PrimitiveInstanceCount;
+      Upload = primitive::instance_upload {.FirstInstance = FirstInstance, .FirstDrawIndex = FirstDrawIndex};
+
+      if (Primitive->IsRigid)
+      {
+        // Culling pass expands packed transforms to instance matrices, so only their draw indices are written, when range moves
+        for (UINT32 Index = UploadFirst; Index < UploadEnd; Index++)
+          RigidTransforms[FirstInstance + Index] = ftrs::FromMatrix(Primitive->Transforms[Index]).Packed();
+        if (UploadFirst < UploadEnd)
+        {
+          FirstRigidChanged = std::min(FirstRigidChanged, FirstInstance + UploadFirst);
+          RigidChangedEnd = std::max(RigidChangedEnd, FirstInstance + UploadEnd);
+        }
+        if (!IsFullUpload)
+          UploadEnd = UploadFirst;
+
+        for (UINT32 Index = UploadFirst; Index < UploadEnd; Index++)
+        {
+          gpu_culling_instance &Instance = Instances[FirstInstance + Index];
+
+          Instance.DrawIndex = FirstDrawIndex;
+          Instance.VisibilityID = GetVisibilityId(FirstInstance + Index);
+          Instance.FirstDrawIndex = FirstDrawIndex;
+        }
+      }
+      else
+        for (UINT32 Index = UploadFirst; Index < UploadEnd; Index++)
+          Instances[FirstInstance + Index] = gpu_culling_instance
+          {
+            .Transform = Primitive->Transforms[Index],
+            .DrawIndex = FirstDrawIndex,
+            .VisibilityID = GetVisibilityId(FirstInstance + Index),
+            .FirstDrawIndex = FirstDrawIndex,
+          };
+      if (UploadFirst < UploadEnd)
+      {
+        FirstChanged = std::min(FirstChanged, FirstInstance + UploadFirst);
+        ChangedEnd = std::max(ChangedEnd, FirstInstance + UploadEnd);
+      }
+      FirstInstance += PrimitiveInstanceCount;
+    }
+    SceneBvhMutex.unlock();
+
+    // Levels are selected by projected size of world space box, as primitive::SelectLod does
+    auto *Params = reinterpret_cast<gpu_culling_params *>(Slot.CullingParamsBuffer.Data);
+    Params->DepthPyramidViewProjection = DepthPyramidViewProjection;
+    for (UINT32 Plane = 0; Plane < math::frustum::_eCount; Plane++)
+      for (UINT32 i = 0; i < 4; i++)
+        Params->Planes[Plane][i] = Frustum != nullptr ? Frustum->Planes[Plane].Array[i] : 0;
+    Params->InstanceCount = InstanceCount;
+    Params->IsFrustumCulled = Frustum != nullptr;
+    Params->IsOcclusionCulled = Frustum != nullptr && IsDepthPyramidValid;
+    Params->DepthPyramidMipCount = DepthPyramidMipCount;
+    Params->DepthPyramidExtent[0] = (FLOAT)DepthPyramidExtent.width;
+    Params->DepthPyramidExtent[1] = (FLOAT)DepthPyramidExtent.height;
+    Params->LodMode = GPU_LOD_MODE_NONE;
+    if (Camera != nullptr)
+    {
+      Params->LodMode = Camera->Projection.Data[3][3] != 0 ? GPU_LOD_MODE_ORTHOGRAPHIC : GPU_LOD_MODE_PERSPECTIVE;
+      Params->LodProjectionScale = std::abs(Camera->Projection.Data[1][1]);
+      for (UINT32 i = 0; i < 4; i++)
+        Params->LodViewDepth[i] = Camera->View.Data[i][2];
+    }
+
+    for (gpu_culling_buffer *Buffer : {&Slot.CullingParamsBuffer, &Slot.CullingDrawBuffer, &Slot.IndirectCommandBuffer})
+      vmaFlushAllocation(Allocator, Buffer->Allocation, 0, VK_WHOLE_SIZE);
+    if (FirstChanged < ChangedEnd)
+      vmaFlushAllocation(Allocator, Slot.CullingInstanceBuffer.Allocation, FirstChanged * sizeof(gpu_culling_instance), (ChangedEnd - FirstChanged) * sizeof(gpu_culling_instance));
+    if (FirstRigidChanged < RigidChangedEnd)
+      vmaFlushAllocation(Allocator, Slot.CullingRigidBuffer.Allocation, FirstRigidChanged * sizeof(math::packed_trs), (RigidChangedEnd - FirstRigidChanged) * sizeof(math::packed_trs));
+
+    // Record culling pass
+    const vk::CommandBuffer CullingCommandBuffer = Slot.CullingCommandBuffer;
+    const BOOL IsComputeFamilyDedicated = ComputeQueueFamilyIndex != GraphicsQueueFamilyIndex;
+    const vk::Buffer TransferredBuffers[] {Slot.CullingInstanceBuffer.Buffer, Slot.IndirectCommandBuffer.Buffer, Slot.VisibleInstanceBuffer.Buffer};
+    BOOL IsReleaseWaited = FALSE;
+
+    CullingCommandBuffer.reset();
+    CullingCommandBuffer.begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+
+    if (IsComputeFamilyDedicated)
+    {
+      // Buffers, released by previous frame of slot, are acquired back (reallocated ones have no owner yet)
+      vk::Buffer AcquiredBuffers[std::size(TransferredBuffers)];
+      for (UINT32 i = 0; i < std::size(TransferredBuffers); i++)
+        if (std::ranges::find(Slot.CullingReleasedBuffers, TransferredBuffers[i]) != std::end(Slot.CullingReleasedBuffers))
+        {
+          AcquiredBuffers[i] = TransferredBuffers[i];
+          IsReleaseWaited = TRUE;
+        }
+      std::ranges::fill(Slot.CullingReleasedBuffers, vk::Buffer());
+      RecordBufferOwnershipTransfer(CullingCommandBuffer, AcquiredBuffers, GraphicsQueueFamilyIndex, ComputeQueueFamilyIndex,
+        vk::PipelineStageFlagBits::eTopOfPipe, {}, vk::PipelineStageFlagBits::eComputeShader, vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+
+      // Pyramid is released by graphics queue after building, its previous contents are never needed, so it isn't returned
+      if (IsDepthPyramidSignaled)
+        CullingCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eComputeShader, {}, {}, {},
+          vk::ImageMemoryBarrier()
+            .setImage(DepthPyramid.Image)
+            .setOldLayout(vk::ImageLayout::eGeneral)
+            .setNewLayout(vk::ImageLayout::eGeneral)
+            .setDstAccessMask(vk::AccessFlagBits::eShaderRead)
+            .setSrcQueueFamilyIndex(GraphicsQueueFamilyIndex)
+            .setDstQueueFamilyIndex(ComputeQueueFamilyIndex)
+            .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, DepthPyramidMipCount, 0, 1))
+        );
+    }
+
+    if (InstanceCount != 0)
+    {
+      // Levels of detail of previous pass are read for hysteresis
+      vk::MemoryBarrier LodBarrier = vk::MemoryBarrier()
+        .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+      CullingCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, {}, LodBarrier, {}, {});
+
+      CullingCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, CullingPipeline);
+      CullingCommandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, CullingPipelineLayout, 0, Slot.CullingDescriptorSet, {});
+      CullingCommandBuffer.dispatch((InstanceCount + GPU_CULLING_GROUP_SIZE - 1) / GPU_CULLING_GROUP_SIZE, 1, 1);
+    }
+
+    // Make visible instance counts available for statistics
+    vk::MemoryBarrier ToHostBarrier = vk::MemoryBarrier()
+      .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+      .setDstAccessMask(vk::AccessFlagBits::eHostRead);
+    CullingCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eHost, {}, ToHostBarrier, {}, {});
+
+    // Graphics queue acquires buffers by RecordCullingAcquire
+    if (IsComputeFamilyDedicated)
+      RecordBufferOwnershipTransfer(CullingCommandBuffer, TransferredBuffers, ComputeQueueFamilyIndex, GraphicsQueueFamilyIndex,
+        vk::PipelineStageFlagBits::eComputeShader, vk::AccessFlagBits::eShaderWrite, vk::PipelineStageFlagBits::eBottomOfPipe, {});
+
+    CullingCommandBuffer.end();
+
+    // Depth pyramid of previous frame is built by graphics queue. Release of acquired buffers is in previous frame of slot, which is finished, so its wait doesn't block.
+    vk::Semaphore WaitSemaphores[2];
+    vk::PipelineStageFlags WaitStageMasks[2];
+    UINT64 WaitValues[2] {};
+    UINT32 WaitSemaphoreCount = 0;
+
+    if (IsDepthPyramidSignaled)
+    {
+      WaitSemaphores[WaitSemaphoreCount] = DepthPyramidReadySemaphore;
+      WaitStageMasks[WaitSemaphoreCount++] = vk::PipelineStageFlagBits::eComputeShader;
+    }
+    if (IsReleaseWaited)
+    {
+      WaitValues[WaitSemaphoreCount] = Slot.TimelineValue;
+      WaitSemaphores[WaitSemaphoreCount] = TimelineSemaphore;
+      WaitStageMasks[WaitSemaphoreCount++] = vk::PipelineStageFlagBits::eComputeShader;
+    }
+
+    vk::TimelineSemaphoreSubmitInfo TimelineSubmitInfo = vk::TimelineSemaphoreSubmitInfo()
+      .setWaitSemaphoreValueCount(WaitSemaphoreCount)
+      .setPWaitSemaphoreValues(WaitValues)
+      ;
+    ComputeQueue.submit(vk::SubmitInfo()
+      .setPNext(&TimelineSubmitInfo)
+      .setCommandBuffers(CullingCommandBuffer)
+      .setWaitSemaphoreCount(WaitSemaphoreCount)
+      .setPWaitSemaphores(WaitSemaphores)
+      .setPWaitDstStageMask(WaitStageMasks)
+      .setSignalSemaphores(CullingFinishedSemaphore)
+    );
+    IsDepthPyramidSignaled = FALSE;
+    Slot.GpuCullingDrawCount = DrawCount;
+  } /* SubmitGpuCulling */
+
+  /**
+   * @brief Depth pyramid building recording function, called from render graph depth pyramid pass. Graph transitions depth image.
+   * @param CommandBuffer Command buffer to record pyramid building to
+   * @param Frustum Frustum, frame is culled by. Depth pyramid is used for occlusion culling in next frame only if it's not nullptr.
+   * @param ViewProjection View projection matrix, frustum is built from
+  */
+  VOID system::RecordDepthPyramid( vk::CommandBuffer CommandBuffer, const math::frustum *Frustum, const mat4x4 &ViewProjection )
+  {
+    // Depth is transitioned by graph, pyramid is fully rewritten after previous frame building
+    CommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, {}, {}, {},
+      vk::ImageMemoryBarrier()
+        .setImage(DepthPyramid.Image)
+        .setOldLayout(vk::ImageLayout::eUndefined)
+        .setNewLayout(vk::ImageLayout::eGeneral)
+        .setDstAccessMask(vk::AccessFlagBits::eShaderWrite)
+        .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, DepthPyramidMipCount, 0, 1))
+    );
+
+    CommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, DepthPyramidPipeline);
+
+    vk::Extent2D SourceExtent = SwapchainImageExtent;
+    for (UINT32 Level = 0; Level < DepthPyramidMipCount; Level++)
+    {
+      vk::Extent2D LevelExtent(std::max(DepthPyramidExtent.width >> Level, 1U), std::max(DepthPyramidExtent.height >> Level, 1U));
+      UINT32 Extents[4] {SourceExtent.width, SourceExtent.height, LevelExtent.width, LevelExtent.height};
+
+      CommandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, DepthPyramidPipelineLayout, 0, DepthPyramidDescriptorSets[Level], {});
+      CommandBuffer.pushConstants(DepthPyramidPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(Extents), Extents);
+      CommandBuffer.dispatch(
+        (LevelExtent.width + DEPTH_PYRAMID_GROUP_SIZE - 1) / DEPTH_PYRAMID_GROUP_SIZE,
+        (LevelExtent.height + DEPTH_PYRAMID_GROUP_SIZE - 1) / DEPTH_PYRAMID_GROUP_SIZE,
+        1
+      );
+
+      // Level is read by next level building and by next frame culling pass
+      CommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, {}, {}, {},
+        vk::ImageMemoryBarrier()
+          .setImage(DepthPyramid.Image)
+          .setOldLayout(vk::ImageLayout::eGeneral)
+          .setNewLayout(vk::ImageLayout::eGeneral)
+          .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+          .setDstAccessMask(vk::AccessFlagBits::eShaderRead)
+          .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, Level, 1, 0, 1))
+      );
+
+      SourceExtent = LevelExtent;
+    }
+
+    // Next frame culling pass acquires pyramid
+    if (ComputeQueueFamilyIndex != GraphicsQueueFamilyIndex)
+      CommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, {},
+        vk::ImageMemoryBarrier()
+          .setImage(DepthPyramid.Image)
+          .setOldLayout(vk::ImageLayout::eGeneral)
+          .setNewLayout(vk::ImageLayout::eGeneral)
+          .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+          .setSrcQueueFamilyIndex(GraphicsQueueFamilyIndex)
+          .setDstQueueFamilyIndex(ComputeQueueFamilyIndex)
+          .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, DepthPyramidMipCount, 0, 1))
+      );
+
+    // Occlusion test reprojects boxes by matrix, depth was rendered with
+    IsDepthPyramidValid = Frustum != nullptr;
+    DepthPyramidViewProjection = ViewProjection;
+  } /* RecordDepthPyramid */
+
+  /**
+   * @brief Culling buffers acquisition by graphics queue family recording function. Does nothing if compute queue is taken from graphics family.
+   * @param CommandBuffer Graphics command buffer to record acquire barriers to, before culled draws
+  */
+  VOID system::RecordCullingAcquire( vk::CommandBuffer CommandBuffer )
+  {
+    if (ComputeQueueFamilyIndex == GraphicsQueueFamilyIndex)
+      return;
+
+    // Visible instances are read as vertex buffer, instances - by vertex and (visibility layout) shading shaders
+    const vk::Buffer Buffers[] {FrameSlot->CullingInstanceBuffer.Buffer, FrameSlot->IndirectCommandBuffer.Buffer, FrameSlot->VisibleInstanceBuffer.Buffer};
+    RecordBufferOwnershipTransfer(CommandBuffer, Buffers, ComputeQueueFamilyIndex, GraphicsQueueFamilyIndex,
+      vk::PipelineStageFlagBits::eTopOfPipe, {},
+      vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eComputeShader,
+      vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eShaderRead);
+  } /* RecordCullingAcquire */
+
+  /**
+   * @brief Culling buffers release to compute queue family recording function. Does nothing if compute queue is taken from graphics family.
+   * @param CommandBuffer Graphics command buffer to record release barriers to, after culled draws and shading
+  */
+  VOID system::RecordCullingRelease( vk::CommandBuffer CommandBuffer )
+  {
+    if (ComputeQueueFamilyIndex == GraphicsQueueFamilyIndex)
+      return;
+
+    // Instance buffer keeps unchanged transforms, so buffers are returned to compute family, that acquires them in next culling pass of slot
+    const vk::Buffer Buffers[] {FrameSlot->CullingInstanceBuffer.Buffer, FrameSlot->IndirectCommandBuffer.Buffer, FrameSlot->VisibleInstanceBuffer.Buffer};
+    RecordBufferOwnershipTransfer(CommandBuffer, Buffers, GraphicsQueueFamilyIndex, ComputeQueueFamilyIndex,
+      vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eComputeShader, {},
+      vk::PipelineStageFlagBits::eBottomOfPipe, {});
+    std::ranges::copy(Buffers, FrameSlot->CullingReleasedBuffers);
+  } /* RecordCullingRelease */
+} /* namespace anv::render::core */
+
+/* file anv_render_core_gpu_culling.cpp */
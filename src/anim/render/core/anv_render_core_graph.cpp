@@ -0,0 +1,922 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/anim/render/core/anv_render_core_graph.cpp
+ * @description Render graph implementation module
+ * @last_update 18.10.2026
+*/
+
+#include "anv.h"
+
+namespace anv::render::core
+{
+  /**
+   * @brief Image access synchronization description
+  */
+  struct graph_access_info
+  {
+    vk::PipelineStageFlags2 Stages; // Accessing stages
+    vk::AccessFlags2 Access;        // Memory accesses
+    vk::ImageLayout Layout;         // Required layout
+    vk::ImageUsageFlags Usage;      // Required image usage
+    BOOL IsWrite;                   // Access writes image
+    BOOL IsAttachment;              // Access is attachment one
+  }; /* struct graph_access_info */
+
+  // Stages, that access only current framebuffer region
+  static constexpr vk::PipelineStageFlags2 FramebufferLocalStages =
+    vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eEarlyFragmentTests |
+    vk::PipelineStageFlagBits2::eLateFragmentTests | vk::PipelineStageFlagBits2::eColorAttachmentOutput;
+
+  // Accesses, that must be made available to other ones
+  static constexpr vk::AccessFlags2 WriteAccesses =
+    vk::AccessFlagBits2::eColorAttachmentWrite | vk::AccessFlagBits2::eDepthStencilAttachmentWrite |
+    vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eTransferWrite;
+
+  /**
+   * @brief Depth format checking function
+   * @param Format Vulkan format to check
+   * @return TRUE if format has depth component
+  */
+  static BOOL IsDepthFormat( vk::Format Format )
+  {
+    switch (Format)
+    {
+    case vk::Format::eD16Unorm:
+    case vk::Format::eX8D24UnormPack32:
+    case vk::Format::eD32Sfloat:
+    case vk::Format::eD16UnormS8Uint:
+    case vk::Format::eD24UnormS8Uint:
+    case vk::Format::eD32SfloatS8Uint:
+      return TRUE;
+    default:
+      return FALSE;
+    }
+  } /* IsDepthFormat */
+
+  /**
+   * @brief Format image aspect getting function
+   * @param Format Image format
+   * @return Depth and stencil aspects for depth stencil formats, depth aspect for depth ones, color aspect otherwise
+  */
+  static vk::ImageAspectFlags GetFormatAspect( vk::Format Format )
+  {
+    switch (Format)
+    {
+    case vk::Format::eD16UnormS8Uint:
+    case vk::Format::eD24UnormS8Uint:
+    case vk::Format::eD32SfloatS8Uint:
+      return vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
+    default:
+      return IsDepthFormat(Format) ? vk::ImageAspectFlagBits::eDepth : vk::ImageAspectFlagBits::eColor;
+    }
+  } /* GetFormatAspect */
+
+  /**
+   * @brief Pass image access synchronization info getting function
+   * @param Access Image access of pass
+   * @return Stages, memory accesses, layout and usage of access, whether it writes image and whether it is attachment access
+  */
+  static graph_access_info GetAccessInfo( render_graph::access Access )
+  {
+    using stage = vk::PipelineStageFlagBits2;
+    using memory = vk::AccessFlagBits2;
+    using layout = vk::ImageLayout;
+    using usage = vk::ImageUsageFlagBits;
+
+    switch (Access)
+    {
+    case render_graph::access::eColorWrite:
+      return {stage::eColorAttachmentOutput, memory::eColorAttachmentWrite | memory::eColorAttachmentRead, layout::eColorAttachmentOptimal, usage::eColorAttachment, TRUE, TRUE};
+    case render_graph::access::eDepthWrite:
+      return {stage::eEarlyFragmentTests | stage::eLateFragmentTests, memory::eDepthStencilAttachmentWrite | memory::eDepthStencilAttachmentRead, layout::eDepthStencilAttachmentOptimal, usage::eDepthStencilAttachment, TRUE, TRUE};
+    case render_graph::access::eDepthRead:
+      return {stage::eEarlyFragmentTests | stage::eLateFragmentTests, memory::eDepthStencilAttachmentRead, layout::eDepthStencilReadOnlyOptimal, usage::eDepthStencilAttachment, FALSE, TRUE};
+    case render_graph::access::eInputRead:
+      return {stage::eFragmentShader, memory::eInputAttachmentRead, layout::eShaderReadOnlyOptimal, usage::eInputAttachment, FALSE, TRUE};
+    case render_graph::access::eFragmentSampled:
+      return {stage::eFragmentShader, memory::eShaderSampledRead, layout::eShaderReadOnlyOptimal, usage::eSampled, FALSE, FALSE};
+    case render_graph::access::eComputeSampled:
+      return {stage::eComputeShader, memory::eShaderSampledRead, layout::eShaderReadOnlyOptimal, usage::eSampled, FALSE, FALSE};
+    case render_graph::access::eComputeStorage:
+      return {stage::eComputeShader, memory::eShaderStorageRead | memory::eShaderStorageWrite, layout::eGeneral, usage::eStorage, TRUE, FALSE};
+    case render_graph::access::eTransferRead:
+      return {stage::eAllTransfer, memory::eTransferRead, layout::eTransferSrcOptimal, usage::eTransferSrc, FALSE, FALSE};
+    case render_graph::access::eTransferWrite:
+      return {stage::eAllTransfer, memory::eTransferWrite, layout::eTransferDstOptimal, usage::eTransferDst, TRUE, FALSE};
+    }
+    return {};
+  } /* GetAccessInfo */
+
+  /**
+   * @brief Render graph constructor
+   * @param Device Device
+   * @param Allocator Allocator for graph images
+  */
+  render_graph::render_graph( vk::Device Device, VmaAllocator Allocator ) : Device(Device), Allocator(Allocator)
+  {
+  } /* render_graph */
+
+  /**
+   * @brief Render graph destructor. Graph images mustn't be in use by device.
+  */
+  render_graph::~render_graph( VOID )
+  {
+    Destroy();
+  } /* ~render_graph */
+
+  /**
+   * @brief Graph declaration and compiled state clearing function. Graph images mustn't be in use by device.
+  */
+  VOID render_graph::Reset( VOID )
+  {
+    Destroy();
+    Images.clear();
+    Passes.clear();
+    ImportedImages.clear();
+  } /* Reset */
+
+  /**
+   * @brief Graph image creation function. Image contents are discarded before its first access in every execution.
+   * @param Name Image name
+   * @param Description Image description
+   * @return Image handle
+  */
+  render_graph::resource render_graph::CreateImage( std::string_view Name, const image_description &Description )
+  {
+    Images.push_back(image
+      {
+        .Name = std::string(Name),
+        .Description = Description,
+      });
+    return (resource)Images.size() - 1;
+  } /* CreateImage */
+
+  /**
+   * @brief External image import function. Image is bound at execution, its contents are discarded before first access.
+   * @param Name Image name
+   * @param Format Image format
+   * @param FinalLayout Layout, image is transitioned to after last access
+   * @return Image handle
+  */
+  render_graph::resource render_graph::ImportImage( std::string_view Name, vk::Format Format, vk::ImageLayout FinalLayout )
+  {
+    Images.push_back(image
+      {
+        .Name = std::string(Name),
+        .Description = image_description {.Format = Format},
+        .IsImported = TRUE,
+        .ImportIndex = (UINT32)ImportedImages.size(),
+        .FinalLayout = FinalLayout,
+      });
+    ImportedImages.push_back((resource)Images.size() - 1);
+    return (resource)Images.size() - 1;
+  } /* ImportImage */
+
+  /**
+   * @brief Pass adding function
+   * @param Description Pass description
+   * @return Pass index
+  */
+  UINT32 render_graph::AddPass( pass_description &&Description )
+  {
+    Passes.push_back(std::move(Description));
+    return (UINT32)Passes.size() - 1;
+  } /* AddPass */
+
+  /**
+   * @brief Compiled state destroy function
+  */
+  VOID render_graph::Destroy( VOID )
+  {
+    ReleaseFramebuffers();
+
+    for (group &Group : Groups)
+      if (Group.RenderPass)
+        Device.destroyRenderPass(Group.RenderPass);
+
+    for (image &Image : Images)
+    {
+      if (Image.View)
+        Device.destroyImageView(Image.View);
+      if (Image.Image)
+        Device.destroyImage(Image.Image);
+      Image.View = nullptr;
+      Image.Image = nullptr;
+      Image.Block = NONE;
+      Image.MemorySize = 0;
+    }
+    for (memory_block &Block : Blocks)
+      vmaFreeMemory(Allocator, Block.Allocation);
+
+    Blocks.clear();
+    Groups.clear();
+    CompiledPasses.clear();
+    FinalBarriers.clear();
+  } /* Destroy */
+
+  /**
+   * @brief Cached framebuffers destroy function. Must be called before imported image views are destroyed.
+  */
+  VOID render_graph::ReleaseFramebuffers( VOID )
+  {
+    for (auto &[Key, Framebuffer] : Framebuffers)
+      Device.destroyFramebuffer(Framebuffer);
+    Framebuffers.clear();
+  } /* ReleaseFramebuffers */
+
+  /**
+   * @brief Graph images creation and memory aliasing function, called after pass grouping
+  */
+  VOID render_graph::AllocateImages( VOID )
+  {
+    std::vector<resource> Order;
+
+    for (resource Resource = 0; Resource < Images.size(); Resource++)
+    {
+      image &Image = Images[Resource];
+      if (Image.IsImported || Image.FirstGroup == NONE)
+        continue;
+
+      if (Image.IsTransient)
+        Image.Usage |= vk::ImageUsageFlagBits::eTransientAttachment;
+
+      Image.Image = Device.createImage(vk::ImageCreateInfo()
+        .setExtent(vk::Extent3D(Extent, 1))
+        .setFormat(Image.Description.Format)
+        .setUsage(Image.Usage)
+        .setSharingMode(vk::SharingMode::eExclusive)
+        .setImageType(vk::ImageType::e2D)
+        .setTiling(vk::ImageTiling::eOptimal)
+        .setInitialLayout(vk::ImageLayout::eUndefined)
+        .setMipLevels(1)
+        .setArrayLayers(1)
+      );
+      Image.MemorySize = Device.getImageMemoryRequirements(Image.Image).size;
+      Order.push_back(Resource);
+    }
+
+    // Larger images are placed first, so smaller ones fill blocks, they have created
+    std::ranges::stable_sort(Order, std::greater {}, [&]( resource Resource ) { return Images[Resource].MemorySize; });
+
+    for (resource Resource : Order)
+    {
+      image &Image = Images[Resource];
+      vk::MemoryRequirements Requirements = Device.getImageMemoryRequirements(Image.Image);
+
+      // Block may be shared only by images, which are never alive at the same time
+      auto IsCompatible = [&]( const memory_block &Block )
+      {
+        if ((Block.Requirements.memoryTypeBits & Requirements.memoryTypeBits) == 0 || Block.IsTransient != Image.IsTransient)
+          return FALSE;
+        return std::ranges::none_of(Block.Images, [&]( resource Other )
+          {
+            return Images[Other].FirstGroup <= Image.LastGroup && Image.FirstGroup <= Images[Other].LastGroup;
+          });
+      };
+
+      auto BlockIt = std::ranges::find_if(Blocks, IsCompatible);
+      if (BlockIt == Blocks.end())
+      {
+        Blocks.push_back(memory_block {.Requirements = Requirements, .IsTransient = Image.IsTransient});
+        BlockIt = Blocks.end() - 1;
+      }
+      else
+      {
+        BlockIt->Requirements.size = std::max(BlockIt->Requirements.size, Requirements.size);
+        BlockIt->Requirements.alignment = std::max(BlockIt->Requirements.alignment, Requirements.alignment);
+        BlockIt->Requirements.memoryTypeBits &= Requirements.memoryTypeBits;
+      }
+      BlockIt->Images.push_back(Resource);
+      Image.Block = (UINT32)(BlockIt - Blocks.begin());
+    }
+
+    for (memory_block &Block : Blocks)
+    {
+      VmaAllocationCreateInfo AllocationCreateInfo
+      {
+        .usage = VMA_MEMORY_USAGE_GPU_ONLY,
+        .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+      };
+      VmaAllocationCreateInfo LazyAllocationCreateInfo
+      {
+        .usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED,
+      };
+
+      // Lazily allocated memory is exposed by tiled GPUs mostly, transient images are placed to regular memory elsewhere
+      Block.IsLazy = Block.IsTransient && vmaAllocateMemory(Allocator, &(const VkMemoryRequirements &)Block.Requirements, &LazyAllocationCreateInfo, &Block.Allocation, nullptr) == VK_SUCCESS;
+      if (!Block.IsLazy)
+        if (auto Result = vmaAllocateMemory(Allocator, &(const VkMemoryRequirements &)Block.Requirements, &AllocationCreateInfo, &Block.Allocation, nullptr); Result != VK_SUCCESS)
+          vk::detail::throwResultException(vk::Result(Result), "vmaAllocateMemory");
+
+      for (resource Resource : Block.Images)
+      {
+        image &Image = Images[Resource];
+
+        if (auto Result = vmaBindImageMemory(Allocator, Block.Allocation, Image.Image); Result != VK_SUCCESS)
+          vk::detail::throwResultException(vk::Result(Result), "vmaBindImageMemory");
+
+        Image.View = Device.createImageView(vk::ImageViewCreateInfo()
+          .setFormat(Image.Description.Format)
+          .setImage(Image.Image)
+          .setViewType(vk::ImageViewType::e2D)
+          .setSubresourceRange(vk::ImageSubresourceRange(GetFormatAspect(Image.Description.Format) & ~vk::ImageAspectFlags(vk::ImageAspectFlagBits::eStencil), 0, 1, 0, 1))
+        );
+      }
+    }
+  } /* AllocateImages */
+
+  /**
+   * @brief Graph compilation function. Graph images of previous compilation mustn't be in use by device.
+   *        (Re)allocates graph images, creates render passes and derives barriers.
+   * @param NewMode Graphics pass execution mode
+   * @param NewExtent Graph image extent, the maximal render extent
+  */
+  VOID render_graph::Compile( mode NewMode, vk::Extent2D NewExtent )
+  {
+    Destroy();
+    Mode = NewMode;
+    Extent = NewExtent;
+
+    // Input attachments can't be read inside of dynamic rendering scope, so they are sampled from separate one
+    auto GetInfo = [&]( const pass_access &Access )
+    {
+      return GetAccessInfo(Mode == mode::eDynamicRendering && Access.Access == access::eInputRead ? access::eFragmentSampled : Access.Access);
+    };
+
+    for (image &Image : Images)
+    {
+      Image.Usage = Image.Description.Usage;
+      Image.FirstGroup = Image.LastGroup = NONE;
+      Image.IsTransient = Image.Description.IsTransient && !Image.IsImported;
+    }
+
+    /* Group passes */
+
+    // Kinds of accesses of every image in current group
+    constexpr BYTE ATTACHMENT_ACCESS = 1, OTHER_ACCESS = 2;
+
+    CompiledPasses.assign(Passes.size(), compiled_pass {});
+    std::vector<BYTE> GroupAccesses(Images.size(), 0);
+
+    for (UINT32 PassIndex = 0; PassIndex < Passes.size(); PassIndex++)
+    {
+      const pass_description &Pass = Passes[PassIndex];
+      BOOL IsMerged = Mode == mode::eSubpasses && Pass.Type == pass_type::eGraphics && !Groups.empty() && Groups.back().IsRendering;
+
+      // Images, sampled inside of render pass, must be synchronized before it and mustn't be its attachments
+      for (const pass_access &Access : Pass.Accesses)
+        if (GetInfo(Access).IsAttachment ? GroupAccesses[Access.Resource] & OTHER_ACCESS : GroupAccesses[Access.Resource] != 0)
+          IsMerged = FALSE;
+
+      if (!IsMerged)
+      {
+        Groups.push_back(group {.IsRendering = Pass.Type == pass_type::eGraphics});
+        std::ranges::fill(GroupAccesses, 0);
+      }
+
+      const UINT32 GroupIndex = (UINT32)Groups.size() - 1;
+      CompiledPasses[PassIndex].Group = GroupIndex;
+      CompiledPasses[PassIndex].Subpass = (UINT32)Groups.back().Passes.size();
+      Groups.back().Passes.push_back(PassIndex);
+
+      for (const pass_access &Access : Pass.Accesses)
+      {
+        image &Image = Images[Access.Resource];
+
+        GroupAccesses[Access.Resource] |= GetInfo(Access).IsAttachment ? ATTACHMENT_ACCESS : OTHER_ACCESS;
+        Image.Usage |= GetInfo(Access).Usage;
+        if (Image.FirstGroup == NONE)
+          Image.FirstGroup = GroupIndex;
+        Image.LastGroup = GroupIndex;
+      }
+    }
+
+    // Transient image contents mustn't leave render pass, they are never stored
+    constexpr vk::ImageUsageFlags TransientUsage =
+      vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eInputAttachment;
+
+    for (image &Image : Images)
+      if (Image.IsTransient)
+        Image.IsTransient = Image.FirstGroup != NONE && Image.FirstGroup == Image.LastGroup &&
+          Groups[Image.FirstGroup].IsRendering && !(Image.Usage & ~TransientUsage);
+
+    AllocateImages();
+
+    /* Derive barriers, subpass dependencies and attachment operations */
+
+    struct tracked_state
+    {
+      vk::ImageLayout Layout = vk::ImageLayout::eUndefined; // Current layout
+      vk::PipelineStageFlags2 WriteStages;   // Stages of last write or layout transition
+      vk::AccessFlags2 WriteAccess;          // Last write access, not made available yet
+      vk::PipelineStageFlags2 ReadStages;    // Stages of reads after last write
+      vk::PipelineStageFlags2 VisibleStages; // Stages, last write is visible to
+      vk::AccessFlags2 VisibleAccess;        // Accesses, last write is visible to
+      UINT32 Group = NONE;                   // Group of last access
+      UINT32 WriteSubpass = NONE;            // Subpass of last write in current render pass
+      UINT32 ReadSubpass = NONE;             // Subpass of last read in current render pass
+      UINT32 Barrier = NONE;                 // Index of barrier before current group
+      BOOL IsDefined = FALSE;                // Contents are written in this execution
+    };
+    std::vector<tracked_state> States(Images.size());
+
+    // Aliased image must wait for accesses of image, that used memory before it
+    std::vector<vk::PipelineStageFlags2> BlockStages(Blocks.size());
+    std::vector<vk::AccessFlags2> BlockAccess(Blocks.size());
+
+    for (UINT32 GroupIndex = 0; GroupIndex < Groups.size(); GroupIndex++)
+    {
+      group &Group = Groups[GroupIndex];
+      const BOOL IsRenderPass = Group.IsRendering && Mode == mode::eSubpasses;
+      const UINT32 SubpassCount = (UINT32)Group.Passes.size();
+
+      // Render pass description (subpass mode only)
+      std::vector<UINT32> AttachmentIndices(Images.size(), NONE);
+      std::vector<vk::AttachmentDescription2> AttachmentDescriptions;
+      std::vector<std::vector<vk::AttachmentReference2>> ColorReferences(SubpassCount), InputReferences(SubpassCount);
+      std::vector<vk::AttachmentReference2> DepthReferences(SubpassCount);
+      std::vector<std::vector<UINT32>> AttachmentSubpasses; // Subpasses, every attachment is used in
+      std::map<std::pair<UINT32, UINT32>, std::pair<vk::MemoryBarrier2, BOOL>> Dependencies; // Barriers and by region flags by subpass pair
+
+      auto AddDependency = [&]( UINT32 Src, UINT32 Dst, vk::PipelineStageFlags2 SrcStages, vk::AccessFlags2 SrcAccess, const graph_access_info &Info )
+      {
+        auto [It, IsNew] = Dependencies.try_emplace({Src, Dst}, vk::MemoryBarrier2(), TRUE);
+        auto &[Barrier, IsByRegion] = It->second;
+
+        Barrier.srcStageMask |= SrcStages;
+        Barrier.srcAccessMask |= SrcAccess;
+        Barrier.dstStageMask |= Info.Stages;
+        Barrier.dstAccessMask |= Info.Access;
+        // Framebuffer-local dependency lets tiled GPUs keep attachments in tile memory
+        IsByRegion &= Src != VK_SUBPASS_EXTERNAL && !(SrcStages & ~FramebufferLocalStages) && !(Info.Stages & ~FramebufferLocalStages);
+      };
+
+      auto AddBarrier = [&]( resource Resource, tracked_state &State, vk::PipelineStageFlags2 SrcStages, vk::AccessFlags2 SrcAccess, const graph_access_info &Info )
+      {
+        if (State.Barrier != NONE)
+        {
+          vk::ImageMemoryBarrier2 &Barrier = Group.Barriers[State.Barrier].Barrier;
+
+          Barrier.dstStageMask |= Info.Stages;
+          Barrier.dstAccessMask |= Info.Access;
+          return;
+        }
+        State.Barrier = (UINT32)Group.Barriers.size();
+        Group.Barriers.push_back(barrier
+          {
+            .Resource = Resource,
+            .Barrier = vk::ImageMemoryBarrier2()
+              .setSrcStageMask(SrcStages)
+              .setSrcAccessMask(SrcAccess)
+              .setDstStageMask(Info.Stages)
+              .setDstAccessMask(Info.Access)
+              .setOldLayout(State.Layout)
+              .setNewLayout(Info.Layout)
+              .setSubresourceRange(vk::ImageSubresourceRange(GetFormatAspect(Images[Resource].Description.Format), 0, 1, 0, 1)),
+          });
+      };
+
+      for (UINT32 Subpass = 0; Subpass < SubpassCount; Subpass++)
+      {
+        const UINT32 PassIndex = Group.Passes[Subpass];
+        compiled_pass &Compiled = CompiledPasses[PassIndex];
+
+        for (const pass_access &Access : Passes[PassIndex].Accesses)
+        {
+          const graph_access_info Info = GetInfo(Access);
+          const resource Resource = Access.Resource;
+          image &Image = Images[Resource];
+          tracked_state &State = States[Resource];
+
+          // Imported image waits for its first access stages only, so barrier chains with semaphore wait
+          if (State.Group == NONE)
+            State.WriteStages = Image.IsImported ? Info.Stages : BlockStages[Image.Block];
+          if (State.Group == NONE && !Image.IsImported)
+            State.WriteAccess = BlockAccess[Image.Block];
+
+          const BOOL IsInGroup = State.Group == GroupIndex;
+          const BOOL IsFirstUse = State.Layout == vk::ImageLayout::eUndefined;
+          const BOOL WasDefined = State.IsDefined;
+
+          if (!IsInGroup)
+          {
+            State.WriteSubpass = State.ReadSubpass = NONE;
+            State.Barrier = NONE;
+          }
+
+          // Writes and layout transitions wait for all previous accesses, reads wait for last write only
+          const BOOL IsLayoutChange = State.Layout != Info.Layout;
+          const BOOL IsWriteLike = IsLayoutChange || Info.IsWrite;
+          const vk::PipelineStageFlags2 SrcStages = IsWriteLike ? State.WriteStages | State.ReadStages : State.WriteStages;
+          const BOOL IsNeeded = IsWriteLike
+            ? IsLayoutChange || SrcStages
+            : State.WriteStages && ((Info.Stages & ~State.VisibleStages) || (Info.Access & ~State.VisibleAccess));
+
+          if (IsNeeded)
+          {
+            if (IsRenderPass && Info.IsAttachment && (IsInGroup || IsFirstUse))
+            {
+              // Attachment transitions are done by render pass itself
+              if (!IsInGroup)
+                AddDependency(VK_SUBPASS_EXTERNAL, Subpass, SrcStages, State.WriteAccess, Info);
+              else if (State.WriteSubpass == NONE && !IsWriteLike)
+                AddBarrier(Resource, State, State.WriteStages, State.WriteAccess, Info);
+              else
+              {
+                if (State.WriteSubpass != NONE)
+                  AddDependency(State.WriteSubpass, Subpass, State.WriteStages, State.WriteAccess, Info);
+                if (IsWriteLike && State.ReadSubpass != NONE && State.ReadSubpass != Subpass)
+                  AddDependency(State.ReadSubpass, Subpass, State.ReadStages, {}, Info);
+              }
+            }
+            else
+              AddBarrier(Resource, State, SrcStages, State.WriteAccess, Info);
+          }
+
+          if (IsWriteLike)
+          {
+            State.Layout = Info.Layout;
+            State.WriteStages = Info.Stages;
+            State.WriteAccess = Info.IsWrite ? Info.Access & WriteAccesses : vk::AccessFlags2();
+            State.ReadStages = Info.IsWrite ? vk::PipelineStageFlags2() : Info.Stages;
+            State.VisibleStages = Info.IsWrite ? vk::PipelineStageFlags2() : Info.Stages;
+            State.VisibleAccess = Info.IsWrite ? vk::AccessFlags2() : Info.Access;
+            State.WriteSubpass = IsRenderPass ? Subpass : NONE;
+            State.ReadSubpass = Info.IsWrite || !IsRenderPass ? NONE : Subpass;
+          }
+          else
+          {
+            State.ReadStages |= Info.Stages;
+            State.VisibleStages |= Info.Stages;
+            State.VisibleAccess |= Info.Access;
+            State.ReadSubpass = IsRenderPass ? Subpass : NONE;
+          }
+          State.Group = GroupIndex;
+          State.IsDefined |= Info.IsWrite || Access.Clear.has_value();
+
+          if (!Group.IsRendering || !Info.IsAttachment)
+            continue;
+
+          // Attachment is stored, if it's used later
+          attachment Attachment
+          {
+            .Resource = Resource,
+            .Layout = Info.Layout,
+            .LoadOp = Access.Clear.has_value() ? vk::AttachmentLoadOp::eClear : WasDefined ? vk::AttachmentLoadOp::eLoad : vk::AttachmentLoadOp::eDontCare,
+            .StoreOp = Image.IsImported || Image.LastGroup > GroupIndex ? vk::AttachmentStoreOp::eStore : vk::AttachmentStoreOp::eDontCare,
+            .Clear = Access.Clear.value_or(vk::ClearValue()),
+          };
+
+          if (Access.Access == access::eColorWrite)
+            Compiled.ColorFormats.push_back(Image.Description.Format);
+          else if (Access.Access != access::eInputRead)
+            Compiled.DepthFormat = Image.Description.Format;
+
+          if (!IsRenderPass)
+          {
+            if (Access.Access == access::eColorWrite)
+              Compiled.ColorAttachments.push_back(Attachment);
+            else
+              Compiled.DepthAttachment = Attachment;
+            continue;
+          }
+
+          UINT32 &AttachmentIndex = AttachmentIndices[Resource];
+          if (AttachmentIndex == NONE)
+          {
+            AttachmentIndex = (UINT32)AttachmentDescriptions.size();
+            AttachmentDescriptions.push_back(vk::AttachmentDescription2()
+              .setFormat(Image.Description.Format)
+              .setSamples(vk::SampleCountFlagBits::e1)
+              .setLoadOp(Attachment.LoadOp)
+              .setStoreOp(Attachment.StoreOp)
+              .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
+              .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
+              .setInitialLayout(IsFirstUse ? vk::ImageLayout::eUndefined : Info.Layout)
+            );
+            AttachmentSubpasses.emplace_back();
+            Group.Attachments.push_back(Resource);
+            Group.ClearValues.push_back(Attachment.Clear);
+          }
+          AttachmentDescriptions[AttachmentIndex].setFinalLayout(Info.Layout);
+          AttachmentSubpasses[AttachmentIndex].push_back(Subpass);
+
+          vk::AttachmentReference2 Reference = vk::AttachmentReference2()
+            .setAttachment(AttachmentIndex)
+            .setLayout(Info.Layout)
+            ;
+          if (Access.Access == access::eColorWrite)
+            ColorReferences[Subpass].push_back(Reference);
+          else if (Access.Access == access::eInputRead)
+            InputReferences[Subpass].push_back(Reference.setAspectMask(GetFormatAspect(Image.Description.Format)));
+          else
+            DepthReferences[Subpass] = Reference;
+        }
+      }
+
+      // Memory of images, that aren't used anymore, is free for aliased ones
+      for (resource Resource = 0; Resource < Images.size(); Resource++)
+        if (Images[Resource].Block != NONE && Images[Resource].LastGroup == GroupIndex)
+        {
+          BlockStages[Images[Resource].Block] = States[Resource].WriteStages | States[Resource].ReadStages;
+          BlockAccess[Images[Resource].Block] = States[Resource].WriteAccess;
+        }
+
+      if (!IsRenderPass)
+        continue;
+
+      // Attachments, used before and after subpass, must be preserved by it
+      std::vector<std::vector<UINT32>> PreserveAttachments(SubpassCount);
+      for (UINT32 AttachmentIndex = 0; AttachmentIndex < AttachmentSubpasses.size(); AttachmentIndex++)
+      {
+        const std::vector<UINT32> &Used = AttachmentSubpasses[AttachmentIndex];
+
+        for (UINT32 Subpass = Used.front() + 1; Subpass < Used.back(); Subpass++)
+          if (std::ranges::find(Used, Subpass) == Used.end())
+            PreserveAttachments[Subpass].push_back(AttachmentIndex);
+      }
+
+      std::vector<vk::SubpassDescription2> Subpasses(SubpassCount);
+      for (UINT32 Subpass = 0; Subpass < SubpassCount; Subpass++)
+        Subpasses[Subpass]
+          .setPipelineBindPoint(vk::PipelineBindPoint::eGraphics)
+          .setColorAttachments(ColorReferences[Subpass])
+          .setInputAttachments(InputReferences[Subpass])
+          .setPDepthStencilAttachment(DepthReferences[Subpass].layout != vk::ImageLayout::eUndefined ? &DepthReferences[Subpass] : nullptr)
+          .setPreserveAttachments(PreserveAttachments[Subpass])
+          ;
+
+      // Stage masks of dependencies are taken from chained synchronization2 barriers
+      std::vector<vk::MemoryBarrier2> DependencyBarriers;
+      std::vector<vk::SubpassDependency2> SubpassDependencies;
+
+      DependencyBarriers.reserve(Dependencies.size());
+      for (const auto &[Pair, Dependency] : Dependencies)
+      {
+        DependencyBarriers.push_back(Dependency.first);
+        SubpassDependencies.push_back(vk::SubpassDependency2()
+          .setPNext(&DependencyBarriers.back())
+          .setSrcSubpass(Pair.first)
+          .setDstSubpass(Pair.second)
+          .setDependencyFlags(Dependency.second ? vk::DependencyFlagBits::eByRegion : vk::DependencyFlags())
+        );
+      }
+
+      Group.RenderPass = Device.createRenderPass2(vk::RenderPassCreateInfo2()
+        .setAttachments(AttachmentDescriptions)
+        .setSubpasses(Subpasses)
+        .setDependencies(SubpassDependencies)
+      );
+    }
+
+    // Imported images are left in requested layouts
+    for (resource Resource : ImportedImages)
+    {
+      const tracked_state &State = States[Resource];
+
+      if (State.Group != NONE && State.Layout != Images[Resource].FinalLayout)
+        FinalBarriers.push_back(barrier
+          {
+            .Resource = Resource,
+            .Barrier = vk::ImageMemoryBarrier2()
+              .setSrcStageMask(State.WriteStages | State.ReadStages)
+              .setSrcAccessMask(State.WriteAccess)
+              .setOldLayout(State.Layout)
+              .setNewLayout(Images[Resource].FinalLayout)
+              .setSubresourceRange(vk::ImageSubresourceRange(GetFormatAspect(Images[Resource].Description.Format), 0, 1, 0, 1)),
+          });
+    }
+
+    // Inheritance and pipeline infos point to compiled pass formats, so they are filled after all passes are compiled
+    for (compiled_pass &Compiled : CompiledPasses)
+    {
+      const group &Group = Groups[Compiled.Group];
+
+      Compiled.RenderingInfo = vk::PipelineRenderingCreateInfo()
+        .setColorAttachmentFormats(Compiled.ColorFormats)
+        .setDepthAttachmentFormat(Compiled.DepthFormat)
+        ;
+      Compiled.InheritanceRenderingInfo = vk::CommandBufferInheritanceRenderingInfo()
+        .setColorAttachmentFormats(Compiled.ColorFormats)
+        .setDepthAttachmentFormat(Compiled.DepthFormat)
+        .setRasterizationSamples(vk::SampleCountFlagBits::e1)
+        ;
+      Compiled.InheritanceInfo = Mode == mode::eSubpasses
+        ? vk::CommandBufferInheritanceInfo()
+          .setRenderPass(Group.RenderPass)
+          .setSubpass(Compiled.Subpass)
+        : vk::CommandBufferInheritanceInfo()
+          .setPNext(&Compiled.InheritanceRenderingInfo);
+    }
+  } /* Compile */
+
+  /**
+   * @brief Compiled graph recording function
+   * @param CommandBuffer Command buffer to record graph to
+   * @param RenderExtent Render area extent, not larger than compilation one
+   * @param Bindings Imported image bindings, in import order
+  */
+  VOID render_graph::Execute( vk::CommandBuffer CommandBuffer, vk::Extent2D RenderExtent, std::span<const imported_image> Bindings )
+  {
+    auto GetBinding = [&]( resource Resource )
+    {
+      const image &Image = Images[Resource];
+      return Image.IsImported ? Bindings[Image.ImportIndex] : imported_image {Image.Image, Image.View};
+    };
+
+    std::vector<vk::ImageMemoryBarrier2> Barriers;
+    auto RecordBarriers = [&]( const std::vector<barrier> &Templates )
+    {
+      if (Templates.empty())
+        return;
+
+      Barriers.clear();
+      for (const barrier &Template : Templates)
+        Barriers.push_back(vk::ImageMemoryBarrier2(Template.Barrier).setImage(GetBinding(Template.Resource).Image));
+      CommandBuffer.pipelineBarrier2(vk::DependencyInfo().setImageMemoryBarriers(Barriers));
+    };
+
+    const vk::Rect2D RenderArea({0, 0}, RenderExtent);
+
+    for (UINT32 GroupIndex = 0; GroupIndex < Groups.size(); GroupIndex++)
+    {
+      const group &Group = Groups[GroupIndex];
+
+      RecordBarriers(Group.Barriers);
+
+      if (!Group.IsRendering)
+      {
+        for (UINT32 PassIndex : Group.Passes)
+          if (Passes[PassIndex].Record)
+            Passes[PassIndex].Record(CommandBuffer);
+        continue;
+      }
+
+      if (Mode == mode::eSubpasses)
+      {
+        auto GetContents = [&]( UINT32 PassIndex )
+        {
+          return Passes[PassIndex].IsSecondary ? vk::SubpassContents::eSecondaryCommandBuffers : vk::SubpassContents::eInline;
+        };
+
+        // Framebuffers are cached by attachment views, because imported images differ between executions
+        std::vector<vk::ImageView> Views;
+        std::vector<UINT64> Key {GroupIndex, RenderExtent.width, RenderExtent.height};
+        for (resource Resource : Group.Attachments)
+        {
+          Views.push_back(GetBinding(Resource).View);
+          Key.push_back((UINT64)(VkImageView)Views.back());
+        }
+
+        auto [It, IsNew] = Framebuffers.try_emplace(std::move(Key));
+        if (IsNew)
+          It->second = Device.createFramebuffer(vk::FramebufferCreateInfo()
+            .setRenderPass(Group.RenderPass)
+            .setAttachments(Views)
+            .setWidth(RenderExtent.width)
+            .setHeight(RenderExtent.height)
+            .setLayers(1)
+          );
+
+        CommandBuffer.beginRenderPass(vk::RenderPassBeginInfo()
+          .setRenderPass(Group.RenderPass)
+          .setFramebuffer(It->second)
+          .setRenderArea(RenderArea)
+          .setClearValues(Group.ClearValues),
+          GetContents(Group.Passes[0])
+        );
+        for (UINT32 Subpass = 0; Subpass < Group.Passes.size(); Subpass++)
+        {
+          const UINT32 PassIndex = Group.Passes[Subpass];
+
+          if (Subpass != 0)
+            CommandBuffer.nextSubpass(GetContents(PassIndex));
+          if (Passes[PassIndex].Record)
+            Passes[PassIndex].Record(CommandBuffer);
+        }
+        CommandBuffer.endRenderPass();
+      }
+      else
+      {
+        const UINT32 PassIndex = Group.Passes[0];
+        const compiled_pass &Compiled = CompiledPasses[PassIndex];
+
+        auto GetAttachmentInfo = [&]( const attachment &Attachment )
+        {
+          return vk::RenderingAttachmentInfo()
+            .setImageView(GetBinding(Attachment.Resource).View)
+            .setImageLayout(Attachment.Layout)
+            .setLoadOp(Attachment.LoadOp)
+            .setStoreOp(Attachment.StoreOp)
+            .setClearValue(Attachment.Clear);
+        };
+
+        std::vector<vk::RenderingAttachmentInfo> ColorAttachments;
+        for (const attachment &Attachment : Compiled.ColorAttachments)
+          ColorAttachments.push_back(GetAttachmentInfo(Attachment));
+        vk::RenderingAttachmentInfo DepthAttachment = Compiled.DepthAttachment.Resource != NONE
+          ? GetAttachmentInfo(Compiled.DepthAttachment)
+          : vk::RenderingAttachmentInfo();
+
+        CommandBuffer.beginRendering(vk::RenderingInfo()
+          .setFlags(Passes[PassIndex].IsSecondary ? vk::RenderingFlagBits::eContentsSecondaryCommandBuffers : vk::RenderingFlags())
+          .setRenderArea(RenderArea)
+          .setLayerCount(1)
+          .setColorAttachments(ColorAttachments)
+          .setPDepthAttachment(Compiled.DepthAttachment.Resource != NONE ? &DepthAttachment : nullptr)
+        );
+        if (Passes[PassIndex].Record)
+          Passes[PassIndex].Record(CommandBuffer);
+        CommandBuffer.endRendering();
+      }
+    }
+
+    RecordBarriers(FinalBarriers);
+  } /* Execute */
+
+  /**
+   * @brief Pass render pass getting function
+   * @param Pass Graphics pass index
+   * @return Render pass, the pass is subpass of, null in dynamic rendering mode
+  */
+  vk::RenderPass render_graph::GetRenderPass( UINT32 Pass ) const
+  {
+    return Groups[CompiledPasses[Pass].Group].RenderPass;
+  } /* GetRenderPass */
+
+  /**
+   * @brief Pass subpass index getting function
+   * @param Pass Graphics pass index
+   * @return Subpass index
+  */
+  UINT32 render_graph::GetSubpass( UINT32 Pass ) const
+  {
+    return CompiledPasses[Pass].Subpass;
+  } /* GetSubpass */
+
+  /**
+   * @brief Pass pipeline rendering info getting function
+   * @param Pass Graphics pass index
+   * @return Attachment formats to chain to pipeline create info, nullptr in subpass mode
+  */
+  const vk::PipelineRenderingCreateInfo * render_graph::GetPipelineRenderingInfo( UINT32 Pass ) const
+  {
+    return Mode == mode::eDynamicRendering ? &CompiledPasses[Pass].RenderingInfo : nullptr;
+  } /* GetPipelineRenderingInfo */
+
+  /**
+   * @brief Pass secondary command buffer inheritance info getting function
+   * @param Pass Graphics pass index
+   * @return Inheritance info, valid till next compilation
+  */
+  const vk::CommandBufferInheritanceInfo & render_graph::GetInheritanceInfo( UINT32 Pass ) const
+  {
+    return CompiledPasses[Pass].InheritanceInfo;
+  } /* GetInheritanceInfo */
+
+  /**
+   * @brief Graph image getting function
+   * @param Resource Graph (not imported) image handle
+   * @return Image
+  */
+  vk::Image render_graph::GetImage( resource Resource ) const
+  {
+    return Images[Resource].Image;
+  } /* GetImage */
+
+  /**
+   * @brief Graph image view getting function
+   * @param Resource Graph (not imported) image handle
+   * @return Image view
+  */
+  vk::ImageView render_graph::GetImageView( resource Resource ) const
+  {
+    return Images[Resource].View;
+  } /* GetImageView */
+
+  /**
+   * @brief Graph image memory statistics getting function
+   * @return Memory statistics of compiled graph
+  */
+  render_graph::memory_stats render_graph::GetMemoryStats( VOID ) const
+  {
+    memory_stats Stats;
+
+    for (const image &Image : Images)
+    {
+      Stats.ImageSize += (SIZE_T)Image.MemorySize;
+      Stats.TransientImageCount += Image.IsTransient && Image.Image;
+    }
+    for (const memory_block &Block : Blocks)
+    {
+      Stats.AllocatedSize += (SIZE_T)Block.Requirements.size;
+      if (Block.IsLazy)
+        Stats.LazySize += (SIZE_T)Block.Requirements.size;
+    }
+    Stats.AllocationCount = (UINT32)Blocks.size();
+
+    return Stats;
+  } /* GetMemoryStats */
+} /* namespace anv::render::core */
+
+/* file anv_render_core_graph.cpp */
@@ -0,0 +1,353 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/anim/render/core/anv_render_core_graph.h
+ * @description Render graph declaration module
+ * @last_update 18.10.2026
+*/
+
+#ifndef ANV_RENDER_CORE_GRAPH_H_
+#define ANV_RENDER_CORE_GRAPH_H_
+
+#include "anv_common.h"
+
+#include <vulkan/vulkan.hpp>
+#include <vma/vk_mem_alloc.h>
+
+namespace anv::render::core
+{
+  /**
+   * @brief Render graph. Passes declare images they access, graph derives layout transitions and minimal synchronization2 barriers from them,
+   *        runs graphics passes as subpasses of merged render passes or with dynamic rendering and aliases memory of graph images
+   *        with disjoint lifetimes. All passes are recorded to single command buffer in declaration order.
+  */
+  class render_graph
+  {
+  public:
+    using resource = UINT32; // Graph image handle
+
+    /**
+     * @brief Graphics pass execution mode
+    */
+    enum class mode
+    {
+      eSubpasses,        // Consecutive graphics passes are merged to subpasses of one render pass, attachments may stay in tile memory
+      eDynamicRendering, // Every graphics pass is separate dynamic rendering scope, input attachments are read as sampled images
+    }; /* enum mode */
+
+    /**
+     * @brief Pass type
+    */
+    enum class pass_type
+    {
+      eGraphics, // Pass draws to attachments
+      eCompute,  // Pass dispatches compute shaders
+      eTransfer, // Pass copies images
+    }; /* enum pass_type */
+
+    /**
+     * @brief Image access kind
+    */
+    enum class access
+    {
+      eColorWrite,      // Color attachment write
+      eDepthWrite,      // Depth attachment test and write
+      eDepthRead,       // Depth attachment test without write
+      eInputRead,       // Input attachment fragment shader read
+      eFragmentSampled, // Fragment shader sampled read
+      eComputeSampled,  // Compute shader sampled read
+      eComputeStorage,  // Compute shader storage read and write
+      eTransferRead,    // Copy source
+      eTransferWrite,   // Copy destination
+    }; /* enum access */
+
+    /**
+     * @brief Graph image description structure
+    */
+    struct image_description
+    {
+      vk::Format Format = vk::Format::eUndefined; // Image format
+      vk::ImageUsageFlags Usage {};               // Usage in addition to one derived from accesses
+      BOOL IsTransient = FALSE;                   // Image may live in lazily allocated (tile) memory only. Applied, if image is used as attachment of single render pass only.
+    }; /* struct image_description */
+
+    /**
+     * @brief Pass image access structure
+    */
+    struct pass_access
+    {
+      resource Resource;                // Accessed image
+      access Access;                    // Access kind
+      std::optional<vk::ClearValue> Clear; // Attachment clear value, image is cleared at the beginning of pass if present
+    }; /* struct pass_access */
+
+    /**
+     * @brief Pass description structure
+    */
+    struct pass_description
+    {
+      std::string Name;                                      // Pass name
+      pass_type Type = pass_type::eGraphics;                 // Pass type
+      std::vector<pass_access> Accesses;                     // Image accesses, one per image. Color attachments are bound in their order.
+      BOOL IsSecondary = FALSE;                              // Graphics pass contents are recorded to secondary command buffers
+      std::function<VOID( vk::CommandBuffer )> Record;       // Pass commands recording callback
+    }; /* struct pass_description */
+
+    /**
+     * @brief Imported image binding structure
+    */
+    struct imported_image
+    {
+      vk::Image Image;    // Image
+      vk::ImageView View; // Image view
+    }; /* struct imported_image */
+
+    /**
+     * @brief Graph image memory statistics structure
+    */
+    struct memory_stats
+    {
+      SIZE_T ImageSize = 0;         // Sum of memory sizes of graph images
+      SIZE_T AllocatedSize = 0;     // Size of allocated memory, smaller than ImageSize if images are aliased
+      SIZE_T LazySize = 0;          // Part of AllocatedSize in lazily allocated memory, that may be never committed
+      UINT32 AllocationCount = 0;   // Count of allocations
+      UINT32 TransientImageCount = 0; // Count of images, created as transient attachments
+    }; /* struct memory_stats */
+
+    /**
+     * @brief Render graph constructor
+     * @param Device Device
+     * @param Allocator Allocator for graph images
+    */
+    render_graph( vk::Device Device, VmaAllocator Allocator );
+
+    /**
+     * @brief Render graph destructor. Graph images mustn't be in use by device.
+    */
+    ~render_graph( VOID );
+
+    render_graph( const render_graph & ) = delete;
+    render_graph & operator=( const render_graph & ) = delete;
+
+    /**
+     * @brief Graph declaration and compiled state clearing function. Graph images mustn't be in use by device.
+    */
+    VOID Reset( VOID );
+
+    /**
+     * @brief Graph image creation function. Image contents are discarded before its first access in every execution.
+     * @param Name Image name
+     * @param Description Image description
+     * @return Image handle
+    */
+    resource CreateImage( std::string_view Name, const image_description &Description );
+
+    /**
+     * @brief External image import function. Image is bound at execution, its contents are discarded before first access.
+     * @param Name Image name
+     * @param Format Image format
+     * @param FinalLayout Layout, image is transitioned to after last access
+     * @return Image handle
+    */
+    resource ImportImage( std::string_view Name, vk::Format Format, vk::ImageLayout FinalLayout );
+
+    /**
+     * @brief Pass adding function
+     * @param Description Pass description
+     * @return Pass index
+    */
+    UINT32 AddPass( pass_description &&Description );
+
+    /**
+     * @brief Graph compilation function. Graph images of previous compilation mustn't be in use by device.
+     *        (Re)allocates graph images, creates render passes and derives barriers.
+     * @param NewMode Graphics pass execution mode
+     * @param Extent Graph image extent, the maximal render extent
+    */
+    VOID Compile( mode NewMode, vk::Extent2D Extent );
+
+    /**
+     * @brief Compiled graph recording function
+     * @param CommandBuffer Command buffer to record graph to
+     * @param RenderExtent Render area extent, not larger than compilation one
+     * @param ImportedImages Imported image bindings, in import order
+    */
+    VOID Execute( vk::CommandBuffer CommandBuffer, vk::Extent2D RenderExtent, std::span<const imported_image> ImportedImages );
+
+    /**
+     * @brief Cached framebuffers destroy function. Must be called before imported image views are destroyed.
+    */
+    VOID ReleaseFramebuffers( VOID );
+
+    /**
+     * @brief Graphics pass execution mode getting function
+     * @return Mode, graph is compiled with
+    */
+    mode GetMode( VOID ) const
+    {
+      return Mode;
+    } /* GetMode */
+
+    /**
+     * @brief Pass render pass getting function
+     * @param Pass Graphics pass index
+     * @return Render pass, the pass is subpass of, null in dynamic rendering mode
+    */
+    vk::RenderPass GetRenderPass( UINT32 Pass ) const;
+
+    /**
+     * @brief Pass subpass index getting function
+     * @param Pass Graphics pass index
+     * @return Subpass index
+    */
+    UINT32 GetSubpass( UINT32 Pass ) const;
+
+    /**
+     * @brief Pass pipeline rendering info getting function
+     * @param Pass Graphics pass index
+     * @return Attachment formats to chain to pipeline create info, nullptr in subpass mode
+    */
+    const vk::PipelineRenderingCreateInfo * GetPipelineRenderingInfo( UINT32 Pass ) const;
+
+    /**
+     * @brief Pass secondary command buffer inheritance info getting function
+     * @param Pass Graphics pass index
+     * @return Inheritance info, valid till next compilation
+    */
+    const vk::CommandBufferInheritanceInfo & GetInheritanceInfo( UINT32 Pass ) const;
+
+    /**
+     * @brief Graph image getting function
+     * @param Resource Graph (not imported) image handle
+     * @return Image
+    */
+    vk::Image GetImage( resource Resource ) const;
+
+    /**
+     * @brief Graph image view getting function
+     * @param Resource Graph (not imported) image handle
+     * @return Image view
+    */
+    vk::ImageView GetImageView( resource Resource ) const;
+
+    /**
+     * @brief Graph image memory statistics getting function
+     * @return Memory statistics of compiled graph
+    */
+    memory_stats GetMemoryStats( VOID ) const;
+
+  private:
+    constexpr static UINT32 NONE = UINT32_MAX; // Invalid index
+
+    /**
+     * @brief Graph image representation structure
+    */
+    struct image
+    {
+      std::string Name;                                          // Image name
+      image_description Description;                             // Image description
+      BOOL IsImported = FALSE;                                   // Image is bound at execution
+      UINT32 ImportIndex = 0;                                    // Index of binding at execution (imported images only)
+      vk::ImageLayout FinalLayout = vk::ImageLayout::eUndefined; // Layout after last access (imported images only)
+
+      vk::ImageUsageFlags Usage;          // Derived usage
+      BOOL IsTransient = FALSE;           // Image is created as transient attachment
+      UINT32 FirstGroup = NONE;           // Index of first group, image is accessed in
+      UINT32 LastGroup = NONE;            // Index of last group, image is accessed in
+      vk::Image Image;                    // Image
+      vk::ImageView View;                 // Image view
+      vk::DeviceSize MemorySize = 0;      // Memory size
+      UINT32 Block = NONE;                // Memory block index
+    }; /* struct image */
+
+    /**
+     * @brief Memory block, shared by aliased images
+    */
+    struct memory_block
+    {
+      VmaAllocation Allocation = nullptr; // Allocation
+      vk::MemoryRequirements Requirements; // Merged requirements of images
+      std::vector<resource> Images;        // Images, bound to block
+      BOOL IsTransient = FALSE;            // Block holds transient attachments
+      BOOL IsLazy = FALSE;                 // Block is allocated from lazily allocated memory
+    }; /* struct memory_block */
+
+    /**
+     * @brief Barrier, recorded before group
+    */
+    struct barrier
+    {
+      resource Resource;              // Image
+      vk::ImageMemoryBarrier2 Barrier; // Barrier without image
+    }; /* struct barrier */
+
+    /**
+     * @brief Compiled attachment of render pass or rendering scope
+    */
+    struct attachment
+    {
+      resource Resource = NONE;                                     // Image
+      vk::ImageLayout Layout = vk::ImageLayout::eUndefined;         // Layout during rendering (dynamic rendering mode)
+      vk::AttachmentLoadOp LoadOp = vk::AttachmentLoadOp::eDontCare; // Load operation
+      vk::AttachmentStoreOp StoreOp = vk::AttachmentStoreOp::eStore; // Store operation
+      vk::ClearValue Clear;                                          // Clear value
+    }; /* struct attachment */
+
+    /**
+     * @brief Pass group, recorded as one render pass, rendering scope or plain commands
+    */
+    struct group
+    {
+      std::vector<UINT32> Passes;           // Passes, subpass index is index in this vector
+      BOOL IsRendering = FALSE;             // Group is render pass or dynamic rendering scope
+      std::vector<barrier> Barriers;        // Barriers before group
+      vk::RenderPass RenderPass;            // Render pass (subpass mode only)
+      std::vector<resource> Attachments;    // Render pass attachments (subpass mode only)
+      std::vector<vk::ClearValue> ClearValues; // Render pass clear values (subpass mode only)
+    }; /* struct group */
+
+    /**
+     * @brief Compiled pass
+    */
+    struct compiled_pass
+    {
+      UINT32 Group = NONE;                        // Group index
+      UINT32 Subpass = 0;                         // Subpass index in group render pass
+      std::vector<attachment> ColorAttachments;   // Color attachments (dynamic rendering mode only)
+      attachment DepthAttachment;                 // Depth attachment, NONE resource if absent (dynamic rendering mode only)
+      std::vector<vk::Format> ColorFormats;       // Color attachment formats
+      vk::Format DepthFormat = vk::Format::eUndefined; // Depth attachment format
+      vk::PipelineRenderingCreateInfo RenderingInfo;                      // Pipeline attachment formats (dynamic rendering mode only)
+      vk::CommandBufferInheritanceRenderingInfo InheritanceRenderingInfo; // Secondary command buffer attachment formats (dynamic rendering mode only)
+      vk::CommandBufferInheritanceInfo InheritanceInfo;                   // Secondary command buffer inheritance info
+    }; /* struct compiled_pass */
+
+    vk::Device Device;      // Device
+    VmaAllocator Allocator; // Allocator
+
+    mode Mode = mode::eSubpasses;           // Graphics pass execution mode
+    vk::Extent2D Extent;                    // Graph image extent
+    std::vector<image> Images;              // Declared images
+    std::vector<pass_description> Passes;   // Declared passes
+    std::vector<resource> ImportedImages;   // Imported images in import order
+
+    std::vector<memory_block> Blocks;            // Compiled memory blocks
+    std::vector<group> Groups;                   // Compiled pass groups
+    std::vector<compiled_pass> CompiledPasses;   // Compiled passes
+    std::vector<barrier> FinalBarriers;          // Barriers after last group
+    std::map<std::vector<UINT64>, vk::Framebuffer> Framebuffers; // Framebuffers by group, extent and attachment views
+
+    /**
+     * @brief Compiled state destroy function
+    */
+    VOID Destroy( VOID );
+
+    /**
+     * @brief Graph images creation and memory aliasing function, called after pass grouping
+    */
+    VOID AllocateImages( VOID );
+  }; /* class render_graph */
+} /* namespace anv::render::core */
+
+#endif // !defined(ANV_RENDER_CORE_GRAPH_H_)
+
+/* file anv_render_core_graph.h */
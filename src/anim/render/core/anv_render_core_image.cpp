@@ -8,36 +8,131 @@ namespace anv::render::core
   vk::ImageUsageFlags TranslateImageUsage( image::usage_flags Usage )
   {
     return vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc
-      | ((Usage & (image::usage_flags)image::usage::eSampled ) ? vk::ImageUsageFlagBits::eSampled : vk::ImageUsageFlagBits())
-      | ((Usage & (image::usage_flags)image::usage::eStorage ) ? vk::ImageUsageFlagBits::eStorage : vk::ImageUsageFlagBits())
+      | ((Usage & (image::usage_flags)image::usage::eSampled        ) ? vk::ImageUsageFlagBits::eSampled                : vk::ImageUsageFlagBits())
+      | ((Usage & (image::usage_flags)image::usage::eStorage        ) ? vk::ImageUsageFlagBits::eStorage                : vk::ImageUsageFlagBits())
+      | ((Usage & (image::usage_flags)image::usage::eColorAttachment) ? vk::ImageUsageFlagBits::eColorAttachment        : vk::ImageUsageFlagBits())
+      | ((Usage & (image::usage_flags)image::usage::eDepthAttachment) ? vk::ImageUsageFlagBits::eDepthStencilAttachment : vk::ImageUsageFlagBits())
       ;
   } /* TranslateImageUsage */
 
-  vk::Format TranslateFormat( format Format )
+  /* Format table row */
+  struct format_table_row
+  {
+    format::type Type;     // Component type, row is for
+    vk::Format Formats[4]; // Vulkan formats by component count (eUndefined if there is no format)
+  }; /* struct format_table_row */
+
+  /* Component type to Vulkan format table */
+  static constexpr format_table_row FormatTable[]
+  {
+    {format::type::eU8,      {vk::Format::eR8Uint, vk::Format::eR8G8Uint, vk::Format::eR8G8B8Uint, vk::Format::eR8G8B8A8Uint}},
+    {format::type::eU16,     {vk::Format::eR16Uint, vk::Format::eR16G16Uint, vk::Format::eR16G16B16Uint, vk::Format::eR16G16B16A16Uint}},
+    {format::type::eU32,     {vk::Format::eR32Uint, vk::Format::eR32G32Uint, vk::Format::eR32G32B32Uint, vk::Format::eR32G32B32A32Uint}},
+    {format::type::eU8Norm,  {vk::Format::eR8Unorm, vk::Format::eR8G8Unorm, vk::Format::eR8G8B8Unorm, vk::Format::eR8G8B8A8Unorm}},
+    {format::type::eU16Norm, {vk::Format::eR16Unorm, vk::Format::eR16G16Unorm, vk::Format::eR16G16B16Unorm, vk::Format::eR16G16B16A16Unorm}},
+    {format::type::eU8Srgb,  {vk::Format::eR8Srgb, vk::Format::eR8G8Srgb, vk::Format::eR8G8B8Srgb, vk::Format::eR8G8B8A8Srgb}},
+    {format::type::eI8,      {vk::Format::eR8Sint, vk::Format::eR8G8Sint, vk::Format::eR8G8B8Sint, vk::Format::eR8G8B8A8Sint}},
+    {format::type::eI16,     {vk::Format::eR16Sint, vk::Format::eR16G16Sint, vk::Format::eR16G16B16Sint, vk::Format::eR16G16B16A16Sint}},
+    {format::type::eI32,     {vk::Format::eR32Sint, vk::Format::eR32G32Sint, vk::Format::eR32G32B32Sint, vk::Format::eR32G32B32A32Sint}},
+    {format::type::eI8Norm,  {vk::Format::eR8Snorm, vk::Format::eR8G8Snorm, vk::Format::eR8G8B8Snorm, vk::Format::eR8G8B8A8Snorm}},
+    {format::type::eI16Norm, {vk::Format::eR16Snorm, vk::Format::eR16G16Snorm, vk::Format::eR16G16B16Snorm, vk::Format::eR16G16B16A16Snorm}},
+    {format::type::eI32Norm, {}},
+    {format::type::eF16,     {vk::Format::eR16Sfloat, vk::Format::eR16G16Sfloat, vk::Format::eR16G16B16Sfloat, vk::Format::eR16G16B16A16Sfloat}},
+    {format::type::eF32,     {vk::Format::eR32Sfloat, vk::Format::eR32G32Sfloat, vk::Format::eR32G32B32Sfloat, vk::Format::eR32G32B32A32Sfloat}},
+
+    {format::type::eD16,   {vk::Format::eD16Unorm}},
+    {format::type::eD32,   {vk::Format::eD32Sfloat}},
+    {format::type::eD24S8, {vk::Format::eUndefined, vk::Format::eD24UnormS8Uint}},
+    {format::type::eD32S8, {vk::Format::eUndefined, vk::Format::eD32SfloatS8Uint}},
+
+    {format::type::eBC1,         {vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eBc1RgbUnormBlock, vk::Format::eBc1RgbaUnormBlock}},
+    {format::type::eBC1Srgb,     {vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eBc1RgbSrgbBlock, vk::Format::eBc1RgbaSrgbBlock}},
+    {format::type::eBC2,         {vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eBc2UnormBlock}},
+    {format::type::eBC2Srgb,     {vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eBc2SrgbBlock}},
+    {format::type::eBC3,         {vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eBc3UnormBlock}},
+    {format::type::eBC3Srgb,     {vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eBc3SrgbBlock}},
+    {format::type::eBC4,         {vk::Format::eBc4UnormBlock}},
+    {format::type::eBC4Norm,     {vk::Format::eBc4SnormBlock}},
+    {format::type::eBC5,         {vk::Format::eUndefined, vk::Format::eBc5UnormBlock}},
+    {format::type::eBC5Norm,     {vk::Format::eUndefined, vk::Format::eBc5SnormBlock}},
+    {format::type::eBC6H,        {vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eBc6HUfloatBlock}},
+    {format::type::eBC6HSigned,  {vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eBc6HSfloatBlock}},
+    {format::type::eBC7,         {vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eBc7UnormBlock}},
+    {format::type::eBC7Srgb,     {vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eBc7SrgbBlock}},
+    {format::type::eETC2,        {vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eEtc2R8G8B8UnormBlock, vk::Format::eEtc2R8G8B8A8UnormBlock}},
+    {format::type::eETC2Srgb,    {vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eEtc2R8G8B8SrgbBlock, vk::Format::eEtc2R8G8B8A8SrgbBlock}},
+    {format::type::eEAC,         {vk::Format::eEacR11UnormBlock, vk::Format::eEacR11G11UnormBlock}},
+    {format::type::eEACNorm,     {vk::Format::eEacR11SnormBlock, vk::Format::eEacR11G11SnormBlock}},
+    {format::type::eASTC4x4,     {vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eAstc4x4UnormBlock}},
+    {format::type::eASTC4x4Srgb, {vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eAstc4x4SrgbBlock}},
+    {format::type::eASTC6x6,     {vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eAstc6x6UnormBlock}},
+    {format::type::eASTC6x6Srgb, {vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eAstc6x6SrgbBlock}},
+    {format::type::eASTC8x8,     {vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eAstc8x8UnormBlock}},
+    {format::type::eASTC8x8Srgb, {vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eUndefined, vk::Format::eAstc8x8SrgbBlock}},
+  };
+
+  /**
+   * @brief Format table validation function
+   * @return TRUE if table has row for every component type in enumeration order, and no Vulkan format is used twice
+  */
+  static constexpr BOOL IsFormatTableValid( VOID )
   {
-    static vk::Format FormatLUTTable[(SIZE_T)format::type::_eCount][4]
+    if (std::size(FormatTable) != (SIZE_T)format::type::_eCount)
+      return FALSE;
+
+    for (SIZE_T Row = 0; Row < std::size(FormatTable); Row++)
+      if (FormatTable[Row].Type != (format::type)Row)
+        return FALSE;
+
+    // Copied rows (e.g. 16 bit types, mapped to 8 bit formats) repeat formats of other ones
+    constexpr SIZE_T CELL_COUNT = std::size(FormatTable) * 4;
+    for (SIZE_T Cell = 0; Cell < CELL_COUNT; Cell++)
     {
-      /* eU8      */ {vk::Format::eR8Uint, vk::Format::eR8G8Uint, vk::Format::eR8G8B8Uint, vk::Format::eR8G8B8A8Uint},
-      /* eU16     */ {vk::Format::eR8Uint, vk::Format::eR8G8Uint, vk::Format::eR8G8B8Uint, vk::Format::eR8G8B8A8Uint},
-      /* eU32     */ {vk::Format::eR8Uint, vk::Format::eR8G8Uint, vk::Format::eR8G8B8Uint, vk::Format::eR8G8B8A8Uint},
-      /* eU8Norm  */ {vk::Format::eR8Unorm, vk::Format::eR8G8Unorm, vk::Format::eR8G8B8Unorm, vk::Format::eR8G8B8A8Unorm},
-      /* eU16Norm */ {vk::Format::eR8Unorm, vk::Format::eR8G8Unorm, vk::Format::eR8G8B8Unorm, vk::Format::eR8G8B8A8Unorm},
-      /* eU8Srgb  */ {vk::Format::eR8Srgb, vk::Format::eR8G8Srgb, vk::Format::eR8G8B8Srgb, vk::Format::eR8G8B8A8Srgb},
-      /* eI8      */ {vk::Format::eR8Sint, vk::Format::eR8G8Sint, vk::Format::eR8G8B8Sint, vk::Format::eR8G8B8A8Sint},
-      /* eI16     */ {vk::Format::eR8Sint, vk::Format::eR8G8Sint, vk::Format::eR8G8B8Sint, vk::Format::eR8G8B8A8Sint},
-      /* eI32     */ {vk::Format::eR8Sint, vk::Format::eR8G8Sint, vk::Format::eR8G8B8Sint, vk::Format::eR8G8B8A8Sint},
-      /* eI8Norm  */ {vk::Format::eR8Snorm, vk::Format::eR8G8Snorm, vk::Format::eR8G8B8Snorm, vk::Format::eR8G8B8A8Snorm},
-      /* eI16Norm */ {vk::Format::eR8Snorm, vk::Format::eR8G8Snorm, vk::Format::eR8G8B8Snorm, vk::Format::eR8G8B8A8Snorm},
-      /* eI32Norm */ {vk::Format::eR8Snorm, vk::Format::eR8G8Snorm, vk::Format::eR8G8B8Snorm, vk::Format::eR8G8B8A8Snorm},
-      /* eF16     */ {vk::Format::eR32Sfloat, vk::Format::eR32G32Sfloat, vk::Format::eR32G32B32Sfloat, vk::Format::eR32G32B32A32Sfloat},
-      /* eF32     */ {vk::Format::eR32Sfloat, vk::Format::eR32G32Sfloat, vk::Format::eR32G32B32Sfloat, vk::Format::eR32G32B32A32Sfloat},
-    };
+      const vk::Format Format = FormatTable[Cell / 4].Formats[Cell % 4];
+
+      if (Format != vk::Format::eUndefined)
+        for (SIZE_T OtherCell = Cell + 1; OtherCell < CELL_COUNT; OtherCell++)
+          if (FormatTable[OtherCell / 4].Formats[OtherCell % 4] == Format)
+            return FALSE;
+    }
+    return TRUE;
+  } /* IsFormatTableValid */
 
-    if (Format.Count > 4 || Format.Count < 1)
+  static_assert(IsFormatTableValid(), "Format table must have row per format::type in enumeration order without repeated formats");
+
+  vk::Format TranslateFormat( format Format )
+  {
+    if (Format.Count > 4 || Format.Count < 1 || Format.Type >= format::type::_eCount)
       return vk::Format::eUndefined;
-    return FormatLUTTable[(SIZE_T)Format.Type][Format.Count - 1];
+    return FormatTable[(SIZE_T)Format.Type].Formats[Format.Count - 1];
   } /* TranslateFormat */
 
+  BOOL IsDepthFormat( format Format )
+  {
+    return Format.Type >= format::type::eD16 && Format.Type <= format::type::eD32S8;
+  } /* IsDepthFormat */
+
+  format_support system::GetFormatSupport( format Format ) const
+  {
+    const vk::Format FormatVK = TranslateFormat(Format);
+    if (FormatVK == vk::Format::eUndefined)
+      return format_support {};
+
+    // Physical device queries need no synchronization
+    const vk::FormatProperties Properties = PhysicalDevice.getFormatProperties(FormatVK);
+    const vk::FormatFeatureFlags Features = Properties.optimalTilingFeatures;
+
+    return format_support
+    {
+      .IsSampled = (Features & vk::FormatFeatureFlagBits::eSampledImage) ? TRUE : FALSE,
+      .IsFiltered = (Features & vk::FormatFeatureFlagBits::eSampledImageFilterLinear) ? TRUE : FALSE,
+      .IsStorage = (Features & vk::FormatFeatureFlagBits::eStorageImage) ? TRUE : FALSE,
+      .IsColorAttachment = (Features & vk::FormatFeatureFlagBits::eColorAttachment) ? TRUE : FALSE,
+      .IsDepthAttachment = (Features & vk::FormatFeatureFlagBits::eDepthStencilAttachment) ? TRUE : FALSE,
+      .IsVertexBuffer = (Properties.bufferFeatures & vk::FormatFeatureFlagBits::eVertexBuffer) ? TRUE : FALSE,
+    };
+  } /* GetFormatSupport */
+
   /**
    * @brief Image building function
    * @param Builder Builder reference
@@ -45,13 +140,26 @@ namespace anv::render::core
   */
   image * system::Build( image::builder &Builder )
   {
+    // Block compressed formats and some wide ones are optional
+    const format_support Support = GetFormatSupport(Builder.Format);
+    if (((Builder.Usage & (image::usage_flags)image::usage::eSampled) && !Support.IsSampled) ||
+        ((Builder.Usage & (image::usage_flags)image::usage::eStorage) && !Support.IsStorage) ||
+        ((Builder.Usage & (image::usage_flags)image::usage::eColorAttachment) && !Support.IsColorAttachment) ||
+        ((Builder.Usage & (image::usage_flags)image::usage::eDepthAttachment) && !Support.IsDepthAttachment) ||
+        TranslateFormat(Builder.Format) == vk::Format::eUndefined)
+      return nullptr;
+
     vk::ImageUsageFlags UsageVK = TranslateImageUsage(Builder.Usage);
     vk::Format FormatVK = TranslateFormat(Builder.Format);
     vk::ImageCreateInfo ImageCreateInfo;
     ImageCreateInfo
+      .setImageType(vk::ImageType::e2D)
+      .setUsage(UsageVK)
       .setMipLevels(Builder.MipLevels)
+      .setArrayLayers(1)
       .setFormat(FormatVK)
       .setExtent({(UINT32)Builder.Extent.W, (UINT32)Builder.Extent.H, 1})
+      .setTiling(vk::ImageTiling::eOptimal)
       .setSharingMode(vk::SharingMode::eExclusive)
       ;
 
@@ -111,7 +219,7 @@ namespace anv::render::core
       .setFormat(TranslateFormat(Format))
       .setImage(Image)
       .setSubresourceRange(vk::ImageSubresourceRange()
-        .setAspectMask(vk::ImageAspectFlagBits::eColor)
+        .setAspectMask(IsDepthFormat(Format) ? vk::ImageAspectFlagBits::eDepth : vk::ImageAspectFlagBits::eColor)
         .setBaseMipLevel(Builder.BaseMipLevel)
         .setLevelCount(Builder.MipLevelCount)
       )
@@ -0,0 +1,871 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/anim/render/core/anv_render_core_lighting.cpp
+ * @description Render core clustered deferred lighting implementation module
+ * @last_update 18.10.2026
+*/
+
+#include "anv.h"
+
+#include <shaderc/shaderc.hpp>
+
+namespace anv::render::core
+{
+  /**
+   * Light culling shader. One invocation per view space cluster: builds cluster box from its screen tile and exponential depth slice,
+   * tests light spheres against it in batches, loaded to shared memory by whole workgroup.
+  */
+  static const CHAR *LightCullingShaderSource = R"(
+    #version 450
+
+    layout(local_size_x = GROUP_SIZE) in;
+
+    struct light
+    {
+      vec3 Position;
+      float Radius;
+      vec3 Color;
+      float Padding;
+    };
+
+    layout(set = 0, binding = 0, std140) uniform params
+    {
+      mat4 InverseProjection;
+      mat4 View;
+      vec4 Ambient;
+      vec2 OutputExtent;
+      float Near, Far;
+      float SliceScale, SliceBias;
+      uint LightCount;
+      uint IsLit;
+      mat4 ShadowMatrices[SHADOW_CASCADE_COUNT];
+      vec4 CascadeSplits;
+      vec4 CascadeTexelSizes;
+      vec4 SunDirection;
+      vec4 SunColor;
+    } Params;
+
+    layout(set = 0, binding = 1, std430) readonly buffer lights { light Lights[]; };
+    layout(set = 0, binding = 2, std430) writeonly buffer light_grid
+    {
+      uint ClusterLightCounts[CLUSTER_X * CLUSTER_Y * CLUSTER_Z];
+      uint ClusterLightIndices[];
+    };
+    layout(set = 0, binding = 4, std430) buffer light_overflow { uint LightOverflowCount; };
+
+    shared vec4 BatchLights[GROUP_SIZE];
+
+    // View space point at given distance along ray through NDC point
+    vec3 GetViewPoint( vec2 NDC, float Distance )
+    {
+      vec4 Point = Params.InverseProjection * vec4(NDC, 1, 1);
+      vec3 Direction = Point.xyz / Point.w;
+
+      return Direction * (Distance / -Direction.z);
+    }
+
+    void main()
+    {
+      uint Cluster = gl_GlobalInvocationID.x;
+      bool IsValid = Cluster < CLUSTER_X * CLUSTER_Y * CLUSTER_Z;
+      uvec3 Index = uvec3(Cluster % CLUSTER_X, Cluster / CLUSTER_X % CLUSTER_Y, Cluster / (CLUSTER_X * CLUSTER_Y));
+
+      vec2
+        MinNDC = vec2(Index.xy) / vec2(CLUSTER_X, CLUSTER_Y) * 2 - 1,
+        MaxNDC = vec2(Index.xy + 1) / vec2(CLUSTER_X, CLUSTER_Y) * 2 - 1;
+      float
+        NearDistance = Params.Near * pow(Params.Far / Params.Near, float(Index.z) / CLUSTER_Z),
+        FarDistance = Params.Near * pow(Params.Far / Params.Near, float(Index.z + 1) / CLUSTER_Z);
+      vec3 Min = vec3(1e30), Max = vec3(-1e30);
+
+      for (int i = 0; i < 8; i++)
+      {
+        vec3 Corner = GetViewPoint(
+          vec2((i & 1) != 0 ? MaxNDC.x : MinNDC.x, (i & 2) != 0 ? MaxNDC.y : MinNDC.y),
+          (i & 4) != 0 ? FarDistance : NearDistance);
+
+        Min = min(Min, Corner);
+        Max = max(Max, Corner);
+      }
+
+      // Every invocation takes part in batch loading, so barriers are in uniform control flow.
+      // Lights past cluster list capacity are still counted to report them as dropped.
+      uint Count = 0;
+
+      for (uint First = 0; First < Params.LightCount; First += GROUP_SIZE)
+      {
+        uint LightIndex = First + gl_LocalInvocationID.x;
+
+        if (LightIndex < Params.LightCount)
+          BatchLights[gl_LocalInvocationID.x] = vec4(Lights[LightIndex].Position, Lights[LightIndex].Radius);
+        barrier();
+
+        if (IsValid)
+          for (uint i = 0; i < min(GROUP_SIZE, Params.LightCount - First); i++)
+          {
+            vec4 Light = BatchLights[i];
+            vec3 Offset = clamp(Light.xyz, Min, Max) - Light.xyz;
+
+            if (dot(Offset, Offset) <= Light.w * Light.w)
+            {
+              if (Count < MAX_CLUSTER_LIGHT_COUNT)
+                ClusterLightIndices[Cluster * MAX_CLUSTER_LIGHT_COUNT + Count] = First + i;
+              Count++;
+            }
+          }
+        barrier();
+      }
+
+      if (IsValid)
+      {
+        ClusterLightCounts[Cluster] = min(Count, MAX_CLUSTER_LIGHT_COUNT);
+        if (Count > MAX_CLUSTER_LIGHT_COUNT)
+          atomicAdd(LightOverflowCount, Count - MAX_CLUSTER_LIGHT_COUNT);
+      }
+    }
+  )";
+
+  // Fullscreen triangle vertex shader
+  static const CHAR *ShadingVertexShaderSource = R"(
+    #version 450
+
+    void main()
+    {
+      vec2 UV = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+
+      gl_Position = vec4(UV * 2 - 1, 0, 1);
+    }
+  )";
+
+  /**
+   * Deferred shading fragment shader. Reads G-buffer of layout, selected by GBUFFER_* macro, as input attachments
+   * (as sampled images in dynamic rendering mode) and evaluates lights of pixel cluster. Visibility layout surface is
+   * fetched by device addresses: instance, its level of detail draw, triangle vertices and material surface.
+  */
+  static const CHAR *ShadingFragmentShaderSource = R"(
+    #version 450
+
+    #if defined(GBUFFER_VISIBILITY)
+      #extension GL_EXT_buffer_reference : require
+    #endif
+
+    #ifdef DYNAMIC_RENDERING
+      #define INPUT(Index, SubpassType, SamplerType, Name) layout(set = 1, binding = Index) uniform SamplerType Name
+      #define LOAD(Name) texelFetch(Name, ivec2(gl_FragCoord.xy), 0)
+    #else
+      #define INPUT(Index, SubpassType, SamplerType, Name) layout(set = 1, binding = Index, input_attachment_index = Index) uniform SubpassType Name
+      #define LOAD(Name) subpassLoad(Name)
+    #endif
+
+    #define PI 3.14159265
+
+    struct light
+    {
+      vec3 Position;
+      float Radius;
+      vec3 Color;
+      float Padding;
+    };
+
+    #if defined(GBUFFER_VISIBILITY)
+      layout(buffer_reference, std430, buffer_reference_align = 4) readonly buffer words { uint Words[]; };
+
+      struct instance
+      {
+        mat4 Transform;
+        uint DrawIndex;
+        uint VisibilityID;
+        uint FirstDrawIndex;
+        uint Padding;
+      };
+
+      struct shading_draw
+      {
+        words Indices;
+        words Positions;
+        words Normals;
+        uint PositionStride;
+        uint NormalStride;
+        uint FirstIndex;
+        int VertexOffset;
+        uint TriangleCount;
+        uint VertexCount;
+        uint IsIndexed;
+        uint HasNormals;
+        vec4 BaseColorAmbientOcclusion;
+        vec4 MetallicRoughness;
+      };
+
+      layout(buffer_reference, std430, buffer_reference_align = 16) readonly buffer instances { instance Instances[]; };
+      layout(buffer_reference, std430, buffer_reference_align = 16) readonly buffer shading_draws { shading_draw Draws[]; };
+    #endif
+
+    layout(set = 0, binding = 0, std140) uniform params
+    {
+      mat4 InverseProjection;
+      mat4 View;
+      vec4 Ambient;
+      vec2 OutputExtent;
+      float Near, Far;
+      float SliceScale, SliceBias;
+      uint LightCount;
+      uint IsLit;
+      mat4 ShadowMatrices[SHADOW_CASCADE_COUNT];
+      vec4 CascadeSplits;
+      vec4 CascadeTexelSizes;
+      vec4 SunDirection;
+      vec4 SunColor;
+    #if defined(GBUFFER_VISIBILITY)
+      shading_draws ShadingDraws;
+      instances GpuInstances;
+      instances CpuInstances;
+      uint GpuInstanceCount;
+      uint TriangleBits;
+    #endif
+    } Params;
+
+    layout(set = 0, binding = 1, std430) readonly buffer lights { light Lights[]; };
+    layout(set = 0, binding = 2, std430) readonly buffer light_grid
+    {
+      uint ClusterLightCounts[CLUSTER_X * CLUSTER_Y * CLUSTER_Z];
+      uint ClusterLightIndices[];
+    };
+    layout(set = 0, binding = 3) uniform sampler2DArrayShadow ShadowMap;
+
+    #if defined(GBUFFER_WIDE)
+      INPUT(0, subpassInput, sampler2D, PositionObjectID);
+    #else
+      INPUT(0, usubpassInput, usampler2D, ObjectID);
+    #endif
+    #if defined(GBUFFER_VISIBILITY)
+      INPUT(1, subpassInput, sampler2D, Depth);
+    #else
+      INPUT(1, subpassInput, sampler2D, Normal);
+      INPUT(2, subpassInput, sampler2D, BaseColorAmbientOcclusion);
+      INPUT(3, subpassInput, sampler2D, MetallicRoughnessInstance);
+    #endif
+    #if defined(GBUFFER_COMPACT)
+      INPUT(4, subpassInput, sampler2D, Depth);
+    #endif
+
+    layout(location = 0) out vec4 OutColor;
+
+    vec3 DecodeOctahedral( vec2 E )
+    {
+      vec3 N = vec3(E, 1 - abs(E.x) - abs(E.y));
+      float T = max(-N.z, 0);
+
+      N.xy += vec2(N.x >= 0 ? -T : T, N.y >= 0 ? -T : T);
+      return normalize(N);
+    }
+
+    #if defined(GBUFFER_VISIBILITY)
+      vec3 FetchVec3( words Buffer, uint Word )
+      {
+        return uintBitsToFloat(uvec3(Buffer.Words[Word], Buffer.Words[Word + 1], Buffer.Words[Word + 2]));
+      }
+    #endif
+
+    // Lambert diffuse and GGX specular with Schlick Fresnel of unit light
+    vec3 EvaluateBRDF( vec3 N, vec3 V, vec3 L, vec3 BaseColor, vec3 F0, float Metallic, float A2 )
+    {
+      vec3 H = normalize(L + V);
+      float NdotH = max(dot(N, H), 0);
+      float D = A2 / (PI * pow(NdotH * NdotH * (A2 - 1) + 1, 2));
+      vec3 F = F0 + (1 - F0) * pow(1 - max(dot(H, V), 0), 5);
+      vec3 Diffuse = (1 - F) * (1 - Metallic) * BaseColor / PI;
+
+      return (Diffuse + F * D * 0.25) * max(dot(N, L), 0);
+    }
+
+    // Directional light visibility from the nearest cascade, containing point
+    float GetSunShadow( vec3 Position, vec3 N )
+    {
+      float Distance = -Position.z;
+      uint Cascade = 0;
+
+      while (Cascade < SHADOW_CASCADE_COUNT - 1 && Distance > Params.CascadeSplits[Cascade])
+        Cascade++;
+      if (Distance > Params.CascadeSplits[SHADOW_CASCADE_COUNT - 1])
+        return 1;
+
+      // Normal offset by cascade texel hides acne on surfaces, parallel to light
+      vec4 Point = Params.ShadowMatrices[Cascade] * vec4(Position + N * Params.CascadeTexelSizes[Cascade] * 1.5, 1);
+
+      // Explicit zero gradients, as lookup is in non-uniform control flow
+      return textureGrad(ShadowMap, vec4(Point.xy, Cascade, Point.z), vec2(0), vec2(0));
+    }
+
+    void main()
+    {
+      // View space position and surface. Marker pass output is kept under background texels.
+    #if defined(GBUFFER_WIDE)
+      vec4 PositionID = LOAD(PositionObjectID);
+      if (PositionID.w < 0)
+        discard;
+      vec3 Position = (Params.View * vec4(PositionID.xyz, 1)).xyz;
+    #elif defined(GBUFFER_COMPACT)
+      if (LOAD(ObjectID).r == 0xFFFFFFFFu)
+        discard;
+      vec4 Point = Params.InverseProjection * vec4(gl_FragCoord.xy / Params.OutputExtent * 2 - 1, LOAD(Depth).r, 1);
+      vec3 Position = Point.xyz / Point.w;
+    #else
+      uint ID = LOAD(ObjectID).r;
+      if (ID == 0xFFFFFFFFu)
+        discard;
+
+      // Instance indices of CPU culled instances follow GPU culled ones
+      uint InstanceIndex = ID >> Params.TriangleBits, Triangle = ID & ((1u << Params.TriangleBits) - 1);
+      instance Instance = InstanceIndex < Params.GpuInstanceCount ?
+        Params.GpuInstances.Instances[InstanceIndex] : Params.CpuInstances.Instances[InstanceIndex - Params.GpuInstanceCount];
+      shading_draw Draw = Params.ShadingDraws.Draws[Instance.DrawIndex];
+
+      // Primitive without position stream can't be fetched
+      if (Draw.VertexCount == 0 || Draw.TriangleCount == 0)
+        discard;
+
+      // Out of range triangles and indices are clamped, so broken geometry can't read outside of its buffers
+      mat4 ModelView = Params.View * Instance.Transform;
+      uint Vertices[3];
+      vec3 Points[3];
+
+      Triangle = min(Triangle, Draw.TriangleCount - 1);
+      for (uint i = 0; i < 3; i++)
+      {
+        uint Vertex = Draw.IsIndexed != 0 ?
+          uint(int(Draw.Indices.Words[Draw.FirstIndex + Triangle * 3 + i]) + Draw.VertexOffset) : Draw.FirstIndex + Triangle * 3 + i;
+
+        Vertices[i] = min(Vertex, Draw.VertexCount - 1);
+        Points[i] = (ModelView * vec4(FetchVec3(Draw.Positions, Vertices[i] * Draw.PositionStride), 1)).xyz;
+      }
+
+      // Perspective correct barycentrics of view ray through pixel center (Moller-Trumbore intersection)
+      vec4 FarPoint = Params.InverseProjection * vec4(gl_FragCoord.xy / Params.OutputExtent * 2 - 1, 1, 1);
+      vec3
+        Direction = FarPoint.xyz / FarPoint.w,
+        Edge1 = Points[1] - Points[0],
+        Edge2 = Points[2] - Points[0],
+        P = cross(Direction, Edge2),
+        T = -Points[0],
+        Q = cross(T, Edge1);
+      float Determinant = dot(Edge1, P);
+      vec2 UV = abs(Determinant) > 1e-12 ? vec2(dot(T, P), dot(Direction, Q)) / Determinant : vec2(1.0 / 3);
+      vec3 Barycentrics = vec3(1 - UV.x - UV.y, UV);
+      vec3 Position = Points[0] + Edge1 * UV.x + Edge2 * UV.y;
+    #endif
+
+    #if defined(GBUFFER_VISIBILITY)
+      // Instance transforms are assumed to scale uniformly, so normals are transformed by model view rotation part
+      vec3 FaceNormal = cross(Edge1, Edge2);
+      vec3 N = FaceNormal;
+
+      if (Draw.HasNormals != 0)
+        N = mat3(ModelView) * (
+          FetchVec3(Draw.Normals, Vertices[0] * Draw.NormalStride) * Barycentrics.x +
+          FetchVec3(Draw.Normals, Vertices[1] * Draw.NormalStride) * Barycentrics.y +
+          FetchVec3(Draw.Normals, Vertices[2] * Draw.NormalStride) * Barycentrics.z);
+
+      // Back faces (of primitives without culling) are lit from viewed side
+      N = normalize(dot(FaceNormal, Direction) > 0 ? -N : N);
+
+      vec3 BaseColor = Draw.BaseColorAmbientOcclusion.rgb;
+      float AmbientOcclusion = Draw.BaseColorAmbientOcclusion.a, Metallic = Draw.MetallicRoughness.r, Roughness = max(Draw.MetallicRoughness.g, 0.05);
+    #else
+      vec3 N = normalize(mat3(Params.View) * DecodeOctahedral(LOAD(Normal).xy));
+      vec4 BaseColorAO = LOAD(BaseColorAmbientOcclusion);
+      vec4 MetallicRoughness = LOAD(MetallicRoughnessInstance);
+      vec3 BaseColor = BaseColorAO.rgb;
+      float AmbientOcclusion = BaseColorAO.a, Metallic = MetallicRoughness.r, Roughness = max(MetallicRoughness.g, 0.05);
+    #endif
+
+      vec3 Color = Params.Ambient.rgb * BaseColor * AmbientOcclusion;
+
+      if (Params.IsLit != 0)
+      {
+        uvec2 Tile = min(uvec2(gl_FragCoord.xy / Params.OutputExtent * vec2(CLUSTER_X, CLUSTER_Y)), uvec2(CLUSTER_X - 1, CLUSTER_Y - 1));
+        uint Slice = uint(clamp(log(max(-Position.z, Params.Near)) * Params.SliceScale + Params.SliceBias, 0, CLUSTER_Z - 1));
+        uint Cluster = (Slice * CLUSTER_Y + Tile.y) * CLUSTER_X + Tile.x;
+        uint Count = ClusterLightCounts[Cluster];
+
+        vec3 V = normalize(-Position);
+        vec3 F0 = mix(vec3(0.04), BaseColor, Metallic);
+        float A2 = Roughness * Roughness * Roughness * Roughness;
+
+        for (uint i = 0; i < Count; i++)
+        {
+          light Light = Lights[ClusterLightIndices[Cluster * MAX_CLUSTER_LIGHT_COUNT + i]];
+          vec3 L = Light.Position - Position;
+          float Distance = length(L);
+          float Attenuation = clamp(1 - Distance / Light.Radius, 0, 1);
+
+          if (Attenuation == 0)
+            continue;
+          Color += EvaluateBRDF(N, V, L / Distance, BaseColor, F0, Metallic, A2) * Light.Color * Attenuation * Attenuation;
+        }
+
+        if (dot(Params.SunColor.rgb, Params.SunColor.rgb) > 0 && dot(N, Params.SunDirection.xyz) > 0)
+        {
+          float Shadow = Params.SunColor.w != 0 ? GetSunShadow(Position, N) : 1;
+
+          Color += EvaluateBRDF(N, V, Params.SunDirection.xyz, BaseColor, F0, Metallic, A2) * Params.SunColor.rgb * Shadow;
+        }
+      }
+
+      OutColor = vec4(Color, 1);
+    }
+  )";
+
+  /**
+   * @brief GLSL shader module creation function
+   * @param Device Device to create module on
+   * @param Source GLSL shader source
+   * @param Kind Shader stage
+   * @param Name Shader name (for compilation errors)
+   * @param Macros Preprocessor definitions
+   * @return Created shader module
+  */
+  static vk::ShaderModule CreateShaderModule( vk::Device Device, const CHAR *Source, shaderc_shader_kind Kind, const CHAR *Name,
+                                              std::span<const std::pair<std::string, std::string>> Macros )
+  {
+    shaderc::Compiler Compiler;
+    shaderc::CompileOptions Options;
+
+    Options.SetOptimizationLevel(shaderc_optimization_level_performance);
+    Options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_3);
+    for (const auto &[Macro, Value] : Macros)
+      Options.AddMacroDefinition(Macro, Value);
+
+    shaderc::SpvCompilationResult Compiled = Compiler.CompileGlslToSpv(Source, Kind, Name, Options);
+    if (Compiled.GetCompilationStatus() != shaderc_compilation_status_success)
+      throw std::runtime_error(Compiled.GetErrorMessage());
+
+    std::vector<UINT32> SPV(Compiled.cbegin(), Compiled.cend());
+    return Device.createShaderModule(vk::ShaderModuleCreateInfo().setCode(SPV));
+  } /* CreateShaderModule */
+
+  /**
+   * @brief Deferred lighting resources initialization function. Called after render graph is built.
+  */
+  VOID system::InitLighting( VOID )
+  {
+    const BOOL IsDynamicRendering = GraphMode == render_graph::mode::eDynamicRendering;
+    const vk::DescriptorType InputType = IsDynamicRendering ? vk::DescriptorType::eCombinedImageSampler : vk::DescriptorType::eInputAttachment;
+    const vk::ShaderStageFlags LightingStages = vk::ShaderStageFlagBits::eCompute | vk::ShaderStageFlagBits::eFragment;
+
+    vk::DescriptorSetLayoutBinding LightingBindings[]
+    {
+      {0, vk::DescriptorType::eUniformBuffer,        1, LightingStages},                      // Params
+      {1, vk::DescriptorType::eStorageBuffer,        1, LightingStages},                      // Lights
+      {2, vk::DescriptorType::eStorageBuffer,        1, LightingStages},                      // Light grid
+      {3, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment}, // Shadow map
+      {4, vk::DescriptorType::eStorageBuffer,        1, vk::ShaderStageFlagBits::eCompute},  // Light overflow counter
+    };
+    std::vector<vk::DescriptorSetLayoutBinding> InputBindings;
+    for (UINT32 Binding = 0; Binding < ShadingInputs.size(); Binding++)
+      InputBindings.push_back({Binding, InputType, 1, vk::ShaderStageFlagBits::eFragment});
+
+    LightingDescriptorSetLayout = Device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo().setBindings(LightingBindings));
+    ShadingInputSetLayout = Device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo().setBindings(InputBindings));
+
+    const vk::DescriptorSetLayout ShadingSetLayouts[] {LightingDescriptorSetLayout, ShadingInputSetLayout};
+    LightCullingPipelineLayout = Device.createPipelineLayout(vk::PipelineLayoutCreateInfo().setSetLayouts(LightingDescriptorSetLayout));
+    ShadingPipelineLayout = Device.createPipelineLayout(vk::PipelineLayoutCreateInfo().setSetLayouts(ShadingSetLayouts));
+
+    vk::DescriptorPoolSize PoolSizes[]
+    {
+      {vk::DescriptorType::eUniformBuffer,        FRAMES_IN_FLIGHT},
+      {vk::DescriptorType::eStorageBuffer,        3 * FRAMES_IN_FLIGHT},
+      {vk::DescriptorType::eCombinedImageSampler, FRAMES_IN_FLIGHT},
+      {InputType,                                 MAX_SHADING_INPUT_COUNT},
+    };
+    LightingDescriptorPool = Device.createDescriptorPool(vk::DescriptorPoolCreateInfo()
+      .setMaxSets(FRAMES_IN_FLIGHT + 1)
+      .setPoolSizes(PoolSizes)
+    );
+
+    // Lighting sets are per frame in flight, shading input set follows graph images, which are shared
+    for (frame_slot &Slot : FrameSlots)
+      Slot.LightingDescriptorSet = Device.allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
+        .setDescriptorPool(LightingDescriptorPool)
+        .setSetLayouts(LightingDescriptorSetLayout)
+      )[0];
+    ShadingInputSet = Device.allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
+      .setDescriptorPool(LightingDescriptorPool)
+      .setSetLayouts(ShadingInputSetLayout)
+    )[0];
+
+    /* Pipelines */
+
+    const std::pair<std::string, std::string> Macros[]
+    {
+      {"CLUSTER_X", std::to_string(LIGHT_CLUSTER_X)},
+      {"CLUSTER_Y", std::to_string(LIGHT_CLUSTER_Y)},
+      {"CLUSTER_Z", std::to_string(LIGHT_CLUSTER_Z)},
+      {"MAX_CLUSTER_LIGHT_COUNT", std::to_string(MAX_CLUSTER_LIGHT_COUNT)},
+      {"GROUP_SIZE", std::to_string(LIGHT_CULLING_GROUP_SIZE)},
+      {"SHADOW_CASCADE_COUNT", std::to_string(SHADOW_CASCADE_COUNT)},
+      {std::array {"GBUFFER_WIDE", "GBUFFER_COMPACT", "GBUFFER_VISIBILITY"}[(UINT32)GBufferLayout], "1"},
+      {IsDynamicRendering ? "DYNAMIC_RENDERING" : "SUBPASSES", "1"},
+    };
+
+    vk::ShaderModule CullingModule = CreateShaderModule(Device, LightCullingShaderSource, shaderc_compute_shader, "light_culling.comp", Macros);
+    vk::Result CullingCreateResult;
+    std::tie(CullingCreateResult, LightCullingPipeline) = Device.createComputePipeline(nullptr, vk::ComputePipelineCreateInfo()
+      .setStage(vk::PipelineShaderStageCreateInfo()
+        .setStage(vk::ShaderStageFlagBits::eCompute)
+        .setModule(CullingModule)
+        .setPName("main")
+      )
+      .setLayout(LightCullingPipelineLayout)
+    );
+    Device.destroyShaderModule(CullingModule);
+    if (CullingCreateResult != vk::Result::eSuccess)
+      vk::detail::throwResultException(CullingCreateResult, "createComputePipeline");
+
+    vk::ShaderModule
+      VertexModule = CreateShaderModule(Device, ShadingVertexShaderSource, shaderc_vertex_shader, "shading.vert", Macros),
+      FragmentModule = CreateShaderModule(Device, ShadingFragmentShaderSource, shaderc_fragment_shader, "shading.frag", Macros);
+
+    vk::PipelineShaderStageCreateInfo Stages[]
+    {
+      vk::PipelineShaderStageCreateInfo()
+        .setModule(VertexModule)
+        .setPName("main")
+        .setStage(vk::ShaderStageFlagBits::eVertex),
+      vk::PipelineShaderStageCreateInfo()
+        .setModule(FragmentModule)
+        .setPName("main")
+        .setStage(vk::ShaderStageFlagBits::eFragment),
+    };
+    vk::PipelineVertexInputStateCreateInfo VertexInputState;
+    vk::PipelineInputAssemblyStateCreateInfo InputAssemblyState = vk::PipelineInputAssemblyStateCreateInfo()
+      .setTopology(vk::PrimitiveTopology::eTriangleList);
+    vk::PipelineViewportStateCreateInfo ViewportState = vk::PipelineViewportStateCreateInfo()
+      .setViewportCount(1)
+      .setScissorCount(1);
+    vk::PipelineRasterizationStateCreateInfo RasterizationState = vk::PipelineRasterizationStateCreateInfo()
+      .setPolygonMode(vk::PolygonMode::eFill)
+      .setCullMode(vk::CullModeFlagBits::eNone)
+      .setLineWidth(1);
+    vk::PipelineMultisampleStateCreateInfo MultisampleState = vk::PipelineMultisampleStateCreateInfo()
+      .setRasterizationSamples(vk::SampleCountFlagBits::e1);
+    vk::PipelineColorBlendAttachmentState ColorBlendAttachmentState = vk::PipelineColorBlendAttachmentState()
+      .setBlendEnable(vk::False)
+      .setColorWriteMask(vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA);
+    vk::PipelineColorBlendStateCreateInfo ColorBlendState = vk::PipelineColorBlendStateCreateInfo()
+      .setAttachments(ColorBlendAttachmentState);
+    vk::DynamicState DynamicStates[] {vk::DynamicState::eViewport, vk::DynamicState::eScissor};
+    vk::PipelineDynamicStateCreateInfo DynamicState = vk::PipelineDynamicStateCreateInfo()
+      .setDynamicStates(DynamicStates);
+
+    // Graph rebuilds keep shading render pass compatible
+    RenderGraphMutex.lock();
+    vk::Result ShadingCreateResult;
+    std::tie(ShadingCreateResult, ShadingPipeline) = Device.createGraphicsPipeline(nullptr, vk::GraphicsPipelineCreateInfo()
+      .setPNext(RenderGraph->GetPipelineRenderingInfo(ShadingGraphPass))
+      .setStages(Stages)
+      .setPVertexInputState(&VertexInputState)
+      .setPInputAssemblyState(&InputAssemblyState)
+      .setPViewportState(&ViewportState)
+      .setPRasterizationState(&RasterizationState)
+      .setPMultisampleState(&MultisampleState)
+      .setPColorBlendState(&ColorBlendState)
+      .setPDynamicState(&DynamicState)
+      .setLayout(ShadingPipelineLayout)
+      .setRenderPass(RenderGraph->GetRenderPass(ShadingGraphPass))
+      .setSubpass(RenderGraph->GetSubpass(ShadingGraphPass))
+    );
+    RenderGraphMutex.unlock();
+
+    Device.destroyShaderModule(VertexModule);
+    Device.destroyShaderModule(FragmentModule);
+    if (ShadingCreateResult != vk::Result::eSuccess)
+      vk::detail::throwResultException(ShadingCreateResult, "createGraphicsPipeline");
+
+    // G-buffer images are fetched texel by texel, so they never blend neighbour texels or mip levels
+    GBufferSampler = Device.createSampler(vk::SamplerCreateInfo()
+      .setMinFilter(vk::Filter::eNearest)
+      .setMagFilter(vk::Filter::eNearest)
+      .setMipmapMode(vk::SamplerMipmapMode::eNearest)
+      .setAddressModeU(vk::SamplerAddressMode::eClampToEdge)
+      .setAddressModeV(vk::SamplerAddressMode::eClampToEdge)
+      .setMaxLod(0)
+    );
+
+    /* Buffers */
+
+    ReserveGpuCullingBuffer(LightGridBuffer, (SIZE_T)LIGHT_CLUSTER_COUNT * (1 + MAX_CLUSTER_LIGHT_COUNT) * sizeof(UINT32),
+      vk::BufferUsageFlagBits::eStorageBuffer, FALSE);
+
+    for (frame_slot &Slot : FrameSlots)
+    {
+      ReserveGpuCullingBuffer(Slot.LightingParamsBuffer, sizeof(gpu_lighting_params), vk::BufferUsageFlagBits::eUniformBuffer, TRUE);
+      ReserveGpuCullingBuffer(Slot.LightBuffer, sizeof(gpu_light), vk::BufferUsageFlagBits::eStorageBuffer, TRUE);
+      ReserveGpuCullingBuffer(Slot.LightOverflowBuffer, sizeof(UINT32), vk::BufferUsageFlagBits::eStorageBuffer, TRUE);
+      *reinterpret_cast<UINT32 *>(Slot.LightOverflowBuffer.Data) = 0;
+      vmaFlushAllocation(Allocator, Slot.LightOverflowBuffer.Allocation, 0, VK_WHOLE_SIZE);
+
+      // Light buffer grows with light count, so its binding is rewritten by PrepareLighting too
+      vk::DescriptorBufferInfo BufferInfos[]
+      {
+        {Slot.LightingParamsBuffer.Buffer, 0, VK_WHOLE_SIZE},
+        {Slot.LightBuffer.Buffer,          0, VK_WHOLE_SIZE},
+        {LightGridBuffer.Buffer,           0, VK_WHOLE_SIZE},
+        {Slot.LightOverflowBuffer.Buffer,  0, VK_WHOLE_SIZE},
+      };
+      vk::DescriptorImageInfo ShadowMapInfo {ShadowSampler, ShadowMapView, vk::ImageLayout::eShaderReadOnlyOptimal};
+      vk::WriteDescriptorSet Writes[5];
+      for (UINT32 Binding = 0; Binding < 3; Binding++)
+        Writes[Binding] = vk::WriteDescriptorSet()
+          .setDstSet(Slot.LightingDescriptorSet)
+          .setDstBinding(Binding)
+          .setDescriptorType(Binding == 0 ? vk::DescriptorType::eUniformBuffer : vk::DescriptorType::eStorageBuffer)
+          .setBufferInfo(BufferInfos[Binding]);
+      Writes[3] = vk::WriteDescriptorSet()
+        .setDstSet(Slot.LightingDescriptorSet)
+        .setDstBinding(3)
+        .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+        .setImageInfo(ShadowMapInfo);
+      Writes[4] = vk::WriteDescriptorSet()
+        .setDstSet(Slot.LightingDescriptorSet)
+        .setDstBinding(4)
+        .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+        .setBufferInfo(BufferInfos[3]);
+      Device.updateDescriptorSets(Writes, {});
+    }
+  } /* InitLighting */
+
+  /**
+   * @brief Deferred lighting resources destroy function
+  */
+  VOID system::DestroyLighting( VOID )
+  {
+    for (frame_slot &Slot : FrameSlots)
+      for (gpu_culling_buffer *Buffer : {&Slot.LightingParamsBuffer, &Slot.LightBuffer, &Slot.LightOverflowBuffer})
+        if (Buffer->Allocation != nullptr)
+          vmaDestroyBuffer(Allocator, Buffer->Buffer, Buffer->Allocation);
+    if (LightGridBuffer.Allocation != nullptr)
+      vmaDestroyBuffer(Allocator, LightGridBuffer.Buffer, LightGridBuffer.Allocation);
+
+    Device.destroySampler(GBufferSampler);
+    Device.destroyDescriptorPool(LightingDescriptorPool);
+    Device.destroyPipeline(ShadingPipeline);
+    Device.destroyPipeline(LightCullingPipeline);
+    Device.destroyPipelineLayout(ShadingPipelineLayout);
+    Device.destroyPipelineLayout(LightCullingPipelineLayout);
+    Device.destroyDescriptorSetLayout(ShadingInputSetLayout);
+    Device.destroyDescriptorSetLayout(LightingDescriptorSetLayout);
+  } /* DestroyLighting */
+
+  /**
+   * @brief Lights setting function, may be called from any thread.
+   *        Lights are binned into view space clusters of culling camera every frame, so shading evaluates only lights, affecting pixel cluster.
+   *        Without culling camera only ambient light is applied.
+   * @param NewLights Point lights
+   * @param Ambient Ambient light color
+  */
+  VOID system::SetLights( std::span<const point_light> NewLights, const vec3 &Ambient )
+  {
+    LightingMutex.lock();
+    Lights.assign(NewLights.begin(), NewLights.end());
+    AmbientLight = Ambient;
+    LightingMutex.unlock();
+  } /* SetLights */
+
+  /**
+   * @brief Lighting frame preparation function, called from render thread before graph execution.
+   *        Uploads view space lights and parameters, rewrites shading input set, if graph images are changed.
+   * @param Camera Camera, frame is shaded from, nullptr to output ambient lit base color only
+  */
+  VOID system::PrepareLighting( const math::util::camera::projection_matrices *Camera )
+  {
+    frame_slot &Slot = *FrameSlot;
+
+    // Previous frame of slot is finished, so its buffers and sets are free and its overflow counter may be read
+    vmaInvalidateAllocation(Allocator, Slot.LightOverflowBuffer.Allocation, 0, VK_WHOLE_SIZE);
+    LightOverflowCount = *reinterpret_cast<UINT32 *>(Slot.LightOverflowBuffer.Data);
+    *reinterpret_cast<UINT32 *>(Slot.LightOverflowBuffer.Data) = 0;
+    vmaFlushAllocation(Allocator, Slot.LightOverflowBuffer.Allocation, 0, VK_WHOLE_SIZE);
+
+    LightingMutex.lock();
+    const UINT32 LightCount = Camera != nullptr ? (UINT32)Lights.size() : 0;
+
+    if (ReserveGpuCullingBuffer(Slot.LightBuffer, std::max(LightCount, 1U) * sizeof(gpu_light), vk::BufferUsageFlagBits::eStorageBuffer, TRUE))
+    {
+      vk::DescriptorBufferInfo LightBufferInfo {Slot.LightBuffer.Buffer, 0, VK_WHOLE_SIZE};
+
+      Device.updateDescriptorSets(vk::WriteDescriptorSet()
+        .setDstSet(Slot.LightingDescriptorSet)
+        .setDstBinding(1)
+        .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+        .setBufferInfo(LightBufferInfo), {});
+    }
+
+    // Lights are shaded in view space, so they are transformed once here instead of per pixel
+    auto *GpuLights = reinterpret_cast<gpu_light *>(Slot.LightBuffer.Data);
+    for (UINT32 i = 0; i < LightCount; i++)
+    {
+      const point_light &Light = Lights[i];
+      const vec3 Position = Camera->View * Light.Position;
+
+      GpuLights[i] = gpu_light
+      {
+        .Position = {Position.X, Position.Y, Position.Z},
+        .Radius = Light.Radius,
+        .Color = {Light.Color.X * Light.Intensity, Light.Color.Y * Light.Intensity, Light.Color.Z * Light.Intensity},
+      };
+    }
+
+    auto *Params = reinterpret_cast<gpu_lighting_params *>(Slot.LightingParamsBuffer.Data);
+    Params->Ambient[0] = AmbientLight.X;
+    Params->Ambient[1] = AmbientLight.Y;
+    Params->Ambient[2] = AmbientLight.Z;
+    Params->Ambient[3] = 1;
+    LightingMutex.unlock();
+
+    Params->OutputExtent[0] = (FLOAT)SwapchainImageExtent.width;
+    Params->OutputExtent[1] = (FLOAT)SwapchainImageExtent.height;
+    Params->LightCount = LightCount;
+    Params->IsLit = FALSE;
+    Params->View = mat4x4::Identity();
+    Params->InverseProjection = mat4x4::Identity();
+    std::fill_n(Params->SunDirection, 4, 0.0F);
+    std::fill_n(Params->SunColor, 4, 0.0F);
+
+    // Visibility layout shading fetches instances and draws, written for this frame by culling
+    auto GetAddress = [&]( const gpu_culling_buffer &Buffer ) -> vk::DeviceAddress
+    {
+      return Buffer.Buffer ? Device.getBufferAddress(vk::BufferDeviceAddressInfo(Buffer.Buffer)) : 0;
+    };
+    Params->ShadingDrawAddress = GetAddress(Slot.ShadingDrawBuffer);
+    Params->GpuInstanceAddress = GetAddress(Slot.CullingInstanceBuffer);
+    Params->CpuInstanceAddress = GetAddress(Slot.DrawInstanceBuffer);
+    Params->GpuInstanceCount = VisibilityGpuInstanceCount;
+    Params->TriangleBits = VisibilityTriangleBits;
+
+    if (Camera != nullptr)
+    {
+      // Near and far distances of perspective projection (as built by mat4x4::FrustumProjection)
+      const mat4x4 &Projection = Camera->Projection;
+      const FLOAT
+        Near = Projection.Data[3][2] / (Projection.Data[2][2] - 1),
+        Far = Projection.Data[3][2] / (Projection.Data[2][2] + 1);
+
+      Params->View = Camera->View;
+      Params->InverseProjection = Projection.Inversed();
+
+      if (Near > 0 && Far > Near)
+      {
+        Params->Near = Near;
+        Params->Far = Far;
+        Params->SliceScale = LIGHT_CLUSTER_Z / std::log(Far / Near);
+        Params->SliceBias = -Params->SliceScale * std::log(Near);
+        Params->IsLit = TRUE;
+      }
+
+      if (FrameDirectionalLight.has_value())
+      {
+        const directional_light &Sun = *FrameDirectionalLight;
+        const vec3 ToLight = -Sun.Direction.Normalized();
+
+        // Direction is rotated only, so translation row of view matrix is skipped
+        for (UINT32 i = 0; i < 3; i++)
+          Params->SunDirection[i] =
+            ToLight.X * Camera->View.Data[0][i] + ToLight.Y * Camera->View.Data[1][i] + ToLight.Z * Camera->View.Data[2][i];
+        Params->SunColor[0] = Sun.Color.X * Sun.Intensity;
+        Params->SunColor[1] = Sun.Color.Y * Sun.Intensity;
+        Params->SunColor[2] = Sun.Color.Z * Sun.Intensity;
+        Params->SunColor[3] = IsFrameShadowed ? 1.0F : 0.0F;
+      }
+
+      if (IsFrameShadowed)
+      {
+        // Shadow lookup starts from view space position, and ends in [0, 1] texture coordinates
+        const mat4x4 InverseView = Camera->View.Inversed();
+        const mat4x4 TextureBias
+        {
+          0.5F, 0,    0, 0,
+          0,    0.5F, 0, 0,
+          0,    0,    1, 0,
+          0.5F, 0.5F, 0, 1,
+        };
+
+        for (UINT32 i = 0; i < SHADOW_CASCADE_COUNT; i++)
+        {
+          Params->ShadowMatrices[i] = InverseView * ShadowCascades[i].ViewProjection * TextureBias;
+          Params->CascadeSplits[i] = ShadowCascadeSplits[i];
+          Params->CascadeTexelSizes[i] = 2 * ShadowCascades[i].Radius / SHADOW_MAP_SIZE;
+        }
+      }
+    }
+
+    for (gpu_culling_buffer *Buffer : {&Slot.LightingParamsBuffer, &Slot.LightBuffer})
+      vmaFlushAllocation(Allocator, Buffer->Allocation, 0, VK_WHOLE_SIZE);
+
+    FrameLightCount = Params->IsLit ? LightCount : 0;
+    IsFrameLit = Params->IsLit;
+
+    // Graph images are recreated on graph rebuilding
+    BOOL IsInputSetOutdated = FALSE;
+    for (UINT32 Binding = 0; Binding < ShadingInputs.size(); Binding++)
+      IsInputSetOutdated |= ShadingInputViews[Binding] != RenderGraph->GetImageView(ShadingInputs[Binding]);
+
+    if (IsInputSetOutdated)
+    {
+      const BOOL IsDynamicRendering = GraphMode == render_graph::mode::eDynamicRendering;
+      vk::DescriptorImageInfo ImageInfos[MAX_SHADING_INPUT_COUNT];
+      vk::WriteDescriptorSet Writes[MAX_SHADING_INPUT_COUNT];
+
+      for (UINT32 Binding = 0; Binding < ShadingInputs.size(); Binding++)
+      {
+        ShadingInputViews[Binding] = RenderGraph->GetImageView(ShadingInputs[Binding]);
+        ImageInfos[Binding] = vk::DescriptorImageInfo(IsDynamicRendering ? GBufferSampler : vk::Sampler(),
+          ShadingInputViews[Binding], vk::ImageLayout::eShaderReadOnlyOptimal);
+        Writes[Binding] = vk::WriteDescriptorSet()
+          .setDstSet(ShadingInputSet)
+          .setDstBinding(Binding)
+          .setDescriptorType(IsDynamicRendering ? vk::DescriptorType::eCombinedImageSampler : vk::DescriptorType::eInputAttachment)
+          .setImageInfo(ImageInfos[Binding]);
+      }
+      Device.updateDescriptorSets(vk::ArrayProxy<const vk::WriteDescriptorSet>((UINT32)ShadingInputs.size(), Writes), {});
+    }
+  } /* PrepareLighting */
+
+  /**
+   * @brief Light culling recording function, called from render graph light culling pass.
+   *        Bins lights into view space clusters and makes bins visible to shading pass.
+   * @param CommandBuffer Command buffer to record culling to
+  */
+  VOID system::RecordLightCulling( vk::CommandBuffer CommandBuffer )
+  {
+    // Shading doesn't read light grid of unlit frame
+    if (!IsFrameLit)
+      return;
+
+    CommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, LightCullingPipeline);
+    CommandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, LightCullingPipelineLayout, 0, FrameSlot->LightingDescriptorSet, {});
+    CommandBuffer.dispatch((LIGHT_CLUSTER_COUNT + LIGHT_CULLING_GROUP_SIZE - 1) / LIGHT_CULLING_GROUP_SIZE, 1, 1);
+
+    vk::MemoryBarrier ToShadingBarrier = vk::MemoryBarrier()
+      .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+      .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+    CommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eFragmentShader, {}, ToShadingBarrier, {}, {});
+  } /* RecordLightCulling */
+
+  /**
+   * @brief Deferred shading recording function, called from render graph shading pass
+   * @param CommandBuffer Command buffer to record fullscreen shading to
+  */
+  VOID system::RecordShading( vk::CommandBuffer CommandBuffer )
+  {
+    const vk::DescriptorSet Sets[] {FrameSlot->LightingDescriptorSet, ShadingInputSet};
+
+    CommandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, ShadingPipeline);
+    CommandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, ShadingPipelineLayout, 0, Sets, {});
+    CommandBuffer.setViewport(0, vk::Viewport(0, 0, (FLOAT)SwapchainImageExtent.width, (FLOAT)SwapchainImageExtent.height, 0, 1));
+    CommandBuffer.setScissor(0, vk::Rect2D({0, 0}, SwapchainImageExtent));
+    CommandBuffer.draw(3, 1, 0, 0);
+  } /* RecordShading */
+} /* namespace anv::render::core */
+
+/* file anv_render_core_lighting.cpp */
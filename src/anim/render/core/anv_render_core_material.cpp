@@ -12,6 +12,11 @@
 */
 namespace anv::render::core
 {
+  /**
+   * @brief Material builder implementation
+  */
+  ANV_BUILDER_IMPL(material)
+
   /**
    * @brief Material building function
    * @param Builder Builder to build material in
@@ -136,6 +141,7 @@ namespace anv::render::core
     Result->AttachedResources = {Builder.AttachedResources.begin(), Builder.AttachedResources.end()};
     for (auto &Resource : Result->AttachedResources)
       Resource.Grab();
+    Result->Surface = Builder.Surface;
 
     System.ResourcePool.Add(Result);
 
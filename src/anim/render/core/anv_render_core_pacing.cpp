@@ -0,0 +1,153 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/anim/render/core/anv_render_core_pacing.cpp
+ * @description Render core frame pacing implementation module
+ * @last_update 18.10.2026
+*/
+
+#include "anv.h"
+
+namespace anv::render::core
+{
+  /**
+   * @brief Frame pacing policy setting function, may be called from any thread.
+   *        Swapchain is recreated before next frame, if present mode or queued frame count is changed.
+   * @param NewPacing New pacing policy
+  */
+  VOID system::SetFramePacing( const frame_pacing &NewPacing )
+  {
+    PacingMutex.lock();
+    BOOL IsSwapchainChanged = NewPacing.PresentMode != Pacing.PresentMode || NewPacing.MaxQueuedFrames != Pacing.MaxQueuedFrames;
+    Pacing = NewPacing;
+    PacingMutex.unlock();
+
+    if (IsSwapchainChanged && !IsHeadless)
+      SwapchainOutdated = TRUE;
+  } /* SetFramePacing */
+
+  /**
+   * @brief Frame pacing policy getting function
+   * @return Current pacing policy
+  */
+  frame_pacing system::GetFramePacing( VOID )
+  {
+    PacingMutex.lock();
+    frame_pacing Result = Pacing;
+    PacingMutex.unlock();
+
+    return Result;
+  } /* GetFramePacing */
+
+  /**
+   * @brief Frame pacing statistics getting function, may be called from any thread
+   * @return Frame time statistics of last frames
+  */
+  frame_pacing_stats system::GetFramePacingStats( VOID )
+  {
+    std::vector<DOUBLE> Times;
+
+    PacingMutex.lock();
+    Times.assign(FrameTimes, FrameTimes + std::min(FrameTimeCount, (UINT64)FRAME_TIME_COUNT));
+    PacingMutex.unlock();
+
+    frame_pacing_stats Stats
+    {
+      // Offscreen output isn't synchronized with any display
+      .PresentMode = IsHeadless ? present_mode::eImmediate : ActivePresentMode.load(),
+      .OutputImageCount = OutputImageCount,
+      .FrameCount = (UINT32)Times.size(),
+    };
+
+    if (Times.empty())
+      return Stats;
+
+    Stats.MeanFrameTime = std::accumulate(Times.begin(), Times.end(), 0.0) / Times.size();
+    Stats.FrameTimeDeviation = std::sqrt(std::accumulate(Times.begin(), Times.end(), 0.0, [&]( DOUBLE Sum, DOUBLE Time )
+      {
+        return Sum + (Time - Stats.MeanFrameTime) * (Time - Stats.MeanFrameTime);
+      }) / Times.size());
+
+    std::sort(Times.begin(), Times.end());
+    Stats.P99FrameTime = Times[std::min(Times.size() - 1, Times.size() * 99 / 100)];
+    Stats.MaxFrameTime = Times.back();
+
+    return Stats;
+  } /* GetFramePacingStats */
+
+  /**
+   * @brief Present mode selection function
+   * @param Mode Requested present mode
+   * @return Supported Vulkan present mode, the nearest to requested one
+  */
+  vk::PresentModeKHR system::SelectPresentMode( present_mode Mode )
+  {
+    auto SurfacePresentModes = PhysicalDevice.getSurfacePresentModesKHR(Surface);
+    auto IsSupported = [&]( vk::PresentModeKHR VkMode )
+    {
+      return std::ranges::find(SurfacePresentModes, VkMode) != SurfacePresentModes.end();
+    };
+
+    // FIFO is required to be supported, so it ends every fallback chain
+    if (Mode == present_mode::eImmediate && IsSupported(vk::PresentModeKHR::eImmediate))
+    {
+      ActivePresentMode = present_mode::eImmediate;
+      return vk::PresentModeKHR::eImmediate;
+    }
+    if (Mode != present_mode::eFifo && IsSupported(vk::PresentModeKHR::eMailbox))
+    {
+      ActivePresentMode = present_mode::eMailbox;
+      return vk::PresentModeKHR::eMailbox;
+    }
+    ActivePresentMode = present_mode::eFifo;
+    return vk::PresentModeKHR::eFifo;
+  } /* SelectPresentMode */
+
+  /**
+   * @brief Frame rate limiting function, called from render thread after frame presentation.
+   *        Sleeps till most of time till next frame deadline, then spins, because OS sleep is coarse. Records frame time.
+  */
+  VOID system::LimitFrameRate( VOID )
+  {
+    using clock = std::chrono::steady_clock;
+
+    PacingMutex.lock();
+    FLOAT MaxFrameRate = Pacing.MaxFrameRate;
+    PacingMutex.unlock();
+
+    clock::time_point Now = clock::now();
+
+    if (MaxFrameRate > 0)
+    {
+      const clock::duration Period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<DOUBLE>(1.0 / MaxFrameRate));
+
+      // Deadline isn't kept after stalls, so limiter doesn't burst frames to catch up
+      NextFrameTime += Period;
+      if (NextFrameTime < Now)
+        NextFrameTime = Now;
+
+      if (NextFrameTime - Now > LimiterSleepMargin)
+      {
+        const clock::duration SleepTime = NextFrameTime - Now - LimiterSleepMargin;
+
+        std::this_thread::sleep_for(SleepTime);
+
+        // Margin follows the worst recent oversleep and slowly decays, when sleeps get precise
+        const clock::duration Oversleep = clock::now() - Now - SleepTime;
+        LimiterSleepMargin = std::clamp<clock::duration>(std::max(Oversleep + Oversleep / 4, LimiterSleepMargin - LimiterSleepMargin / 16),
+          std::chrono::microseconds(200), std::chrono::milliseconds(4));
+      }
+      while (clock::now() < NextFrameTime)
+        std::this_thread::yield();
+      Now = clock::now();
+    }
+    else
+      NextFrameTime = Now;
+
+    PacingMutex.lock();
+    FrameTimes[FrameTimeCount++ % FRAME_TIME_COUNT] = std::chrono::duration<DOUBLE, std::milli>(Now - LastFrameTime).count();
+    PacingMutex.unlock();
+    LastFrameTime = Now;
+  } /* LimitFrameRate */
+} /* namespace anv::render::core */
+
+/* file anv_render_core_pacing.cpp */
@@ -53,6 +53,70 @@ namespace anv::render::core
     }[(UINT32)PolygonMode];
   }
 
+  /**
+   * @brief Vertex shader position invariance decoration function. Pre-pass depth must match geometry pass one bit by bit,
+   *        so both vertex shaders get Invariant position, even if their source language can't declare it (e.g. HLSL).
+   * @param SPV Vertex shader SPIR-V
+   * @return SPIR-V with Invariant decoration on every BuiltIn Position target
+  */
+  static std::vector<UINT32> DecoratePositionInvariant( std::span<const UINT32> SPV )
+  {
+    constexpr UINT32
+      HEADER_WORD_COUNT = 5,
+      OP_DECORATE = 71, OP_MEMBER_DECORATE = 72,
+      DECORATION_BUILT_IN = 11, DECORATION_INVARIANT = 18, BUILT_IN_POSITION = 0,
+      NO_MEMBER = ~0U;
+
+    if (SPV.size() < HEADER_WORD_COUNT)
+      throw std::runtime_error("Invalid vertex shader SPIR-V");
+
+    // Position is variable (OpDecorate) or gl_PerVertex block member (OpMemberDecorate), that may be invariant already
+    std::vector<std::pair<UINT32, UINT32>> PositionTargets, InvariantTargets;
+    for (SIZE_T i = HEADER_WORD_COUNT, WordCount; i < SPV.size(); i += WordCount)
+    {
+      const UINT32 Opcode = SPV[i] & 0xFFFF;
+
+      WordCount = SPV[i] >> 16;
+      if (WordCount == 0 || i + WordCount > SPV.size())
+        throw std::runtime_error("Invalid vertex shader SPIR-V");
+
+      if (Opcode == OP_DECORATE && WordCount >= 3)
+      {
+        if (SPV[i + 2] == DECORATION_INVARIANT)
+          InvariantTargets.push_back({SPV[i + 1], NO_MEMBER});
+        else if (SPV[i + 2] == DECORATION_BUILT_IN && WordCount == 4 && SPV[i + 3] == BUILT_IN_POSITION)
+          PositionTargets.push_back({SPV[i + 1], NO_MEMBER});
+      }
+      else if (Opcode == OP_MEMBER_DECORATE && WordCount >= 4)
+      {
+        if (SPV[i + 3] == DECORATION_INVARIANT)
+          InvariantTargets.push_back({SPV[i + 1], SPV[i + 2]});
+        else if (SPV[i + 3] == DECORATION_BUILT_IN && WordCount == 5 && SPV[i + 4] == BUILT_IN_POSITION)
+          PositionTargets.push_back({SPV[i + 1], SPV[i + 2]});
+      }
+    }
+
+    // Decorations are annotation section instructions, so new ones are placed right after position ones
+    std::vector<UINT32> Result(SPV.begin(), SPV.begin() + HEADER_WORD_COUNT);
+    Result.reserve(SPV.size() + PositionTargets.size() * 4);
+    for (SIZE_T i = HEADER_WORD_COUNT, WordCount; i < SPV.size(); i += WordCount)
+    {
+      const UINT32 Opcode = SPV[i] & 0xFFFF;
+
+      WordCount = SPV[i] >> 16;
+      Result.insert(Result.end(), SPV.begin() + i, SPV.begin() + i + WordCount);
+
+      if (Opcode == OP_DECORATE && WordCount == 4 && SPV[i + 2] == DECORATION_BUILT_IN && SPV[i + 3] == BUILT_IN_POSITION &&
+          std::ranges::find(InvariantTargets, std::pair(SPV[i + 1], NO_MEMBER)) == InvariantTargets.end())
+        Result.insert(Result.end(), {3U << 16 | OP_DECORATE, SPV[i + 1], DECORATION_INVARIANT});
+      else if (Opcode == OP_MEMBER_DECORATE && WordCount == 5 && SPV[i + 3] == DECORATION_BUILT_IN && SPV[i + 4] == BUILT_IN_POSITION &&
+          std::ranges::find(InvariantTargets, std::pair(SPV[i + 1], SPV[i + 2])) == InvariantTargets.end())
+        Result.insert(Result.end(), {4U << 16 | OP_MEMBER_DECORATE, SPV[i + 1], SPV[i + 2], DECORATION_INVARIANT});
+    }
+
+    return Result;
+  } /* DecoratePositionInvariant */
+
   /**
    * @brief Pipeline building function
    * @param Builder Builder reference
@@ -60,10 +124,35 @@ namespace anv::render::core
   */
   pipeline * system::Build( pipeline::builder &Builder )
   {
+    // Visibility buffer shading fetches triangle lists with F32x3 positions and normals by 4 byte words
+    if (Builder.RenderPass == render_pass::eGeometry && GBufferLayout == gbuffer_layout::eVisibility)
+    {
+      auto IsFetchable = [&]( INT32 AttributeIndex )
+      {
+        if (AttributeIndex < 0 || AttributeIndex >= (INT32)Builder.VertexAttributeLayouts.size())
+          return FALSE;
+
+        const pipeline::vertex_attribute_layout &Attribute = Builder.VertexAttributeLayouts[AttributeIndex];
+        if (Attribute.Format.Type != format::type::eF32 || Attribute.Format.Count < 3 || Attribute.Offset % sizeof(UINT32) != 0 ||
+            Attribute.BufferIndex >= Builder.VertexBufferLayouts.size())
+          return FALSE;
+
+        const pipeline::vertex_buffer_layout &BufferLayout = Builder.VertexBufferLayouts[Attribute.BufferIndex];
+        return BufferLayout.Rate == pipeline::vertex_input_rate::eVertex && BufferLayout.Stride != 0 && BufferLayout.Stride % sizeof(UINT32) == 0;
+      };
+
+      if (Builder.PrimitiveTopology != topology::eTriangleList || !IsFetchable(0) ||
+          (Builder.NormalAttributeIndex >= 0 && !IsFetchable(Builder.NormalAttributeIndex)))
+        return nullptr;
+    }
+
     pipeline *Result = new pipeline(*this);
 
-    // Copy shader bindings to result
+    // Copy shader bindings and vertex layouts to result
     Result->ShaderBindingTypes = {Builder.ShaderBindingTypes.begin(), Builder.ShaderBindingTypes.end()};
+    Result->VertexBufferLayouts = {Builder.VertexBufferLayouts.begin(), Builder.VertexBufferLayouts.end()};
+    Result->VertexAttributeLayouts = {Builder.VertexAttributeLayouts.begin(), Builder.VertexAttributeLayouts.end()};
+    Result->NormalAttributeIndex = Builder.NormalAttributeIndex;
 
     std::vector<vk::DescriptorSetLayoutBinding> Bindings;
     Bindings.reserve(Builder.ShaderBindingTypes.size());
@@ -83,9 +172,13 @@ namespace anv::render::core
 
     Result->DescriptorSetLayout = Device.createDescriptorSetLayout(DescriptorSetLayoutCreateInfo);
 
+    // Instance set is shared by all pipelines, it's bound by draw recording
+    vk::DescriptorSetLayout SetLayouts[] {Result->DescriptorSetLayout, DrawInstanceSetLayout};
+    static_assert(pipeline::INSTANCE_SET == 1, "Instance set must follow material set");
+
     vk::PipelineLayoutCreateInfo PipelineLayoutCreateInfo;
     PipelineLayoutCreateInfo
-      .setSetLayouts(Result->DescriptorSetLayout)
+      .setSetLayouts(SetLayouts)
       ;
 
     std::vector<vk::PipelineColorBlendAttachmentState> ColorBlendAttachmentStates;
@@ -127,6 +220,10 @@ namespace anv::render::core
                              vk::ColorComponentFlagBits::eB |
                              vk::ColorComponentFlagBits::eA),
       };
+
+      // Visibility buffer layout has single ID target
+      if (GBufferLayout == gbuffer_layout::eVisibility)
+        ColorBlendAttachmentStates.resize(1);
       break;
 
     case render_pass::eOverlay:
@@ -215,7 +312,13 @@ namespace anv::render::core
       .setScissorCount(1)
       ;
 
-    vk::ShaderModule VertexModule = Device.createShaderModule(vk::ShaderModuleCreateInfo().setCode(Builder.VertexSPV));
+    // Pre-passed primitives get depth only marker pass pipeline, fed by position stream, and equal depth test geometry pipeline
+    const BOOL IsDepthPrepassed = Builder.RenderPass == render_pass::eGeometry && !Builder.DepthVertexSPV.empty() && !Builder.VertexAttributeLayouts.empty();
+
+    const std::vector<UINT32> InvariantVertexSPV = IsDepthPrepassed ? DecoratePositionInvariant(Builder.VertexSPV) : std::vector<UINT32>();
+    const std::span<const UINT32> VertexSPV = IsDepthPrepassed ? std::span<const UINT32>(InvariantVertexSPV) : Builder.VertexSPV;
+
+    vk::ShaderModule VertexModule = Device.createShaderModule(vk::ShaderModuleCreateInfo().setCode(VertexSPV));
     vk::ShaderModule FragmentModule = Device.createShaderModule(vk::ShaderModuleCreateInfo().setCode(Builder.FragmentSPV));
 
     vk::PipelineShaderStageCreateInfo ShaderStageCreateInfos[]
@@ -259,18 +362,83 @@ namespace anv::render::core
       .setPViewportState(&ViewportState)
       .setPDepthStencilState(PDepthStencilState)
       .setStages(ShaderStageCreateInfos)
-      .setRenderPass(OutputRenderPass)
-      .setSubpass(GetRenderPassSubpassIndex(Builder.RenderPass))
       ;
 
-    Device.destroyShaderModule(VertexModule);
-    Device.destroyShaderModule(FragmentModule);
+    // Graph may be rebuilt by render thread, its render passes stay compatible with built pipelines
+    RenderGraphMutex.lock();
+    UINT32 GraphPass = GetRenderPassGraphPass(Builder.RenderPass);
+    PipelineCreateInfo
+      .setPNext(RenderGraph->GetPipelineRenderingInfo(GraphPass))
+      .setRenderPass(RenderGraph->GetRenderPass(GraphPass))
+      .setSubpass(RenderGraph->GetSubpass(GraphPass))
+      ;
 
     vk::Result PipelineCreateResult;
     std::tie(PipelineCreateResult, Result->Pipeline) = Device.createGraphicsPipeline(nullptr, PipelineCreateInfo);
 
+    vk::ShaderModule DepthVertexModule;
+
+    if (PipelineCreateResult == vk::Result::eSuccess && IsDepthPrepassed)
+    {
+      vk::PipelineDepthStencilStateCreateInfo DepthEqualState = vk::PipelineDepthStencilStateCreateInfo()
+        .setDepthCompareOp(vk::CompareOp::eEqual)
+        .setDepthTestEnable(vk::True)
+        .setDepthWriteEnable(vk::False);
+
+      PipelineCreateInfo.setPDepthStencilState(&DepthEqualState);
+      std::tie(PipelineCreateResult, Result->DepthEqualPipeline) = Device.createGraphicsPipeline(nullptr, PipelineCreateInfo);
+
+      const pipeline::vertex_attribute_layout &PositionLayout = Builder.VertexAttributeLayouts[0];
+      vk::VertexInputBindingDescription PositionBinding = vk::VertexInputBindingDescription()
+        .setBinding(0)
+        .setStride(Builder.VertexBufferLayouts[PositionLayout.BufferIndex].Stride)
+        .setInputRate(vk::VertexInputRate::eVertex);
+      vk::VertexInputAttributeDescription PositionAttribute = vk::VertexInputAttributeDescription()
+        .setLocation(0)
+        .setBinding(0)
+        .setOffset(PositionLayout.Offset)
+        .setFormat(TranslateFormat(PositionLayout.Format));
+      vk::PipelineVertexInputStateCreateInfo PositionInputState = vk::PipelineVertexInputStateCreateInfo()
+        .setVertexBindingDescriptions(PositionBinding)
+        .setVertexAttributeDescriptions(PositionAttribute);
+
+      // Marker pass output is kept untouched
+      vk::PipelineColorBlendAttachmentState NoColorAttachmentState = vk::PipelineColorBlendAttachmentState()
+        .setBlendEnable(vk::False)
+        .setColorWriteMask({});
+      vk::PipelineColorBlendStateCreateInfo NoColorBlendState = vk::PipelineColorBlendStateCreateInfo()
+        .setAttachments(NoColorAttachmentState);
+
+      const std::vector<UINT32> DepthVertexSPV = DecoratePositionInvariant(Builder.DepthVertexSPV);
+      DepthVertexModule = Device.createShaderModule(vk::ShaderModuleCreateInfo().setCode(DepthVertexSPV));
+      vk::PipelineShaderStageCreateInfo DepthVertexStage = vk::PipelineShaderStageCreateInfo()
+        .setModule(DepthVertexModule)
+        .setPName("vs_main")
+        .setStage(vk::ShaderStageFlagBits::eVertex);
+
+      const UINT32 MarkerPass = GetRenderPassGraphPass(render_pass::eMarker);
+      if (PipelineCreateResult == vk::Result::eSuccess)
+        std::tie(PipelineCreateResult, Result->DepthPrepassPipeline) = Device.createGraphicsPipeline(nullptr, PipelineCreateInfo
+          .setStages(DepthVertexStage)
+          .setPVertexInputState(&PositionInputState)
+          .setPColorBlendState(&NoColorBlendState)
+          .setPDepthStencilState(&DepthStencilState)
+          .setPNext(RenderGraph->GetPipelineRenderingInfo(MarkerPass))
+          .setRenderPass(RenderGraph->GetRenderPass(MarkerPass))
+          .setSubpass(RenderGraph->GetSubpass(MarkerPass))
+        );
+    }
+    RenderGraphMutex.unlock();
+
+    // Modules must live until pipeline is created
+    Device.destroyShaderModule(VertexModule);
+    Device.destroyShaderModule(FragmentModule);
+    Device.destroyShaderModule(DepthVertexModule);
+
     if (PipelineCreateResult != vk::Result::eSuccess)
     {
+      Device.destroyPipeline(Result->DepthEqualPipeline);
+      Device.destroyPipeline(Result->Pipeline);
       Device.destroyPipelineLayout(Result->PipelineLayout);
       Device.destroyDescriptorSetLayout(Result->DescriptorSetLayout);
 
@@ -278,6 +446,11 @@ namespace anv::render::core
       return nullptr;
     }
 
+    if (Builder.CastShadows)
+      Result->ShadowPipeline = CreateShadowPipeline(Builder);
+    if (!Builder.VertexAttributeLayouts.empty())
+      Result->PositionBufferIndex = Builder.VertexAttributeLayouts[0].BufferIndex;
+
     Result->Grab();
     ResourcePool.Add(Result);
     return Result;
@@ -289,6 +462,9 @@ namespace anv::render::core
   */
   VOID pipeline::OnDestroy( VOID )
   {
+    System.Device.destroyPipeline(ShadowPipeline);
+    System.Device.destroyPipeline(DepthPrepassPipeline);
+    System.Device.destroyPipeline(DepthEqualPipeline);
     System.Device.destroyPipeline(Pipeline);
     System.Device.destroyPipelineLayout(PipelineLayout);
     System.Device.destroyDescriptorSetLayout(DescriptorSetLayout);
@@ -1,17 +1,24 @@
 /**
  * @brief       ANIM-VK Project
- * @file        src/anim/render/core/anv_render_core_material.cpp
- * @description Render core material implementation module
+ * @file        src/anim/render/core/anv_render_core_primitive.cpp
+ * @description Render core primitive implementation module
  * @last_update 30.12.2023
 */
 
 #include "anv.h"
 
+#include "util/math/anv_math_batch.h"
+
 /**
  * @brief Renderer core namespace
 */
 namespace anv::render::core
 {
+  /**
+   * @brief Primitive builder implementation
+  */
+  ANV_BUILDER_IMPL(primitive)
+
   /**
    * @brief Primitive building function
    * @param Builder Builder to build primitive in
@@ -24,9 +31,29 @@ namespace anv::render::core
     Result->IndexBuffer = Builder.IndexBufferView;
     Result->VertexBuffers = {Builder.VertexBufferViews.begin(), Builder.VertexBufferViews.end()};
     Result->Material = Builder.Material;
-    Result->IndexBuffer->Grab();
+    Result->Bounds = Builder.Bounds;
+    Result->LodHysteresis = Builder.LodHysteresis;
+    Result->IsRigid = Builder.IsRigid;
+    if (!Builder.Lods.empty())
+      Result->Lods = {Builder.Lods.begin(), Builder.Lods.end()};
+    else
+      // Index buffers are 32-bit, non-indexed primitives have single level with no indices
+      Result->Lods = {primitive::lod {.IndexCount = Builder.IndexBufferView != nullptr ? (UINT32)(Builder.IndexBufferView->Size / sizeof(UINT32)) : 0}};
+    if (Result->IndexBuffer != nullptr)
+      Result->IndexBuffer->Grab();
     for (buffer::view *VertexBuffer : Result->VertexBuffers)
       VertexBuffer->Grab();
+
+    // Non-indexed primitive draws as many vertices, as every per vertex buffer holds
+    if (Result->IndexBuffer == nullptr)
+    {
+      UINT32 VertexCount = UINT32_MAX;
+
+      for (UINT32 i = 0; i < Result->VertexBuffers.size() && i < VertexBufferLayouts.size(); i++)
+        if (VertexBufferLayouts[i].Rate == pipeline::vertex_input_rate::eVertex && VertexBufferLayouts[i].Stride != 0)
+          VertexCount = std::min(VertexCount, (UINT32)(Result->VertexBuffers[i]->Size / VertexBufferLayouts[i].Stride));
+      Result->VertexCount = VertexCount != UINT32_MAX ? VertexCount : 0;
+    }
     Result->Material->Grab();
 
     System.PrimitivePool.Add(Result);
@@ -77,6 +104,100 @@ namespace anv::render::core
     Material = NewMaterial;
   } /* SetMaterial */
 
+  /**
+   * @brief Local space bounding box getting function
+   * @return Bounding box, empty if primitive isn't culled
+  */
+  std::optional<math::aabb> primitive::GetBounds( VOID ) const
+  {
+    return Bounds;
+  } /* GetBounds */
+
+  /**
+   * @brief Local space bounding box setting function
+   * @param NewBounds New bounding box, empty to disable culling of this primitive
+  */
+  VOID primitive::SetBounds( const std::optional<math::aabb> &NewBounds )
+  {
+    Bounds = NewBounds;
+    UpdateInstanceBounds(0, (UINT32)Instances.size());
+  } /* SetBounds */
+
+  /**
+   * @brief Instance culling function, called from render thread
+   * @param Frustum Frustum to cull by, nullptr to treat all instances as visible
+   * @return Count of visible instances
+  */
+  SIZE_T primitive::Cull( const math::frustum *Frustum )
+  {
+    VisibleInstances.resize(Transforms.size());
+
+    if (Frustum == nullptr || !Bounds.has_value())
+      std::iota(VisibleInstances.begin(), VisibleInstances.end(), 0);
+    else
+      VisibleInstances.resize(math::batch::CullInstances(*Frustum, *Bounds, Transforms, VisibleInstances));
+
+    return VisibleInstances.size();
+  } /* Cull */
+
+  /**
+   * @brief Instance level of detail selection function, called from render thread
+   * @param Index Instance index
+   * @param Camera Camera, instance is viewed by, nullptr to use the most detailed level
+   * @return Selected level of detail
+  */
+  UINT32 primitive::SelectLod( UINT32 Index, const math::util::camera::projection_matrices *Camera )
+  {
+    instance *Instance = Instances[Index];
+
+    if (Lods.size() == 1 || Camera == nullptr || !Bounds.has_value())
+      return Instance->Lod = 0;
+
+    const math::aabb Box = Bounds->Transformed(Transforms[Index]);
+    const fvec3 Center = (Box.Min + Box.Max) * 0.5F, Extent = (Box.Max - Box.Min) * 0.5F;
+    const FLOAT ScreenSize = Camera->GetProjectedSize(Center, std::sqrt(Extent & Extent));
+    UINT32 Lod = std::min(Instance->Lod, (UINT32)Lods.size() - 1);
+
+    // Level changes only when size crosses threshold by hysteresis band, so instances don't flicker on boundaries
+    while (Lod > 0 && ScreenSize >= Lods[Lod - 1].MinScreenSize * (1 + LodHysteresis))
+      Lod--;
+    while (Lod + 1 < Lods.size() && ScreenSize < Lods[Lod].MinScreenSize * (1 - LodHysteresis))
+      Lod++;
+
+    return Instance->Lod = Lod;
+  } /* SelectLod */
+
+  /**
+   * @brief Visible instances levels of detail selection function, called from render thread.
+   *        Groups visible instances by level and fills level counts.
+   * @param Camera Camera, instances are viewed by, nullptr to use the most detailed level
+   * @return Count of indices of visible instances of all levels
+  */
+  UINT64 primitive::SelectVisibleLods( const math::util::camera::projection_matrices *Camera )
+  {
+    VisibleLodCounts.assign(Lods.size(), 0);
+    for (UINT32 Index : VisibleInstances)
+      VisibleLodCounts[SelectLod(Index, Camera)]++;
+
+    UINT64 IndexCount = 0;
+
+    for (UINT32 Lod = 0; Lod < Lods.size(); Lod++)
+      IndexCount += (UINT64)VisibleLodCounts[Lod] * Lods[Lod].IndexCount;
+    if (Lods.size() == 1)
+      return IndexCount;
+
+    // Counting sort by level, so every level is drawn by single instanced draw
+    std::vector<UINT32> LodOffsets(Lods.size());
+    std::exclusive_scan(VisibleLodCounts.begin(), VisibleLodCounts.end(), LodOffsets.begin(), 0U);
+
+    std::vector<UINT32> Grouped(VisibleInstances.size());
+    for (UINT32 Index : VisibleInstances)
+      Grouped[LodOffsets[Instances[Index]->Lod]++] = Index;
+    VisibleInstances = std::move(Grouped);
+
+    return IndexCount;
+  } /* SelectVisibleLods */
+
   /**
    * @brief Instance create function
   */
@@ -86,17 +207,152 @@ namespace anv::render::core
 
     Instances.push_back(Result);
     Transforms.push_back(Transform);
+    UpdateInstanceBounds(Result->Index, 1);
 
     Result->Grab();
 
     return Result;
   } /* Instance */
 
+  /**
+   * @brief Instances bulk create function. Instances are inserted into scene hierarchy at once, so many of them rebuild it by parallel SAH builder.
+   * @param NewTransforms Transforms of instances to create
+   * @return Created instances, in transform order
+  */
+  std::vector<primitive::instance *> primitive::CreateInstances( std::span<const mat4x4> NewTransforms )
+  {
+    const UINT32 FirstIndex = (UINT32)Instances.size();
+    std::vector<instance *> Result;
+
+    Result.reserve(NewTransforms.size());
+    for (UINT32 i = 0; i < (UINT32)NewTransforms.size(); i++)
+    {
+      instance *Instance = new instance(*this, FirstIndex + i);
+
+      Instance->Grab();
+      Instances.push_back(Instance);
+      Result.push_back(Instance);
+    }
+    Transforms.insert(Transforms.end(), NewTransforms.begin(), NewTransforms.end());
+    UpdateInstanceBounds(FirstIndex, (UINT32)NewTransforms.size());
+
+    return Result;
+  } /* CreateInstances */
+
+  /**
+   * @brief Instance transforms getting function. Intended for bulk updates (e.g. by math::batch kernels).
+   * @return Transform span, indexed by instance::GetIndex. Valid until instance creation or destruction.
+  */
+  std::span<mat4x4> primitive::GetTransforms( VOID )
+  {
+    return Transforms;
+  } /* GetTransforms */
+
+  /**
+   * @brief Instance transforms bulk setting function
+   * @param FirstIndex Index of first instance to set transform of
+   * @param NewTransforms Transforms to copy, must fit in instance count
+  */
+  VOID primitive::SetTransforms( UINT32 FirstIndex, std::span<const mat4x4> NewTransforms )
+  {
+    std::copy(NewTransforms.begin(), NewTransforms.end(), Transforms.begin() + FirstIndex);
+    UpdateInstanceBounds(FirstIndex, (UINT32)NewTransforms.size());
+  } /* SetTransforms */
+
+  /**
+   * @brief Instance world bounds updating function. Must be called after transforms are written through GetTransforms span.
+   * @param FirstIndex Index of first instance to update bounds of
+   * @param Count Count of instances to update bounds of
+  */
+  VOID primitive::UpdateInstanceBounds( UINT32 FirstIndex, UINT32 Count )
+  {
+    math::bvh &SceneBvh = Pipeline.System.SceneBvh;
+
+    const BOOL IsShadowCaster = Pipeline.ShadowPipeline ? TRUE : FALSE;
+    std::vector<UINT32> InsertedIndices;
+    std::vector<math::aabb> InsertedBoxes;
+    std::vector<UINT64> InsertedUserData;
+
+    Pipeline.System.SceneBvhMutex.lock();
+    MarkInstancesChanged(FirstIndex, Count);
+    for (UINT32 Index = FirstIndex; Index < FirstIndex + Count; Index++)
+    {
+      instance *Instance = Instances[Index];
+
+      // Cached shadow cascades, overlapping old or new bounds of caster, are re-rendered
+      if (IsShadowCaster)
+      {
+        if (Instance->BvhHandle != math::bvh::INVALID_HANDLE)
+          Pipeline.System.InvalidateShadowCasters(SceneBvh.GetBox(Instance->BvhHandle));
+        Pipeline.System.InvalidateShadowCasters(Bounds.has_value() ? std::optional(Bounds->Transformed(Transforms[Index])) : std::nullopt);
+      }
+
+      if (!Bounds.has_value())
+      {
+        if (Instance->BvhHandle != math::bvh::INVALID_HANDLE)
+          SceneBvh.Remove(Instance->BvhHandle);
+        Instance->BvhHandle = math::bvh::INVALID_HANDLE;
+      }
+      else if (Instance->BvhHandle == math::bvh::INVALID_HANDLE)
+      {
+        InsertedIndices.push_back(Index);
+        InsertedBoxes.push_back(Bounds->Transformed(Transforms[Index]));
+        InsertedUserData.push_back(reinterpret_cast<UINT64>(Instance));
+      }
+      else
+        // Tree structure is kept, boxes are refit once per frame before culling
+        SceneBvh.SetBox(Instance->BvhHandle, Bounds->Transformed(Transforms[Index]));
+    }
+
+    // New instances (e.g. created by bulk instancing) are inserted at once, so many of them rebuild tree by parallel SAH builder
+    if (!InsertedIndices.empty())
+    {
+      std::vector<math::bvh::handle> Handles(InsertedIndices.size());
+
+      SceneBvh.InsertBulk(InsertedBoxes, InsertedUserData, Handles);
+      for (SIZE_T i = 0; i < InsertedIndices.size(); i++)
+        Instances[InsertedIndices[i]]->BvhHandle = Handles[i];
+    }
+    Pipeline.System.SceneBvhMutex.unlock();
+  } /* UpdateInstanceBounds */
+
+  /**
+   * @brief Changed instances marking function, must be called with locked SceneBvhMutex
+   * @param FirstIndex Index of first changed instance
+   * @param Count Count of changed instances
+  */
+  VOID primitive::MarkInstancesChanged( UINT32 FirstIndex, UINT32 Count )
+  {
+    // Every slot buffer keeps its own copy, so range is extended for all of them
+    for (instance_upload &Upload : InstanceUploads)
+      if (Upload.ChangedFirst >= Upload.ChangedEnd)
+      {
+        Upload.ChangedFirst = FirstIndex;
+        Upload.ChangedEnd = FirstIndex + Count;
+      }
+      else
+      {
+        Upload.ChangedFirst = std::min(Upload.ChangedFirst, FirstIndex);
+        Upload.ChangedEnd = std::max(Upload.ChangedEnd, FirstIndex + Count);
+      }
+  } /* MarkInstancesChanged */
+
   /**
    * @brief Instance destroy callback
   */
   VOID primitive::OnInstanceDestroy( instance *Instance )
   {
+    Pipeline.System.SceneBvhMutex.lock();
+    if (Pipeline.ShadowPipeline)
+      Pipeline.System.InvalidateShadowCasters(Instance->BvhHandle != math::bvh::INVALID_HANDLE ?
+        std::optional(Pipeline.System.SceneBvh.GetBox(Instance->BvhHandle)) : std::nullopt);
+    if (Instance->BvhHandle != math::bvh::INVALID_HANDLE)
+      Pipeline.System.SceneBvh.Remove(Instance->BvhHandle);
+
+    // Later instances are shifted, so their uploaded copies are outdated
+    MarkInstancesChanged(Instance->Index, (UINT32)Instances.size() - Instance->Index);
+    Pipeline.System.SceneBvhMutex.unlock();
+
     Instances.erase(Instances.begin() + Instance->Index);
     Transforms.erase(Transforms.begin() + Instance->Index);
 
@@ -125,8 +381,18 @@ namespace anv::render::core
   VOID primitive::instance::SetTransform( const mat4x4 &NewTransform )
   {
     Primitive.Transforms[Index] = NewTransform;
+    Primitive.UpdateInstanceBounds(Index, 1);
   } /* SetTrasnform */
 
+  /**
+   * @brief Index in primitive transform span getting function
+   * @return Current instance index
+  */
+  UINT32 primitive::instance::GetIndex( VOID ) const
+  {
+    return Index;
+  } /* GetIndex */
+
   /**
    * @brief Resource destroy callback
   */
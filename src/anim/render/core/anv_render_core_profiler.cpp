@@ -0,0 +1,250 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/anim/render/core/anv_render_core_profiler.cpp
+ * @description Render core frame profiler implementation module
+ * @last_update 18.10.2026
+*/
+
+#include "anv.h"
+
+#include <format>
+
+namespace anv::render::core
+{
+  // Render thread zone names
+  static const CHAR *ProfileZoneNames[(UINT32)profile_zone::_eCount]
+  {
+    "Wait",
+    "Garbage collection",
+    "Acquire",
+    "Recording",
+    "Culling",
+    "Submit",
+    "Present",
+  };
+
+  // GPU pass names
+  static const CHAR *ProfilePassNames[(UINT32)profile_pass::_eCount]
+  {
+    "Shadow",
+    "Marker",
+    "Geometry",
+    "Shading",
+    "Overlay",
+  };
+
+  /**
+   * @brief Profiler initialization function
+  */
+  VOID system::InitProfiler( VOID )
+  {
+    ProfileEpoch = std::chrono::steady_clock::now();
+
+    UINT32 ValidBits = PhysicalDevice.getQueueFamilyProperties()[GraphicsQueueFamilyIndex].timestampValidBits;
+    if (ValidBits == 0)
+      return;
+
+    TimestampMask = ValidBits >= 64 ? ~0ULL : (1ULL << ValidBits) - 1;
+    TimestampPeriod = PhysicalDevice.getProperties().limits.timestampPeriod;
+    IsTimestampSupported = TRUE;
+
+    // Frames in flight write their timestamps to separate pools
+    for (frame_slot &Slot : FrameSlots)
+      Slot.TimestampQueryPool = Device.createQueryPool(vk::QueryPoolCreateInfo()
+        .setQueryType(vk::QueryType::eTimestamp)
+        .setQueryCount(PROFILE_TIMESTAMP_COUNT)
+      );
+  } /* InitProfiler */
+
+  /**
+   * @brief Profiler destroy function
+  */
+  VOID system::DestroyProfiler( VOID )
+  {
+    for (frame_slot &Slot : FrameSlots)
+      if (Slot.TimestampQueryPool)
+        Device.destroyQueryPool(Slot.TimestampQueryPool);
+  } /* DestroyProfiler */
+
+  /**
+   * @brief Frame profiling enabling function, may be called from any thread
+   * @param Enable TRUE to measure render thread zones and GPU pass times of every frame
+  */
+  VOID system::SetProfiling( BOOL Enable )
+  {
+    IsProfilingEnabled = Enable;
+  } /* SetProfiling */
+
+  /**
+   * @brief Profile time getting function
+   * @return Time since profiler initialization, in microseconds
+  */
+  DOUBLE system::GetProfileTime( VOID ) const
+  {
+    return std::chrono::duration<DOUBLE, std::micro>(std::chrono::steady_clock::now() - ProfileEpoch).count();
+  } /* GetProfileTime */
+
+  /**
+   * @brief Frame profiling start function, called from render thread at frame begin. Discards unsubmitted frame profile.
+  */
+  VOID system::BeginProfileFrame( VOID )
+  {
+    IsFrameProfiled = IsProfilingEnabled;
+    if (!IsFrameProfiled)
+      return;
+
+    CurrentProfile = frame_profile {.FrameIndex = (UINT64)GlobalFrameIndex + 1};
+    CurrentProfile.Frame.Begin = GetProfileTime();
+  } /* BeginProfileFrame */
+
+  /**
+   * @brief Frame profiling end function, called from render thread after frame presentation
+  */
+  VOID system::EndProfileFrame( VOID )
+  {
+    if (!IsFrameProfiled)
+      return;
+
+    CurrentProfile.Frame.Duration = GetProfileTime() - CurrentProfile.Frame.Begin;
+    FrameSlot->SubmittedProfile = CurrentProfile;
+    FrameSlot->IsProfileSubmitted = TRUE;
+  } /* EndProfileFrame */
+
+  /**
+   * @brief Submitted frame profiles completion function, called from render thread after frames are finished on GPU
+   * @param CompletedFrameIndex Number of last finished frame
+  */
+  VOID system::CompleteProfileFrames( UINT64 CompletedFrameIndex )
+  {
+    // Only last FRAMES_IN_FLIGHT frames may still keep their profiles in slots
+    const UINT64 First = CompletedFrameIndex >= FRAMES_IN_FLIGHT ? CompletedFrameIndex - FRAMES_IN_FLIGHT + 1 : 1;
+
+    for (UINT64 FrameIndex = First; FrameIndex <= CompletedFrameIndex; FrameIndex++)
+    {
+      frame_slot &Slot = FrameSlots[FrameIndex % FRAMES_IN_FLIGHT];
+
+      if (!Slot.IsProfileSubmitted || Slot.SubmittedProfile.FrameIndex != FrameIndex)
+        continue;
+      Slot.IsProfileSubmitted = FALSE;
+
+      UINT64 Timestamps[PROFILE_TIMESTAMP_COUNT];
+      frame_profile &Profile = Slot.SubmittedProfile;
+
+      // Frame is finished, so results are available without waiting
+      if (Slot.TimestampQueryPool && Device.getQueryPoolResults(Slot.TimestampQueryPool, 0, PROFILE_TIMESTAMP_COUNT, sizeof(Timestamps), Timestamps, sizeof(UINT64), vk::QueryResultFlagBits::e64) == vk::Result::eSuccess)
+      {
+        const profile_interval &Submit = Profile.CpuZones[(UINT32)profile_zone::eSubmit];
+        const DOUBLE GpuBegin = Submit.Begin + std::max(Submit.Duration, 0.0);
+
+        for (UINT32 Pass = 0; Pass < (UINT32)profile_pass::_eCount; Pass++)
+          Profile.GpuPasses[Pass] =
+          {
+            .Begin = GpuBegin + ((Timestamps[Pass] - Timestamps[0]) & TimestampMask) * TimestampPeriod / 1000,
+            .Duration = ((Timestamps[Pass + 1] - Timestamps[Pass]) & TimestampMask) * TimestampPeriod / 1000,
+          };
+      }
+
+      ProfileMutex.lock();
+      ProfileFrames[ProfileFrameCount++ % PROFILE_FRAME_COUNT] = Profile;
+      ProfileMutex.unlock();
+    }
+  } /* CompleteProfileFrames */
+
+  /**
+   * @brief Render thread zone begin function
+   * @param Zone Zone to begin
+  */
+  VOID system::BeginProfileZone( profile_zone Zone )
+  {
+    if (IsFrameProfiled)
+      CurrentProfile.CpuZones[(UINT32)Zone].Begin = GetProfileTime();
+  } /* BeginProfileZone */
+
+  /**
+   * @brief Render thread zone end function
+   * @param Zone Zone to end
+  */
+  VOID system::EndProfileZone( profile_zone Zone )
+  {
+    if (IsFrameProfiled)
+    {
+      profile_interval &Interval = CurrentProfile.CpuZones[(UINT32)Zone];
+
+      Interval.Duration = GetProfileTime() - Interval.Begin;
+    }
+  } /* EndProfileZone */
+
+  /**
+   * @brief Pass timestamp recording function
+   * @param CommandBuffer Command buffer to record timestamp write to
+   * @param Index Timestamp index: 0 for frame begin, pass index + 1 for pass end
+  */
+  VOID system::RecordProfileTimestamp( vk::CommandBuffer CommandBuffer, UINT32 Index )
+  {
+    if (!IsFrameProfiled || !IsTimestampSupported)
+      return;
+
+    const vk::QueryPool TimestampQueryPool = FrameSlot->TimestampQueryPool;
+
+    // Frame begin timestamp is recorded first, outside of render pass
+    if (Index == 0)
+    {
+      CommandBuffer.resetQueryPool(TimestampQueryPool, 0, PROFILE_TIMESTAMP_COUNT);
+      CommandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, TimestampQueryPool, 0);
+    }
+    else
+      CommandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, TimestampQueryPool, Index);
+  } /* RecordProfileTimestamp */
+
+  /**
+   * @brief Profiled frames getting function, may be called from any thread
+   * @return Last profiled frames, whose GPU work is finished, from the oldest one
+  */
+  std::vector<frame_profile> system::GetFrameProfiles( VOID )
+  {
+    std::vector<frame_profile> Result;
+
+    ProfileMutex.lock();
+    const UINT64 First = ProfileFrameCount > PROFILE_FRAME_COUNT ? ProfileFrameCount - PROFILE_FRAME_COUNT : 0;
+
+    Result.reserve(ProfileFrameCount - First);
+    for (UINT64 i = First; i < ProfileFrameCount; i++)
+      Result.push_back(ProfileFrames[i % PROFILE_FRAME_COUNT]);
+    ProfileMutex.unlock();
+
+    return Result;
+  } /* GetFrameProfiles */
+
+  /**
+   * @brief Profiled frames Chrome trace (chrome://tracing, Perfetto) export function, may be called from any thread
+   * @return Trace event JSON document
+  */
+  std::string system::ExportChromeTrace( VOID )
+  {
+    constexpr UINT32 CPU_TRACK = 1, GPU_TRACK = 2;
+    std::string Json = "{\"traceEvents\": [\n";
+
+    Json += std::format("  {{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": {}, \"args\": {{\"name\": \"Render thread\"}}}},\n", CPU_TRACK);
+    Json += std::format("  {{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": {}, \"args\": {{\"name\": \"Graphics queue\"}}}}", GPU_TRACK);
+
+    auto WriteEvent = [&]( std::string_view Name, UINT32 Track, const profile_interval &Interval )
+    {
+      if (Interval.Duration >= 0)
+        Json += std::format(",\n  {{\"name\": \"{}\", \"ph\": \"X\", \"pid\": 1, \"tid\": {}, \"ts\": {:.3f}, \"dur\": {:.3f}}}",
+          Name, Track, Interval.Begin, Interval.Duration);
+    };
+
+    for (const frame_profile &Profile : GetFrameProfiles())
+    {
+      WriteEvent(std::format("Frame {}", Profile.FrameIndex), CPU_TRACK, Profile.Frame);
+      for (UINT32 Zone = 0; Zone < (UINT32)profile_zone::_eCount; Zone++)
+        WriteEvent(ProfileZoneNames[Zone], CPU_TRACK, Profile.CpuZones[Zone]);
+      for (UINT32 Pass = 0; Pass < (UINT32)profile_pass::_eCount; Pass++)
+        WriteEvent(ProfilePassNames[Pass], GPU_TRACK, Profile.GpuPasses[Pass]);
+    }
+
+    return Json + "\n], \"displayTimeUnit\": \"ms\"}\n";
+  } /* ExportChromeTrace */
+} /* namespace anv::render::core */
+
+/* file anv_render_core_profiler.cpp */
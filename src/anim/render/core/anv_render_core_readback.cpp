@@ -0,0 +1,238 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/anim/render/core/anv_render_core_readback.cpp
+ * @description Render core frame readback implementation module
+ * @last_update 18.10.2026
+*/
+
+#include "anv.h"
+
+namespace anv::render::core
+{
+  /**
+   * @brief Continuous frame readback setting function. Copies are done asynchronously into host-visible buffer ring.
+   * @param Targets Images to copy every frame, empty to disable readback
+   * @param Callback Callback, called from readback thread for every captured frame. Frames are dropped while it is busy with whole ring.
+  */
+  VOID system::SetReadback( readback_target_flags Targets, readback_callback Callback )
+  {
+    if ((Targets & readback_target::eOutput) && !IsOutputReadbackSupported)
+      throw std::runtime_error("Output image readback is not supported by surface");
+
+    ReadbackConfigMutex.lock();
+    ReadbackTargets = Targets;
+    ReadbackCallback = Callback ? std::make_shared<readback_callback>(std::move(Callback)) : nullptr;
+    ReadbackConfigMutex.unlock();
+  } /* SetReadback */
+
+  /**
+   * @brief Readback statistics getting function
+   * @return Readback statistics
+  */
+  readback_stats system::GetReadbackStats( VOID ) const
+  {
+    return readback_stats
+    {
+      .CapturedCount = ReadbackCapturedCount,
+      .DroppedCount = ReadbackDroppedCount,
+    };
+  } /* GetReadbackStats */
+
+  /**
+   * @brief Frame copy recording function, called from render graph readback pass. Graph transitions copied images.
+   * @param CommandBuffer Command buffer to record copy to
+   * @param Frame Frame context to copy output of
+   * @param FrameIndex Frame number
+  */
+  VOID system::RecordReadback( vk::CommandBuffer CommandBuffer, frame_context &Frame, UINT64 FrameIndex )
+  {
+    // Graph transitions only targets, it is built with
+    ReadbackConfigMutex.lock();
+    readback_target_flags Targets = GraphReadbackTargets;
+    std::shared_ptr<readback_callback> Callback = ReadbackCallback;
+    ReadbackConfigMutex.unlock();
+
+    if (!Targets || Callback == nullptr)
+      return;
+
+    // Drop frame instead of waiting for readback thread
+    readback_slot &Slot = ReadbackSlots[NextReadbackSlot];
+    if (Slot.State.load(std::memory_order_acquire) != readback_slot::state::eFree)
+    {
+      ReadbackDroppedCount++;
+      return;
+    }
+    NextReadbackSlot = (NextReadbackSlot + 1) % READBACK_SLOT_COUNT;
+
+    // Images of targets, graph isn't built with, may be absent
+    auto GetImage = [&]( readback_target Target, render_graph::resource Resource )
+    {
+      return (Targets & Target) ? RenderGraph->GetImage(Resource) : vk::Image();
+    };
+
+    struct
+    {
+      readback_target Target;
+      vk::Image Image;
+      vk::Format Format;
+      vk::ImageAspectFlagBits Aspect;
+      UINT32 TexelSize;
+    } Sources[READBACK_TARGET_COUNT]
+    {
+      {readback_target::eOutput,                    Frame.SwapchainImage,                                                             OutputAttachmentFormat,                    vk::ImageAspectFlagBits::eColor, 4},
+      {readback_target::ePositionObjectID,          GetImage(readback_target::ePositionObjectID, PositionObjectID),                   PositionObjectIDAttachmentFormat,          vk::ImageAspectFlagBits::eColor, GBufferLayout == gbuffer_layout::eWide ? 16U : 4U},
+      {readback_target::eNormal,                    GetImage(readback_target::eNormal, Normal),                                       NormalAttachmentFormat,                    vk::ImageAspectFlagBits::eColor, 4},
+      {readback_target::eBaseColorAmbientOcclusion, GetImage(readback_target::eBaseColorAmbientOcclusion, BaseColorAmbientOcclusion), BaseColorAmbientOcclusionAttachmentFormat, vk::ImageAspectFlagBits::eColor, 4},
+      {readback_target::eMetallicRoughnessInstance, GetImage(readback_target::eMetallicRoughnessInstance, MetallicRoughnessInstance), MetallicRoughnessInstanceAttachmentFormat, vk::ImageAspectFlagBits::eColor, 4},
+      {readback_target::eDepth,                     GetImage(readback_target::eDepth, Depth),                                         DepthAttachmentFormat,                     vk::ImageAspectFlagBits::eDepth, 4},
+    };
+
+    vk::DeviceSize Size = (vk::DeviceSize)SwapchainImageExtent.width * SwapchainImageExtent.height;
+
+    Slot.ImageCount = 0;
+    for (UINT32 i = 0; i < READBACK_TARGET_COUNT; i++)
+    {
+      auto &Source = Sources[i];
+      if (!(Targets & Source.Target))
+        continue;
+
+      // (Re)allocate copy buffer, if it's too small
+      readback_slot::buffer &Buffer = Slot.Buffers[i];
+      SIZE_T RequiredSize = (SIZE_T)(Size * Source.TexelSize);
+      if (Buffer.Size < RequiredSize)
+      {
+        if (Buffer.Allocation != nullptr)
+          vmaDestroyBuffer(Allocator, Buffer.Buffer, Buffer.Allocation);
+
+        VkBufferCreateInfo BufferCreateInfo = vk::BufferCreateInfo()
+          .setSize(RequiredSize)
+          .setUsage(vk::BufferUsageFlagBits::eTransferDst)
+          .setSharingMode(vk::SharingMode::eExclusive)
+          ;
+        VmaAllocationCreateInfo AllocationCreateInfo
+        {
+          .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+          .usage = VMA_MEMORY_USAGE_AUTO,
+        };
+        VkBuffer CBuffer;
+        VmaAllocationInfo AllocationInfo;
+        if (auto Result = vmaCreateBuffer(Allocator, &BufferCreateInfo, &AllocationCreateInfo, &CBuffer, &Buffer.Allocation, &AllocationInfo); Result != VK_SUCCESS)
+          vk::detail::throwResultException(vk::Result(Result), "vmaCreateBuffer");
+
+        Buffer.Buffer = CBuffer;
+        Buffer.Data = AllocationInfo.pMappedData;
+        Buffer.Size = RequiredSize;
+      }
+
+      Slot.Images[Slot.ImageCount++] = readback_image
+      {
+        .Target = Source.Target,
+        .Format = Source.Format,
+        .Extent = extent2((INT)SwapchainImageExtent.width, (INT)SwapchainImageExtent.height),
+        .Data = std::span<const BYTE>(reinterpret_cast<const BYTE *>(Buffer.Data), RequiredSize),
+      };
+    }
+
+    for (UINT32 i = 0; i < READBACK_TARGET_COUNT; i++)
+      if (Targets & Sources[i].Target)
+        CommandBuffer.copyImageToBuffer(Sources[i].Image, vk::ImageLayout::eTransferSrcOptimal, Slot.Buffers[i].Buffer, vk::BufferImageCopy()
+          .setImageSubresource(vk::ImageSubresourceLayers(Sources[i].Aspect, 0, 0, 1))
+          .setImageExtent(vk::Extent3D(SwapchainImageExtent, 1))
+        );
+
+    // Make copies visible to host. Graph returns swapchain image to presentable layout.
+    vk::MemoryBarrier ToHostBarrier = vk::MemoryBarrier()
+      .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+      .setDstAccessMask(vk::AccessFlagBits::eHostRead);
+    CommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {}, ToHostBarrier, {}, {});
+
+    Slot.FrameIndex = FrameIndex;
+    Slot.VisibilityTriangleBits = VisibilityTriangleBits;
+    Slot.Callback = std::move(Callback);
+    Slot.State.store(readback_slot::state::eRecorded, std::memory_order_relaxed);
+  } /* RecordReadback */
+
+  /**
+   * @brief Finished copies passing function, called from render thread
+   * @param CompletedFrameIndex Number of last frame, finished on GPU
+  */
+  VOID system::CompleteReadbacks( UINT64 CompletedFrameIndex )
+  {
+    BOOL IsAnyCompleted = FALSE;
+
+    // Iterate from oldest slot to keep frame order
+    for (UINT32 i = 0; i < READBACK_SLOT_COUNT; i++)
+    {
+      UINT32 SlotIndex = (NextReadbackSlot + i) % READBACK_SLOT_COUNT;
+      readback_slot &Slot = ReadbackSlots[SlotIndex];
+
+      if (Slot.State.load(std::memory_order_relaxed) != readback_slot::state::eRecorded || Slot.FrameIndex > CompletedFrameIndex)
+        continue;
+
+      Slot.State.store(readback_slot::state::eReady, std::memory_order_release);
+      ReadyReadbackSlots.TryPush(SlotIndex); // Never fails, ring capacity is equal to slot count
+      IsAnyCompleted = TRUE;
+    }
+
+    if (IsAnyCompleted)
+    {
+      ReadyReadbackCounter++;
+      ReadyReadbackCounter.notify_one();
+    }
+  } /* CompleteReadbacks */
+
+  /**
+   * @brief Readback thread function
+  */
+  VOID system::ReadbackThreadMain( VOID )
+  {
+    UINT32 ObservedCounter = 0;
+
+    while (DoReadback)
+    {
+      ReadyReadbackCounter.wait(ObservedCounter);
+      ObservedCounter = ReadyReadbackCounter;
+
+      UINT32 SlotIndex;
+      while (ReadyReadbackSlots.TryPop(SlotIndex))
+      {
+        readback_slot &Slot = ReadbackSlots[SlotIndex];
+
+        for (UINT32 i = 0; i < READBACK_TARGET_COUNT; i++)
+          if (Slot.Buffers[i].Allocation != nullptr)
+            vmaInvalidateAllocation(Allocator, Slot.Buffers[i].Allocation, 0, VK_WHOLE_SIZE);
+
+        (*Slot.Callback)(readback_frame
+          {
+            .FrameIndex = Slot.FrameIndex,
+            .Images = std::span<const readback_image>(Slot.Images, Slot.ImageCount),
+            .VisibilityTriangleBits = Slot.VisibilityTriangleBits,
+          });
+        Slot.Callback.reset();
+        ReadbackCapturedCount++;
+
+        Slot.State.store(readback_slot::state::eFree, std::memory_order_release);
+      }
+    }
+  } /* ReadbackThreadMain */
+
+  /**
+   * @brief Readback ring destroy function
+  */
+  VOID system::DestroyReadback( VOID )
+  {
+    for (auto &Slot : ReadbackSlots)
+    {
+      for (auto &Buffer : Slot.Buffers)
+        if (Buffer.Allocation != nullptr)
+          vmaDestroyBuffer(Allocator, Buffer.Buffer, Buffer.Allocation);
+      Slot.Callback.reset();
+    }
+
+    ReadbackConfigMutex.lock();
+    ReadbackCallback.reset();
+    ReadbackConfigMutex.unlock();
+  } /* DestroyReadback */
+} /* namespace anv::render::core */
+
+/* file anv_render_core_readback.cpp */
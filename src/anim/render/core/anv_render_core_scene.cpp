@@ -0,0 +1,105 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/anim/render/core/anv_render_core_scene.cpp
+ * @description Render core scene hierarchy culling and queries implementation module
+ * @last_update 18.10.2026
+*/
+
+#include "anv.h"
+
+namespace anv::render::core
+{
+  /**
+   * @brief Scene hierarchy culling function, called from render thread.
+   *        Fills visible instances of CPU culled primitives with bounds.
+   * @param Frustum Frustum to cull by
+  */
+  VOID system::CullScene( const math::frustum &Frustum )
+  {
+    for (primitive *Primitive : PrimitivePool)
+      if (Primitive->Bounds.has_value() && Primitive->IndirectDrawIndex == primitive::NO_INDIRECT_DRAW)
+        Primitive->VisibleInstances.clear();
+
+    SceneBvhMutex.lock();
+    SceneBvh.Refit();
+    SceneBvh.RebuildIfDegraded();
+    SceneBvh.QueryFrustum(Frustum, []( math::bvh::handle, UINT64 UserData )
+    {
+      primitive::instance *Instance = reinterpret_cast<primitive::instance *>(UserData);
+
+      if (Instance->Primitive.IndirectDrawIndex == primitive::NO_INDIRECT_DRAW)
+        Instance->Primitive.VisibleInstances.push_back(Instance->Index);
+      return TRUE;
+    });
+    SceneBvhMutex.unlock();
+  } /* CullScene */
+
+  /**
+   * @brief Instances, overlapping box, querying function, may be called from any thread
+   * @param Box World space box
+   * @return Instances of primitives with bounds, whose world bounds overlap box. Valid until released by owner.
+  */
+  std::vector<primitive::instance *> system::QueryInstances( const math::aabb &Box )
+  {
+    std::vector<primitive::instance *> Result;
+
+    SceneBvhMutex.lock();
+    SceneBvh.Refit();
+    SceneBvh.QueryAABB(Box, [&]( math::bvh::handle, UINT64 UserData )
+    {
+      Result.push_back(reinterpret_cast<primitive::instance *>(UserData));
+      return TRUE;
+    });
+    SceneBvhMutex.unlock();
+
+    return Result;
+  } /* QueryInstances */
+
+  /**
+   * @brief Instances, possibly visible in frustum, querying function, may be called from any thread
+   * @param Frustum World space frustum
+   * @return Instances of primitives with bounds, whose world bounds aren't outside frustum. Valid until released by owner.
+  */
+  std::vector<primitive::instance *> system::QueryInstances( const math::frustum &Frustum )
+  {
+    std::vector<primitive::instance *> Result;
+
+    SceneBvhMutex.lock();
+    SceneBvh.Refit();
+    SceneBvh.QueryFrustum(Frustum, [&]( math::bvh::handle, UINT64 UserData )
+    {
+      Result.push_back(reinterpret_cast<primitive::instance *>(UserData));
+      return TRUE;
+    });
+    SceneBvhMutex.unlock();
+
+    return Result;
+  } /* QueryInstances */
+
+  /**
+   * @brief Instance box-level picking function, may be called from any thread.
+   *        Ray is tested against world bounding boxes of instances, not against their triangles (primitives keep no CPU copy of geometry),
+   *        so picked instance is the one with the nearest box and ray may pass by its geometry.
+   * @param Ray World space ray
+   * @param MaxDistance Maximal distance along ray
+   * @return Instance with the nearest world bounds, hit by ray, and distance to box entry point. Instance is valid until released by owner.
+  */
+  std::optional<std::pair<primitive::instance *, FLOAT>> system::PickInstance( const math::ray &Ray, FLOAT MaxDistance )
+  {
+    std::optional<std::pair<primitive::instance *, FLOAT>> Result;
+
+    SceneBvhMutex.lock();
+    SceneBvh.Refit();
+    SceneBvh.QueryRay(Ray, MaxDistance, [&]( math::bvh::handle, UINT64 UserData, FLOAT Distance )
+    {
+      // Query is clipped by the nearest hit found so far
+      Result = {reinterpret_cast<primitive::instance *>(UserData), Distance};
+      return Distance;
+    });
+    SceneBvhMutex.unlock();
+
+    return Result;
+  } /* PickInstance */
+} /* namespace anv::render::core */
+
+/* file anv_render_core_scene.cpp */
@@ -0,0 +1,587 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/anim/render/core/anv_render_core_shadow.cpp
+ * @description Render core directional light cascaded shadow maps implementation module
+ * @last_update 18.10.2026
+*/
+
+#include "anv.h"
+
+#include <shaderc/shaderc.hpp>
+
+namespace anv::render::core
+{
+  /**
+   * Shadow caster vertex shader. Transforms pipeline position attribute by caster instance transform,
+   * taken by instance index from rendered cascades transform buffer, and cascade view projection.
+  */
+  static const CHAR *ShadowVertexShaderSource = R"(
+    #version 450
+
+    layout(set = 0, binding = 0, std430) readonly buffer casters { mat4 Transforms[]; };
+
+    layout(push_constant) uniform cascade { mat4 ViewProjection; } Cascade;
+
+    layout(location = 0) in vec3 Position;
+
+    void main()
+    {
+      gl_Position = Cascade.ViewProjection * (Transforms[gl_InstanceIndex] * vec4(Position, 1));
+    }
+  )";
+
+  static constexpr vk::Format ShadowMapFormat = vk::Format::eD32Sfloat;
+
+  /* Shadow caster draw (instances of one primitive, visible in cascade) */
+  struct shadow_draw
+  {
+    primitive *Primitive; // Caster primitive
+    UINT32 FirstInstance; // First transform in caster buffer
+    UINT32 InstanceCount; // Count of drawn instances
+  }; /* struct shadow_draw */
+
+  /**
+   * @brief Shadow resources initialization function. Called before lighting initialization.
+  */
+  VOID system::InitShadows( VOID )
+  {
+    // Device is created with every supported feature
+    IsDepthClampSupported = PhysicalDevice.getFeatures().depthClamp;
+
+    shaderc::Compiler Compiler;
+    shaderc::CompileOptions Options;
+
+    Options.SetOptimizationLevel(shaderc_optimization_level_performance);
+    Options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_3);
+
+    shaderc::SpvCompilationResult Compiled = Compiler.CompileGlslToSpv(ShadowVertexShaderSource, shaderc_vertex_shader, "shadow.vert", Options);
+    if (Compiled.GetCompilationStatus() != shaderc_compilation_status_success)
+      throw std::runtime_error(Compiled.GetErrorMessage());
+    ShadowVertexSPV.assign(Compiled.cbegin(), Compiled.cend());
+
+    /* Render pass */
+
+    vk::AttachmentDescription DepthAttachment = vk::AttachmentDescription()
+      .setFormat(ShadowMapFormat)
+      .setSamples(vk::SampleCountFlagBits::e1)
+      .setLoadOp(vk::AttachmentLoadOp::eClear)
+      .setStoreOp(vk::AttachmentStoreOp::eStore)
+      .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
+      .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
+      .setInitialLayout(vk::ImageLayout::eUndefined)
+      .setFinalLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
+    vk::AttachmentReference DepthReference {0, vk::ImageLayout::eDepthStencilAttachmentOptimal};
+    vk::SubpassDescription Subpass = vk::SubpassDescription()
+      .setPipelineBindPoint(vk::PipelineBindPoint::eGraphics)
+      .setPDepthStencilAttachment(&DepthReference);
+
+    // Cascade is sampled by shading of previous frame before it's rendered, and by shading of this frame after
+    vk::SubpassDependency Dependencies[]
+    {
+      {VK_SUBPASS_EXTERNAL, 0,
+        vk::PipelineStageFlagBits::eFragmentShader, vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests,
+        {}, vk::AccessFlagBits::eDepthStencilAttachmentWrite},
+      {0, VK_SUBPASS_EXTERNAL,
+        vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests, vk::PipelineStageFlagBits::eFragmentShader,
+        vk::AccessFlagBits::eDepthStencilAttachmentWrite, vk::AccessFlagBits::eShaderRead},
+    };
+    ShadowRenderPass = Device.createRenderPass(vk::RenderPassCreateInfo()
+      .setAttachments(DepthAttachment)
+      .setSubpasses(Subpass)
+      .setDependencies(Dependencies)
+    );
+
+    /* Shadow map */
+
+    VkImageCreateInfo ImageCreateInfo = vk::ImageCreateInfo()
+      .setExtent(vk::Extent3D(SHADOW_MAP_SIZE, SHADOW_MAP_SIZE, 1))
+      .setFormat(ShadowMapFormat)
+      .setUsage(vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled)
+      .setSharingMode(vk::SharingMode::eExclusive)
+      .setImageType(vk::ImageType::e2D)
+      .setTiling(vk::ImageTiling::eOptimal)
+      .setMipLevels(1)
+      .setArrayLayers(SHADOW_CASCADE_COUNT)
+      ;
+    VmaAllocationCreateInfo AllocationCreateInfo
+    {
+      .usage = VMA_MEMORY_USAGE_GPU_ONLY,
+    };
+
+    VkImage CImage;
+    if (auto Result = vmaCreateImage(Allocator, &ImageCreateInfo, &AllocationCreateInfo, &CImage, &ShadowMapAllocation, nullptr); Result != VK_SUCCESS)
+      vk::detail::throwResultException(vk::Result(Result), "vmaCreateImage");
+    ShadowMap = CImage;
+
+    ShadowMapView = Device.createImageView(vk::ImageViewCreateInfo()
+      .setFormat(ShadowMapFormat)
+      .setImage(ShadowMap)
+      .setViewType(vk::ImageViewType::e2DArray)
+      .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eDepth, 0, 1, 0, SHADOW_CASCADE_COUNT))
+    );
+    for (UINT32 Cascade = 0; Cascade < SHADOW_CASCADE_COUNT; Cascade++)
+    {
+      ShadowCascadeViews[Cascade] = Device.createImageView(vk::ImageViewCreateInfo()
+        .setFormat(ShadowMapFormat)
+        .setImage(ShadowMap)
+        .setViewType(vk::ImageViewType::e2D)
+        .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eDepth, 0, 1, Cascade, 1))
+      );
+      ShadowFramebuffers[Cascade] = Device.createFramebuffer(vk::FramebufferCreateInfo()
+        .setRenderPass(ShadowRenderPass)
+        .setAttachments(ShadowCascadeViews[Cascade])
+        .setWidth(SHADOW_MAP_SIZE)
+        .setHeight(SHADOW_MAP_SIZE)
+        .setLayers(1)
+      );
+    }
+
+    // Hardware 2x2 PCF, points outside of cascade are lit
+    ShadowSampler = Device.createSampler(vk::SamplerCreateInfo()
+      .setMinFilter(vk::Filter::eLinear)
+      .setMagFilter(vk::Filter::eLinear)
+      .setMipmapMode(vk::SamplerMipmapMode::eNearest)
+      .setAddressModeU(vk::SamplerAddressMode::eClampToBorder)
+      .setAddressModeV(vk::SamplerAddressMode::eClampToBorder)
+      .setAddressModeW(vk::SamplerAddressMode::eClampToEdge)
+      .setBorderColor(vk::BorderColor::eFloatOpaqueWhite)
+      .setCompareEnable(vk::True)
+      .setCompareOp(vk::CompareOp::eLessOrEqual)
+    );
+
+    /* Caster transforms */
+
+    vk::DescriptorSetLayoutBinding CasterBinding {0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eVertex};
+    ShadowDescriptorSetLayout = Device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo().setBindings(CasterBinding));
+
+    vk::PushConstantRange CascadeRange {vk::ShaderStageFlagBits::eVertex, 0, sizeof(mat4x4)};
+    ShadowPipelineLayout = Device.createPipelineLayout(vk::PipelineLayoutCreateInfo()
+      .setSetLayouts(ShadowDescriptorSetLayout)
+      .setPushConstantRanges(CascadeRange)
+    );
+
+    vk::DescriptorPoolSize PoolSize {vk::DescriptorType::eStorageBuffer, FRAMES_IN_FLIGHT};
+    ShadowDescriptorPool = Device.createDescriptorPool(vk::DescriptorPoolCreateInfo()
+      .setMaxSets(FRAMES_IN_FLIGHT)
+      .setPoolSizes(PoolSize)
+    );
+
+    // Caster transforms are written every frame, so frames in flight have separate buffers
+    for (frame_slot &Slot : FrameSlots)
+    {
+      Slot.ShadowDescriptorSet = Device.allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
+        .setDescriptorPool(ShadowDescriptorPool)
+        .setSetLayouts(ShadowDescriptorSetLayout)
+      )[0];
+
+      ReserveGpuCullingBuffer(Slot.ShadowCasterBuffer, sizeof(mat4x4), vk::BufferUsageFlagBits::eStorageBuffer, TRUE);
+
+      vk::DescriptorBufferInfo CasterBufferInfo {Slot.ShadowCasterBuffer.Buffer, 0, VK_WHOLE_SIZE};
+      Device.updateDescriptorSets(vk::WriteDescriptorSet()
+        .setDstSet(Slot.ShadowDescriptorSet)
+        .setDstBinding(0)
+        .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+        .setBufferInfo(CasterBufferInfo), {});
+    }
+  } /* InitShadows */
+
+  /**
+   * @brief Shadow resources destroy function
+  */
+  VOID system::DestroyShadows( VOID )
+  {
+    for (frame_slot &Slot : FrameSlots)
+      if (Slot.ShadowCasterBuffer.Allocation != nullptr)
+        vmaDestroyBuffer(Allocator, Slot.ShadowCasterBuffer.Buffer, Slot.ShadowCasterBuffer.Allocation);
+
+    Device.destroyDescriptorPool(ShadowDescriptorPool);
+    Device.destroyPipelineLayout(ShadowPipelineLayout);
+    Device.destroyDescriptorSetLayout(ShadowDescriptorSetLayout);
+    Device.destroySampler(ShadowSampler);
+
+    for (UINT32 Cascade = 0; Cascade < SHADOW_CASCADE_COUNT; Cascade++)
+    {
+      Device.destroyFramebuffer(ShadowFramebuffers[Cascade]);
+      Device.destroyImageView(ShadowCascadeViews[Cascade]);
+    }
+    Device.destroyImageView(ShadowMapView);
+    vmaDestroyImage(Allocator, ShadowMap, ShadowMapAllocation);
+
+    Device.destroyRenderPass(ShadowRenderPass);
+  } /* DestroyShadows */
+
+  /**
+   * @brief Shadow caster pipeline creation function, called from pipeline building
+   * @param Builder Pipeline builder with position as first vertex attribute
+   * @return Created depth only pipeline, empty if pipeline has no vertex attributes
+  */
+  vk::Pipeline system::CreateShadowPipeline( const pipeline::builder &Builder )
+  {
+    if (Builder.VertexAttributeLayouts.empty())
+      return vk::Pipeline();
+
+    // Only position attribute is fetched
+    const pipeline::vertex_attribute_layout &PositionLayout = Builder.VertexAttributeLayouts[0];
+    vk::VertexInputBindingDescription PositionBinding = vk::VertexInputBindingDescription()
+      .setBinding(0)
+      .setStride(Builder.VertexBufferLayouts[PositionLayout.BufferIndex].Stride)
+      .setInputRate(vk::VertexInputRate::eVertex);
+    vk::VertexInputAttributeDescription PositionAttribute = vk::VertexInputAttributeDescription()
+      .setLocation(0)
+      .setBinding(0)
+      .setOffset(PositionLayout.Offset)
+      .setFormat(TranslateFormat(PositionLayout.Format));
+
+    vk::PipelineShaderStageCreateInfo VertexStage = vk::PipelineShaderStageCreateInfo()
+      .setModule(Device.createShaderModule(vk::ShaderModuleCreateInfo().setCode(ShadowVertexSPV)))
+      .setPName("main")
+      .setStage(vk::ShaderStageFlagBits::eVertex);
+    vk::PipelineVertexInputStateCreateInfo VertexInputState = vk::PipelineVertexInputStateCreateInfo()
+      .setVertexBindingDescriptions(PositionBinding)
+      .setVertexAttributeDescriptions(PositionAttribute);
+    vk::PipelineInputAssemblyStateCreateInfo InputAssemblyState = vk::PipelineInputAssemblyStateCreateInfo()
+      .setTopology(TranslateTopology(Builder.PrimitiveTopology));
+    vk::PipelineViewportStateCreateInfo ViewportState = vk::PipelineViewportStateCreateInfo()
+      .setViewportCount(1)
+      .setScissorCount(1);
+
+    // Casters between light and cascade are flattened to its near plane, so cascade depth range is tight
+    vk::PipelineRasterizationStateCreateInfo RasterizationState = vk::PipelineRasterizationStateCreateInfo()
+      .setDepthClampEnable(IsDepthClampSupported)
+      .setPolygonMode(vk::PolygonMode::eFill)
+      .setCullMode(TranslateCullMode(Builder.CullMode))
+      .setDepthBiasEnable(vk::True)
+      .setDepthBiasConstantFactor(1.25F)
+      .setDepthBiasSlopeFactor(1.75F)
+      .setLineWidth(1);
+    vk::PipelineMultisampleStateCreateInfo MultisampleState = vk::PipelineMultisampleStateCreateInfo()
+      .setRasterizationSamples(vk::SampleCountFlagBits::e1);
+    vk::PipelineDepthStencilStateCreateInfo DepthStencilState = vk::PipelineDepthStencilStateCreateInfo()
+      .setDepthTestEnable(vk::True)
+      .setDepthWriteEnable(vk::True)
+      .setDepthCompareOp(vk::CompareOp::eLessOrEqual);
+    vk::DynamicState DynamicStates[] {vk::DynamicState::eViewport, vk::DynamicState::eScissor};
+    vk::PipelineDynamicStateCreateInfo DynamicState = vk::PipelineDynamicStateCreateInfo()
+      .setDynamicStates(DynamicStates);
+
+    vk::Result PipelineCreateResult;
+    vk::Pipeline Pipeline;
+    std::tie(PipelineCreateResult, Pipeline) = Device.createGraphicsPipeline(nullptr, vk::GraphicsPipelineCreateInfo()
+      .setStages(VertexStage)
+      .setPVertexInputState(&VertexInputState)
+      .setPInputAssemblyState(&InputAssemblyState)
+      .setPViewportState(&ViewportState)
+      .setPRasterizationState(&RasterizationState)
+      .setPMultisampleState(&MultisampleState)
+      .setPDepthStencilState(&DepthStencilState)
+      .setPDynamicState(&DynamicState)
+      .setLayout(ShadowPipelineLayout)
+      .setRenderPass(ShadowRenderPass)
+      .setSubpass(0)
+    );
+    Device.destroyShaderModule(VertexStage.module);
+
+    // Primitives of pipeline just don't cast shadows then
+    if (PipelineCreateResult != vk::Result::eSuccess)
+      return vk::Pipeline();
+    return Pipeline;
+  } /* CreateShadowPipeline */
+
+  /**
+   * @brief Moved shadow caster registration function, called with SceneBvhMutex locked
+   * @param Box World bounds of instance before or after movement, empty if primitive has no bounds
+  */
+  VOID system::InvalidateShadowCasters( const std::optional<math::aabb> &Box )
+  {
+    // Too many moved casters are cheaper to handle as moved everything
+    if (!Box.has_value() || MovedCasterBoxes.size() >= MAX_MOVED_CASTER_COUNT)
+    {
+      IsShadowCacheInvalid = TRUE;
+      MovedCasterBoxes.clear();
+    }
+    else if (!IsShadowCacheInvalid)
+      MovedCasterBoxes.push_back(*Box);
+  } /* InvalidateShadowCasters */
+
+  /**
+   * @brief Directional light setting function, may be called from any thread.
+   *        Shadows are cast by primitives of pipelines, built with CastShadows, into cascades over culling camera view.
+   * @param Light Directional light, empty to disable it
+  */
+  VOID system::SetDirectionalLight( const std::optional<directional_light> &Light )
+  {
+    ShadowMutex.lock();
+    DirectionalLight = Light;
+    ShadowMutex.unlock();
+  } /* SetDirectionalLight */
+
+  /**
+   * @brief Shadow caching enabling function, may be called from any thread
+   * @param Enable TRUE to keep cascades until their placement changes or casters in them move, FALSE to render every cascade every frame
+  */
+  VOID system::SetShadowCaching( BOOL Enable )
+  {
+    IsShadowCachingEnabled = Enable;
+  } /* SetShadowCaching */
+
+  /**
+   * @brief Shadow statistics getting function
+   * @return Shadow statistics of last rendered frame
+  */
+  shadow_stats system::GetShadowStats( VOID ) const
+  {
+    return shadow_stats
+    {
+      .RenderedCascadeCount = ShadowRenderedCascadeCount,
+      .CasterInstanceCount = ShadowCasterInstanceCount,
+    };
+  } /* GetShadowStats */
+
+  /**
+   * @brief Cascade shadow maps recording function, called from render thread before graph execution.
+   *        Places cascades over camera view, renders only cascades with changed placement or moved casters.
+   * @param CommandBuffer Command buffer to record cascade render passes to
+   * @param Camera Camera, frame is shaded from, nullptr to disable shadows
+  */
+  VOID system::RecordShadows( vk::CommandBuffer CommandBuffer, const math::util::camera::projection_matrices *Camera )
+  {
+    ShadowMutex.lock();
+    FrameDirectionalLight = DirectionalLight;
+    ShadowMutex.unlock();
+
+    // Moved casters are taken every frame, so list doesn't grow while shadows are off
+    SceneBvhMutex.lock();
+    std::vector<math::aabb> MovedBoxes = std::move(MovedCasterBoxes);
+    BOOL IsCacheInvalid = IsShadowCacheInvalid || !IsShadowCachingEnabled;
+    MovedCasterBoxes.clear();
+    IsShadowCacheInvalid = FALSE;
+    SceneBvhMutex.unlock();
+
+    // Shading set always refers shadow map, so its layers are readable before the first cascade is rendered
+    if (!IsShadowMapInitialized)
+    {
+      CommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eFragmentShader, {}, {}, {},
+        vk::ImageMemoryBarrier()
+          .setOldLayout(vk::ImageLayout::eUndefined)
+          .setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+          .setDstAccessMask(vk::AccessFlagBits::eShaderRead)
+          .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+          .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+          .setImage(ShadowMap)
+          .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eDepth, 0, 1, 0, SHADOW_CASCADE_COUNT)));
+      IsShadowMapInitialized = TRUE;
+    }
+
+    // Near and far distances of perspective projection (as built by mat4x4::FrustumProjection)
+    FLOAT Near = 0, Far = 0;
+    if (Camera != nullptr)
+    {
+      Near = Camera->Projection.Data[3][2] / (Camera->Projection.Data[2][2] - 1);
+      Far = Camera->Projection.Data[3][2] / (Camera->Projection.Data[2][2] + 1);
+    }
+
+    IsFrameShadowed = FrameDirectionalLight.has_value() && FrameDirectionalLight->CastShadows && Near > 0 && Far > Near;
+    if (!IsFrameShadowed)
+    {
+      // Moved casters aren't tracked, so cached cascades are outdated
+      for (shadow_cascade &Cascade : ShadowCascades)
+        Cascade.IsValid = FALSE;
+      ShadowRenderedCascadeCount = 0;
+      ShadowCasterInstanceCount = 0;
+      return;
+    }
+
+    // Light space basis
+    const vec3 Direction = FrameDirectionalLight->Direction.Normalized();
+    if ((Direction & ShadowLightDirection) < 0.99999F)
+    {
+      ShadowLightDirection = Direction;
+      for (shadow_cascade &Cascade : ShadowCascades)
+        Cascade.IsValid = FALSE;
+    }
+    const vec3
+      Right = ((std::abs(Direction.Y) < 0.99F ? vec3(0, 1, 0) : vec3(1, 0, 0)) % Direction).Normalized(),
+      Up = Direction % Right;
+
+    // View space directions to frustum corners, scaled to unit depth
+    const mat4x4 InverseView = Camera->View.Inversed(), InverseProjection = Camera->Projection.Inversed();
+    vec3 CornerDirections[4];
+    for (UINT32 i = 0; i < 4; i++)
+    {
+      const vec3 Point = InverseProjection * vec3((i & 1) != 0 ? 1.0F : -1.0F, (i & 2) != 0 ? 1.0F : -1.0F, 1.0F);
+
+      CornerDirections[i] = Point / -Point.Z;
+    }
+
+    const FLOAT ShadowFar = std::min(Far, SHADOW_DISTANCE);
+    FLOAT SplitNear = Near;
+    std::vector<mat4x4> CasterTransforms;
+    std::vector<shadow_draw> Draws;
+    std::vector<std::pair<primitive *, UINT32>> Casters;
+    UINT32 CascadeDrawRanges[SHADOW_CASCADE_COUNT][2] {};
+    BOOL IsCascadeRendered[SHADOW_CASCADE_COUNT] {};
+    UINT32 RenderedCascadeCount = 0;
+
+    for (UINT32 CascadeIndex = 0; CascadeIndex < SHADOW_CASCADE_COUNT; CascadeIndex++)
+    {
+      shadow_cascade &Cascade = ShadowCascades[CascadeIndex];
+
+      // Practical split scheme: logarithmic and uniform splits blend
+      const FLOAT Fraction = (FLOAT)(CascadeIndex + 1) / SHADOW_CASCADE_COUNT;
+      const FLOAT SplitFar = SHADOW_SPLIT_LAMBDA * Near * std::pow(ShadowFar / Near, Fraction) + (1 - SHADOW_SPLIT_LAMBDA) * (Near + (ShadowFar - Near) * Fraction);
+
+      // Bounding sphere of cascade view frustum slice
+      vec3 Corners[8], Center(0);
+      for (UINT32 i = 0; i < 8; i++)
+      {
+        Corners[i] = InverseView * (CornerDirections[i & 3] * (i < 4 ? SplitNear : SplitFar));
+        Center += Corners[i];
+      }
+      Center /= 8;
+
+      FLOAT Radius = 0;
+      for (const vec3 &Corner : Corners)
+        Radius = std::max(Radius, (Corner - Center).Length());
+
+      ShadowCascadeSplits[CascadeIndex] = SplitFar;
+      SplitNear = SplitFar;
+
+      // Cascade is kept while slice sphere stays inside of it
+      const FLOAT X = Center & Right, Y = Center & Up, Depth = Center & Direction;
+      const FLOAT
+        DX = X - Cascade.CenterX,
+        DY = Y - Cascade.CenterY,
+        DZ = Depth - Cascade.CenterDepth;
+      BOOL IsRendered = !Cascade.IsValid || IsCacheInvalid;
+
+      if (!Cascade.IsValid || std::sqrt(DX * DX + DY * DY + DZ * DZ) + Radius > Cascade.Radius)
+      {
+        Cascade.Radius = Radius * SHADOW_CASCADE_MARGIN;
+
+        // Snapping to texels keeps shadow edges from shimmering, when cascade is moved
+        const FLOAT TexelSize = 2 * Cascade.Radius / SHADOW_MAP_SIZE;
+        Cascade.CenterX = std::floor(X / TexelSize) * TexelSize;
+        Cascade.CenterY = std::floor(Y / TexelSize) * TexelSize;
+        Cascade.CenterDepth = Depth;
+
+        // Casters toward light are clamped to near plane, if depth clamp isn't supported depth range includes them
+        const FLOAT
+          CasterNear = Cascade.CenterDepth - Cascade.Radius - SHADOW_CASTER_DISTANCE,
+          DepthNear = IsDepthClampSupported ? Cascade.CenterDepth - Cascade.Radius : CasterNear,
+          DepthFar = Cascade.CenterDepth + Cascade.Radius,
+          InverseRadius = 1 / Cascade.Radius,
+          InverseDepthRange = 1 / (DepthFar - DepthNear);
+
+        Cascade.ViewProjection = mat4x4
+        {
+          Right.X * InverseRadius,          Up.X * InverseRadius,             Direction.X * InverseDepthRange, 0,
+          Right.Y * InverseRadius,          Up.Y * InverseRadius,             Direction.Y * InverseDepthRange, 0,
+          Right.Z * InverseRadius,          Up.Z * InverseRadius,             Direction.Z * InverseDepthRange, 0,
+          -Cascade.CenterX * InverseRadius, -Cascade.CenterY * InverseRadius, -DepthNear * InverseDepthRange,  1
+        };
+
+        math::frustum &Frustum = Cascade.CasterFrustum;
+        Frustum.Planes[math::frustum::eLeft] = fvec4(Right.X, Right.Y, Right.Z, Cascade.Radius - Cascade.CenterX);
+        Frustum.Planes[math::frustum::eRight] = fvec4(-Right.X, -Right.Y, -Right.Z, Cascade.Radius + Cascade.CenterX);
+        Frustum.Planes[math::frustum::eBottom] = fvec4(Up.X, Up.Y, Up.Z, Cascade.Radius - Cascade.CenterY);
+        Frustum.Planes[math::frustum::eTop] = fvec4(-Up.X, -Up.Y, -Up.Z, Cascade.Radius + Cascade.CenterY);
+        Frustum.Planes[math::frustum::eNear] = fvec4(Direction.X, Direction.Y, Direction.Z, -CasterNear);
+        Frustum.Planes[math::frustum::eFar] = fvec4(-Direction.X, -Direction.Y, -Direction.Z, DepthFar);
+
+        IsRendered = TRUE;
+      }
+
+      for (UINT32 i = 0; !IsRendered && i < MovedBoxes.size(); i++)
+        IsRendered = Cascade.CasterFrustum.TestAABB(MovedBoxes[i]);
+
+      if (!IsRendered)
+        continue;
+      Cascade.IsValid = TRUE;
+      IsCascadeRendered[CascadeIndex] = TRUE;
+      RenderedCascadeCount++;
+
+      // Per cascade culling, casters without bounds are drawn to every cascade
+      Casters.clear();
+      for (primitive::instance *Instance : QueryInstances(Cascade.CasterFrustum))
+        if (Instance->Primitive.Pipeline.ShadowPipeline && Instance->Primitive.IndexBuffer != nullptr)
+          Casters.push_back({&Instance->Primitive, Instance->Index});
+      for (primitive *Primitive : PrimitivePool)
+        if (Primitive->Pipeline.ShadowPipeline && Primitive->IndexBuffer != nullptr && !Primitive->Bounds.has_value())
+          for (UINT32 Index = 0; Index < Primitive->Transforms.size(); Index++)
+            Casters.push_back({Primitive, Index});
+
+      // Instances of one primitive are drawn by single instanced draw
+      std::sort(Casters.begin(), Casters.end());
+
+      CascadeDrawRanges[CascadeIndex][0] = (UINT32)Draws.size();
+      for (const auto &[Primitive, Index] : Casters)
+      {
+        if (Draws.size() == CascadeDrawRanges[CascadeIndex][0] || Draws.back().Primitive != Primitive)
+          Draws.push_back({Primitive, (UINT32)CasterTransforms.size(), 0});
+        Draws.back().InstanceCount++;
+        CasterTransforms.push_back(Primitive->Transforms[Index]);
+      }
+      CascadeDrawRanges[CascadeIndex][1] = (UINT32)Draws.size();
+    }
+
+    if (!CasterTransforms.empty())
+    {
+      if (ReserveGpuCullingBuffer(FrameSlot->ShadowCasterBuffer, CasterTransforms.size() * sizeof(mat4x4), vk::BufferUsageFlagBits::eStorageBuffer, TRUE))
+      {
+        vk::DescriptorBufferInfo CasterBufferInfo {FrameSlot->ShadowCasterBuffer.Buffer, 0, VK_WHOLE_SIZE};
+
+        Device.updateDescriptorSets(vk::WriteDescriptorSet()
+          .setDstSet(FrameSlot->ShadowDescriptorSet)
+          .setDstBinding(0)
+          .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+          .setBufferInfo(CasterBufferInfo), {});
+      }
+      std::memcpy(FrameSlot->ShadowCasterBuffer.Data, CasterTransforms.data(), CasterTransforms.size() * sizeof(mat4x4));
+      vmaFlushAllocation(Allocator, FrameSlot->ShadowCasterBuffer.Allocation, 0, VK_WHOLE_SIZE);
+    }
+
+    vk::ClearValue DepthClear = vk::ClearDepthStencilValue(1.0F, 0);
+    UINT64 CasterInstanceCount = 0;
+
+    for (UINT32 CascadeIndex = 0; CascadeIndex < SHADOW_CASCADE_COUNT; CascadeIndex++)
+    {
+      if (!IsCascadeRendered[CascadeIndex])
+        continue;
+
+      // Rendered cascade is cleared even without casters
+      CommandBuffer.beginRenderPass(vk::RenderPassBeginInfo()
+        .setRenderPass(ShadowRenderPass)
+        .setFramebuffer(ShadowFramebuffers[CascadeIndex])
+        .setRenderArea(vk::Rect2D({0, 0}, {SHADOW_MAP_SIZE, SHADOW_MAP_SIZE}))
+        .setClearValues(DepthClear), vk::SubpassContents::eInline);
+      CommandBuffer.setViewport(0, vk::Viewport(0, 0, (FLOAT)SHADOW_MAP_SIZE, (FLOAT)SHADOW_MAP_SIZE, 0, 1));
+      CommandBuffer.setScissor(0, vk::Rect2D({0, 0}, {SHADOW_MAP_SIZE, SHADOW_MAP_SIZE}));
+      CommandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, ShadowPipelineLayout, 0, FrameSlot->ShadowDescriptorSet, {});
+      CommandBuffer.pushConstants(ShadowPipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(mat4x4), &ShadowCascades[CascadeIndex].ViewProjection);
+
+      vk::Pipeline BoundPipeline;
+      for (UINT32 DrawIndex = CascadeDrawRanges[CascadeIndex][0]; DrawIndex < CascadeDrawRanges[CascadeIndex][1]; DrawIndex++)
+      {
+        const shadow_draw &Draw = Draws[DrawIndex];
+        const primitive &Primitive = *Draw.Primitive;
+        const primitive::lod &Lod = Primitive.Lods[0];
+
+        if (Primitive.Pipeline.ShadowPipeline != BoundPipeline)
+        {
+          BoundPipeline = Primitive.Pipeline.ShadowPipeline;
+          CommandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, BoundPipeline);
+        }
+        CommandBuffer.bindVertexBuffers(0, Primitive.VertexBuffers[Primitive.Pipeline.PositionBufferIndex]->View, {0});
+        CommandBuffer.bindIndexBuffer(Primitive.IndexBuffer->View, 0, vk::IndexType::eUint32);
+        CommandBuffer.drawIndexed(Lod.IndexCount, Draw.InstanceCount, Lod.FirstIndex, Lod.VertexOffset, Draw.FirstInstance);
+        CasterInstanceCount += Draw.InstanceCount;
+      }
+      CommandBuffer.endRenderPass();
+    }
+
+    ShadowRenderedCascadeCount = RenderedCascadeCount;
+    ShadowCasterInstanceCount = CasterInstanceCount;
+  } /* RecordShadows */
+} /* namespace anv::render::core */
+
+/* file anv_render_core_shadow.cpp */
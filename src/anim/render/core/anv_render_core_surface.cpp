@@ -15,9 +15,11 @@ namespace anv::render::core
   {
     switch (Window.Kind)
     {
+#ifdef _WIN32
     case window::raw_handle::kind::eWin32:
       Surface = CreateWin32Surface((VkInstance)Instance, Window.Win32.HWnd, Window.Win32.HInstance).second;
       break;
+#endif // defined(_WIN32)
 
     default:
       throw std::runtime_error("Platform unsupported");
@@ -28,8 +30,10 @@ namespace anv::render::core
   {
     switch (Window.Kind)
     {
+#ifdef _WIN32
     case window::raw_handle::kind::eWin32:
       return GetWin32Extensions();
+#endif // defined(_WIN32)
 
     default:
       throw std::runtime_error("Platform unsupported");
@@ -37,6 +41,7 @@ namespace anv::render::core
   } /* GetRequiredSurfaceExtensions */
 } /* namespace anv::render::core */
 
+#ifdef _WIN32
 #include <windows.h>
 #include <vulkan/vulkan_win32.h>
 
@@ -75,5 +80,6 @@ namespace anv::render::core
     return { VK_KHR_SURFACE_EXTENSION_NAME, VK_KHR_WIN32_SURFACE_EXTENSION_NAME };
   } /* GetWin32Extensions */
 } /* namespace anv::render::core */
+#endif // defined(_WIN32)
 
 /* file anv_render_core_surface.cpp */
\ No newline at end of file
@@ -0,0 +1,127 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/anim/render/core/anv_render_core_timeline.cpp
+ * @description Render core GPU timeline implementation module
+ * @last_update 18.10.2026
+*/
+
+#include "anv.h"
+
+namespace anv::render::core
+{
+  /**
+   * @brief Timeline semaphore initialization function
+  */
+  VOID system::InitTimeline( VOID )
+  {
+    vk::SemaphoreTypeCreateInfo TypeCreateInfo = vk::SemaphoreTypeCreateInfo()
+      .setSemaphoreType(vk::SemaphoreType::eTimeline)
+      .setInitialValue(0)
+      ;
+
+    TimelineSemaphore = Device.createSemaphore(vk::SemaphoreCreateInfo().setPNext(&TypeCreateInfo));
+  } /* InitTimeline */
+
+  /**
+   * @brief Timeline semaphore destroy function. Device must be idle.
+  */
+  VOID system::DestroyTimeline( VOID )
+  {
+    // Destroy callbacks may defer other ones
+    while (!DeferredDestroys.empty())
+      CollectDeferredDestroys(TRUE);
+    Device.destroySemaphore(TimelineSemaphore);
+  } /* DestroyTimeline */
+
+  /**
+   * @brief Last submitted GPU timeline value getting function, may be called from any thread.
+   *        Every frame signals its number (starting from 1) on graphics queue, so value V is complete when frame V finished.
+   * @return Last submitted timeline value
+  */
+  UINT64 system::GetSubmittedTimelineValue( VOID ) const
+  {
+    return SubmittedTimelineValue;
+  } /* GetSubmittedTimelineValue */
+
+  /**
+   * @brief Completed GPU timeline value getting function, may be called from any thread
+   * @return Last timeline value, whose GPU work is finished
+  */
+  UINT64 system::GetCompletedTimelineValue( VOID )
+  {
+    UINT64 Value = Device.getSemaphoreCounterValue(TimelineSemaphore);
+
+    // Cache is only raised, concurrent queries may finish out of order
+    for (UINT64 Cached = CompletedTimelineValue; Cached < Value && !CompletedTimelineValue.compare_exchange_weak(Cached, Value); )
+      ;
+    return std::max(Value, (UINT64)CompletedTimelineValue);
+  } /* GetCompletedTimelineValue */
+
+  /**
+   * @brief Timeline value completion checking function, may be called from any thread. Doesn't query device, if value is known to be complete.
+   * @param Value Timeline value
+   * @return TRUE if GPU work, that signals value, is finished
+  */
+  BOOL system::IsTimelineValueComplete( UINT64 Value )
+  {
+    return Value <= CompletedTimelineValue || Value <= GetCompletedTimelineValue();
+  } /* IsTimelineValueComplete */
+
+  /**
+   * @brief Timeline value completion waiting function, may be called from any thread
+   * @param Value Timeline value, must be submitted or be going to be submitted
+   * @param Timeout Wait timeout, in nanoseconds
+   * @return TRUE if value is complete, FALSE if timeout elapsed
+  */
+  BOOL system::WaitTimelineValue( UINT64 Value, UINT64 Timeout )
+  {
+    if (Value <= CompletedTimelineValue)
+      return TRUE;
+
+    if (Device.waitSemaphores(vk::SemaphoreWaitInfo()
+      .setSemaphores(TimelineSemaphore)
+      .setValues(Value), Timeout) == vk::Result::eTimeout)
+      return FALSE;
+
+    for (UINT64 Cached = CompletedTimelineValue; Cached < Value && !CompletedTimelineValue.compare_exchange_weak(Cached, Value); )
+      ;
+    return TRUE;
+  } /* WaitTimelineValue */
+
+  /**
+   * @brief Deferred destroy function, may be called from any thread.
+   *        Callback is called from render thread, when GPU work of all frames, submitted before the next one, is finished.
+   * @param Destroy Destroy callback
+  */
+  VOID system::DeferDestroy( std::function<VOID( VOID )> Destroy )
+  {
+    // Frame, that is recorded now, may use destroyed object too, so its value is waited
+    DeferredDestroyMutex.lock();
+    DeferredDestroys.emplace_back(SubmittedTimelineValue + 1, std::move(Destroy));
+    DeferredDestroyMutex.unlock();
+  } /* DeferDestroy */
+
+  /**
+   * @brief Deferred destroy callbacks of completed timeline values calling function
+   * @param IsDeviceIdle TRUE to call all callbacks, device must be idle then
+  */
+  VOID system::CollectDeferredDestroys( BOOL IsDeviceIdle )
+  {
+    std::vector<std::function<VOID( VOID )>> Destroys;
+    const UINT64 Completed = IsDeviceIdle ? UINT64_MAX : GetCompletedTimelineValue();
+
+    // Callbacks are called outside of lock, so they may defer destroys too
+    DeferredDestroyMutex.lock();
+    while (!DeferredDestroys.empty() && DeferredDestroys.front().first <= Completed)
+    {
+      Destroys.push_back(std::move(DeferredDestroys.front().second));
+      DeferredDestroys.pop_front();
+    }
+    DeferredDestroyMutex.unlock();
+
+    for (auto &Destroy : Destroys)
+      Destroy();
+  } /* CollectDeferredDestroys */
+} /* namespace anv::render::core */
+
+/* file anv_render_core_timeline.cpp */
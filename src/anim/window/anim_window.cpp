@@ -7,19 +7,29 @@ namespace anv::window
     std::this_thread::sleep_for(std::chrono::duration<FLOAT>(1));
     while (RunSdlThread)
     {
-      SdlTaskListMutex.lock();
-      if (!SdlThreadTaskList.empty())
+      // Reset wakeup flag before draining, so tasks posted during draining will push new wakeup event
+      WakeupPending = FALSE;
+
+      sdl_task Task;
+      while (SdlThreadTaskQueue.TryPop(Task))
       {
-        for (auto &&Task : SdlThreadTaskList)
-          Task();
-        SdlThreadTaskList.clear();
+        Task();
+        Task.Reset();
+        SdlTaskCounter.fetch_add(1);
+        SdlTaskCounter.notify_all();
       }
-      SdlTaskListMutex.unlock();
 
       SDL_Event Event;
 
-      while (SDL_PollEvent(&Event))
+      // Sleep until any event (including wakeup one) arrives
+      if (!SDL_WaitEventTimeout(&Event, SDL_THREAD_WAIT_TIMEOUT_MS))
+        continue;
+
+      do
       {
+        if (Event.type == WakeupEventType)
+          continue;
+
         switch (Event.type)
         {
         case SDL_QUIT:
@@ -35,13 +45,31 @@ namespace anv::window
           if (auto WindowIter = WindowPool.find(Event.window.windowID); WindowIter != WindowPool.end())
           {
             auto [WindowID, Window] = *WindowIter;
+            input_event InputEvent {.Timestamp = Event.common.timestamp};
 
             switch (Event.window.event)
             {
             case SDL_WINDOWEVENT_CLOSE:
               Window->Opened = FALSE;
               break;
+
+            case SDL_WINDOWEVENT_SIZE_CHANGED:
+              InputEvent.Type = input_event::type::eResize;
+              InputEvent.Resize = {Event.window.data1, Event.window.data2};
+              Window->PushInputEvent(InputEvent);
+              if (Window->ResizeCallback)
+                Window->ResizeCallback(extent2(Event.window.data1, Event.window.data2));
+              break;
+
+            case SDL_WINDOWEVENT_FOCUS_GAINED:
+            case SDL_WINDOWEVENT_FOCUS_LOST:
+              InputEvent.Type = Event.window.event == SDL_WINDOWEVENT_FOCUS_GAINED
+                ? input_event::type::eFocusGained
+                : input_event::type::eFocusLost;
+              Window->PushInputEvent(InputEvent);
+              break;
             }
+            Window->NotifyEvent();
           }
 
           WindowPoolMutex.unlock();
@@ -53,37 +81,143 @@ namespace anv::window
         {
           WindowPoolMutex.lock();
 
-          if (auto WindowIter = WindowPool.find(Event.window.windowID); WindowIter != WindowPool.end())
-            WindowIter->second->KeyPressedStates[Event.key.keysym.scancode] = (Event.type == SDL_KEYDOWN);
+          if (auto WindowIter = WindowPool.find(Event.key.windowID); WindowIter != WindowPool.end())
+          {
+            WindowIter->second->KeyPressedStates[Event.key.keysym.scancode].store(Event.type == SDL_KEYDOWN, std::memory_order_relaxed);
+            WindowIter->second->PushInputEvent(input_event
+            {
+              .Type = Event.type == SDL_KEYDOWN ? input_event::type::eKeyDown : input_event::type::eKeyUp,
+              .Timestamp = Event.common.timestamp,
+              .Key = {Event.key.keysym.scancode, Event.key.repeat != 0},
+            });
+          }
 
           WindowPoolMutex.unlock();
           break;
         }
+
+        case SDL_MOUSEMOTION:
+        {
+          WindowPoolMutex.lock();
+
+          if (auto WindowIter = WindowPool.find(Event.motion.windowID); WindowIter != WindowPool.end())
+          {
+            input_event InputEvent {.Type = input_event::type::eMouseMove, .Timestamp = Event.common.timestamp};
+            InputEvent.MouseMove = {Event.motion.x, Event.motion.y, Event.motion.xrel, Event.motion.yrel};
+            WindowIter->second->PushInputEvent(InputEvent);
+          }
+
+          WindowPoolMutex.unlock();
+          break;
         }
-      }
+
+        case SDL_MOUSEBUTTONUP:
+        case SDL_MOUSEBUTTONDOWN:
+        {
+          WindowPoolMutex.lock();
+
+          if (auto WindowIter = WindowPool.find(Event.button.windowID); WindowIter != WindowPool.end())
+          {
+            input_event InputEvent
+            {
+              .Type = Event.type == SDL_MOUSEBUTTONDOWN ? input_event::type::eMouseButtonDown : input_event::type::eMouseButtonUp,
+              .Timestamp = Event.common.timestamp,
+            };
+            InputEvent.MouseButton = {Event.button.button, Event.button.x, Event.button.y};
+            WindowIter->second->PushInputEvent(InputEvent);
+          }
+
+          WindowPoolMutex.unlock();
+          break;
+        }
+
+        case SDL_MOUSEWHEEL:
+        {
+          WindowPoolMutex.lock();
+
+          if (auto WindowIter = WindowPool.find(Event.wheel.windowID); WindowIter != WindowPool.end())
+          {
+            input_event InputEvent {.Type = input_event::type::eMouseWheel, .Timestamp = Event.common.timestamp};
+            InputEvent.MouseWheel = {Event.wheel.x, Event.wheel.y};
+            WindowIter->second->PushInputEvent(InputEvent);
+          }
+
+          WindowPoolMutex.unlock();
+          break;
+        }
+        }
+      } while (SDL_PollEvent(&Event));
     }
 
+    SdlInitialized = FALSE;
 
+    // Tasks, left in queue, are never executed, so their waiters are woken up to fail
+    IsSdlThreadFinished = TRUE;
+    SdlTaskCounter.fetch_add(1);
+    SdlTaskCounter.notify_all();
+
+    // Wake up everyone, who waits for window events
+    WindowPoolMutex.lock();
     for (auto &[Id, Window] : WindowPool)
+    {
+      Window->Opened = FALSE;
+      Window->NotifyEvent();
       SDL_DestroyWindow(Window->Window);
+    }
+    WindowPoolMutex.unlock();
     SDL_Quit();
   } /* SdlThreadMain */
 
+  /**
+   * @brief SDL thread wakeup function. Pushes custom event to SDL event queue if thread may be sleeping.
+  */
+  VOID system::WakeupSdlThread( VOID )
+  {
+    // Tasks, posted before SDL initialization, are handled before first wait
+    if (!SdlInitialized || WakeupPending.exchange(TRUE))
+      return;
+
+    SDL_Event Event {};
+    Event.type = WakeupEventType;
+    SDL_PushEvent(&Event);
+  } /* WakeupSdlThread */
 
-  VOID system::AddSdlThreadTask( std::function<VOID(VOID)> &&Func )
+  /**
+   * @brief SDL thread task posting function, never blocks on SDL thread
+   * @param Task Task to execute in SDL thread
+  */
+  VOID system::AddSdlThreadTask( sdl_task &&Task )
   {
-    SdlTaskListMutex.lock();
-    SdlThreadTaskList.push_back(Func);
-    SdlTaskListMutex.unlock();
+    SdlThreadTaskQueue.Push(std::move(Task));
+    WakeupSdlThread();
   } /* AddSdlThreadTask */
 
+  /**
+   * @brief SDL thread task completion waiting function
+   * @param Completed Flag, set by task on completion
+   * @return TRUE if task is completed, FALSE if SDL thread finished before executing it
+  */
+  BOOL system::WaitSdlThreadTask( const std::atomic_bool &Completed )
+  {
+    // Counter is read before checks, so increment after them wakes the wait up
+    for (UINT32 Observed = SdlTaskCounter.load(); !Completed; Observed = SdlTaskCounter.load())
+    {
+      if (IsSdlThreadFinished)
+        return Completed;
+      SdlTaskCounter.wait(Observed);
+    }
+    return TRUE;
+  } /* WaitSdlThreadTask */
+
   system::system( VOID )
   {
     RunSdlThread = TRUE;
 
-    AddSdlThreadTask([]()
+    AddSdlThreadTask([this]()
       {
         SDL_Init(SDL_INIT_VIDEO);
+        WakeupEventType = SDL_RegisterEvents(1);
+        SdlInitialized = TRUE;
       });
     SdlThread = std::thread([this](){ SdlThreadMain(); });
   } /* system */
@@ -105,6 +239,7 @@ namespace anv::window
    * @brief Window building function
    * @param Builder Builder reference
    * @return Created window
+   * @note Throws std::runtime_error if SDL thread is already finished
   */
   window * system::Build( window::builder &Builder )
   {
@@ -120,6 +255,7 @@ namespace anv::window
         window *Window = new window(*this, WindowID);
 
         Window->Opened = TRUE;
+        Window->InputStates[0].Extent = Window->InputStates[1].Extent = Builder.Extent;
 
         WindowPool.emplace(WindowID, Window);
 
@@ -130,7 +266,8 @@ namespace anv::window
         BuildCompleted = TRUE;
         BuildCompleted.notify_all();
       });
-    BuildCompleted.wait(FALSE);
+    if (!WaitSdlThreadTask(BuildCompleted))
+      throw std::runtime_error("Can't create window after SDL thread is finished");
 
     return Result;
   } /* Build */
@@ -145,6 +282,7 @@ namespace anv::window
     {
       RunSdlThread = FALSE;
       RunSdlThread.notify_all();
+      WakeupSdlThread();
     }
     if (SdlThread.joinable())
       SdlThread.join();
@@ -172,11 +310,172 @@ namespace anv::window
     return Opened;
   } /* End of 'IsOpen' function */
 
+  /**
+   * @brief Input event pushing function, called from SDL thread
+   * @param Event Event to push
+  */
+  VOID window::PushInputEvent( const input_event &Event )
+  {
+    if (!InputEvents.TryPush(Event))
+      DroppedInputEventCount.fetch_add(1, std::memory_order_relaxed);
+    NotifyEvent();
+  } /* PushInputEvent */
+
+  /**
+   * @brief Input snapshot updating function. Consumes all buffered input events.
+  */
+  VOID window::UpdateInput( VOID )
+  {
+    const input_state &Previous = InputStates[CurrentInputStateIndex];
+    input_state &Current = InputStates[CurrentInputStateIndex ^ 1];
+
+    // Carry persistent state, reset per-snapshot one
+    Current = Previous;
+    Current.KeyPressed.reset();
+    Current.KeyReleased.reset();
+    Current.MouseDeltaX = Current.MouseDeltaY = 0;
+    Current.WheelX = Current.WheelY = 0;
+    Current.MouseButtonsPressed = 0;
+    Current.Resized = FALSE;
+
+    FrameInputEvents.clear();
+
+    UINT32 Now = SDL_GetTicks();
+    input_event Event;
+
+    while (InputEvents.TryPop(Event))
+    {
+      switch (Event.Type)
+      {
+      case input_event::type::eKeyDown:
+        Current.KeyDown.set(Event.Key.Scancode);
+        if (!Event.Key.Repeat)
+          Current.KeyPressed.set(Event.Key.Scancode);
+        break;
+
+      case input_event::type::eKeyUp:
+        Current.KeyDown.reset(Event.Key.Scancode);
+        Current.KeyReleased.set(Event.Key.Scancode);
+        break;
+
+      case input_event::type::eMouseMove:
+        Current.MouseX = Event.MouseMove.X;
+        Current.MouseY = Event.MouseMove.Y;
+        Current.MouseDeltaX += Event.MouseMove.DeltaX;
+        Current.MouseDeltaY += Event.MouseMove.DeltaY;
+        break;
+
+      case input_event::type::eMouseButtonDown:
+        Current.MouseButtonsDown |= SDL_BUTTON(Event.MouseButton.Button);
+        Current.MouseButtonsPressed |= SDL_BUTTON(Event.MouseButton.Button);
+        break;
+
+      case input_event::type::eMouseButtonUp:
+        Current.MouseButtonsDown &= ~SDL_BUTTON(Event.MouseButton.Button);
+        break;
+
+      case input_event::type::eMouseWheel:
+        Current.WheelX += Event.MouseWheel.X;
+        Current.WheelY += Event.MouseWheel.Y;
+        break;
+
+      case input_event::type::eResize:
+        Current.Extent = extent2(Event.Resize.W, Event.Resize.H);
+        Current.Resized = TRUE;
+        break;
+
+      case input_event::type::eFocusGained:
+      case input_event::type::eFocusLost:
+        Current.Focused = Event.Type == input_event::type::eFocusGained;
+        break;
+      }
+
+      // Update latency statistics
+      UINT32 Latency = Now - Event.Timestamp;
+
+      InputLatencyStats.LastMs = Latency;
+      InputLatencyStats.MaxMs = std::max(InputLatencyStats.MaxMs, Latency);
+      InputLatencyStats.SmoothedMs = InputLatencyStats.EventCount == 0
+        ? (FLOAT)Latency
+        : InputLatencyStats.SmoothedMs + ((FLOAT)Latency - InputLatencyStats.SmoothedMs) / 16.0F;
+      InputLatencyStats.EventCount++;
+
+      FrameInputEvents.push_back(Event);
+    }
+    InputLatencyStats.DroppedCount = DroppedInputEventCount.load(std::memory_order_relaxed);
+
+    CurrentInputStateIndex ^= 1;
+  } /* UpdateInput */
+
+  /**
+   * @brief Current input snapshot getting function
+   * @return Input state as of last UpdateInput call
+  */
+  const input_state & window::GetInput( VOID ) const
+  {
+    return InputStates[CurrentInputStateIndex];
+  } /* GetInput */
+
+  /**
+   * @brief Previous input snapshot getting function
+   * @return Input state as of previous to last UpdateInput call
+  */
+  const input_state & window::GetPreviousInput( VOID ) const
+  {
+    return InputStates[CurrentInputStateIndex ^ 1];
+  } /* GetPreviousInput */
+
+  /**
+   * @brief Events, consumed by last UpdateInput call, getting function
+   * @return Timestamped event span, valid until next UpdateInput call
+  */
+  std::span<const input_event> window::GetInputEvents( VOID ) const
+  {
+    return FrameInputEvents;
+  } /* GetInputEvents */
+
+  /**
+   * @brief Input latency statistics getting function
+   * @return Input latency statistics
+  */
+  input_latency_stats window::GetInputLatencyStats( VOID ) const
+  {
+    return InputLatencyStats;
+  } /* GetInputLatencyStats */
+
   BOOL window::IsKeyPressed( SDL_Keycode Keycode )
   {
-    return KeyPressedStates[SDL_GetScancodeFromKey(Keycode)];
+    return KeyPressedStates[SDL_GetScancodeFromKey(Keycode)].load(std::memory_order_relaxed);
   } /* End of 'GetKeyState' function */
 
+  /**
+   * @brief Key click getting function
+   * @param Keycode Key to check
+   * @return TRUE if key was pressed since previous snapshot, even if it was released already
+  */
+  BOOL window::IsKeyClicked( SDL_Keycode Keycode )
+  {
+    return GetInput().KeyPressed.test(SDL_GetScancodeFromKey(Keycode));
+  } /* IsKeyClicked */
+
+  /**
+   * @brief Window event handling notification function, called from SDL thread
+  */
+  VOID window::NotifyEvent( VOID )
+  {
+    EventCounter.fetch_add(1, std::memory_order_release);
+    EventCounter.notify_all();
+  } /* NotifyEvent */
+
+  /**
+   * @brief Event waiting function. Blocks until any event for this window is handled after previous call.
+  */
+  VOID window::WaitEvents( VOID )
+  {
+    EventCounter.wait(ObservedEventCounter, std::memory_order_acquire);
+    ObservedEventCounter = EventCounter.load(std::memory_order_acquire);
+  } /* WaitEvents */
+
   /**
    * @brief Window title setting function
    * @param NewTitle New window title
@@ -184,9 +483,17 @@ namespace anv::window
   VOID window::SetTitle( std::string_view NewTitle )
   {
     Title = NewTitle;
-    System.AddSdlThreadTask([this]() { SDL_SetWindowTitle(Window, Title.data()); });
+    // Title is copied, so task doesn't race with next SetTitle call
+    System.AddSdlThreadTask([this, Title = std::string(NewTitle)]() { SDL_SetWindowTitle(Window, Title.c_str()); });
   } /* SetTitle */
 
+  VOID window::SetResizeCallback( std::function<VOID( extent2 )> NewResizeCallback )
+  {
+    System.WindowPoolMutex.lock();
+    ResizeCallback = std::move(NewResizeCallback);
+    System.WindowPoolMutex.unlock();
+  } /* SetResizeCallback */
+
   std::string_view window::GetTitle( VOID )
   {
     return Title;
@@ -211,12 +518,12 @@ namespace anv::window
         SDL_SysWMinfo WMInfo;
         SDL_VERSION(&WMInfo.version);
         SDL_GetWindowWMInfo(Window, &WMInfo);
-        if (WMInfo.subsystem != SDL_SYSWM_WINDOWS)
-          Handle = raw_handle
-          {
-            .Unknown = raw_handle::unknown { .Kind = raw_handle::kind::eUnknown, }
-          };
-        else
+        Handle = raw_handle
+        {
+          .Unknown = raw_handle::unknown { .Kind = raw_handle::kind::eUnknown, }
+        };
+#ifdef SDL_VIDEO_DRIVER_WINDOWS
+        if (WMInfo.subsystem == SDL_SYSWM_WINDOWS)
           Handle = raw_handle
           {
             .Win32 = raw_handle::win32
@@ -226,10 +533,12 @@ namespace anv::window
               .HInstance = WMInfo.info.win.hinstance,
             }
           };
+#endif // defined(SDL_VIDEO_DRIVER_WINDOWS)
         FinishFlag = TRUE;
         FinishFlag.notify_all();
       });
-    FinishFlag.wait(FALSE);
+    if (!System.WaitSdlThreadTask(FinishFlag))
+      throw std::runtime_error("Can't get window handle after SDL thread is finished");
 
     return Handle;
   } /* End of 'GetRawHandle' function */
@@ -5,6 +5,10 @@
 
 #include "util/meta/anv_meta_builder.h"
 #include "util/math/anv_math.h"
+#include "util/thread/anv_thread_task_queue.h"
+#include "util/thread/anv_thread_spsc_ring.h"
+
+#include <bitset>
 
 #define SDL_MAIN_HANDLED
 #include <SDL2/SDL.h>
@@ -41,6 +45,92 @@ namespace anv::window
 
   using window_id = UINT32;
 
+  /* Timestamped input event */
+  struct input_event
+  {
+    /* Input event type */
+    enum class type : BYTE
+    {
+      eKeyDown,         // Key pressed
+      eKeyUp,           // Key released
+      eMouseMove,       // Mouse moved
+      eMouseButtonDown, // Mouse button pressed
+      eMouseButtonUp,   // Mouse button released
+      eMouseWheel,      // Mouse wheel scrolled
+      eResize,          // Window resized
+      eFocusGained,     // Window gained keyboard focus
+      eFocusLost,       // Window lost keyboard focus
+    }; /* enum class type */
+
+    type Type;        // Event type
+    UINT32 Timestamp; // SDL event timestamp (SDL_GetTicks milliseconds)
+
+    union
+    {
+      /* Key event data */
+      struct
+      {
+        SDL_Scancode Scancode; // Key scancode
+        BOOL Repeat;           // Is key repeat event
+      } Key;
+
+      /* Mouse move event data */
+      struct
+      {
+        INT32 X, Y;           // New mouse position
+        INT32 DeltaX, DeltaY; // Mouse position delta
+      } MouseMove;
+
+      /* Mouse button event data */
+      struct
+      {
+        BYTE Button; // SDL button index (SDL_BUTTON_LEFT, ...)
+        INT32 X, Y;  // Mouse position
+      } MouseButton;
+
+      /* Mouse wheel event data */
+      struct
+      {
+        INT32 X, Y; // Wheel scroll amounts
+      } MouseWheel;
+
+      /* Resize event data */
+      struct
+      {
+        INT32 W, H; // New window size
+      } Resize;
+    }; /* union */
+  }; /* struct input_event */
+
+  /* Frame-coherent input state snapshot */
+  struct input_state
+  {
+    std::bitset<SDL_NUM_SCANCODES>
+      KeyDown,     // Key is held at snapshot moment
+      KeyPressed,  // Key was pressed since previous snapshot (even if already released)
+      KeyReleased; // Key was released since previous snapshot
+
+    INT32 MouseX = 0, MouseY = 0;           // Mouse position
+    INT32 MouseDeltaX = 0, MouseDeltaY = 0; // Mouse movement since previous snapshot
+    INT32 WheelX = 0, WheelY = 0;           // Wheel scroll since previous snapshot
+    UINT32 MouseButtonsDown = 0;            // Held mouse buttons mask (SDL_BUTTON(...) bits)
+    UINT32 MouseButtonsPressed = 0;         // Mouse buttons, pressed since previous snapshot
+
+    extent2 Extent;      // Window extent
+    BOOL Resized = FALSE; // Window was resized since previous snapshot
+    BOOL Focused = FALSE; // Window has keyboard focus
+  }; /* struct input_state */
+
+  /* Input latency statistics, measured from SDL event timestamp to event consumption */
+  struct input_latency_stats
+  {
+    UINT32 LastMs = 0;         // Latency of last consumed event
+    FLOAT SmoothedMs = 0;      // Exponential moving average of latency (1/16 weight of new event)
+    UINT32 MaxMs = 0;          // Maximal latency
+    UINT64 EventCount = 0;     // Count of consumed events
+    UINT64 DroppedCount = 0;   // Count of events, dropped due to ring overflow
+  }; /* struct input_latency_stats */
+
   /* SDL Window */
   class window
   {
@@ -52,8 +142,32 @@ namespace anv::window
     SDL_Window *Window = nullptr;
     std::string Title = "anim-vk";
 
-    BOOL Opened = FALSE;
-    BOOL KeyPressedStates[SDL_NUM_SCANCODES] {FALSE};
+    std::atomic_bool Opened = FALSE;
+    std::atomic_bool KeyPressedStates[SDL_NUM_SCANCODES] {}; // Live key hold states, written by SDL thread
+
+    thread::spsc_ring<input_event, 1024> InputEvents; // Input events, produced by SDL thread and consumed by UpdateInput caller
+    std::atomic<UINT64> DroppedInputEventCount = 0;   // Count of events, that didn't fit in ring
+
+    input_state InputStates[2];                // Input snapshots (current and previous)
+    UINT32 CurrentInputStateIndex = 0;         // Index of current snapshot
+    std::vector<input_event> FrameInputEvents; // Events, consumed by last UpdateInput call
+    input_latency_stats InputLatencyStats;     // Input latency statistics
+
+    /**
+     * @brief Input event pushing function, called from SDL thread
+     * @param Event Event to push
+    */
+    VOID PushInputEvent( const input_event &Event );
+
+    std::function<VOID( extent2 )> ResizeCallback; // Resize callback, called from SDL thread under window pool lock
+
+    std::atomic<UINT32> EventCounter = 0; // Count of events, handled for this window
+    UINT32 ObservedEventCounter = 0;      // Event counter value, observed by last WaitEvents call
+
+    /**
+     * @brief Window event handling notification function, called from SDL thread
+    */
+    VOID NotifyEvent( VOID );
 
     /**
      * @brief Window constructor
@@ -85,16 +199,74 @@ namespace anv::window
     */
     BOOL IsOpen( VOID );
 
+    /**
+     * @brief Input snapshot updating function. Consumes all buffered input events.
+     * @note Must be called from one (e.g. main or game) thread only, once per frame.
+    */
+    VOID UpdateInput( VOID );
+
+    /**
+     * @brief Current input snapshot getting function
+     * @return Input state as of last UpdateInput call
+    */
+    const input_state & GetInput( VOID ) const;
+
+    /**
+     * @brief Previous input snapshot getting function
+     * @return Input state as of previous to last UpdateInput call
+    */
+    const input_state & GetPreviousInput( VOID ) const;
+
+    /**
+     * @brief Events, consumed by last UpdateInput call, getting function
+     * @return Timestamped event span, valid until next UpdateInput call
+    */
+    std::span<const input_event> GetInputEvents( VOID ) const;
+
+    /**
+     * @brief Input latency statistics getting function
+     * @return Input latency statistics
+    */
+    input_latency_stats GetInputLatencyStats( VOID ) const;
+
+    /**
+     * @brief Key hold state getting function. Doesn't depend on UpdateInput calls, use GetInput().KeyDown for frame-coherent state.
+     * @param Keycode Key to check
+     * @return TRUE if key is held at the moment of last handled SDL event
+    */
     BOOL IsKeyPressed( SDL_Keycode Keycode );
 
+    /**
+     * @brief Key click getting function
+     * @param Keycode Key to check
+     * @return TRUE if key was pressed since previous snapshot, even if it was released already
+    */
+    BOOL IsKeyClicked( SDL_Keycode Keycode );
+
+    /**
+     * @brief Event waiting function. Blocks until any event for this window is handled after previous call.
+    */
+    VOID WaitEvents( VOID );
+
     /**
      * @brief Window title setting function
      * @param NewTitle New window title
     */
     VOID SetTitle( std::string_view NewTitle );
 
+    /**
+     * @brief Resize callback setting function
+     * @param NewResizeCallback Callback, called from SDL thread on window size change. Must not block on SDL thread.
+    */
+    VOID SetResizeCallback( std::function<VOID( extent2 )> NewResizeCallback );
+
     std::string_view GetTitle( VOID );
 
+    /**
+     * @brief Raw window handle getting function
+     * @return Platform window handle
+     * @note Throws std::runtime_error if SDL thread is already finished
+    */
     raw_handle GetRawHandle( VOID );
   }; /* class window */
 
@@ -103,20 +275,48 @@ namespace anv::window
   private:
     friend class window;
 
+    // Task, executed in SDL thread. Captures must fit in-place storage.
+    using sdl_task = thread::inplace_task<64>;
+
     std::thread SdlThread;
 
-    std::mutex SdlTaskListMutex;
-    std::deque<std::function<VOID(VOID)>> SdlThreadTaskList;
+    thread::mpsc_queue<sdl_task, 256> SdlThreadTaskQueue; // Tasks posted to SDL thread
+
+    // SDL thread wakes up at least this often even without events
+    constexpr static UINT32 SDL_THREAD_WAIT_TIMEOUT_MS = 250;
+
+    std::atomic_bool SdlInitialized = FALSE;  // SDL is initialized, so wakeup events can be pushed
+    std::atomic_bool WakeupPending = FALSE;   // Wakeup event is already pushed and not handled yet
+    UINT32 WakeupEventType = (UINT32)-1;      // Custom SDL event type, used for SDL thread wakeup
 
     std::atomic_bool RunSdlThread;
 
+    std::atomic_bool IsSdlThreadFinished = FALSE; // SDL thread left its loop, so posted tasks will never be executed
+    std::atomic<UINT32> SdlTaskCounter = 0;       // Count of executed SDL thread tasks, also incremented on SDL thread finish
+
     std::mutex WindowPoolMutex;
     std::map<window_id, window *> WindowPool;
     BOOL IsClosed = FALSE;
 
     VOID SdlThreadMain( VOID );
 
-    VOID AddSdlThreadTask( std::function<VOID(VOID)> &&Func );
+    /**
+     * @brief SDL thread wakeup function. Pushes custom event to SDL event queue if thread may be sleeping.
+    */
+    VOID WakeupSdlThread( VOID );
+
+    /**
+     * @brief SDL thread task posting function, never blocks on SDL thread
+     * @param Task Task to execute in SDL thread
+    */
+    VOID AddSdlThreadTask( sdl_task &&Task );
+
+    /**
+     * @brief SDL thread task completion waiting function
+     * @param Completed Flag, set by task on completion
+     * @return TRUE if task is completed, FALSE if SDL thread finished before executing it
+    */
+    BOOL WaitSdlThreadTask( const std::atomic_bool &Completed );
   public:
     /**
      * @brief System constructor
@@ -133,6 +333,7 @@ namespace anv::window
      * @brief Window building function
      * @param Builder Builder reference
      * @return Created window
+     * @note Throws std::runtime_error if SDL thread is already finished
     */
     window * Build( window::builder &Builder );
 
@@ -0,0 +1,929 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/anv_bench.cpp
+ * @description Render core microbenchmark suite implementation module
+ * @last_update 18.10.2026
+*/
+
+#include "anv.h"
+#include "anv_bench.h"
+
+#include "util/bench/anv_bench.h"
+#include "util/math/anv_math_batch.h"
+
+#include <shaderc/shaderc.hpp>
+
+#include <random>
+
+namespace anv_main
+{
+  using namespace anv::common_types;
+
+  namespace core = anv::render::core;
+
+  /**
+   * @brief Resource, deleted on destroy. Used to measure pool overhead only.
+  */
+  class bench_resource : public anv::rc::resource
+  {
+    VOID OnDestroy( VOID ) override
+    {
+      delete this;
+    } /* OnDestroy */
+  }; /* class bench_resource */
+
+  // Benchmark vertex shader, transforms position by matrix from uniform buffer
+  static const CHAR *BenchVertexShader = R"(
+    cbuffer camera : register(b0)
+    {
+      float4x4 ViewProjection;
+    };
+
+    float4 vs_main( float3 Position : POSITION ) : SV_Position
+    {
+      return mul(float4(Position, 1), ViewProjection);
+    }
+  )";
+
+  // Depth pre-pass benchmark vertex shader, generates [-1, 1] cube from vertex index and transforms it by instance transform (pipeline::INSTANCE_SET)
+  // and benchmark camera, which is prepended as VIEW_PROJECTION define. Position attribute is fetched, but unused, so it is pre-pass shader too.
+  // HLSL can't declare invariant position, pipeline building decorates SV_Position of both stages Invariant.
+  static const CHAR *BenchInstancedVertexShader = R"(
+    struct instance
+    {
+      row_major float4x4 Transform;
+      uint DrawIndex;
+      uint VisibilityID;
+      uint FirstDrawIndex;
+      uint Padding;
+    };
+
+    [[vk::binding(0, 1)]] StructuredBuffer<instance> Instances;
+    [[vk::binding(1, 1)]] StructuredBuffer<uint> VisibleInstances;
+
+    static const uint CubeIndices[36] = {0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4, 2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5};
+
+    float4 vs_main( float3 Position : POSITION, uint VertexID : SV_VertexID, uint InstanceID : SV_InstanceID ) : SV_Position
+    {
+      const uint Corner = CubeIndices[VertexID % 36];
+      const float4 Local = float4((Corner & 1) != 0 ? 1 : -1, (Corner & 2) != 0 ? 1 : -1, (Corner & 4) != 0 ? 1 : -1, 1);
+
+      return mul(mul(Local, Instances[VisibleInstances[InstanceID]].Transform), VIEW_PROJECTION);
+    }
+  )";
+
+  // G-buffer layouts benchmark vertex shader, transforms position by instance transform (pipeline::INSTANCE_SET) and matrix from
+  // uniform buffer and passes instance visibility ID, which visibility buffer layout fragment shader combines with triangle index
+  static const CHAR *BenchGBufferVertexShader = R"(
+    cbuffer camera : register(b0)
+    {
+      float4x4 ViewProjection;
+    };
+
+    struct instance
+    {
+      row_major float4x4 Transform;
+      uint DrawIndex;
+      uint VisibilityID;
+      uint FirstDrawIndex;
+      uint Padding;
+    };
+
+    [[vk::binding(0, 1)]] StructuredBuffer<instance> Instances;
+    [[vk::binding(1, 1)]] StructuredBuffer<uint> VisibleInstances;
+
+    struct output
+    {
+      float4 Position : SV_Position;
+      nointerpolation uint VisibilityID : VISIBILITY_ID;
+    };
+
+    output vs_main( float3 Position : POSITION, uint InstanceID : SV_InstanceID )
+    {
+      const instance Instance = Instances[VisibleInstances[InstanceID]];
+      output Output;
+
+      Output.Position = mul(mul(float4(Position, 1), Instance.Transform), ViewProjection);
+      Output.VisibilityID = Instance.VisibilityID;
+      return Output;
+    }
+  )";
+
+  // Benchmark fragment shader, writes constants to all geometry pass targets
+  static const CHAR *BenchFragmentShader = R"(
+    struct output
+    {
+      float4 PositionObjectID          : SV_Target0;
+      float4 Normal                    : SV_Target1;
+      float4 BaseColorAmbientOcclusion : SV_Target2;
+      float4 MetallicRoughnessInstance : SV_Target3;
+    };
+
+    output fs_main( float4 Position : SV_Position )
+    {
+      output Output;
+
+      Output.PositionObjectID = Position;
+      Output.Normal = float4(0, 0, 1, 0);
+      Output.BaseColorAmbientOcclusion = float4(1, 1, 1, 1);
+      Output.MetallicRoughnessInstance = float4(0, 1, 0, 0);
+      return Output;
+    }
+  )";
+
+  // Benchmark fragment shader for compact G-buffer layout, writes object ID instead of position
+  static const CHAR *BenchCompactFragmentShader = R"(
+    struct output
+    {
+      uint ObjectID                    : SV_Target0;
+      float4 Normal                    : SV_Target1;
+      float4 BaseColorAmbientOcclusion : SV_Target2;
+      float4 MetallicRoughnessInstance : SV_Target3;
+    };
+
+    output fs_main( float4 Position : SV_Position )
+    {
+      output Output;
+
+      Output.ObjectID = 1;
+      Output.Normal = float4(0, 0, 1, 0);
+      Output.BaseColorAmbientOcclusion = float4(1, 1, 1, 1);
+      Output.MetallicRoughnessInstance = float4(0, 1, 0, 0);
+      return Output;
+    }
+  )";
+
+  // Benchmark fragment shader for visibility buffer layout, writes instance visibility ID (pre-shifted, see core::visibility_id) and triangle index
+  static const CHAR *BenchVisibilityFragmentShader = R"(
+    uint fs_main( float4 Position : SV_Position, nointerpolation uint VisibilityID : VISIBILITY_ID, uint Triangle : SV_PrimitiveID ) : SV_Target0
+    {
+      return VisibilityID | Triangle;
+    }
+  )";
+
+  /**
+   * @brief HLSL shader compilation function
+   * @param Source Shader source
+   * @param Kind Shader stage
+   * @param EntryPoint Entry point name
+   * @return SPIR-V code
+  */
+  static std::vector<UINT32> CompileShader( const CHAR *Source, shaderc_shader_kind Kind, const CHAR *EntryPoint )
+  {
+    shaderc::Compiler Compiler;
+    shaderc::CompileOptions Options;
+
+    // Pipelines use 'vs_main' and 'fs_main' entry points, which GLSL can't declare
+    Options.SetSourceLanguage(shaderc_source_language_hlsl);
+    Options.SetOptimizationLevel(shaderc_optimization_level_performance);
+    Options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_3);
+
+    shaderc::SpvCompilationResult Compiled = Compiler.CompileGlslToSpv(Source, Kind, EntryPoint, EntryPoint, Options);
+    if (Compiled.GetCompilationStatus() != shaderc_compilation_status_success)
+      throw std::runtime_error(Compiled.GetErrorMessage());
+
+    return {Compiled.cbegin(), Compiled.cend()};
+  } /* CompileShader */
+
+  /**
+   * @brief Random matrices generation function
+   * @param Count Count of matrices to generate
+   * @param Generator Random generator
+   * @return Invertible matrices of random rotation, scale and translation
+  */
+  static std::vector<anv::mat4x4> RandomMatrices( SIZE_T Count, std::mt19937 &Generator )
+  {
+    std::uniform_real_distribution<FLOAT> Distribution(-1, 1);
+    std::vector<anv::mat4x4> Result;
+
+    Result.reserve(Count);
+    for (SIZE_T i = 0; i < Count; i++)
+      Result.push_back(
+        anv::mat4x4::Scale(1.5F + Distribution(Generator), 1.5F + Distribution(Generator), 1.5F + Distribution(Generator)) *
+        anv::mat4x4::Rotate(Distribution(Generator) * 3.14159265F, anv::vec3(Distribution(Generator), Distribution(Generator), 1).Normalize()) *
+        anv::mat4x4::Translate(Distribution(Generator) * 100, Distribution(Generator) * 100, Distribution(Generator) * 100));
+    return Result;
+  } /* RandomMatrices */
+
+  /**
+   * @brief Benchmark culling camera getting function
+   * @return Camera at scene side, looking at its center
+  */
+  static anv::math::util::camera::projection_matrices BenchCamera( VOID )
+  {
+    return
+    {
+      .View = anv::mat4x4::View(anv::vec3(0, 20, 150), anv::vec3(0, 0, 0), anv::vec3(0, 1, 0)),
+      .Projection = anv::mat4x4::FrustumProjection(-0.05F, 0.05F, -0.0375F, 0.0375F, 0.1F, 1000),
+    };
+  } /* BenchCamera */
+
+  /**
+   * @brief CPU hot paths benchmarking function
+   * @param Suite Suite to run benchmarks in
+   * @return Count of failed checks
+  */
+  static UINT32 RunCpuBenchmarks( anv::bench::suite &Suite )
+  {
+    std::mt19937 Generator(30102026);
+    UINT32 FailedCheckCount = 0;
+
+    /* Resource pool */
+    {
+      constexpr UINT32 COUNT = 100'000;
+      std::optional<anv::rc::pool<anv::rc::resource>> Pool;
+
+      // Destroys resources, left alive by previous repetition
+      auto Drain = [&]
+      {
+        if (!Pool.has_value())
+          return;
+        for (anv::rc::resource *Resource : *Pool)
+          Resource->Release();
+        Pool->CollectGarbage();
+        Pool.reset();
+      };
+
+      // Pool is refilled before every repetition, collected resources are destroyed by it
+      auto Fill = [&]( BOOL ReleaseHalf )
+      {
+        Drain();
+        Pool.emplace();
+        for (UINT32 i = 0; i < COUNT; i++)
+        {
+          bench_resource *Resource = new bench_resource();
+
+          if (!ReleaseHalf || i % 2 == 0)
+            Resource->Grab();
+          Pool->Add(Resource);
+        }
+      };
+
+      Suite.Run("rc.pool.collect_garbage/100k_half_released", COUNT, [&]{ Fill(TRUE); }, [&]{ Pool->CollectGarbage(); });
+      Suite.Run("rc.pool.collect_garbage/100k_alive", COUNT, [&]{ Fill(FALSE); }, [&]{ Pool->CollectGarbage(); });
+      Drain();
+    }
+
+    /* Matrices */
+    {
+      constexpr UINT32 COUNT = 4096;
+      const std::vector<anv::mat4x4>
+        A = RandomMatrices(COUNT, Generator),
+        B = RandomMatrices(COUNT, Generator);
+      std::vector<anv::mat4x4> Result(COUNT);
+
+      Suite.Run("math.mat4x4.multiply", COUNT, [&]
+      {
+        for (UINT32 i = 0; i < COUNT; i++)
+          Result[i] = A[i] * B[i];
+        anv::bench::DoNotOptimize(Result);
+      });
+      Suite.Run("math.mat4x4.inverse", COUNT, [&]
+      {
+        for (UINT32 i = 0; i < COUNT; i++)
+          Result[i] = A[i].Inversed();
+        anv::bench::DoNotOptimize(Result);
+      });
+    }
+
+    /* Quaternions */
+    {
+      constexpr UINT32 COUNT = 4096;
+      std::uniform_real_distribution<FLOAT> Distribution(-1, 1);
+      UINT32 MismatchCount = 0;
+
+      // Quaternion rotation must follow matrix one, both by matrix and by vector rotation
+      for (UINT32 i = 0; i < COUNT; i++)
+      {
+        const FLOAT Angle = Distribution(Generator) * 3.14159265F;
+        const anv::vec3
+          Axis = anv::vec3(Distribution(Generator), Distribution(Generator), Distribution(Generator) + 2),
+          V = anv::vec3(Distribution(Generator), Distribution(Generator), Distribution(Generator));
+        const anv::quat Q = anv::quat::Rotate(Angle, Axis);
+        const anv::mat4x4 QM = Q.ToMatrix(), M = anv::mat4x4::Rotate(Angle, Axis);
+        const anv::vec3 QV = Q.Rotate(V), MV = M * V;
+        FLOAT MaxError = std::max({std::abs(QV.X - MV.X), std::abs(QV.Y - MV.Y), std::abs(QV.Z - MV.Z)});
+
+        for (UINT32 Row = 0; Row < 4; Row++)
+          for (UINT32 Column = 0; Column < 4; Column++)
+            MaxError = std::max(MaxError, std::abs(QM.Data[Row][Column] - M.Data[Row][Column]));
+        if (MaxError > 1e-4F)
+          MismatchCount++;
+      }
+      if (MismatchCount != 0)
+      {
+        std::printf("math.quat.rotate: %u of %u rotations don't match mat4x4::Rotate\n", MismatchCount, COUNT);
+        FailedCheckCount++;
+      }
+
+      // Rigid instances are uploaded packed, so packed transform must expand back to source matrix
+      const std::vector<anv::mat4x4> Transforms = RandomMatrices(COUNT, Generator);
+      std::vector<anv::packed_trs> Packed(COUNT);
+
+      MismatchCount = 0;
+      for (UINT32 i = 0; i < COUNT; i++)
+      {
+        const anv::mat4x4 M = anv::trs::Unpacked(anv::trs::FromMatrix(Transforms[i]).Packed()).ToMatrix();
+        FLOAT MaxError = 0;
+
+        for (UINT32 Row = 0; Row < 4; Row++)
+          for (UINT32 Column = 0; Column < 4; Column++)
+            MaxError = std::max(MaxError, std::abs(M.Data[Row][Column] - Transforms[i].Data[Row][Column]) / (Row == 3 ? 100.0F : 2.5F));
+        if (MaxError > 1e-3F)
+          MismatchCount++;
+      }
+      if (MismatchCount != 0)
+      {
+        std::printf("math.trs.packed: %u of %u packed transforms don't match source matrices\n", MismatchCount, COUNT);
+        FailedCheckCount++;
+      }
+
+      Suite.Run("math.trs.pack/4k", COUNT, [&]
+      {
+        for (UINT32 i = 0; i < COUNT; i++)
+          Packed[i] = anv::trs::FromMatrix(Transforms[i]).Packed();
+        anv::bench::DoNotOptimize(Packed.data());
+      });
+    }
+
+    /* Culling */
+    {
+      constexpr UINT32 COUNT = 100'000;
+      const anv::math::aabb Box {anv::vec3(-1), anv::vec3(1)};
+      const anv::math::frustum Frustum = BenchCamera().GetFrustum();
+      const std::vector<anv::mat4x4> Transforms = RandomMatrices(COUNT, Generator);
+      std::vector<UINT32> Visible(COUNT);
+      std::vector<anv::math::aabb> Boxes;
+      std::vector<UINT64> UserData(COUNT);
+      anv::math::bvh Bvh;
+
+      Boxes.reserve(COUNT);
+      for (const anv::mat4x4 &Transform : Transforms)
+        Boxes.push_back(Box.Transformed(Transform));
+      std::iota(UserData.begin(), UserData.end(), 0);
+
+      Suite.Run("math.batch.cull_instances/100k", COUNT, [&]
+      {
+        anv::bench::DoNotOptimize(anv::math::batch::CullInstances(Frustum, Box, Transforms, Visible));
+      });
+      Suite.Run("math.bvh.build/100k", COUNT, [&]
+      {
+        Bvh.Build(Boxes, UserData);
+      });
+      std::vector<anv::math::bvh::handle> Handles(COUNT);
+      Suite.Run("math.bvh.insert_bulk/100k", COUNT, [&]
+      {
+        anv::math::bvh BulkBvh;
+
+        BulkBvh.InsertBulk(Boxes, UserData, Handles);
+        anv::bench::DoNotOptimize(Handles.data());
+      });
+      Bvh.Build(Boxes, UserData);
+      Suite.Run("math.bvh.query_frustum/100k", COUNT, [&]
+      {
+        SIZE_T Count = 0;
+
+        Bvh.QueryFrustum(Frustum, [&]( anv::math::bvh::handle, UINT64 ) { Count++; return TRUE; });
+        anv::bench::DoNotOptimize(Count);
+      });
+
+      // Bulk inserted half, rebuilt together with incrementally inserted one, must answer queries as built tree
+      {
+        anv::math::bvh BulkBvh;
+        SIZE_T BuiltCount = 0, BulkCount = 0;
+
+        for (UINT32 i = 0; i < COUNT / 2; i++)
+          BulkBvh.Insert(Boxes[i], UserData[i]);
+        BulkBvh.InsertBulk(std::span(Boxes).subspan(COUNT / 2), std::span(UserData).subspan(COUNT / 2), std::span(Handles).subspan(COUNT / 2));
+        Bvh.QueryFrustum(Frustum, [&]( anv::math::bvh::handle, UINT64 ) { BuiltCount++; return TRUE; });
+        BulkBvh.QueryFrustum(Frustum, [&]( anv::math::bvh::handle, UINT64 ) { BulkCount++; return TRUE; });
+        if (BuiltCount != BulkCount)
+        {
+          std::printf("math.bvh.insert_bulk: %zu instances in frustum, %zu expected\n", BulkCount, BuiltCount);
+          FailedCheckCount++;
+        }
+      }
+    }
+    return FailedCheckCount;
+  } /* RunCpuBenchmarks */
+
+  /**
+   * @brief Render core benchmarking function. Skips benchmarks if no Vulkan device is available.
+   * @param Suite Suite to run benchmarks in
+  */
+  static VOID RunRenderBenchmarks( anv::bench::suite &Suite )
+  {
+    std::unique_ptr<core::system> System;
+
+    try
+    {
+      System = std::make_unique<core::system>(core::headless_output {.Extent = {800, 600}});
+    }
+    catch (const std::exception &Error)
+    {
+      std::printf("Render benchmarks are skipped, no Vulkan device: %s\n", Error.what());
+      return;
+    }
+
+    const std::vector<UINT32>
+      VertexSPV = CompileShader(BenchVertexShader, shaderc_vertex_shader, "vs_main"),
+      FragmentSPV = CompileShader(BenchFragmentShader, shaderc_fragment_shader, "fs_main");
+    std::array ShaderBindingTypes {core::pipeline::shader_binding_type::eUniformBuffer};
+    const std::array VertexAttributeLayouts {core::pipeline::vertex_attribute_layout {.Format = {core::format::type::eF32, 3}}};
+    const std::array VertexBufferLayouts {core::pipeline::vertex_buffer_layout {.Stride = sizeof(FLOAT) * 3}};
+
+    auto BuildPipeline = [&]
+    {
+      return System->Pipeline()
+        .SetVertexSPV(std::span<const UINT32>(VertexSPV))
+        .SetFragmentSPV(std::span<const UINT32>(FragmentSPV))
+        .SetShaderBindingTypes(std::span<core::pipeline::shader_binding_type>(ShaderBindingTypes))
+        .SetPrimitiveTopology(core::topology::eTriangleList)
+        .SetVertexAttributeLayouts(std::span<const core::pipeline::vertex_attribute_layout>(VertexAttributeLayouts))
+        .SetVertexBufferLayouts(std::span<const core::pipeline::vertex_buffer_layout>(VertexBufferLayouts))
+        .Build();
+    };
+
+    core::pipeline *Pipeline = BuildPipeline();
+    core::buffer *UniformBuffer = System->Buffer()
+      .SetSize(sizeof(anv::mat4x4))
+      .SetUsage(core::buffer::usage::eUniform)
+      .Build();
+    core::buffer::view *UniformView = UniformBuffer->View()
+      .SetSize(sizeof(anv::mat4x4))
+      .SetUsage(core::buffer::usage::eUniform)
+      .Build();
+    core::buffer *IndexBuffer = System->Buffer()
+      .SetSize(36 * sizeof(UINT32))
+      .SetUsage(core::buffer::usage::eIndex)
+      .Build();
+    core::buffer::view *IndexView = IndexBuffer->View()
+      .SetSize(36 * sizeof(UINT32))
+      .SetUsage(core::buffer::usage::eIndex)
+      .Build();
+    std::array AttachedResources {core::material::attached_resource(UniformView)};
+
+    auto BuildMaterial = [&]
+    {
+      return Pipeline->Material()
+        .SetAttachedResources(std::span<core::material::attached_resource>(AttachedResources))
+        .Build();
+    };
+
+    core::material *Material = BuildMaterial();
+
+    /* Resource building. Built resources are released at once and collected by render thread. */
+    Suite.Run("render.pipeline.build", 16, [&]
+    {
+      for (UINT32 i = 0; i < 16; i++)
+        BuildPipeline()->Release();
+    });
+    Suite.Run("render.material.build", 256, [&]
+    {
+      for (UINT32 i = 0; i < 256; i++)
+        BuildMaterial()->Release();
+    });
+    Suite.Run("render.sampler.build", 256, [&]
+    {
+      for (UINT32 i = 0; i < 256; i++)
+        System->Sampler().Build()->Release();
+    });
+
+    /* Instance churn */
+    {
+      constexpr UINT32 COUNT = 10'000;
+      std::mt19937 Generator(18102026);
+      const std::vector<anv::mat4x4> Transforms = RandomMatrices(COUNT, Generator);
+
+      // Primitive isn't registered in system, so render thread doesn't draw it while instances are changed
+      core::primitive *Primitive = new core::primitive(*Pipeline);
+
+      Primitive->Material = Material;
+      Material->Grab();
+
+      auto Churn = [&]
+      {
+        anv::rc::pool<anv::rc::resource> Instances;
+
+        for (UINT32 i = 0; i < COUNT; i++)
+          Instances.Add(Primitive->Instance(Transforms[i]));
+        for (anv::rc::resource *Instance : Instances)
+          Instance->Release();
+        Instances.CollectGarbage();
+      };
+
+      Suite.Run("render.primitive.instance_churn/10k", COUNT, Churn);
+      Primitive->SetBounds(anv::math::aabb {anv::vec3(-1), anv::vec3(1)});
+      Suite.Run("render.primitive.instance_churn/10k_bounded", COUNT, Churn);
+      Suite.Run("render.primitive.instance_churn/10k_bounded_bulk", COUNT, [&]
+      {
+        anv::rc::pool<anv::rc::resource> Instances;
+
+        for (core::primitive::instance *Instance : Primitive->CreateInstances(Transforms))
+          Instances.Add(Instance);
+        for (anv::rc::resource *Instance : Instances)
+          Instance->Release();
+        Instances.CollectGarbage();
+      });
+
+      Primitive->OnDestroy();
+    }
+
+    /* Frame */
+    {
+      constexpr UINT32 PRIMITIVE_COUNT = 1000, INSTANCE_COUNT = 16, FRAME_COUNT = 16;
+      std::mt19937 Generator(1000);
+      std::vector<core::primitive *> Primitives;
+
+      for (UINT32 i = 0; i < PRIMITIVE_COUNT; i++)
+      {
+        const std::vector<anv::mat4x4> Transforms = RandomMatrices(INSTANCE_COUNT, Generator);
+        core::primitive *Primitive = Pipeline->Primitive()
+          .SetIndexBufferView(std::move(IndexView))
+          .SetMaterial(std::move(Material))
+          .SetBounds(anv::math::aabb {anv::vec3(-1), anv::vec3(1)})
+          .Build();
+
+        for (const anv::mat4x4 &Transform : Transforms)
+          Primitive->Instance(Transform);
+        Primitives.push_back(Primitive);
+      }
+
+      auto WaitFrames = [&]
+      {
+        System->WaitFrames(System->GetCompletedFrameCount() + FRAME_COUNT);
+      };
+
+      Suite.Run("render.frame/1000x16_unculled", FRAME_COUNT, WaitFrames);
+      System->SetCullingCamera(BenchCamera());
+      Suite.Run("render.frame/1000x16_culled", FRAME_COUNT, WaitFrames);
+      System->SetCullingCamera(std::nullopt);
+
+      for (core::primitive *Primitive : Primitives)
+        Primitive->Release();
+    }
+
+    Material->Release();
+    IndexView->Release();
+    IndexBuffer->Release();
+    UniformView->Release();
+    UniformBuffer->Release();
+    Pipeline->Release();
+
+    System.reset();
+  } /* RunRenderBenchmarks */
+
+  /**
+   * @brief G-buffer layouts comparison benchmarking function. Skips benchmarks if no Vulkan device is available.
+   * @param Suite Suite to run benchmarks in
+  */
+  static VOID RunGBufferLayoutBenchmarks( anv::bench::suite &Suite )
+  {
+    constexpr UINT32 PRIMITIVE_COUNT = 1000, INSTANCE_COUNT = 16, FRAME_COUNT = 16;
+    const struct
+    {
+      const CHAR *Name;
+      core::gbuffer_layout Layout;
+      const CHAR *FragmentShader;
+    } Layouts[]
+    {
+      {"render.frame.gbuffer/wide_1080p",       core::gbuffer_layout::eWide,       BenchFragmentShader},
+      {"render.frame.gbuffer/compact_1080p",    core::gbuffer_layout::eCompact,    BenchCompactFragmentShader},
+      {"render.frame.gbuffer/visibility_1080p", core::gbuffer_layout::eVisibility, BenchVisibilityFragmentShader},
+    };
+
+    for (const auto &Layout : Layouts)
+    {
+      std::unique_ptr<core::system> System;
+
+      try
+      {
+        System = std::make_unique<core::system>(core::headless_output {.Extent = {1920, 1080}, .GBufferLayout = Layout.Layout});
+      }
+      catch (const std::exception &Error)
+      {
+        std::printf("G-buffer layout benchmarks are skipped, no Vulkan device: %s\n", Error.what());
+        return;
+      }
+
+      const std::vector<UINT32>
+        VertexSPV = CompileShader(BenchGBufferVertexShader, shaderc_vertex_shader, "vs_main"),
+        FragmentSPV = CompileShader(Layout.FragmentShader, shaderc_fragment_shader, "fs_main");
+      std::array ShaderBindingTypes {core::pipeline::shader_binding_type::eUniformBuffer};
+      const std::array VertexAttributeLayouts {core::pipeline::vertex_attribute_layout {.Format = {core::format::type::eF32, 3}}};
+      const std::array VertexBufferLayouts {core::pipeline::vertex_buffer_layout {.Stride = sizeof(FLOAT) * 3}};
+
+      core::pipeline *Pipeline = System->Pipeline()
+        .SetVertexSPV(std::span<const UINT32>(VertexSPV))
+        .SetFragmentSPV(std::span<const UINT32>(FragmentSPV))
+        .SetShaderBindingTypes(std::span<core::pipeline::shader_binding_type>(ShaderBindingTypes))
+        .SetPrimitiveTopology(core::topology::eTriangleList)
+        .SetVertexAttributeLayouts(std::span<const core::pipeline::vertex_attribute_layout>(VertexAttributeLayouts))
+        .SetVertexBufferLayouts(std::span<const core::pipeline::vertex_buffer_layout>(VertexBufferLayouts))
+        .Build();
+      core::buffer *UniformBuffer = System->Buffer()
+        .SetSize(sizeof(anv::mat4x4))
+        .SetUsage(core::buffer::usage::eUniform)
+        .Build();
+      core::buffer::view *UniformView = UniformBuffer->View()
+        .SetSize(sizeof(anv::mat4x4))
+        .SetUsage(core::buffer::usage::eUniform)
+        .Build();
+      core::buffer *IndexBuffer = System->Buffer()
+        .SetSize(36 * sizeof(UINT32))
+        .SetUsage(core::buffer::usage::eIndex)
+        .Build();
+      core::buffer::view *IndexView = IndexBuffer->View()
+        .SetSize(36 * sizeof(UINT32))
+        .SetUsage(core::buffer::usage::eIndex)
+        .Build();
+
+      // Cube corners, visibility buffer shading fetches them too
+      core::buffer *VertexBuffer = System->Buffer()
+        .SetSize(8 * sizeof(FLOAT) * 3)
+        .SetUsage(core::buffer::usage::eVertex)
+        .Build();
+      core::buffer::view *VertexView = VertexBuffer->View()
+        .SetSize(8 * sizeof(FLOAT) * 3)
+        .SetUsage(core::buffer::usage::eVertex)
+        .Build();
+      std::array AttachedResources {core::material::attached_resource(UniformView)};
+      core::material *Material = Pipeline->Material()
+        .SetAttachedResources(std::span<core::material::attached_resource>(AttachedResources))
+        .Build();
+
+      // Same scene for all layouts
+      std::mt19937 Generator(1000);
+      std::vector<core::primitive *> Primitives;
+
+      for (UINT32 i = 0; i < PRIMITIVE_COUNT; i++)
+      {
+        const std::vector<anv::mat4x4> Transforms = RandomMatrices(INSTANCE_COUNT, Generator);
+        core::primitive *Primitive = Pipeline->Primitive()
+          .SetIndexBufferView(std::move(IndexView))
+          .SetVertexBufferViews(std::span<core::buffer::view *>(&VertexView, 1))
+          .SetMaterial(std::move(Material))
+          .SetBounds(anv::math::aabb {anv::vec3(-1), anv::vec3(1)})
+          .Build();
+
+        for (const anv::mat4x4 &Transform : Transforms)
+          Primitive->Instance(Transform);
+        Primitives.push_back(Primitive);
+      }
+
+      Suite.Run(Layout.Name, FRAME_COUNT, [&]
+      {
+        System->WaitFrames(System->GetCompletedFrameCount() + FRAME_COUNT);
+      });
+
+      const core::render_graph::memory_stats Stats = System->GetAttachmentMemoryStats();
+      std::printf("%s: %zu bytes of G-buffer and depth images\n", Layout.Name, Stats.ImageSize);
+
+      for (core::primitive *Primitive : Primitives)
+        Primitive->Release();
+      Material->Release();
+      VertexView->Release();
+      VertexBuffer->Release();
+      IndexView->Release();
+      IndexBuffer->Release();
+      UniformView->Release();
+      UniformBuffer->Release();
+      Pipeline->Release();
+
+      System.reset();
+    }
+  } /* RunGBufferLayoutBenchmarks */
+
+  /**
+   * @brief Depth pre-pass benchmarking function. Every scene is rendered with pre-pass disabled and enabled.
+   *        Checks, that only enabled pre-pass records marker pass draws, and prints GPU marker and geometry pass times.
+   *        Skips benchmarks if no Vulkan device is available.
+   * @param Suite Suite to run benchmarks in
+   * @return Count of failed checks
+  */
+  static UINT32 RunDepthPrepassBenchmarks( anv::bench::suite &Suite )
+  {
+    constexpr UINT32 PRIMITIVE_COUNT = 1000, INSTANCE_COUNT = 16, FRAME_COUNT = 16;
+    std::unique_ptr<core::system> System;
+
+    try
+    {
+      System = std::make_unique<core::system>(core::headless_output {.Extent = {1920, 1080}});
+    }
+    catch (const std::exception &Error)
+    {
+      std::printf("Depth pre-pass benchmarks are skipped, no Vulkan device: %s\n", Error.what());
+      return 0;
+    }
+
+    // Render core doesn't write buffers, so camera is compiled in and cube is generated by vertex shader
+    const anv::math::util::camera::projection_matrices Camera = BenchCamera();
+    const anv::mat4x4 ViewProjection = Camera.View * Camera.Projection;
+    std::string VertexSource = "#define VIEW_PROJECTION float4x4(";
+
+    for (UINT32 i = 0; i < 16; i++)
+      VertexSource += std::format("{}{:.9g}", i != 0 ? ", " : "", ViewProjection.Data[i / 4][i % 4]);
+    VertexSource += std::string(")\n") + BenchInstancedVertexShader;
+
+    const std::vector<UINT32>
+      VertexSPV = CompileShader(VertexSource.c_str(), shaderc_vertex_shader, "vs_main"),
+      FragmentSPV = CompileShader(BenchFragmentShader, shaderc_fragment_shader, "fs_main");
+    std::array ShaderBindingTypes {core::pipeline::shader_binding_type::eUniformBuffer};
+    const std::array VertexAttributeLayouts {core::pipeline::vertex_attribute_layout {.Format = {core::format::type::eF32, 3}}};
+    const std::array VertexBufferLayouts {core::pipeline::vertex_buffer_layout {.Stride = sizeof(FLOAT) * 3}};
+
+    core::pipeline *Pipeline = System->Pipeline()
+      .SetVertexSPV(std::span<const UINT32>(VertexSPV))
+      .SetFragmentSPV(std::span<const UINT32>(FragmentSPV))
+      .SetDepthVertexSPV(std::span<const UINT32>(VertexSPV))
+      .SetShaderBindingTypes(std::span<core::pipeline::shader_binding_type>(ShaderBindingTypes))
+      .SetPrimitiveTopology(core::topology::eTriangleList)
+      .SetVertexAttributeLayouts(std::span<const core::pipeline::vertex_attribute_layout>(VertexAttributeLayouts))
+      .SetVertexBufferLayouts(std::span<const core::pipeline::vertex_buffer_layout>(VertexBufferLayouts))
+      .Build();
+    core::buffer *UniformBuffer = System->Buffer()
+      .SetSize(sizeof(anv::mat4x4))
+      .SetUsage(core::buffer::usage::eUniform)
+      .Build();
+    core::buffer::view *UniformView = UniformBuffer->View()
+      .SetSize(sizeof(anv::mat4x4))
+      .SetUsage(core::buffer::usage::eUniform)
+      .Build();
+
+    // Non-indexed cube of 36 vertices
+    core::buffer *VertexBuffer = System->Buffer()
+      .SetSize(36 * sizeof(FLOAT) * 3)
+      .SetUsage(core::buffer::usage::eVertex)
+      .Build();
+    core::buffer::view *VertexView = VertexBuffer->View()
+      .SetSize(36 * sizeof(FLOAT) * 3)
+      .SetUsage(core::buffer::usage::eVertex)
+      .Build();
+    std::array AttachedResources {core::material::attached_resource(UniformView)};
+    core::material *Material = Pipeline->Material()
+      .SetAttachedResources(std::span<core::material::attached_resource>(AttachedResources))
+      .Build();
+
+    // Scattered scene has little overdraw, layered one is walls, drawn from far to near, so every layer passes depth test
+    auto ScatteredTransforms = []( std::mt19937 &Generator )
+    {
+      return RandomMatrices(INSTANCE_COUNT, Generator);
+    };
+    auto LayeredTransforms = [Layer = 0U]( std::mt19937 & ) mutable
+    {
+      std::vector<anv::mat4x4> Result;
+
+      for (UINT32 i = 0; i < INSTANCE_COUNT; i++, Layer++)
+        Result.push_back(anv::mat4x4::Scale(80, 60, 0.1F) * anv::mat4x4::Translate(0, 20, Layer * 0.05F - 700));
+      return Result;
+    };
+    const struct
+    {
+      const CHAR *Name;
+      std::function<std::vector<anv::mat4x4>( std::mt19937 & )> Transforms;
+    } Scenes[]
+    {
+      {"scattered_1000x16", ScatteredTransforms},
+      {"layered_1000x16",   LayeredTransforms},
+    };
+
+    UINT32 FailedCheckCount = 0;
+
+    System->SetCullingCamera(Camera);
+    System->SetProfiling(TRUE);
+    for (const auto &Scene : Scenes)
+    {
+      std::mt19937 Generator(1000);
+      std::vector<core::primitive *> Primitives;
+
+      for (UINT32 i = 0; i < PRIMITIVE_COUNT; i++)
+      {
+        core::primitive *Primitive = Pipeline->Primitive()
+          .SetVertexBufferViews(std::span<core::buffer::view *>(&VertexView, 1))
+          .SetMaterial(std::move(Material))
+          .SetBounds(anv::math::aabb {anv::vec3(-1), anv::vec3(1)})
+          .Build();
+
+        for (const anv::mat4x4 &Transform : Scene.Transforms(Generator))
+          Primitive->Instance(Transform);
+        Primitives.push_back(Primitive);
+      }
+
+      UINT64 DrawCounts[2] {};
+      for (BOOL IsPrepassed : {FALSE, TRUE})
+      {
+        const std::string Name = std::string("render.frame.depth_prepass/") + Scene.Name + (IsPrepassed ? "_on" : "_off");
+
+        // Frame, recorded with previous setting, may be in flight
+        System->SetDepthPrepass(IsPrepassed);
+        System->WaitFrames(System->GetCompletedFrameCount() + 2);
+
+        const core::culling_stats Stats = System->GetCullingStats();
+        DrawCounts[IsPrepassed] = Stats.DrawCount;
+        if ((Stats.PrepassDrawCount != 0) != IsPrepassed)
+        {
+          std::printf("%s: %llu depth pre-pass draws recorded\n", Name.c_str(), (unsigned long long)Stats.PrepassDrawCount);
+          FailedCheckCount++;
+        }
+
+        Suite.Run(Name, FRAME_COUNT, [&]
+        {
+          System->WaitFrames(System->GetCompletedFrameCount() + FRAME_COUNT);
+        });
+
+        // Pre-pass moves depth testing cost to marker pass, geometry pass shades visible fragments only
+        DOUBLE MarkerTime = 0, GeometryTime = 0;
+        UINT32 ProfileCount = 0;
+        for (const core::frame_profile &Profile : System->GetFrameProfiles())
+        {
+          const core::profile_interval
+            &Marker = Profile.GpuPasses[(UINT32)core::profile_pass::eMarker],
+            &Geometry = Profile.GpuPasses[(UINT32)core::profile_pass::eGeometry];
+
+          if (Marker.Duration >= 0 && Geometry.Duration >= 0)
+          {
+            MarkerTime += Marker.Duration;
+            GeometryTime += Geometry.Duration;
+            ProfileCount++;
+          }
+        }
+        if (ProfileCount != 0)
+          std::printf("%s: %llu draws, GPU marker pass %.1f us, geometry pass %.1f us\n", Name.c_str(), (unsigned long long)Stats.DrawCount,
+            MarkerTime / ProfileCount, GeometryTime / ProfileCount);
+      }
+
+      // Every geometry draw gets its pre-pass draw
+      if (DrawCounts[TRUE] != DrawCounts[FALSE] * 2)
+      {
+        std::printf("render.frame.depth_prepass/%s: %llu draws with pre-pass, %llu without\n", Scene.Name,
+          (unsigned long long)DrawCounts[TRUE], (unsigned long long)DrawCounts[FALSE]);
+        FailedCheckCount++;
+      }
+
+      for (core::primitive *Primitive : Primitives)
+        Primitive->Release();
+    }
+    System->SetProfiling(FALSE);
+    System->SetCullingCamera(std::nullopt);
+
+    Material->Release();
+    VertexView->Release();
+    VertexBuffer->Release();
+    UniformView->Release();
+    UniformBuffer->Release();
+    Pipeline->Release();
+
+    System.reset();
+    return FailedCheckCount;
+  } /* RunDepthPrepassBenchmarks */
+
+  /**
+   * @brief Benchmark suite main function
+   * @param Args Benchmark arguments: [Output.json [Baseline.json [MaxSlowdown [Filter]]]], "-" skips output or baseline
+   * @return Process exit code, 1 if any benchmark is slower than baseline by more than MaxSlowdown or any benchmark check fails
+  */
+  INT BenchMain( std::span<const std::string_view> Args )
+  {
+    auto GetArg = [&]( SIZE_T Index ) -> std::string_view
+    {
+      return Index < Args.size() && Args[Index] != "-" ? Args[Index] : "";
+    };
+    const std::string_view OutputPath = GetArg(0), BaselinePath = GetArg(1), Filter = GetArg(3);
+    const DOUBLE MaxSlowdown = GetArg(2).empty() ? 1.10 : std::atof(std::string(GetArg(2)).c_str());
+
+    // Software driver (e.g. lavapipe) may be selected by VK_DRIVER_FILES environment variable for reproducible results
+    anv::bench::suite Suite(9, 1, Filter);
+
+    UINT32 FailedCheckCount = RunCpuBenchmarks(Suite);
+    RunRenderBenchmarks(Suite);
+    RunGBufferLayoutBenchmarks(Suite);
+    FailedCheckCount += RunDepthPrepassBenchmarks(Suite);
+
+    if (!OutputPath.empty())
+    {
+      std::ofstream File {std::filesystem::path(OutputPath)};
+
+      File << Suite.ToJson();
+    }
+
+    if (FailedCheckCount != 0)
+      std::printf("%u benchmark check(s) failed\n", FailedCheckCount);
+    if (BaselinePath.empty())
+      return FailedCheckCount != 0 ? 1 : 0;
+
+    std::ifstream File {std::filesystem::path(BaselinePath)};
+    if (!File)
+    {
+      std::printf("Baseline %s can't be read\n", std::string(BaselinePath).c_str());
+      return 1;
+    }
+
+    const std::string Json {std::istreambuf_iterator<CHAR>(File), std::istreambuf_iterator<CHAR>()};
+    const UINT32 RegressionCount = Suite.Compare(anv::bench::suite::ParseBaseline(Json), MaxSlowdown);
+
+    std::printf("%u regression(s) over %.0f%% threshold\n", RegressionCount, (MaxSlowdown - 1) * 100);
+    return RegressionCount != 0 || FailedCheckCount != 0 ? 1 : 0;
+  } /* BenchMain */
+} /* namespace anv_main */
+
+/* file anv_bench.cpp */
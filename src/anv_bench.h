@@ -0,0 +1,27 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/anv_bench.h
+ * @description Render core microbenchmark suite declaration module
+ * @last_update 18.10.2026
+*/
+
+#ifndef __ANV_BENCH_H_
+#define __ANV_BENCH_H_
+
+#include "anv_common.h"
+
+namespace anv_main
+{
+  using namespace anv::common_types;
+
+  /**
+   * @brief Benchmark suite main function
+   * @param Args Benchmark arguments: [Output.json [Baseline.json [MaxSlowdown [Filter]]]], "-" skips output or baseline
+   * @return Process exit code, 1 if any benchmark is slower than baseline by more than MaxSlowdown
+  */
+  INT BenchMain( std::span<const std::string_view> Args );
+} /* namespace anv_main */
+
+#endif // !defined(__ANV_BENCH_H_)
+
+/* file anv_bench.h */
@@ -1,8 +1,8 @@
 #ifndef ANV_COMMON_H_
 #define ANV_COMMON_H_
 
-/* Debug memory allocation support */ 
-#ifndef NDEBUG
+/* Debug memory allocation support (MSVC CRT only) */ 
+#if !defined(NDEBUG) && defined(_MSC_VER)
 #  define _CRTDBG_MAP_ALLOC
 #  include <crtdbg.h> 
 #  define SetDbgMemHooks() \
@@ -43,6 +43,11 @@ namespace anv
 #include <functional>
 #include <variant>
 #include <span>
+#include <optional>
+#include <algorithm>
+#include <numeric>
+#include <bit>
+#include <ranges>
 
 // IO
 #include <fstream>
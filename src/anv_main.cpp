@@ -1,6 +1,7 @@
 #include "anv.h"
+#include "anv_bench.h"
 
-namespace main
+namespace anv_main
 {
   using namespace anv::common_types;
 
@@ -10,12 +11,88 @@ namespace main
     auto &AnimContext = Anim.GetContext();
 
     while (AnimContext.MainWindow->IsOpen() && !AnimContext.MainWindow->IsKeyPressed(SDLK_ESCAPE))
-      ;
+    {
+      AnimContext.MainWindow->WaitEvents();
+      AnimContext.MainWindow->UpdateInput();
+    }
 
     Anim.Close();
   } /* End of 'main' function */
+
+  /**
+   * @brief Headless main function. Renders frames offscreen and writes last one to PPM file.
+   * @param Extent Output extent
+   * @param FrameCount Count of frames to render
+   * @param OutputPath Output file path, empty if no output is required
+  */
+  VOID HeadlessMain( anv::extent2 Extent, UINT32 FrameCount, std::string_view OutputPath )
+  {
+    anv::render::system Render;
+
+    Render.InitHeadless(anv::render::core::headless_output
+      {
+        .Extent = Extent,
+        .Readback = !OutputPath.empty(),
+      });
+
+    auto Start = std::chrono::high_resolution_clock::now();
+    Render.WaitFrames(FrameCount);
+    FLOAT Seconds = std::chrono::duration<FLOAT>(std::chrono::high_resolution_clock::now() - Start).count();
+    std::printf("Rendered %u frames in %.3f s (%.2f ms/frame)\n", FrameCount, Seconds, Seconds * 1000.0F / std::max(FrameCount, 1U));
+
+    anv::render::core::frame_pacing_stats PacingStats = Render.GetFramePacingStats();
+    std::printf("Frame time over last %u frames: mean %.2f ms, deviation %.2f ms, p99 %.2f ms, max %.2f ms\n",
+      PacingStats.FrameCount, PacingStats.MeanFrameTime, PacingStats.FrameTimeDeviation, PacingStats.P99FrameTime, PacingStats.MaxFrameTime);
+
+    if (!OutputPath.empty())
+    {
+      std::vector<BYTE> Pixels;
+      anv::extent2 OutputExtent;
+
+      // Readback is asynchronous, so last frame may still be in readback thread
+      while (Render.ReadOutput(Pixels, OutputExtent) < FrameCount)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+      std::ofstream File {std::filesystem::path(OutputPath), std::ios::binary};
+      std::string Header = std::format("P6\n{} {}\n255\n", OutputExtent.W, OutputExtent.H);
+
+      File.write(Header.data(), Header.size());
+      for (SIZE_T i = 0; i < Pixels.size(); i += 4)
+        File.write(reinterpret_cast<const CHAR *>(&Pixels[i]), 3);
+    }
+
+    Render.Close();
+  } /* HeadlessMain */
+
+  /**
+   * @brief Command line handling function
+   * @param Args Command line arguments (without program name)
+   * @return Process exit code
+  */
+  INT Run( std::span<const std::string_view> Args )
+  {
+    // --headless [Width Height [FrameCount [Output.ppm]]]
+    if (!Args.empty() && Args[0] == "--headless")
+    {
+      auto GetInt = [&]( SIZE_T Index, INT Default )
+      {
+        return Index < Args.size() ? std::atoi(std::string(Args[Index]).c_str()) : Default;
+      };
+
+      HeadlessMain(anv::extent2(GetInt(1, 800), GetInt(2, 600)), (UINT32)GetInt(3, 100), Args.size() > 4 ? Args[4] : "");
+      return 0;
+    }
+
+    // --bench [Output.json [Baseline.json [MaxSlowdown [Filter]]]]
+    if (!Args.empty() && Args[0] == "--bench")
+      return BenchMain(Args.subspan(1));
+
+    Main();
+    return 0;
+  } /* Run */
 }
 
+#ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
 #include <windows.h>
@@ -32,10 +109,24 @@ INT WINAPI WinMain(
   std::freopen("conin$", "r", stdin);
   std::freopen("conout$", "w", stderr);
 
-  main::Main();
+  std::vector<std::string_view> Args;
+  std::string_view CommandLine = CommandLineArgs;
+  for (auto Word : std::views::split(CommandLine, ' '))
+    if (!Word.empty())
+      Args.emplace_back(Word.begin(), Word.end());
+
+  INT ExitCode = anv_main::Run(Args);
 
   std::system("pause");
   FreeConsole();
 
-  return 0;
+  return ExitCode;
+}
+#else // defined(_WIN32)
+int main( int ArgC, char *ArgV[] )
+{
+  std::vector<std::string_view> Args(ArgV + 1, ArgV + ArgC);
+
+  return anv_main::Run(Args);
 }
+#endif // !defined(_WIN32)
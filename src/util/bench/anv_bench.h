@@ -0,0 +1,204 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/util/bench/anv_bench.h
+ * @description Microbenchmark timing and reporting implementation module
+ * @last_update 18.10.2026
+*/
+
+#ifndef ANV_BENCH_H_
+#define ANV_BENCH_H_
+
+#include "anv_common.h"
+
+#include <atomic>
+#include <cstdio>
+#include <format>
+
+/**
+ * @brief Microbenchmark namespace
+*/
+namespace anv::bench
+{
+  /**
+   * @brief Value computation forcing function. Keeps compiler from removing code, Value is computed by.
+   * @param Value Value to keep
+  */
+  template <typename type>
+    inline VOID DoNotOptimize( const type &Value )
+    {
+      static const VOID * volatile Sink;
+
+      Sink = &Value;
+      std::atomic_signal_fence(std::memory_order_seq_cst);
+    } /* DoNotOptimize */
+
+  /**
+   * @brief Benchmark result. Timings are per single operation.
+  */
+  struct result
+  {
+    std::string Name;        // Benchmark name
+    UINT64 OperationCount;   // Count of operations in one repetition
+    UINT32 RepetitionCount;  // Count of timed repetitions
+    DOUBLE MinNs;            // Minimal operation time, in nanoseconds
+    DOUBLE MedianNs;         // Median operation time, in nanoseconds
+    DOUBLE MeanNs;           // Mean operation time, in nanoseconds
+  }; /* struct result */
+
+  /**
+   * @brief Benchmark suite. Runs benchmarks, collects results and compares them with baseline.
+  */
+  class suite
+  {
+  public:
+    /**
+     * @brief Suite constructor
+     * @param RepetitionCount Count of timed repetitions of every benchmark, median of them is the main result
+     * @param WarmupCount Count of untimed repetitions before timed ones
+     * @param Filter Substring of names of benchmarks to run, all benchmarks are run if empty
+    */
+    suite( UINT32 RepetitionCount = 9, UINT32 WarmupCount = 1, std::string_view Filter = "" ) :
+      RepetitionCount(std::max(RepetitionCount, 1U)), WarmupCount(WarmupCount), Filter(Filter)
+    {
+    } /* suite */
+
+    /**
+     * @brief Benchmark running function
+     * @param Name Benchmark name, unique in suite
+     * @param OperationCount Count of operations, performed by one Body call
+     * @param Setup Untimed preparation, called before every Body call
+     * @param Body Timed benchmark body
+    */
+    template <typename setup, typename body>
+      VOID Run( std::string_view Name, UINT64 OperationCount, setup &&Setup, body &&Body )
+      {
+        if (!Filter.empty() && Name.find(Filter) == std::string_view::npos)
+          return;
+
+        std::vector<DOUBLE> Times;
+
+        Times.reserve(RepetitionCount);
+        for (UINT32 i = 0; i < WarmupCount + RepetitionCount; i++)
+        {
+          Setup();
+
+          const auto Start = std::chrono::steady_clock::now();
+          Body();
+          const auto End = std::chrono::steady_clock::now();
+
+          if (i >= WarmupCount)
+            Times.push_back(std::chrono::duration<DOUBLE, std::nano>(End - Start).count() / std::max(OperationCount, (UINT64)1));
+        }
+
+        std::sort(Times.begin(), Times.end());
+        Results.push_back(result
+          {
+            .Name = std::string(Name),
+            .OperationCount = OperationCount,
+            .RepetitionCount = RepetitionCount,
+            .MinNs = Times.front(),
+            .MedianNs = Times.size() % 2 != 0 ? Times[Times.size() / 2] : (Times[Times.size() / 2 - 1] + Times[Times.size() / 2]) / 2,
+            .MeanNs = std::accumulate(Times.begin(), Times.end(), 0.0) / Times.size(),
+          });
+        std::printf("%-48s %14.1f ns/op (min %.1f, mean %.1f, %llu ops x %u)\n",
+          Results.back().Name.c_str(), Results.back().MedianNs, Results.back().MinNs, Results.back().MeanNs,
+          (unsigned long long)OperationCount, RepetitionCount);
+      } /* Run */
+
+    /**
+     * @brief Benchmark without setup running function
+     * @param Name Benchmark name, unique in suite
+     * @param OperationCount Count of operations, performed by one Body call
+     * @param Body Timed benchmark body
+    */
+    template <typename body>
+      VOID Run( std::string_view Name, UINT64 OperationCount, body &&Body )
+      {
+        Run(Name, OperationCount, []{}, std::forward<body>(Body));
+      } /* Run */
+
+    /**
+     * @brief Results getting function
+     * @return Results of all run benchmarks
+    */
+    const std::vector<result> & GetResults( VOID ) const
+    {
+      return Results;
+    } /* GetResults */
+
+    /**
+     * @brief Results JSON representation getting function. Every result is written on its own line.
+     * @return JSON document
+    */
+    std::string ToJson( VOID ) const
+    {
+      std::string Json = "{\n  \"results\": [\n";
+
+      for (SIZE_T i = 0; i < Results.size(); i++)
+      {
+        const result &Result = Results[i];
+
+        Json += std::format("    {{\"name\": \"{}\", \"operations\": {}, \"repetitions\": {}, \"min_ns\": {:.3f}, \"median_ns\": {:.3f}, \"mean_ns\": {:.3f}}}{}\n",
+          Result.Name, Result.OperationCount, Result.RepetitionCount, Result.MinNs, Result.MedianNs, Result.MeanNs,
+          i + 1 < Results.size() ? "," : "");
+      }
+      return Json + "  ]\n}\n";
+    } /* ToJson */
+
+    /**
+     * @brief Baseline parsing function. Accepts documents, written by ToJson.
+     * @param Json JSON document
+     * @return Median operation times by benchmark name
+    */
+    static std::map<std::string, DOUBLE> ParseBaseline( std::string_view Json )
+    {
+      std::map<std::string, DOUBLE> Baseline;
+
+      for (SIZE_T Position = Json.find("\"name\""); Position != std::string_view::npos; Position = Json.find("\"name\"", Position + 1))
+      {
+        const SIZE_T
+          NameStart = Json.find('"', Json.find(':', Position)) + 1,
+          NameEnd = Json.find('"', NameStart),
+          Median = Json.find("\"median_ns\"", NameEnd);
+
+        if (NameEnd == std::string_view::npos || Median == std::string_view::npos)
+          break;
+        Baseline[std::string(Json.substr(NameStart, NameEnd - NameStart))] = std::atof(std::string(Json.substr(Json.find(':', Median) + 1, 32)).c_str());
+      }
+      return Baseline;
+    } /* ParseBaseline */
+
+    /**
+     * @brief Results by baseline checking function. Prints comparison of every benchmark, present in baseline.
+     * @param Baseline Baseline median times by benchmark name
+     * @param MaxSlowdown Maximal allowed ratio of median time to baseline one
+     * @return Count of benchmarks, slower than allowed
+    */
+    UINT32 Compare( const std::map<std::string, DOUBLE> &Baseline, DOUBLE MaxSlowdown ) const
+    {
+      UINT32 RegressionCount = 0;
+
+      for (const result &Result : Results)
+        if (auto It = Baseline.find(Result.Name); It != Baseline.end() && It->second > 0)
+        {
+          const DOUBLE Ratio = Result.MedianNs / It->second;
+          const BOOL IsRegression = Ratio > MaxSlowdown;
+
+          RegressionCount += IsRegression;
+          std::printf("%-48s %14.1f -> %14.1f ns/op (%+.1f%%)%s\n",
+            Result.Name.c_str(), It->second, Result.MedianNs, (Ratio - 1) * 100, IsRegression ? " REGRESSION" : "");
+        }
+      return RegressionCount;
+    } /* Compare */
+
+  private:
+    UINT32 RepetitionCount;      // Count of timed repetitions
+    UINT32 WarmupCount;          // Count of untimed repetitions
+    std::string Filter;          // Benchmark name filter
+    std::vector<result> Results; // Collected results
+  }; /* class suite */
+} /* namespace anv::bench */
+
+#endif // !defined(ANV_BENCH_H_)
+
+/* file anv_bench.h */
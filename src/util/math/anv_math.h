@@ -9,6 +9,7 @@
 #define ANV_MATH_H_
 
 #include "anv_math_linalg.h"
+#include "anv_math_quat.h"
 #include "anv_math_extent.h"
 
 // #define ANV_MATH_LINALG_VEC_SWIZZLE_ELEM(INDEX) Array[GetVectorComponentIndex<SwizzleString[INDEX]>()]
@@ -133,6 +134,23 @@ namespace anv
     */
     template <arithmetic_type component> using mat4x4 = linalg::mat<component, 4, 4>;
 
+    /**
+     * @brief Quaternion math namespace alias
+     * 
+     * @tparam component (arithmetic_type) Quaternion component type
+    */
+    template <arithmetic_type component> using quat = linalg::quat<component>;
+
+    /**
+     * @brief Translation-rotation-scale transform math namespace alias
+     * 
+     * @tparam component (arithmetic_type) Transform component type
+    */
+    template <arithmetic_type component> using trs = linalg::trs<component>;
+
+    /** @brief Packed transform GPU representation alias */
+    using packed_trs = linalg::packed_trs;
+
     /**
      * @brief Namespace with math constants
     */
@@ -156,11 +174,15 @@ namespace anv
   using dvec3 = math::vec3<DOUBLE>;
   using dvec4 = math::vec4<DOUBLE>;
   using dmat4x4 = math::mat4x4<DOUBLE>;
+  using dquat = math::quat<DOUBLE>;
+  using dtrs = math::trs<DOUBLE>;
 
   using fvec2 = math::vec2<FLOAT>;
   using fvec3 = math::vec3<FLOAT>;
   using fvec4 = math::vec4<FLOAT>;
   using fmat4x4 = math::mat4x4<FLOAT>;
+  using fquat = math::quat<FLOAT>;
+  using ftrs = math::trs<FLOAT>;
 
   using extent2 = iextent2;
 
@@ -168,6 +190,9 @@ namespace anv
   using vec3 = fvec3;
   using vec4 = fvec4;
   using mat4x4 = fmat4x4;
+  using quat = fquat;
+  using trs = ftrs;
+  using packed_trs = math::packed_trs;
 } /* namespace anv */
 
 #endif // !defined(ANV_MATH_H_)
\ No newline at end of file
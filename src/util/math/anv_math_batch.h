@@ -0,0 +1,470 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/util/math/anv_math_batch.h
+ * @description Math batched structure-of-arrays transformation kernels module
+ * @last_update 18.10.2026
+*/
+
+#ifndef ANV_MATH_BATCH_H_
+#define ANV_MATH_BATCH_H_
+
+#include "anv_math_bounds.h"
+
+#include <bit>
+
+/**
+ * @brief Batched transformation kernels namespace.
+ * Every kernel processes Result.size() elements, all input streams must be at least of this size.
+*/
+namespace anv::math::batch
+{
+  /**
+   * @brief 3-component vector stream (structure of arrays)
+   * @tparam component Component type (const FLOAT for input streams, FLOAT for output ones)
+  */
+  template <typename component>
+    struct vec3_stream
+    {
+      std::span<component> X, Y, Z; // Component streams
+    }; /* struct vec3_stream */
+
+  /**
+   * @brief 4-component vector (e.g. quaternion) stream (structure of arrays)
+   * @tparam component Component type (const FLOAT for input streams, FLOAT for output ones)
+  */
+  template <typename component>
+    struct vec4_stream
+    {
+      std::span<component> X, Y, Z, W; // Component streams
+    }; /* struct vec4_stream */
+
+  /**
+   * @brief Axis aligned bounding box stream (structure of arrays)
+   * @tparam component Component type (const FLOAT for input streams, FLOAT for output ones)
+  */
+  template <typename component>
+    struct aabb_stream
+    {
+      vec3_stream<component> Min, Max; // Box corner streams
+    }; /* struct aabb_stream */
+
+  /* Parent index of hierarchy roots */
+  inline constexpr UINT32 NO_PARENT = ~0U;
+
+  /**
+   * @brief Translation-rotation-scale to matrix composition function. Matrix is Scale * Rotate * Translate (row vector convention).
+   * @param Translation Translation stream
+   * @param Rotation Rotation quaternion (X, Y, Z - vector part, W - scalar part) stream. Quaternions must be normalized.
+   * @param Scale Scale stream
+   * @param Result Matrix span to write composed matrices to
+  */
+  inline VOID ComposeTRS( const vec3_stream<const FLOAT> &Translation, const vec4_stream<const FLOAT> &Rotation, const vec3_stream<const FLOAT> &Scale, std::span<fmat4x4> Result )
+  {
+    SIZE_T i = 0;
+
+#ifdef ANV_MATH_SIMD_SSE
+    const __m128 Zero = _mm_setzero_ps(), One = _mm_set1_ps(1), Two = _mm_set1_ps(2);
+
+    for (; i + 4 <= Result.size(); i += 4)
+    {
+      __m128
+        QX = _mm_loadu_ps(&Rotation.X[i]),
+        QY = _mm_loadu_ps(&Rotation.Y[i]),
+        QZ = _mm_loadu_ps(&Rotation.Z[i]),
+        QW = _mm_loadu_ps(&Rotation.W[i]);
+      __m128
+        SX = _mm_loadu_ps(&Scale.X[i]),
+        SY = _mm_loadu_ps(&Scale.Y[i]),
+        SZ = _mm_loadu_ps(&Scale.Z[i]);
+
+      __m128
+        X2 = _mm_mul_ps(QX, Two), Y2 = _mm_mul_ps(QY, Two), Z2 = _mm_mul_ps(QZ, Two),
+        XX = _mm_mul_ps(QX, X2), YY = _mm_mul_ps(QY, Y2), ZZ = _mm_mul_ps(QZ, Z2),
+        XY = _mm_mul_ps(QX, Y2), XZ = _mm_mul_ps(QX, Z2), YZ = _mm_mul_ps(QY, Z2),
+        WX = _mm_mul_ps(QW, X2), WY = _mm_mul_ps(QW, Y2), WZ = _mm_mul_ps(QW, Z2);
+
+      // Element streams, Mij holds matrix element [i][j] of 4 consecutive instances
+      __m128
+        M00 = _mm_mul_ps(SX, _mm_sub_ps(One, _mm_add_ps(YY, ZZ))),
+        M01 = _mm_mul_ps(SX, _mm_add_ps(XY, WZ)),
+        M02 = _mm_mul_ps(SX, _mm_sub_ps(XZ, WY)),
+        M10 = _mm_mul_ps(SY, _mm_sub_ps(XY, WZ)),
+        M11 = _mm_mul_ps(SY, _mm_sub_ps(One, _mm_add_ps(XX, ZZ))),
+        M12 = _mm_mul_ps(SY, _mm_add_ps(YZ, WX)),
+        M20 = _mm_mul_ps(SZ, _mm_add_ps(XZ, WY)),
+        M21 = _mm_mul_ps(SZ, _mm_sub_ps(YZ, WX)),
+        M22 = _mm_mul_ps(SZ, _mm_sub_ps(One, _mm_add_ps(XX, YY))),
+        M03 = Zero, M13 = Zero, M23 = Zero,
+        M30 = _mm_loadu_ps(&Translation.X[i]),
+        M31 = _mm_loadu_ps(&Translation.Y[i]),
+        M32 = _mm_loadu_ps(&Translation.Z[i]),
+        M33 = One;
+
+      // Transpose every row from element streams to per-instance layout
+      _MM_TRANSPOSE4_PS(M00, M01, M02, M03);
+      _MM_TRANSPOSE4_PS(M10, M11, M12, M13);
+      _MM_TRANSPOSE4_PS(M20, M21, M22, M23);
+      _MM_TRANSPOSE4_PS(M30, M31, M32, M33);
+
+      const __m128 Rows[4][4]
+      {
+        {M00, M10, M20, M30},
+        {M01, M11, M21, M31},
+        {M02, M12, M22, M32},
+        {M03, M13, M23, M33},
+      };
+
+      for (INT Instance = 0; Instance < 4; Instance++)
+        for (INT Row = 0; Row < 4; Row++)
+          _mm_storeu_ps(Result[i + Instance].Data[Row], Rows[Instance][Row]);
+    }
+#endif // defined(ANV_MATH_SIMD_SSE)
+
+    for (; i < Result.size(); i++)
+    {
+      const FLOAT
+        QX = Rotation.X[i], QY = Rotation.Y[i], QZ = Rotation.Z[i], QW = Rotation.W[i],
+        XX = 2 * QX * QX, YY = 2 * QY * QY, ZZ = 2 * QZ * QZ,
+        XY = 2 * QX * QY, XZ = 2 * QX * QZ, YZ = 2 * QY * QZ,
+        WX = 2 * QW * QX, WY = 2 * QW * QY, WZ = 2 * QW * QZ,
+        SX = Scale.X[i], SY = Scale.Y[i], SZ = Scale.Z[i];
+
+      Result[i] = fmat4x4
+      {
+        SX * (1 - YY - ZZ),  SX * (XY + WZ),      SX * (XZ - WY),      0,
+        SY * (XY - WZ),      SY * (1 - XX - ZZ),  SY * (YZ + WX),      0,
+        SZ * (XZ + WY),      SZ * (YZ - WX),      SZ * (1 - XX - YY),  0,
+        Translation.X[i],    Translation.Y[i],    Translation.Z[i],    1,
+      };
+    }
+  } /* ComposeTRS */
+
+  /**
+   * @brief Matrix by common matrix multiplication function
+   * @param Lhs Left matrices
+   * @param Rhs Right matrix, common for all products
+   * @param Result Products (Result[i] = Lhs[i] * Rhs), may alias Lhs
+  */
+  inline VOID Multiply( std::span<const fmat4x4> Lhs, const fmat4x4 &Rhs, std::span<fmat4x4> Result )
+  {
+    for (SIZE_T i = 0; i < Result.size(); i++)
+      simd::MatrixMultiply(Lhs[i].Array, Rhs.Array, Result[i].Array);
+  } /* Multiply */
+
+  /**
+   * @brief Hierarchy local to world matrices transformation function
+   * @param Local Local (relative to parent) matrices
+   * @param Parents Parent indices. Every parent must go before its children, NO_PARENT marks hierarchy roots.
+   * @param World World matrices (World[i] = Local[i] * World[Parents[i]]), may alias Local
+  */
+  inline VOID MultiplyHierarchy( std::span<const fmat4x4> Local, std::span<const UINT32> Parents, std::span<fmat4x4> World )
+  {
+    for (SIZE_T i = 0; i < World.size(); i++)
+    {
+      const UINT32 Parent = Parents[i];
+
+      if (Parent == NO_PARENT)
+        World[i] = Local[i];
+      else
+        simd::MatrixMultiply(Local[i].Array, World[Parent].Array, World[i].Array);
+    }
+  } /* MultiplyHierarchy */
+
+#ifdef ANV_MATH_SIMD_SSE
+  /**
+   * @brief 4 consecutive matrices to element streams transposition function
+   * @param Matrices Pointer to first of 4 matrices
+   * @param M Element streams, M[i][j] holds element [i][j] of every matrix
+  */
+  inline VOID TransposeMatrices4( const fmat4x4 *Matrices, __m128 (&M)[4][4] )
+  {
+    for (INT Row = 0; Row < 4; Row++)
+    {
+      __m128
+        R0 = _mm_loadu_ps(Matrices[0].Data[Row]),
+        R1 = _mm_loadu_ps(Matrices[1].Data[Row]),
+        R2 = _mm_loadu_ps(Matrices[2].Data[Row]),
+        R3 = _mm_loadu_ps(Matrices[3].Data[Row]);
+
+      _MM_TRANSPOSE4_PS(R0, R1, R2, R3);
+      M[Row][0] = R0;
+      M[Row][1] = R1;
+      M[Row][2] = R2;
+      M[Row][3] = R3;
+    }
+  } /* TransposeMatrices4 */
+
+  /**
+   * @brief 4 boxes by 4 matrices transformation function (center-extent form)
+   * @param M Matrix element streams
+   * @param Center Box center streams, transformed in place
+   * @param Extent Box half-extent streams, transformed in place
+  */
+  inline VOID TransformCenterExtent4( const __m128 (&M)[4][4], __m128 (&Center)[3], __m128 (&Extent)[3] )
+  {
+    const __m128 SignMask = _mm_set1_ps(-0.0F);
+    __m128 NewCenter[3], NewExtent[3];
+
+    for (INT c = 0; c < 3; c++)
+    {
+      // Center is transformed as point, extent - by absolute values of matrix elements
+      NewCenter[c] = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(Center[0], M[0][c]), _mm_mul_ps(Center[1], M[1][c])),
+        _mm_add_ps(_mm_mul_ps(Center[2], M[2][c]), M[3][c])
+      );
+      NewExtent[c] = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(Extent[0], _mm_andnot_ps(SignMask, M[0][c])), _mm_mul_ps(Extent[1], _mm_andnot_ps(SignMask, M[1][c]))),
+        _mm_mul_ps(Extent[2], _mm_andnot_ps(SignMask, M[2][c]))
+      );
+    }
+    for (INT c = 0; c < 3; c++)
+    {
+      Center[c] = NewCenter[c];
+      Extent[c] = NewExtent[c];
+    }
+  } /* TransformCenterExtent4 */
+
+  /**
+   * @brief 4 boxes by frustum test function
+   * @param Planes Frustum plane component streams (Planes[Plane][Component], splatted)
+   * @param Center Box center streams
+   * @param Extent Box half-extent streams
+   * @return Mask of possibly visible boxes (bit per box)
+  */
+  inline INT TestCenterExtent4( const __m128 (&Planes)[frustum::_eCount][4], const __m128 (&Center)[3], const __m128 (&Extent)[3] )
+  {
+    const __m128 SignMask = _mm_set1_ps(-0.0F);
+    __m128 Outside = _mm_setzero_ps();
+
+    for (INT p = 0; p < frustum::_eCount; p++)
+    {
+      // Signed distance of box corner, farthest along plane normal
+      __m128 Distance = _mm_add_ps(
+        _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(Center[0], Planes[p][0]), _mm_mul_ps(Center[1], Planes[p][1])),
+          _mm_add_ps(_mm_mul_ps(Center[2], Planes[p][2]), Planes[p][3])
+        ),
+        _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(Extent[0], _mm_andnot_ps(SignMask, Planes[p][0])), _mm_mul_ps(Extent[1], _mm_andnot_ps(SignMask, Planes[p][1]))),
+          _mm_mul_ps(Extent[2], _mm_andnot_ps(SignMask, Planes[p][2]))
+        )
+      );
+
+      Outside = _mm_or_ps(Outside, _mm_cmplt_ps(Distance, _mm_setzero_ps()));
+    }
+
+    return ~_mm_movemask_ps(Outside) & 0xF;
+  } /* TestCenterExtent4 */
+
+  /**
+   * @brief Frustum planes splatting function
+   * @param Frustum Frustum to splat planes of
+   * @param Planes Plane component streams
+  */
+  inline VOID SplatPlanes( const frustum &Frustum, __m128 (&Planes)[frustum::_eCount][4] )
+  {
+    for (INT p = 0; p < frustum::_eCount; p++)
+      for (INT c = 0; c < 4; c++)
+        Planes[p][c] = _mm_set1_ps(Frustum.Planes[p].Array[c]);
+  } /* SplatPlanes */
+#endif // defined(ANV_MATH_SIMD_SSE)
+
+  /**
+   * @brief Box in center-extent form by frustum test function
+   * @param Frustum Frustum to test box by
+   * @param Center Box center
+   * @param Extent Box half-extent
+   * @return FALSE if box is surely outside, TRUE otherwise
+  */
+  inline BOOL TestCenterExtent( const frustum &Frustum, const FLOAT (&Center)[3], const FLOAT (&Extent)[3] )
+  {
+    for (const fvec4 &Plane : Frustum.Planes)
+      if (Center[0] * Plane.X + Center[1] * Plane.Y + Center[2] * Plane.Z + Plane.W +
+          Extent[0] * std::abs(Plane.X) + Extent[1] * std::abs(Plane.Y) + Extent[2] * std::abs(Plane.Z) < 0)
+        return FALSE;
+    return TRUE;
+  } /* TestCenterExtent */
+
+  /**
+   * @brief Box in center-extent form by matrix transformation function
+   * @param M Transformation matrix (affine)
+   * @param Center Box center, transformed in place
+   * @param Extent Box half-extent, transformed in place
+  */
+  inline VOID TransformCenterExtent( const fmat4x4 &M, FLOAT (&Center)[3], FLOAT (&Extent)[3] )
+  {
+    FLOAT NewCenter[3], NewExtent[3];
+
+    for (INT c = 0; c < 3; c++)
+    {
+      NewCenter[c] = Center[0] * M.Data[0][c] + Center[1] * M.Data[1][c] + Center[2] * M.Data[2][c] + M.Data[3][c];
+      NewExtent[c] = Extent[0] * std::abs(M.Data[0][c]) + Extent[1] * std::abs(M.Data[1][c]) + Extent[2] * std::abs(M.Data[2][c]);
+    }
+    std::copy_n(NewCenter, 3, Center);
+    std::copy_n(NewExtent, 3, Extent);
+  } /* TransformCenterExtent */
+
+  /**
+   * @brief Bounding box transformation function. Result boxes bound transformed source ones (affine matrices only).
+   * @param Source Source boxes
+   * @param Matrices Per-box transformation matrices
+   * @param Result Transformed box streams
+  */
+  inline VOID TransformAABB( const aabb_stream<const FLOAT> &Source, std::span<const fmat4x4> Matrices, const aabb_stream<FLOAT> &Result )
+  {
+    const SIZE_T Count = Result.Min.X.size();
+    SIZE_T i = 0;
+
+#ifdef ANV_MATH_SIMD_SSE
+    const __m128 Half = _mm_set1_ps(0.5F);
+
+    for (; i + 4 <= Count; i += 4)
+    {
+      __m128 M[4][4], Center[3], Extent[3];
+
+      TransposeMatrices4(&Matrices[i], M);
+      for (INT c = 0; c < 3; c++)
+      {
+        const std::span<const FLOAT>
+          &Min = c == 0 ? Source.Min.X : c == 1 ? Source.Min.Y : Source.Min.Z,
+          &Max = c == 0 ? Source.Max.X : c == 1 ? Source.Max.Y : Source.Max.Z;
+        __m128 Lo = _mm_loadu_ps(&Min[i]), Hi = _mm_loadu_ps(&Max[i]);
+
+        Center[c] = _mm_mul_ps(_mm_add_ps(Lo, Hi), Half);
+        Extent[c] = _mm_mul_ps(_mm_sub_ps(Hi, Lo), Half);
+      }
+
+      TransformCenterExtent4(M, Center, Extent);
+
+      for (INT c = 0; c < 3; c++)
+      {
+        const std::span<FLOAT>
+          &Min = c == 0 ? Result.Min.X : c == 1 ? Result.Min.Y : Result.Min.Z,
+          &Max = c == 0 ? Result.Max.X : c == 1 ? Result.Max.Y : Result.Max.Z;
+
+        _mm_storeu_ps(&Min[i], _mm_sub_ps(Center[c], Extent[c]));
+        _mm_storeu_ps(&Max[i], _mm_add_ps(Center[c], Extent[c]));
+      }
+    }
+#endif // defined(ANV_MATH_SIMD_SSE)
+
+    for (; i < Count; i++)
+    {
+      FLOAT
+        Center[3] {(Source.Min.X[i] + Source.Max.X[i]) * 0.5F, (Source.Min.Y[i] + Source.Max.Y[i]) * 0.5F, (Source.Min.Z[i] + Source.Max.Z[i]) * 0.5F},
+        Extent[3] {(Source.Max.X[i] - Source.Min.X[i]) * 0.5F, (Source.Max.Y[i] - Source.Min.Y[i]) * 0.5F, (Source.Max.Z[i] - Source.Min.Z[i]) * 0.5F};
+
+      TransformCenterExtent(Matrices[i], Center, Extent);
+
+      Result.Min.X[i] = Center[0] - Extent[0];
+      Result.Min.Y[i] = Center[1] - Extent[1];
+      Result.Min.Z[i] = Center[2] - Extent[2];
+      Result.Max.X[i] = Center[0] + Extent[0];
+      Result.Max.Y[i] = Center[1] + Extent[1];
+      Result.Max.Z[i] = Center[2] + Extent[2];
+    }
+  } /* TransformAABB */
+
+  /**
+   * @brief Bounding boxes frustum culling function
+   * @param Frustum Frustum to cull by
+   * @param Boxes Boxes to cull
+   * @param Visible Index span to write indices of possibly visible boxes to, must be of Boxes size at least
+   * @return Count of visible boxes
+  */
+  inline SIZE_T CullAABB( const frustum &Frustum, const aabb_stream<const FLOAT> &Boxes, std::span<UINT32> Visible )
+  {
+    const SIZE_T Count = Boxes.Min.X.size();
+    SIZE_T i = 0, VisibleCount = 0;
+
+#ifdef ANV_MATH_SIMD_SSE
+    const __m128 Half = _mm_set1_ps(0.5F);
+    __m128 Planes[frustum::_eCount][4];
+
+    SplatPlanes(Frustum, Planes);
+    for (; i + 4 <= Count; i += 4)
+    {
+      __m128 Center[3], Extent[3];
+
+      for (INT c = 0; c < 3; c++)
+      {
+        const std::span<const FLOAT>
+          &Min = c == 0 ? Boxes.Min.X : c == 1 ? Boxes.Min.Y : Boxes.Min.Z,
+          &Max = c == 0 ? Boxes.Max.X : c == 1 ? Boxes.Max.Y : Boxes.Max.Z;
+        __m128 Lo = _mm_loadu_ps(&Min[i]), Hi = _mm_loadu_ps(&Max[i]);
+
+        Center[c] = _mm_mul_ps(_mm_add_ps(Lo, Hi), Half);
+        Extent[c] = _mm_mul_ps(_mm_sub_ps(Hi, Lo), Half);
+      }
+
+      for (INT Mask = TestCenterExtent4(Planes, Center, Extent); Mask != 0; Mask &= Mask - 1)
+        Visible[VisibleCount++] = (UINT32)(i + std::countr_zero((UINT32)Mask));
+    }
+#endif // defined(ANV_MATH_SIMD_SSE)
+
+    for (; i < Count; i++)
+    {
+      const FLOAT
+        Center[3] {(Boxes.Min.X[i] + Boxes.Max.X[i]) * 0.5F, (Boxes.Min.Y[i] + Boxes.Max.Y[i]) * 0.5F, (Boxes.Min.Z[i] + Boxes.Max.Z[i]) * 0.5F},
+        Extent[3] {(Boxes.Max.X[i] - Boxes.Min.X[i]) * 0.5F, (Boxes.Max.Y[i] - Boxes.Min.Y[i]) * 0.5F, (Boxes.Max.Z[i] - Boxes.Min.Z[i]) * 0.5F};
+
+      if (TestCenterExtent(Frustum, Center, Extent))
+        Visible[VisibleCount++] = (UINT32)i;
+    }
+
+    return VisibleCount;
+  } /* CullAABB */
+
+  /**
+   * @brief Instances of one bounding box frustum culling function. Box is transformed by every instance matrix and tested against frustum.
+   * @param Frustum Frustum to cull by
+   * @param Box Bounding box in local (instance) space
+   * @param Matrices Instance transformation matrices (affine)
+   * @param Visible Index span to write indices of possibly visible instances to, must be of Matrices size at least
+   * @return Count of visible instances
+  */
+  inline SIZE_T CullInstances( const frustum &Frustum, const aabb &Box, std::span<const fmat4x4> Matrices, std::span<UINT32> Visible )
+  {
+    const FLOAT
+      LocalCenter[3] {(Box.Min.X + Box.Max.X) * 0.5F, (Box.Min.Y + Box.Max.Y) * 0.5F, (Box.Min.Z + Box.Max.Z) * 0.5F},
+      LocalExtent[3] {(Box.Max.X - Box.Min.X) * 0.5F, (Box.Max.Y - Box.Min.Y) * 0.5F, (Box.Max.Z - Box.Min.Z) * 0.5F};
+    SIZE_T i = 0, VisibleCount = 0;
+
+#ifdef ANV_MATH_SIMD_SSE
+    __m128 Planes[frustum::_eCount][4];
+
+    SplatPlanes(Frustum, Planes);
+    for (; i + 4 <= Matrices.size(); i += 4)
+    {
+      __m128 M[4][4];
+      __m128
+        Center[3] {_mm_set1_ps(LocalCenter[0]), _mm_set1_ps(LocalCenter[1]), _mm_set1_ps(LocalCenter[2])},
+        Extent[3] {_mm_set1_ps(LocalExtent[0]), _mm_set1_ps(LocalExtent[1]), _mm_set1_ps(LocalExtent[2])};
+
+      TransposeMatrices4(&Matrices[i], M);
+      TransformCenterExtent4(M, Center, Extent);
+
+      for (INT Mask = TestCenterExtent4(Planes, Center, Extent); Mask != 0; Mask &= Mask - 1)
+        Visible[VisibleCount++] = (UINT32)(i + std::countr_zero((UINT32)Mask));
+    }
+#endif // defined(ANV_MATH_SIMD_SSE)
+
+    for (; i < Matrices.size(); i++)
+    {
+      FLOAT Center[3], Extent[3];
+
+      std::copy_n(LocalCenter, 3, Center);
+      std::copy_n(LocalExtent, 3, Extent);
+      TransformCenterExtent(Matrices[i], Center, Extent);
+
+      if (TestCenterExtent(Frustum, Center, Extent))
+        Visible[VisibleCount++] = (UINT32)i;
+    }
+
+    return VisibleCount;
+  } /* CullInstances */
+} /* namespace anv::math::batch */
+
+#endif // !defined(ANV_MATH_BATCH_H_)
+
+/* file anv_math_batch.h */
@@ -0,0 +1,280 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/util/math/anv_math_bounds.h
+ * @description Math bounding volumes and frustum implementation module
+ * @last_update 18.10.2026
+*/
+
+#ifndef ANV_MATH_BOUNDS_H_
+#define ANV_MATH_BOUNDS_H_
+
+#include "anv_math.h"
+
+/**
+ * @brief Math namespace
+*/
+namespace anv::math
+{
+  /**
+   * @brief Axis aligned bounding box
+  */
+  struct aabb
+  {
+    fvec3 Min {0}; // Minimal corner
+    fvec3 Max {0}; // Maximal corner
+
+    /**
+     * @brief Bounding box of points building function
+     * @param Points Points to bound, must be non-empty
+     * @return Bounding box
+    */
+    static aabb FromPoints( std::span<const fvec3> Points )
+    {
+      aabb Result {Points[0], Points[0]};
+
+      for (const fvec3 &P : Points)
+        Result.Add(P);
+      return Result;
+    } /* FromPoints */
+
+    /**
+     * @brief Bounding box of interleaved vertex data building function
+     * @param Vertices Vertex data
+     * @param Stride Vertex stride in bytes
+     * @param PositionOffset Offset of position (3 FLOATs) in vertex, in bytes
+     * @return Bounding box, empty (zero) one if there are no vertices
+    */
+    static aabb FromVertices( std::span<const BYTE> Vertices, SIZE_T Stride, SIZE_T PositionOffset = 0 )
+    {
+      if (Vertices.size() < PositionOffset + sizeof(fvec3))
+        return aabb {};
+
+      const SIZE_T Count = (Vertices.size() - PositionOffset - sizeof(fvec3)) / Stride + 1;
+      auto GetPosition = [&]( SIZE_T Index )
+      {
+        fvec3 P;
+
+        std::copy_n(Vertices.data() + Index * Stride + PositionOffset, sizeof(P.Array), reinterpret_cast<BYTE *>(P.Array));
+        return P;
+      };
+
+      aabb Result {GetPosition(0), GetPosition(0)};
+
+      for (SIZE_T i = 1; i < Count; i++)
+        Result.Add(GetPosition(i));
+      return Result;
+    } /* FromVertices */
+
+    /**
+     * @brief Point adding function
+     * @param P Point to extend box by
+    */
+    VOID Add( const fvec3 &P )
+    {
+      Min = fvec3(std::min(Min.X, P.X), std::min(Min.Y, P.Y), std::min(Min.Z, P.Z));
+      Max = fvec3(std::max(Max.X, P.X), std::max(Max.Y, P.Y), std::max(Max.Z, P.Z));
+    } /* Add */
+
+    /**
+     * @brief Bounding box of two boxes getting function
+     * @param Other Box to unite with
+     * @return Box, containing both boxes
+    */
+    aabb Union( const aabb &Other ) const
+    {
+      return aabb
+      {
+        fvec3(std::min(Min.X, Other.Min.X), std::min(Min.Y, Other.Min.Y), std::min(Min.Z, Other.Min.Z)),
+        fvec3(std::max(Max.X, Other.Max.X), std::max(Max.Y, Other.Max.Y), std::max(Max.Z, Other.Max.Z)),
+      };
+    } /* Union */
+
+    /**
+     * @brief Box containment test function
+     * @param Other Box to test
+     * @return TRUE if Other box is completely inside this one
+    */
+    BOOL Contains( const aabb &Other ) const
+    {
+      return
+        Min.X <= Other.Min.X && Min.Y <= Other.Min.Y && Min.Z <= Other.Min.Z &&
+        Max.X >= Other.Max.X && Max.Y >= Other.Max.Y && Max.Z >= Other.Max.Z;
+    } /* Contains */
+
+    /**
+     * @brief Box intersection test function
+     * @param Other Box to test
+     * @return TRUE if boxes intersect or touch
+    */
+    BOOL Overlaps( const aabb &Other ) const
+    {
+      return
+        Min.X <= Other.Max.X && Min.Y <= Other.Max.Y && Min.Z <= Other.Max.Z &&
+        Max.X >= Other.Min.X && Max.Y >= Other.Min.Y && Max.Z >= Other.Min.Z;
+    } /* Overlaps */
+
+    /**
+     * @brief Surface area getting function
+     * @return Box surface area
+    */
+    FLOAT GetSurfaceArea( VOID ) const
+    {
+      const FLOAT DX = Max.X - Min.X, DY = Max.Y - Min.Y, DZ = Max.Z - Min.Z;
+
+      return 2 * (DX * DY + DY * DZ + DZ * DX);
+    } /* GetSurfaceArea */
+
+    /**
+     * @brief Evenly extended box getting function
+     * @param Margin Distance to move every box face outwards by
+     * @return Extended box
+    */
+    aabb Extended( FLOAT Margin ) const
+    {
+      return aabb {Min - fvec3(Margin), Max + fvec3(Margin)};
+    } /* Extended */
+
+    /**
+     * @brief Transformed box bounding box getting function
+     * @param Transform Affine transformation matrix
+     * @return Bounding box of transformed box
+    */
+    aabb Transformed( const fmat4x4 &Transform ) const
+    {
+      const fvec3 Center = (Min + Max) * 0.5F, Extent = (Max - Min) * 0.5F;
+      fvec3 NewCenter, NewExtent;
+
+      // Center is transformed as point, extent - by absolute values of matrix elements
+      for (INT c = 0; c < 3; c++)
+      {
+        NewCenter.Array[c] = Center.X * Transform.Data[0][c] + Center.Y * Transform.Data[1][c] + Center.Z * Transform.Data[2][c] + Transform.Data[3][c];
+        NewExtent.Array[c] =
+          Extent.X * std::abs(Transform.Data[0][c]) +
+          Extent.Y * std::abs(Transform.Data[1][c]) +
+          Extent.Z * std::abs(Transform.Data[2][c]);
+      }
+      return aabb {NewCenter - NewExtent, NewCenter + NewExtent};
+    } /* Transformed */
+  }; /* struct aabb */
+
+  /**
+   * @brief Ray
+  */
+  struct ray
+  {
+    fvec3 Origin {0};    // Ray origin
+    fvec3 Direction {0}; // Ray direction, not necessarily normalized. Distances along ray are measured in its lengths.
+
+    /**
+     * @brief Ray by box intersection function (slab method)
+     * @param Box Box to intersect
+     * @param InverseDirection Per-component inverse of ray direction
+     * @param MaxDistance Maximal distance along ray to account intersection at
+     * @return Distance to box entry point (0 if origin is inside box), empty if there is no intersection in [0, MaxDistance]
+    */
+    std::optional<FLOAT> Intersect( const aabb &Box, const fvec3 &InverseDirection, FLOAT MaxDistance ) const
+    {
+      FLOAT Near = 0, Far = MaxDistance;
+
+      for (INT c = 0; c < 3; c++)
+      {
+        FLOAT
+          T0 = (Box.Min.Array[c] - Origin.Array[c]) * InverseDirection.Array[c],
+          T1 = (Box.Max.Array[c] - Origin.Array[c]) * InverseDirection.Array[c];
+
+        if (T0 > T1)
+          std::swap(T0, T1);
+        // NaNs (zero direction component with origin on slab plane) don't narrow the range
+        Near = T0 > Near ? T0 : Near;
+        Far = T1 < Far ? T1 : Far;
+        if (Near > Far)
+          return std::nullopt;
+      }
+      return Near;
+    } /* Intersect */
+
+    /**
+     * @brief Per-component inverse of ray direction getting function
+     * @return Inverse direction, infinite for zero components
+    */
+    fvec3 GetInverseDirection( VOID ) const
+    {
+      return fvec3(1 / Direction.X, 1 / Direction.Y, 1 / Direction.Z);
+    } /* GetInverseDirection */
+  }; /* struct ray */
+
+  /**
+   * @brief View frustum, represented by 6 planes. Point P is inside if Plane.X * P.X + Plane.Y * P.Y + Plane.Z * P.Z + Plane.W >= 0 for every plane.
+  */
+  struct frustum
+  {
+    /* Plane indices */
+    enum plane
+    {
+      eLeft,
+      eRight,
+      eBottom,
+      eTop,
+      eNear,
+      eFar,
+      _eCount,
+    }; /* enum plane */
+
+    fvec4 Planes[_eCount]; // Normalized frustum planes
+
+    /**
+     * @brief Frustum extraction function (Gribb-Hartmann method)
+     * @param ViewProjection World to clip space matrix (View * Projection), clip space depth in [-W, W] (as built by mat4x4 projection functions)
+     * @return Frustum in world space
+    */
+    static frustum FromMatrix( const fmat4x4 &ViewProjection )
+    {
+      const fmat4x4 &M = ViewProjection;
+      auto Column = [&]( INT Index )
+      {
+        return fvec4(M.Data[0][Index], M.Data[1][Index], M.Data[2][Index], M.Data[3][Index]);
+      };
+      const fvec4 C0 = Column(0), C1 = Column(1), C2 = Column(2), C3 = Column(3);
+
+      frustum Result;
+
+      Result.Planes[eLeft] = C3 + C0;
+      Result.Planes[eRight] = C3 - C0;
+      Result.Planes[eBottom] = C3 + C1;
+      Result.Planes[eTop] = C3 - C1;
+      Result.Planes[eNear] = C3 + C2;
+      Result.Planes[eFar] = C3 - C2;
+
+      for (fvec4 &Plane : Result.Planes)
+        Plane /= std::sqrt(Plane.X * Plane.X + Plane.Y * Plane.Y + Plane.Z * Plane.Z);
+      return Result;
+    } /* FromMatrix */
+
+    /**
+     * @brief Bounding box visibility test function
+     * @param Box Box to test
+     * @return FALSE if box is surely outside, TRUE otherwise (conservative)
+    */
+    BOOL TestAABB( const aabb &Box ) const
+    {
+      for (const fvec4 &Plane : Planes)
+      {
+        // Test the box corner, farthest along plane normal
+        const fvec3 P
+        (
+          Plane.X >= 0 ? Box.Max.X : Box.Min.X,
+          Plane.Y >= 0 ? Box.Max.Y : Box.Min.Y,
+          Plane.Z >= 0 ? Box.Max.Z : Box.Min.Z
+        );
+
+        if (Plane.X * P.X + Plane.Y * P.Y + Plane.Z * P.Z + Plane.W < 0)
+          return FALSE;
+      }
+      return TRUE;
+    } /* TestAABB */
+  }; /* struct frustum */
+} /* namespace anv::math */
+
+#endif // !defined(ANV_MATH_BOUNDS_H_)
+
+/* file anv_math_bounds.h */
@@ -0,0 +1,944 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/util/math/anv_math_bvh.h
+ * @description Math dynamic bounding volume hierarchy implementation module
+ * @last_update 18.10.2026
+*/
+
+#ifndef ANV_MATH_BVH_H_
+#define ANV_MATH_BVH_H_
+
+#include "anv_math_bounds.h"
+
+#include <cfloat>
+
+/**
+ * @brief Math namespace
+*/
+namespace anv::math
+{
+  /**
+   * @brief Dynamic bounding volume hierarchy of boxes.
+   *        Leaves are inserted, removed and moved incrementally (tree is kept balanced by rotations),
+   *        bulk updates are done by leaf box setting and single bottom-up refit,
+   *        degraded tree is rebuilt by parallel binned SAH builder.
+   *        Not thread safe, queries may run concurrently with each other only.
+  */
+  class bvh
+  {
+  public:
+    // Leaf handle, stable during whole leaf lifetime (including rebuilds)
+    using handle = UINT32;
+
+    /* Invalid handle (and node index) value */
+    constexpr static handle INVALID_HANDLE = ~0U;
+
+    /**
+     * @brief Hierarchy constructor
+     * @param Margin Distance, leaf boxes are extended by on Move, so small movements don't change tree
+    */
+    bvh( FLOAT Margin = 0.1F ) : Margin(Margin)
+    {
+    } /* bvh */
+
+    /**
+     * @brief Leaf inserting function
+     * @param Box Leaf bounding box
+     * @param UserData Data, passed to query callbacks
+     * @return Leaf handle
+    */
+    handle Insert( const aabb &Box, UINT64 UserData )
+    {
+      const handle Handle = AllocateProxy();
+      const UINT32 Leaf = AllocateNode();
+
+      Proxies[Handle] = {Leaf, UserData};
+      Nodes[Leaf].Box = Box;
+      Nodes[Leaf].Proxy = Handle;
+      Nodes[Leaf].Height = 0;
+      InsertLeaf(Leaf);
+      LeafCount++;
+
+      return Handle;
+    } /* Insert */
+
+    /**
+     * @brief Leaves bulk inserting function. Few leaves (relative to tree size) are inserted one by one,
+     *        many ones are only linked to handles, then whole tree is rebuilt by parallel binned SAH builder.
+     * @param Boxes Leaf bounding boxes
+     * @param UserData Leaf user data, must be of Boxes size
+     * @param Handles Handles of inserted leaves, must be of Boxes size
+    */
+    VOID InsertBulk( std::span<const aabb> Boxes, std::span<const UINT64> UserData, std::span<handle> Handles )
+    {
+      if (Boxes.size() < BULK_REBUILD_MIN_COUNT || Boxes.size() * BULK_REBUILD_RATIO < LeafCount)
+      {
+        for (SIZE_T i = 0; i < Boxes.size(); i++)
+          Handles[i] = Insert(Boxes[i], UserData[i]);
+        return;
+      }
+
+      for (SIZE_T i = 0; i < Boxes.size(); i++)
+      {
+        const handle Handle = AllocateProxy();
+        const UINT32 Leaf = AllocateNode();
+
+        Proxies[Handle] = {Leaf, UserData[i]};
+        Nodes[Leaf].Box = Boxes[i];
+        Nodes[Leaf].Proxy = Handle;
+        Nodes[Leaf].Height = 0;
+        Handles[i] = Handle;
+      }
+      LeafCount += (UINT32)Boxes.size();
+      Rebuild();
+    } /* InsertBulk */
+
+    /**
+     * @brief Leaf removing function
+     * @param Handle Handle of leaf to remove
+    */
+    VOID Remove( handle Handle )
+    {
+      const UINT32 Leaf = Proxies[Handle].Node;
+
+      RemoveLeaf(Leaf);
+      FreeNode(Leaf);
+      Proxies[Handle] = {FreeProxy, 0};
+      FreeProxy = Handle;
+      LeafCount--;
+    } /* Remove */
+
+    /**
+     * @brief Leaf moving function. Leaf is reinserted only if new box leaves current (extended by margin) one.
+     * @param Handle Leaf handle
+     * @param Box New leaf bounding box
+     * @return TRUE if tree structure was changed
+    */
+    BOOL Move( handle Handle, const aabb &Box )
+    {
+      const UINT32 Leaf = Proxies[Handle].Node;
+
+      if (Nodes[Leaf].Box.Contains(Box))
+        return FALSE;
+
+      RemoveLeaf(Leaf);
+      Nodes[Leaf].Box = Box.Extended(Margin);
+      InsertLeaf(Leaf);
+      return TRUE;
+    } /* Move */
+
+    /**
+     * @brief Leaf box setting function. Keeps tree structure, internal boxes are updated by Refit.
+     * @param Handle Leaf handle
+     * @param Box New leaf bounding box
+    */
+    VOID SetBox( handle Handle, const aabb &Box )
+    {
+      UINT32 Index = Proxies[Handle].Node;
+
+      Nodes[Index].Box = Box;
+
+      // Mark path to root, stop at already marked node
+      while (Index != INVALID_HANDLE && !Nodes[Index].IsDirty)
+      {
+        Nodes[Index].IsDirty = TRUE;
+        Index = Nodes[Index].Parent;
+      }
+    } /* SetBox */
+
+    /**
+     * @brief Internal node boxes updating function. Visits only subtrees with leaves, changed by SetBox.
+    */
+    VOID Refit( VOID )
+    {
+      if (Root != INVALID_HANDLE && Nodes[Root].IsDirty)
+        RefitNode(Root);
+    } /* Refit */
+
+    /**
+     * @brief Hierarchy rebuilding function. Builds tree from scratch by binned SAH, large subtrees are built in parallel.
+     *        Leaf handles are kept.
+    */
+    VOID Rebuild( VOID )
+    {
+      std::vector<build_leaf> Leaves;
+
+      Leaves.reserve(LeafCount);
+      for (handle Handle = 0; Handle < (handle)Proxies.size(); Handle++)
+        if (Proxies[Handle].Node != INVALID_HANDLE && IsProxyAlive(Handle))
+          Leaves.push_back({Nodes[Proxies[Handle].Node].Box, Handle});
+
+      Nodes.clear();
+      FreeNodeList = INVALID_HANDLE;
+      Root = INVALID_HANDLE;
+      if (!Leaves.empty())
+      {
+        Nodes.resize(Leaves.size() * 2 - 1);
+        Root = 0;
+        BuildNode(Leaves, 0, INVALID_HANDLE, 0);
+      }
+      BuiltCost = GetCost();
+    } /* Rebuild */
+
+    /**
+     * @brief Hierarchy building function. Replaces all leaves, handle of leaf I is I.
+     * @param Boxes Leaf bounding boxes
+     * @param UserData Leaf user data, must be of Boxes size
+    */
+    VOID Build( std::span<const aabb> Boxes, std::span<const UINT64> UserData )
+    {
+      Clear();
+      Proxies.resize(Boxes.size());
+      Nodes.resize(Boxes.size());
+      for (SIZE_T i = 0; i < Boxes.size(); i++)
+      {
+        Proxies[i] = {(UINT32)i, UserData[i]};
+        Nodes[i].Box = Boxes[i];
+        Nodes[i].Proxy = (handle)i;
+        Nodes[i].Height = 0;
+      }
+      LeafCount = (UINT32)Boxes.size();
+      Rebuild();
+    } /* Build */
+
+    /**
+     * @brief Rebuilding of degraded hierarchy function
+     * @param Threshold Maximal ratio of current to just built tree cost
+     * @return TRUE if hierarchy was rebuilt
+    */
+    BOOL RebuildIfDegraded( FLOAT Threshold = 1.5F )
+    {
+      if (Root == INVALID_HANDLE || GetCost() <= BuiltCost * Threshold)
+        return FALSE;
+      Rebuild();
+      return TRUE;
+    } /* RebuildIfDegraded */
+
+    /**
+     * @brief Leaves removing function
+    */
+    VOID Clear( VOID )
+    {
+      Nodes.clear();
+      Proxies.clear();
+      Root = FreeNodeList = FreeProxy = INVALID_HANDLE;
+      LeafCount = 0;
+      BuiltCost = 0;
+    } /* Clear */
+
+    /**
+     * @brief Hierarchy traversal cost getting function (surface area heuristic)
+     * @return Sum of internal node areas relative to root one, 0 for empty or single leaf tree
+    */
+    FLOAT GetCost( VOID ) const
+    {
+      if (Root == INVALID_HANDLE || Nodes[Root].IsLeaf())
+        return 0;
+
+      DOUBLE Area = 0;
+
+      for (const node &Node : Nodes)
+        if (Node.Height > 0)
+          Area += Node.Box.GetSurfaceArea();
+      return (FLOAT)(Area / std::max(Nodes[Root].Box.GetSurfaceArea(), FLT_MIN));
+    } /* GetCost */
+
+    /**
+     * @brief Leaf count getting function
+     * @return Count of leaves
+    */
+    UINT32 GetSize( VOID ) const
+    {
+      return LeafCount;
+    } /* GetSize */
+
+    /**
+     * @brief Tree height getting function
+     * @return Count of edges on longest root to leaf path, 0 for empty tree
+    */
+    INT32 GetHeight( VOID ) const
+    {
+      return Root == INVALID_HANDLE ? 0 : Nodes[Root].Height;
+    } /* GetHeight */
+
+    /**
+     * @brief Leaf box getting function
+     * @param Handle Leaf handle
+     * @return Leaf box (extended by margin if leaf was moved by Move)
+    */
+    const aabb & GetBox( handle Handle ) const
+    {
+      return Nodes[Proxies[Handle].Node].Box;
+    } /* GetBox */
+
+    /**
+     * @brief Leaf user data getting function
+     * @param Handle Leaf handle
+     * @return User data
+    */
+    UINT64 GetUserData( handle Handle ) const
+    {
+      return Proxies[Handle].UserData;
+    } /* GetUserData */
+
+    /**
+     * @brief Leaves, overlapping box, querying function
+     * @param Box Box to test leaves by
+     * @param Callback Callback, called as BOOL(handle Handle, UINT64 UserData) for every found leaf, returns FALSE to stop query
+    */
+    template <typename callback>
+      VOID QueryAABB( const aabb &Box, callback &&Callback ) const
+      {
+        if (Root == INVALID_HANDLE)
+          return;
+
+        traversal_stack<UINT32> Stack;
+
+        Stack.Push(Root);
+        while (!Stack.IsEmpty())
+        {
+          const node &Node = Nodes[Stack.Pop()];
+
+          if (!Node.Box.Overlaps(Box))
+            continue;
+          if (Node.IsLeaf())
+          {
+            if (!Callback(Node.Proxy, Proxies[Node.Proxy].UserData))
+              return;
+          }
+          else
+          {
+            Stack.Push(Node.Right);
+            Stack.Push(Node.Left);
+          }
+        }
+      } /* QueryAABB */
+
+    /**
+     * @brief Leaves, possibly visible in frustum, querying function (conservative).
+     *        Subtrees, completely inside frustum, are reported without further tests.
+     * @param Frustum Frustum to test leaves by
+     * @param Callback Callback, called as BOOL(handle Handle, UINT64 UserData) for every found leaf, returns FALSE to stop query
+    */
+    template <typename callback>
+      VOID QueryFrustum( const frustum &Frustum, callback &&Callback ) const
+      {
+        if (Root == INVALID_HANDLE)
+          return;
+
+        constexpr UINT32 AllPlanesMask = (1 << frustum::_eCount) - 1;
+
+        // Entry holds node index in low and mask of planes, node may still cross, in high dword
+        traversal_stack<UINT64> Stack;
+
+        Stack.Push((UINT64)AllPlanesMask << 32 | Root);
+        while (!Stack.IsEmpty())
+        {
+          const UINT64 Entry = Stack.Pop();
+          const node &Node = Nodes[(UINT32)Entry];
+          UINT32 PlaneMask = (UINT32)(Entry >> 32);
+          BOOL IsOutside = FALSE;
+
+          const fvec3
+            Center = (Node.Box.Min + Node.Box.Max) * 0.5F,
+            Extent = (Node.Box.Max - Node.Box.Min) * 0.5F;
+
+          for (INT p = 0; p < frustum::_eCount && !IsOutside; p++)
+            if (PlaneMask & (1 << p))
+            {
+              const fvec4 &Plane = Frustum.Planes[p];
+              const FLOAT
+                Distance = Plane.X * Center.X + Plane.Y * Center.Y + Plane.Z * Center.Z + Plane.W,
+                Radius = std::abs(Plane.X) * Extent.X + std::abs(Plane.Y) * Extent.Y + std::abs(Plane.Z) * Extent.Z;
+
+              if (Distance + Radius < 0)
+                IsOutside = TRUE;
+              else if (Distance - Radius >= 0)
+                PlaneMask &= ~(1 << p);
+            }
+          if (IsOutside)
+            continue;
+
+          if (Node.IsLeaf())
+          {
+            if (!Callback(Node.Proxy, Proxies[Node.Proxy].UserData))
+              return;
+          }
+          else if (PlaneMask == 0)
+          {
+            if (!ReportSubtree(Node, Callback))
+              return;
+          }
+          else
+          {
+            Stack.Push((UINT64)PlaneMask << 32 | Node.Right);
+            Stack.Push((UINT64)PlaneMask << 32 | Node.Left);
+          }
+        }
+      } /* QueryFrustum */
+
+    /**
+     * @brief Leaves, hit by ray, querying function. Leaves are visited roughly in front to back order.
+     * @param Ray Ray to test leaves by
+     * @param MaxDistance Maximal distance along ray
+     * @param Callback Callback, called as FLOAT(handle Handle, UINT64 UserData, FLOAT BoxDistance) for every hit leaf box,
+     *                 returns new maximal distance: exact hit distance to find the closest hit, MaxDistance to find all hits, negative value to stop query
+    */
+    template <typename callback>
+      VOID QueryRay( const ray &Ray, FLOAT MaxDistance, callback &&Callback ) const
+      {
+        if (Root == INVALID_HANDLE || !Ray.Intersect(Nodes[Root].Box, Ray.GetInverseDirection(), MaxDistance).has_value())
+          return;
+
+        const fvec3 InverseDirection = Ray.GetInverseDirection();
+
+        // Entry holds node index in low and entry distance bits in high dword
+        traversal_stack<UINT64> Stack;
+
+        Stack.Push(Root);
+        while (!Stack.IsEmpty())
+        {
+          const UINT64 Entry = Stack.Pop();
+          const node &Node = Nodes[(UINT32)Entry];
+
+          // Box may be already farther than clipped distance
+          if (std::bit_cast<FLOAT>((UINT32)(Entry >> 32)) > MaxDistance)
+            continue;
+
+          if (Node.IsLeaf())
+          {
+            MaxDistance = Callback(Node.Proxy, Proxies[Node.Proxy].UserData, std::bit_cast<FLOAT>((UINT32)(Entry >> 32)));
+            if (MaxDistance < 0)
+              return;
+            continue;
+          }
+
+          const std::optional<FLOAT>
+            LeftDistance = Ray.Intersect(Nodes[Node.Left].Box, InverseDirection, MaxDistance),
+            RightDistance = Ray.Intersect(Nodes[Node.Right].Box, InverseDirection, MaxDistance);
+          auto MakeEntry = []( UINT32 Index, FLOAT Distance )
+          {
+            return (UINT64)std::bit_cast<UINT32>(Distance) << 32 | Index;
+          };
+
+          // Nearer child is pushed last to be visited first
+          if (LeftDistance.has_value() && RightDistance.has_value())
+          {
+            const BOOL IsLeftNearer = *LeftDistance <= *RightDistance;
+
+            Stack.Push(IsLeftNearer ? MakeEntry(Node.Right, *RightDistance) : MakeEntry(Node.Left, *LeftDistance));
+            Stack.Push(IsLeftNearer ? MakeEntry(Node.Left, *LeftDistance) : MakeEntry(Node.Right, *RightDistance));
+          }
+          else if (LeftDistance.has_value())
+            Stack.Push(MakeEntry(Node.Left, *LeftDistance));
+          else if (RightDistance.has_value())
+            Stack.Push(MakeEntry(Node.Right, *RightDistance));
+        }
+      } /* QueryRay */
+
+  private:
+    /* Hierarchy node */
+    struct node
+    {
+      aabb Box;                        // Node bounding box
+      UINT32 Parent = INVALID_HANDLE;  // Parent node index, next free node index for free nodes
+      UINT32 Left = INVALID_HANDLE;    // Left child index
+      UINT32 Right = INVALID_HANDLE;   // Right child index
+      handle Proxy = INVALID_HANDLE;   // Leaf handle (leaves only)
+      INT32 Height = -1;               // 0 for leaves, -1 for free nodes
+      BOOL IsDirty = FALSE;            // Subtree has leaves, changed by SetBox
+
+      /**
+       * @brief Leaf check function
+       * @return TRUE if node is leaf
+      */
+      BOOL IsLeaf( VOID ) const
+      {
+        return Left == INVALID_HANDLE;
+      } /* IsLeaf */
+    }; /* struct node */
+
+    /* Leaf handle data */
+    struct proxy
+    {
+      UINT32 Node = INVALID_HANDLE; // Leaf node index, next free handle for free handles
+      UINT64 UserData = 0;          // User data
+    }; /* struct proxy */
+
+    /* Leaf description for building */
+    struct build_leaf
+    {
+      aabb Box;      // Leaf box
+      handle Proxy;  // Leaf handle
+    }; /* struct build_leaf */
+
+    /**
+     * @brief Traversal stack with in-place storage, enough for balanced trees
+     * @tparam entry Stack entry type
+    */
+    template <typename entry>
+      class traversal_stack
+      {
+      public:
+        VOID Push( entry Entry )
+        {
+          if (Size < INPLACE_SIZE)
+            InPlace[Size] = Entry;
+          else
+            Overflow.push_back(Entry);
+          Size++;
+        } /* Push */
+
+        entry Pop( VOID )
+        {
+          if (--Size < INPLACE_SIZE)
+            return InPlace[Size];
+
+          entry Entry = Overflow.back();
+
+          Overflow.pop_back();
+          return Entry;
+        } /* Pop */
+
+        BOOL IsEmpty( VOID ) const
+        {
+          return Size == 0;
+        } /* IsEmpty */
+
+      private:
+        constexpr static UINT32 INPLACE_SIZE = 64;
+
+        entry InPlace[INPLACE_SIZE];  // In-place entries
+        std::vector<entry> Overflow;  // Entries above in-place storage
+        UINT32 Size = 0;              // Entry count
+      }; /* class traversal_stack */
+
+    constexpr static UINT32 BIN_COUNT = 16;                 // Count of SAH bins along split axis
+    constexpr static SIZE_T PARALLEL_BUILD_THRESHOLD = 4096; // Minimal count of leaves to build subtree in separate task
+    constexpr static UINT32 PARALLEL_BUILD_MAX_DEPTH = 4;    // Maximal depth of subtree tasks spawning, limits task count to 2^depth
+    constexpr static SIZE_T BULK_REBUILD_MIN_COUNT = 256;    // Minimal count of bulk inserted leaves to rebuild tree instead of inserting them one by one
+    constexpr static SIZE_T BULK_REBUILD_RATIO = 4;          // Bulk inserted leaves rebuild tree, if their count times ratio isn't less than leaf count
+
+    std::vector<node> Nodes;           // Node storage
+    std::vector<proxy> Proxies;        // Leaf handle storage
+    UINT32 Root = INVALID_HANDLE;      // Root node index
+    UINT32 FreeNodeList = INVALID_HANDLE; // First free node index
+    handle FreeProxy = INVALID_HANDLE; // First free handle
+    UINT32 LeafCount = 0;              // Count of leaves
+    FLOAT Margin = 0;                  // Moved leaves box margin
+    FLOAT BuiltCost = 0;               // Cost of tree after last rebuild
+
+    /**
+     * @brief Live handle check function
+     * @param Handle Handle to check
+     * @return TRUE if handle refers to leaf node
+    */
+    BOOL IsProxyAlive( handle Handle ) const
+    {
+      const UINT32 Index = Proxies[Handle].Node;
+
+      return Index < Nodes.size() && Nodes[Index].Height == 0 && Nodes[Index].Proxy == Handle;
+    } /* IsProxyAlive */
+
+    /**
+     * @brief Handle allocation function
+     * @return New handle
+    */
+    handle AllocateProxy( VOID )
+    {
+      if (FreeProxy == INVALID_HANDLE)
+      {
+        Proxies.emplace_back();
+        return (handle)Proxies.size() - 1;
+      }
+
+      const handle Handle = FreeProxy;
+
+      FreeProxy = Proxies[Handle].Node;
+      return Handle;
+    } /* AllocateProxy */
+
+    /**
+     * @brief Node allocation function
+     * @return New node index
+    */
+    UINT32 AllocateNode( VOID )
+    {
+      UINT32 Index;
+
+      if (FreeNodeList == INVALID_HANDLE)
+      {
+        Index = (UINT32)Nodes.size();
+        Nodes.emplace_back();
+      }
+      else
+      {
+        Index = FreeNodeList;
+        FreeNodeList = Nodes[Index].Parent;
+      }
+      Nodes[Index] = node {};
+      return Index;
+    } /* AllocateNode */
+
+    /**
+     * @brief Node freeing function
+     * @param Index Index of node to free
+    */
+    VOID FreeNode( UINT32 Index )
+    {
+      Nodes[Index] = node {};
+      Nodes[Index].Parent = FreeNodeList;
+      FreeNodeList = Index;
+    } /* FreeNode */
+
+    /**
+     * @brief Internal node box and height updating function
+     * @param Index Node index
+    */
+    VOID UpdateNode( UINT32 Index )
+    {
+      node &Node = Nodes[Index];
+
+      Node.Box = Nodes[Node.Left].Box.Union(Nodes[Node.Right].Box);
+      Node.Height = 1 + std::max(Nodes[Node.Left].Height, Nodes[Node.Right].Height);
+    } /* UpdateNode */
+
+    /**
+     * @brief Child replacing function
+     * @param Parent Parent node index, INVALID_HANDLE for root
+     * @param OldChild Child to replace
+     * @param NewChild Child to replace by
+    */
+    VOID ReplaceChild( UINT32 Parent, UINT32 OldChild, UINT32 NewChild )
+    {
+      if (Parent == INVALID_HANDLE)
+        Root = NewChild;
+      else if (Nodes[Parent].Left == OldChild)
+        Nodes[Parent].Left = NewChild;
+      else
+        Nodes[Parent].Right = NewChild;
+      Nodes[NewChild].Parent = Parent;
+    } /* ReplaceChild */
+
+    /**
+     * @brief Leaf node linking function. Sibling is chosen by minimal area increase along descent path.
+     * @param Leaf Leaf node index
+    */
+    VOID InsertLeaf( UINT32 Leaf )
+    {
+      if (Root == INVALID_HANDLE)
+      {
+        Root = Leaf;
+        Nodes[Leaf].Parent = INVALID_HANDLE;
+        Nodes[Leaf].IsDirty = FALSE;
+        return;
+      }
+
+      const aabb LeafBox = Nodes[Leaf].Box;
+      UINT32 Index = Root;
+
+      // Leaf box is exact now, dirty flag must not stop marking of new ancestors
+      Nodes[Leaf].IsDirty = FALSE;
+
+      while (!Nodes[Index].IsLeaf())
+      {
+        const node &Node = Nodes[Index];
+        const FLOAT
+          Area = Node.Box.GetSurfaceArea(),
+          CombinedArea = Node.Box.Union(LeafBox).GetSurfaceArea(),
+          Cost = 2 * CombinedArea,                  // Cost of new parent for this node and leaf
+          InheritanceCost = 2 * (CombinedArea - Area); // Minimal cost of pushing leaf further down
+
+        auto GetDescentCost = [&]( UINT32 Child )
+        {
+          const node &ChildNode = Nodes[Child];
+          const FLOAT ChildArea = ChildNode.Box.Union(LeafBox).GetSurfaceArea();
+
+          return InheritanceCost + (ChildNode.IsLeaf() ? ChildArea : ChildArea - ChildNode.Box.GetSurfaceArea());
+        };
+        const FLOAT LeftCost = GetDescentCost(Node.Left), RightCost = GetDescentCost(Node.Right);
+
+        if (Cost < LeftCost && Cost < RightCost)
+          break;
+        Index = LeftCost < RightCost ? Node.Left : Node.Right;
+      }
+
+      // Link new parent of sibling and leaf
+      const UINT32 Sibling = Index, OldParent = Nodes[Sibling].Parent, NewParent = AllocateNode();
+
+      ReplaceChild(OldParent, Sibling, NewParent);
+      Nodes[NewParent].Left = Sibling;
+      Nodes[NewParent].Right = Leaf;
+      Nodes[NewParent].IsDirty = Nodes[Sibling].IsDirty;
+      Nodes[Sibling].Parent = NewParent;
+      Nodes[Leaf].Parent = NewParent;
+
+      for (Index = NewParent; Index != INVALID_HANDLE; Index = Nodes[Index].Parent)
+      {
+        Index = Balance(Index);
+        UpdateNode(Index);
+      }
+    } /* InsertLeaf */
+
+    /**
+     * @brief Leaf node unlinking function. Node itself isn't freed.
+     * @param Leaf Leaf node index
+    */
+    VOID RemoveLeaf( UINT32 Leaf )
+    {
+      if (Leaf == Root)
+      {
+        Root = INVALID_HANDLE;
+        return;
+      }
+
+      const UINT32
+        Parent = Nodes[Leaf].Parent,
+        GrandParent = Nodes[Parent].Parent,
+        Sibling = Nodes[Parent].Left == Leaf ? Nodes[Parent].Right : Nodes[Parent].Left;
+
+      ReplaceChild(GrandParent, Parent, Sibling);
+      FreeNode(Parent);
+
+      for (UINT32 Index = GrandParent; Index != INVALID_HANDLE; Index = Nodes[Index].Parent)
+      {
+        Index = Balance(Index);
+        UpdateNode(Index);
+      }
+    } /* RemoveLeaf */
+
+    /**
+     * @brief Subtree rotation function. Rotates higher grandchild up if children heights differ by more than one.
+     * @param A Subtree root index
+     * @return New subtree root index
+    */
+    UINT32 Balance( UINT32 A )
+    {
+      node &NodeA = Nodes[A];
+
+      if (NodeA.IsLeaf() || NodeA.Height < 2)
+        return A;
+
+      const UINT32 B = NodeA.Left, C = NodeA.Right;
+      const INT32 Difference = Nodes[C].Height - Nodes[B].Height;
+
+      if (Difference > 1)
+        return Rotate(A, C, B);
+      if (Difference < -1)
+        return Rotate(A, B, C);
+      return A;
+    } /* Balance */
+
+    /**
+     * @brief Higher child up rotation function
+     * @param A Subtree root index
+     * @param High Higher child index, becomes subtree root
+     * @param Low Lower child index
+     * @return New subtree root index
+    */
+    UINT32 Rotate( UINT32 A, UINT32 High, UINT32 Low )
+    {
+      const UINT32 F = Nodes[High].Left, G = Nodes[High].Right;
+
+      // High takes A place, A takes place of High lower child, higher one stays under High
+      ReplaceChild(Nodes[A].Parent, A, High);
+      Nodes[High].IsDirty |= Nodes[A].IsDirty;
+
+      const BOOL IsFHigher = Nodes[F].Height > Nodes[G].Height;
+      const UINT32 Kept = IsFHigher ? F : G, Moved = IsFHigher ? G : F;
+
+      Nodes[High].Left = A;
+      Nodes[High].Right = Kept;
+      Nodes[A].Parent = High;
+
+      if (Nodes[A].Left == High)
+        Nodes[A].Left = Moved;
+      else
+        Nodes[A].Right = Moved;
+      Nodes[Moved].Parent = A;
+      Nodes[A].IsDirty = Nodes[Low].IsDirty || Nodes[Moved].IsDirty;
+
+      UpdateNode(A);
+      UpdateNode(High);
+      return High;
+    } /* Rotate */
+
+    /**
+     * @brief Dirty subtree boxes updating function
+     * @param Index Subtree root index
+    */
+    VOID RefitNode( UINT32 Index )
+    {
+      node &Node = Nodes[Index];
+
+      Node.IsDirty = FALSE;
+      if (Node.IsLeaf())
+        return;
+      if (Nodes[Node.Left].IsDirty)
+        RefitNode(Node.Left);
+      if (Nodes[Node.Right].IsDirty)
+        RefitNode(Node.Right);
+      Node.Box = Nodes[Node.Left].Box.Union(Nodes[Node.Right].Box);
+    } /* RefitNode */
+
+    /**
+     * @brief All subtree leaves reporting function
+     * @param Subtree Subtree root node
+     * @param Callback Query callback
+     * @return FALSE if query was stopped by callback
+    */
+    template <typename callback>
+      BOOL ReportSubtree( const node &Subtree, callback &Callback ) const
+      {
+        traversal_stack<UINT32> Stack;
+
+        Stack.Push(Subtree.Left);
+        Stack.Push(Subtree.Right);
+        while (!Stack.IsEmpty())
+        {
+          const node &Node = Nodes[Stack.Pop()];
+
+          if (Node.IsLeaf())
+          {
+            if (!Callback(Node.Proxy, Proxies[Node.Proxy].UserData))
+              return FALSE;
+          }
+          else
+          {
+            Stack.Push(Node.Right);
+            Stack.Push(Node.Left);
+          }
+        }
+        return TRUE;
+      } /* ReportSubtree */
+
+    /**
+     * @brief Subtree building function. Subtree of N leaves occupies 2N - 1 nodes starting from Index,
+     *        so independent subtrees are built without synchronization.
+     * @param Leaves Subtree leaves, reordered
+     * @param Index Subtree root node index
+     * @param Parent Parent node index
+     * @param Depth Subtree root depth
+    */
+    VOID BuildNode( std::span<build_leaf> Leaves, UINT32 Index, UINT32 Parent, UINT32 Depth )
+    {
+      node &Node = Nodes[Index];
+
+      Node.Parent = Parent;
+      if (Leaves.size() == 1)
+      {
+        Node.Box = Leaves[0].Box;
+        Node.Proxy = Leaves[0].Proxy;
+        Node.Height = 0;
+        // Distinct handles are written by different tasks
+        Proxies[Leaves[0].Proxy].Node = Index;
+        return;
+      }
+
+      // Split along longest axis of centroid bounds
+      aabb CentroidBox {Leaves[0].Box.Min + Leaves[0].Box.Max, Leaves[0].Box.Min + Leaves[0].Box.Max};
+
+      for (const build_leaf &Leaf : Leaves)
+        CentroidBox.Add(Leaf.Box.Min + Leaf.Box.Max);
+
+      const fvec3 CentroidSize = CentroidBox.Max - CentroidBox.Min;
+      const INT Axis = CentroidSize.X >= CentroidSize.Y && CentroidSize.X >= CentroidSize.Z ? 0 : CentroidSize.Y >= CentroidSize.Z ? 1 : 2;
+      const FLOAT AxisMin = CentroidBox.Min.Array[Axis], AxisSize = CentroidSize.Array[Axis];
+      SIZE_T LeftCount = 0;
+
+      if (AxisSize > 0)
+      {
+        auto GetBin = [&]( const build_leaf &Leaf )
+        {
+          const FLOAT Centroid = Leaf.Box.Min.Array[Axis] + Leaf.Box.Max.Array[Axis];
+
+          return std::min((UINT32)((Centroid - AxisMin) / AxisSize * BIN_COUNT), BIN_COUNT - 1);
+        };
+
+        // Bin boxes start inverted, so union with first leaf box gives that box
+        const aabb EmptyBox {fvec3(FLT_MAX), fvec3(-FLT_MAX)};
+        aabb BinBoxes[BIN_COUNT];
+        SIZE_T BinCounts[BIN_COUNT] {};
+
+        std::fill_n(BinBoxes, BIN_COUNT, EmptyBox);
+        for (const build_leaf &Leaf : Leaves)
+        {
+          const UINT32 Bin = GetBin(Leaf);
+
+          BinBoxes[Bin] = BinBoxes[Bin].Union(Leaf.Box);
+          BinCounts[Bin]++;
+        }
+
+        // Sweep right to left for right side areas, then left to right evaluating split costs
+        FLOAT RightAreas[BIN_COUNT] {};
+        aabb Accumulated = EmptyBox;
+
+        for (UINT32 Bin = BIN_COUNT - 1; Bin > 0; Bin--)
+        {
+          Accumulated = Accumulated.Union(BinBoxes[Bin]);
+          RightAreas[Bin] = Accumulated.GetSurfaceArea();
+        }
+
+        FLOAT BestCost = FLT_MAX;
+        UINT32 BestSplit = 0;
+        SIZE_T AccumulatedCount = 0;
+
+        Accumulated = EmptyBox;
+        for (UINT32 Split = 1; Split < BIN_COUNT; Split++)
+        {
+          const UINT32 Bin = Split - 1;
+
+          Accumulated = Accumulated.Union(BinBoxes[Bin]);
+          AccumulatedCount += BinCounts[Bin];
+          if (AccumulatedCount == 0 || AccumulatedCount == Leaves.size())
+            continue;
+
+          const FLOAT Cost = Accumulated.GetSurfaceArea() * AccumulatedCount + RightAreas[Split] * (Leaves.size() - AccumulatedCount);
+
+          if (Cost < BestCost)
+          {
+            BestCost = Cost;
+            BestSplit = Split;
+          }
+        }
+
+        if (BestSplit != 0)
+          LeftCount = std::partition(Leaves.begin(), Leaves.end(), [&]( const build_leaf &Leaf ) { return GetBin(Leaf) < BestSplit; }) - Leaves.begin();
+      }
+
+      // Coincident centroids are split by count
+      if (LeftCount == 0)
+      {
+        LeftCount = Leaves.size() / 2;
+        std::nth_element(Leaves.begin(), Leaves.begin() + LeftCount, Leaves.end(), [&]( const build_leaf &Lhs, const build_leaf &Rhs )
+        {
+          return Lhs.Box.Min.Array[Axis] + Lhs.Box.Max.Array[Axis] < Rhs.Box.Min.Array[Axis] + Rhs.Box.Max.Array[Axis];
+        });
+      }
+
+      const std::span<build_leaf> LeftLeaves = Leaves.first(LeftCount), RightLeaves = Leaves.subspan(LeftCount);
+      const UINT32 Left = Index + 1, Right = Index + 2 * (UINT32)LeftCount;
+
+      if (Leaves.size() >= PARALLEL_BUILD_THRESHOLD && Depth < PARALLEL_BUILD_MAX_DEPTH)
+      {
+        std::future<VOID> LeftTask = std::async(std::launch::async, [&]{ BuildNode(LeftLeaves, Left, Index, Depth + 1); });
+
+        BuildNode(RightLeaves, Right, Index, Depth + 1);
+        LeftTask.get();
+      }
+      else
+      {
+        BuildNode(LeftLeaves, Left, Index, Depth + 1);
+        BuildNode(RightLeaves, Right, Index, Depth + 1);
+      }
+
+      Node.Left = Left;
+      Node.Right = Right;
+      UpdateNode(Index);
+    } /* BuildNode */
+  }; /* class bvh */
+} /* namespace anv::math */
+
+#endif // !defined(ANV_MATH_BVH_H_)
+
+/* file anv_math_bvh.h */
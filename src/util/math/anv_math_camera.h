@@ -9,6 +9,9 @@
 #define ANV_MATH_CAMERA_H_
 
 #include "anv_math.h"
+#include "anv_math_bounds.h"
+
+#include <cfloat>
 
 /**
  * @brief Math utilities namespace
@@ -65,6 +68,34 @@ namespace anv::math::util
     {
       mat4x4<FLOAT> View;       // View matrix
       mat4x4<FLOAT> Projection; // Projection matrix
+
+      /**
+       * @brief View frustum getting function
+       * @return World space view frustum
+      */
+      frustum GetFrustum( VOID ) const
+      {
+        return frustum::FromMatrix(View * Projection);
+      } /* GetFrustum */
+
+      /**
+       * @brief Bounding sphere projected size getting function
+       * @param Center World space sphere center
+       * @param Radius Sphere radius
+       * @return Projected sphere diameter relative to frame height, FLT_MAX if viewer is inside sphere
+      */
+      FLOAT GetProjectedSize( const vec3<FLOAT> &Center, FLOAT Radius ) const
+      {
+        const FLOAT Scale = std::abs(Projection.Data[1][1]);
+
+        // Orthographic projection doesn't depend on distance
+        if (Projection.Data[3][3] != 0)
+          return Radius * Scale;
+
+        const FLOAT Depth = std::abs(Center.X * View.Data[0][2] + Center.Y * View.Data[1][2] + Center.Z * View.Data[2][2] + View.Data[3][2]);
+
+        return Depth <= Radius ? FLT_MAX : Radius * Scale / Depth;
+      } /* GetProjectedSize */
     }; /* projection_matrices */
 
     /**
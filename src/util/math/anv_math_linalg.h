@@ -9,6 +9,7 @@
 #define ANV_MATH_LINALG_H_
 
 #include "util/meta/anv_meta_concepts.h"
+#include "anv_math_simd.h"
 
 #define ANV_MATH_LINALG_VEC2_DEFINE_OPERATOR(Op) \
   inline vec<component, 2>   operator Op   ( const vec<component, 2> &Rhs ) const { return vec<component, 2>(X Op Rhs.X, Y Op Rhs.Y); } \
@@ -804,28 +805,38 @@ namespace anv::math::linalg
       */
       mat operator*( const mat &Rhs ) const
       {
-        return mat
+        if constexpr (std::is_same_v<component, FLOAT>)
         {
-          Data[0][0] * Rhs.Data[0][0] + Data[0][1] * Rhs.Data[1][0] + Data[0][2] * Rhs.Data[2][0] + Data[0][3] * Rhs.Data[3][0],
-          Data[0][0] * Rhs.Data[0][1] + Data[0][1] * Rhs.Data[1][1] + Data[0][2] * Rhs.Data[2][1] + Data[0][3] * Rhs.Data[3][1],
-          Data[0][0] * Rhs.Data[0][2] + Data[0][1] * Rhs.Data[1][2] + Data[0][2] * Rhs.Data[2][2] + Data[0][3] * Rhs.Data[3][2],
-          Data[0][0] * Rhs.Data[0][3] + Data[0][1] * Rhs.Data[1][3] + Data[0][2] * Rhs.Data[2][3] + Data[0][3] * Rhs.Data[3][3],
-
-          Data[1][0] * Rhs.Data[0][0] + Data[1][1] * Rhs.Data[1][0] + Data[1][2] * Rhs.Data[2][0] + Data[1][3] * Rhs.Data[3][0],
-          Data[1][0] * Rhs.Data[0][1] + Data[1][1] * Rhs.Data[1][1] + Data[1][2] * Rhs.Data[2][1] + Data[1][3] * Rhs.Data[3][1],
-          Data[1][0] * Rhs.Data[0][2] + Data[1][1] * Rhs.Data[1][2] + Data[1][2] * Rhs.Data[2][2] + Data[1][3] * Rhs.Data[3][2],
-          Data[1][0] * Rhs.Data[0][3] + Data[1][1] * Rhs.Data[1][3] + Data[1][2] * Rhs.Data[2][3] + Data[1][3] * Rhs.Data[3][3],
-
-          Data[2][0] * Rhs.Data[0][0] + Data[2][1] * Rhs.Data[1][0] + Data[2][2] * Rhs.Data[2][0] + Data[2][3] * Rhs.Data[3][0],
-          Data[2][0] * Rhs.Data[0][1] + Data[2][1] * Rhs.Data[1][1] + Data[2][2] * Rhs.Data[2][1] + Data[2][3] * Rhs.Data[3][1],
-          Data[2][0] * Rhs.Data[0][2] + Data[2][1] * Rhs.Data[1][2] + Data[2][2] * Rhs.Data[2][2] + Data[2][3] * Rhs.Data[3][2],
-          Data[2][0] * Rhs.Data[0][3] + Data[2][1] * Rhs.Data[1][3] + Data[2][2] * Rhs.Data[2][3] + Data[2][3] * Rhs.Data[3][3],
-
-          Data[3][0] * Rhs.Data[0][0] + Data[3][1] * Rhs.Data[1][0] + Data[3][2] * Rhs.Data[2][0] + Data[3][3] * Rhs.Data[3][0],
-          Data[3][0] * Rhs.Data[0][1] + Data[3][1] * Rhs.Data[1][1] + Data[3][2] * Rhs.Data[2][1] + Data[3][3] * Rhs.Data[3][1],
-          Data[3][0] * Rhs.Data[0][2] + Data[3][1] * Rhs.Data[1][2] + Data[3][2] * Rhs.Data[2][2] + Data[3][3] * Rhs.Data[3][2],
-          Data[3][0] * Rhs.Data[0][3] + Data[3][1] * Rhs.Data[1][3] + Data[3][2] * Rhs.Data[2][3] + Data[3][3] * Rhs.Data[3][3]
-        };
+          mat Result;
+
+          simd::MatrixMultiply(Array, Rhs.Array, Result.Array);
+          return Result;
+        }
+        else
+        {
+          return mat
+          {
+            Data[0][0] * Rhs.Data[0][0] + Data[0][1] * Rhs.Data[1][0] + Data[0][2] * Rhs.Data[2][0] + Data[0][3] * Rhs.Data[3][0],
+            Data[0][0] * Rhs.Data[0][1] + Data[0][1] * Rhs.Data[1][1] + Data[0][2] * Rhs.Data[2][1] + Data[0][3] * Rhs.Data[3][1],
+            Data[0][0] * Rhs.Data[0][2] + Data[0][1] * Rhs.Data[1][2] + Data[0][2] * Rhs.Data[2][2] + Data[0][3] * Rhs.Data[3][2],
+            Data[0][0] * Rhs.Data[0][3] + Data[0][1] * Rhs.Data[1][3] + Data[0][2] * Rhs.Data[2][3] + Data[0][3] * Rhs.Data[3][3],
+
+            Data[1][0] * Rhs.Data[0][0] + Data[1][1] * Rhs.Data[1][0] + Data[1][2] * Rhs.Data[2][0] + Data[1][3] * Rhs.Data[3][0],
+            Data[1][0] * Rhs.Data[0][1] + Data[1][1] * Rhs.Data[1][1] + Data[1][2] * Rhs.Data[2][1] + Data[1][3] * Rhs.Data[3][1],
+            Data[1][0] * Rhs.Data[0][2] + Data[1][1] * Rhs.Data[1][2] + Data[1][2] * Rhs.Data[2][2] + Data[1][3] * Rhs.Data[3][2],
+            Data[1][0] * Rhs.Data[0][3] + Data[1][1] * Rhs.Data[1][3] + Data[1][2] * Rhs.Data[2][3] + Data[1][3] * Rhs.Data[3][3],
+
+            Data[2][0] * Rhs.Data[0][0] + Data[2][1] * Rhs.Data[1][0] + Data[2][2] * Rhs.Data[2][0] + Data[2][3] * Rhs.Data[3][0],
+            Data[2][0] * Rhs.Data[0][1] + Data[2][1] * Rhs.Data[1][1] + Data[2][2] * Rhs.Data[2][1] + Data[2][3] * Rhs.Data[3][1],
+            Data[2][0] * Rhs.Data[0][2] + Data[2][1] * Rhs.Data[1][2] + Data[2][2] * Rhs.Data[2][2] + Data[2][3] * Rhs.Data[3][2],
+            Data[2][0] * Rhs.Data[0][3] + Data[2][1] * Rhs.Data[1][3] + Data[2][2] * Rhs.Data[2][3] + Data[2][3] * Rhs.Data[3][3],
+
+            Data[3][0] * Rhs.Data[0][0] + Data[3][1] * Rhs.Data[1][0] + Data[3][2] * Rhs.Data[2][0] + Data[3][3] * Rhs.Data[3][0],
+            Data[3][0] * Rhs.Data[0][1] + Data[3][1] * Rhs.Data[1][1] + Data[3][2] * Rhs.Data[2][1] + Data[3][3] * Rhs.Data[3][1],
+            Data[3][0] * Rhs.Data[0][2] + Data[3][1] * Rhs.Data[1][2] + Data[3][2] * Rhs.Data[2][2] + Data[3][3] * Rhs.Data[3][2],
+            Data[3][0] * Rhs.Data[0][3] + Data[3][1] * Rhs.Data[1][3] + Data[3][2] * Rhs.Data[2][3] + Data[3][3] * Rhs.Data[3][3]
+          };
+        }
       } /* operator*( const mat & ) */
 
       /**
@@ -847,22 +858,29 @@ namespace anv::math::linalg
       */
       component operator!( VOID ) const
       {
-        return
-          +Data[0][0] * mat<component, 3, 3>::Determ(Data[1][1], Data[1][2], Data[1][3],
-                                                     Data[2][1], Data[2][2], Data[2][3],
-                                                     Data[3][1], Data[3][2], Data[3][3]) +
-
-          -Data[0][1] * mat<component, 3, 3>::Determ(Data[1][0], Data[1][2], Data[1][3],
-                                                     Data[2][0], Data[2][2], Data[2][3],
-                                                     Data[3][0], Data[3][2], Data[3][3]) +
-
-          +Data[0][2] * mat<component, 3, 3>::Determ(Data[1][0], Data[1][1], Data[1][3],
-                                                     Data[2][0], Data[2][1], Data[2][3],
-                                                     Data[3][0], Data[3][1], Data[3][3]) +
-
-          -Data[0][3] * mat<component, 3, 3>::Determ(Data[1][0], Data[1][1], Data[1][2],
-                                                     Data[2][0], Data[2][1], Data[2][2],
-                                                     Data[3][0], Data[3][1], Data[3][2]);
+        if constexpr (std::is_same_v<component, FLOAT>)
+        {
+          return simd::MatrixDeterminant(Array);
+        }
+        else
+        {
+          return
+            +Data[0][0] * mat<component, 3, 3>::Determ(Data[1][1], Data[1][2], Data[1][3],
+                                                       Data[2][1], Data[2][2], Data[2][3],
+                                                       Data[3][1], Data[3][2], Data[3][3]) +
+
+            -Data[0][1] * mat<component, 3, 3>::Determ(Data[1][0], Data[1][2], Data[1][3],
+                                                       Data[2][0], Data[2][2], Data[2][3],
+                                                       Data[3][0], Data[3][2], Data[3][3]) +
+
+            +Data[0][2] * mat<component, 3, 3>::Determ(Data[1][0], Data[1][1], Data[1][3],
+                                                       Data[2][0], Data[2][1], Data[2][3],
+                                                       Data[3][0], Data[3][1], Data[3][3]) +
+
+            -Data[0][3] * mat<component, 3, 3>::Determ(Data[1][0], Data[1][1], Data[1][2],
+                                                       Data[2][0], Data[2][1], Data[2][2],
+                                                       Data[3][0], Data[3][1], Data[3][2]);
+        }
       } /* operator! */
 
       /**
@@ -872,65 +890,76 @@ namespace anv::math::linalg
       */
       mat Inversed( VOID ) const
       {
-        component Det = !*this;
-
-        if (Det == 0)
-          return Identity();
+        if constexpr (std::is_same_v<component, FLOAT>)
+        {
+          mat Result;
 
-        return mat
+          if (simd::MatrixInverse(Array, Result.Array) == 0)
+            return Identity();
+          return Result;
+        }
+        else
         {
-          +mat<component, 3, 3>::Determ(Data[1][1], Data[1][2], Data[1][3],
-                                        Data[2][1], Data[2][2], Data[2][3],
-                                        Data[3][1], Data[3][2], Data[3][3]) / Det,
-          -mat<component, 3, 3>::Determ(Data[0][1], Data[0][2], Data[0][3],
-                                        Data[2][1], Data[2][2], Data[2][3],
-                                        Data[3][1], Data[3][2], Data[3][3]) / Det,
-          +mat<component, 3, 3>::Determ(Data[0][1], Data[0][2], Data[0][3],
-                                        Data[1][1], Data[1][2], Data[1][3],
-                                        Data[3][1], Data[3][2], Data[3][3]) / Det,
-          -mat<component, 3, 3>::Determ(Data[0][1], Data[0][2], Data[0][3],
-                                        Data[1][1], Data[1][2], Data[1][3],
-                                        Data[2][1], Data[2][2], Data[2][3]) / Det,
-
-          -mat<component, 3, 3>::Determ(Data[1][0], Data[1][2], Data[1][3],
-                                        Data[2][0], Data[2][2], Data[2][3],
-                                        Data[3][0], Data[3][2], Data[3][3]) / Det,
-          +mat<component, 3, 3>::Determ(Data[0][0], Data[0][2], Data[0][3],
-                                        Data[2][0], Data[2][2], Data[2][3],
-                                        Data[3][0], Data[3][2], Data[3][3]) / Det,
-          -mat<component, 3, 3>::Determ(Data[0][0], Data[0][2], Data[0][3],
-                                        Data[3][0], Data[3][2], Data[3][3],
-                                        Data[1][0], Data[1][2], Data[1][3]) / Det,
-          +mat<component, 3, 3>::Determ(Data[0][0], Data[0][2], Data[0][3],
-                                        Data[1][0], Data[1][2], Data[1][3],
-                                        Data[2][0], Data[2][2], Data[2][3]) / Det,
-
-          +mat<component, 3, 3>::Determ(Data[1][0], Data[1][1], Data[1][3],
-                                        Data[2][0], Data[2][1], Data[2][3],
-                                        Data[3][0], Data[3][1], Data[3][3]) / Det,
-          -mat<component, 3, 3>::Determ(Data[0][0], Data[0][1], Data[0][3],
-                                        Data[2][0], Data[2][1], Data[2][3],
-                                        Data[3][0], Data[3][1], Data[3][3]) / Det,
-          +mat<component, 3, 3>::Determ(Data[0][0], Data[0][1], Data[0][3],
-                                        Data[1][0], Data[1][1], Data[1][3],
-                                        Data[3][0], Data[3][1], Data[3][3]) / Det,
-          -mat<component, 3, 3>::Determ(Data[0][0], Data[0][1], Data[0][3],
-                                        Data[1][0], Data[1][1], Data[1][3],
-                                        Data[2][0], Data[2][1], Data[2][3]) / Det,
-
-          -mat<component, 3, 3>::Determ(Data[1][0], Data[1][1], Data[1][2],
-                                        Data[2][0], Data[2][1], Data[2][2],
-                                        Data[3][0], Data[3][1], Data[3][2]) / Det,
-          +mat<component, 3, 3>::Determ(Data[0][0], Data[0][1], Data[0][2],
-                                        Data[2][0], Data[2][1], Data[2][2],
-                                        Data[3][0], Data[3][1], Data[3][2]) / Det,
-          -mat<component, 3, 3>::Determ(Data[0][0], Data[0][1], Data[0][2],
-                                        Data[1][0], Data[1][1], Data[1][2],
-                                        Data[3][0], Data[3][1], Data[3][2]) / Det,
-          +mat<component, 3, 3>::Determ(Data[0][0], Data[0][1], Data[0][2],
-                                        Data[1][0], Data[1][1], Data[1][2],
-                                        Data[2][0], Data[2][1], Data[2][2]) / Det,
-        };
+          component Det = !*this;
+
+          if (Det == 0)
+            return Identity();
+
+          return mat
+          {
+            +mat<component, 3, 3>::Determ(Data[1][1], Data[1][2], Data[1][3],
+                                          Data[2][1], Data[2][2], Data[2][3],
+                                          Data[3][1], Data[3][2], Data[3][3]) / Det,
+            -mat<component, 3, 3>::Determ(Data[0][1], Data[0][2], Data[0][3],
+                                          Data[2][1], Data[2][2], Data[2][3],
+                                          Data[3][1], Data[3][2], Data[3][3]) / Det,
+            +mat<component, 3, 3>::Determ(Data[0][1], Data[0][2], Data[0][3],
+                                          Data[1][1], Data[1][2], Data[1][3],
+                                          Data[3][1], Data[3][2], Data[3][3]) / Det,
+            -mat<component, 3, 3>::Determ(Data[0][1], Data[0][2], Data[0][3],
+                                          Data[1][1], Data[1][2], Data[1][3],
+                                          Data[2][1], Data[2][2], Data[2][3]) / Det,
+
+            -mat<component, 3, 3>::Determ(Data[1][0], Data[1][2], Data[1][3],
+                                          Data[2][0], Data[2][2], Data[2][3],
+                                          Data[3][0], Data[3][2], Data[3][3]) / Det,
+            +mat<component, 3, 3>::Determ(Data[0][0], Data[0][2], Data[0][3],
+                                          Data[2][0], Data[2][2], Data[2][3],
+                                          Data[3][0], Data[3][2], Data[3][3]) / Det,
+            -mat<component, 3, 3>::Determ(Data[0][0], Data[0][2], Data[0][3],
+                                          Data[1][0], Data[1][2], Data[1][3],
+                                          Data[3][0], Data[3][2], Data[3][3]) / Det,
+            +mat<component, 3, 3>::Determ(Data[0][0], Data[0][2], Data[0][3],
+                                          Data[1][0], Data[1][2], Data[1][3],
+                                          Data[2][0], Data[2][2], Data[2][3]) / Det,
+
+            +mat<component, 3, 3>::Determ(Data[1][0], Data[1][1], Data[1][3],
+                                          Data[2][0], Data[2][1], Data[2][3],
+                                          Data[3][0], Data[3][1], Data[3][3]) / Det,
+            -mat<component, 3, 3>::Determ(Data[0][0], Data[0][1], Data[0][3],
+                                          Data[2][0], Data[2][1], Data[2][3],
+                                          Data[3][0], Data[3][1], Data[3][3]) / Det,
+            +mat<component, 3, 3>::Determ(Data[0][0], Data[0][1], Data[0][3],
+                                          Data[1][0], Data[1][1], Data[1][3],
+                                          Data[3][0], Data[3][1], Data[3][3]) / Det,
+            -mat<component, 3, 3>::Determ(Data[0][0], Data[0][1], Data[0][3],
+                                          Data[1][0], Data[1][1], Data[1][3],
+                                          Data[2][0], Data[2][1], Data[2][3]) / Det,
+
+            -mat<component, 3, 3>::Determ(Data[1][0], Data[1][1], Data[1][2],
+                                          Data[2][0], Data[2][1], Data[2][2],
+                                          Data[3][0], Data[3][1], Data[3][2]) / Det,
+            +mat<component, 3, 3>::Determ(Data[0][0], Data[0][1], Data[0][2],
+                                          Data[2][0], Data[2][1], Data[2][2],
+                                          Data[3][0], Data[3][1], Data[3][2]) / Det,
+            -mat<component, 3, 3>::Determ(Data[0][0], Data[0][1], Data[0][2],
+                                          Data[1][0], Data[1][1], Data[1][2],
+                                          Data[3][0], Data[3][1], Data[3][2]) / Det,
+            +mat<component, 3, 3>::Determ(Data[0][0], Data[0][1], Data[0][2],
+                                          Data[1][0], Data[1][1], Data[1][2],
+                                          Data[2][0], Data[2][1], Data[2][2]) / Det,
+          };
+        }
       } /* Inversed */
 
       /**
@@ -976,14 +1005,24 @@ namespace anv::math::linalg
       */
       vec<component, 3> Transform4x4( const vec<component, 3> &V ) const
       {
-        component W = V.X * Data[0][3] + V.Y * Data[1][3] + V.Z * Data[2][3] + Data[3][3];
+        if constexpr (std::is_same_v<component, FLOAT>)
+        {
+          vec<component, 3> Result;
 
-        return vec<component, 3>
+          simd::TransformPoint4x4(Array, V.Array, Result.Array);
+          return Result;
+        }
+        else
         {
-          (V.X * Data[0][0] + V.Y * Data[1][0] + V.Z * Data[2][0] + Data[3][0]) / W,
-          (V.X * Data[0][1] + V.Y * Data[1][1] + V.Z * Data[2][1] + Data[3][1]) / W,
-          (V.X * Data[0][2] + V.Y * Data[1][2] + V.Z * Data[2][2] + Data[3][2]) / W,
-        };
+          component W = V.X * Data[0][3] + V.Y * Data[1][3] + V.Z * Data[2][3] + Data[3][3];
+
+          return vec<component, 3>
+          {
+            (V.X * Data[0][0] + V.Y * Data[1][0] + V.Z * Data[2][0] + Data[3][0]) / W,
+            (V.X * Data[0][1] + V.Y * Data[1][1] + V.Z * Data[2][1] + Data[3][1]) / W,
+            (V.X * Data[0][2] + V.Y * Data[1][2] + V.Z * Data[2][2] + Data[3][2]) / W,
+          };
+        }
       } /* Transform4x4 */
 
       /**
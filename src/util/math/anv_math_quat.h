@@ -0,0 +1,516 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/util/math/anv_math_quat.h
+ * @description Math quaternion and compact transformation implementation module
+ * @last_update 18.10.2026
+*/
+
+#ifndef ANV_MATH_QUAT_H_
+#define ANV_MATH_QUAT_H_
+
+#include "anv_math_linalg.h"
+
+namespace anv::math::linalg
+{
+  /**
+   * @brief Rotation quaternion class
+   *
+   * Quaternion product follows matrix one: (A * B).ToMatrix() == A.ToMatrix() * B.ToMatrix(), so A * B rotates by A first, then by B.
+   *
+   * @tparam component (arithmetic_type) Quaternion component type
+  */
+  template <arithmetic_type component>
+    struct quat
+    {
+      /// @private
+      union
+      {
+        struct
+        {
+          component X, Y, Z; // Vector part
+          component W;       // Scalar part
+        };
+        component Array[4]; // Quaternion components as array
+      };
+
+      /**
+       * @brief Quaternion default constructor
+       *
+       * @warning Components are uninitialized for better performance
+      */
+      quat( VOID )
+      {
+
+      } /* quat( VOID ) */
+
+      /**
+       * @brief Quaternion from components constructor
+       *
+       * @param X (component) X vector part component
+       * @param Y (component) Y vector part component
+       * @param Z (component) Z vector part component
+       * @param W (component) Scalar part
+      */
+      quat( component X, component Y, component Z, component W ) : X(X), Y(Y), Z(Z), W(W)
+      {
+
+      } /* quat( component, component, component, component ) */
+
+      /**
+       * @brief Identity (no rotation) quaternion building function
+       *
+       * @return (quat) Identity quaternion
+      */
+      static quat Identity( VOID )
+      {
+        return quat(0, 0, 0, 1);
+      } /* Identity */
+
+      /**
+       * @brief Rotate by axis quaternion building function. Rotation direction matches mat::Rotate(Angle, Axis).
+       *
+       * @param Angle (component)                 Angle to rotate by
+       * @param Axis  (const vec<component, 3> &) Axis to rotate along
+       *
+       * @return (quat) Rotation quaternion
+      */
+      static quat Rotate( const component Angle, const vec<component, 3> &Axis )
+      {
+        // mat::Rotate(Angle, Axis) rotates row vectors by -Angle, so does ToMatrix() of this quaternion
+        const vec<component, 3> V = Axis.Normalized() * -std::sin(Angle / 2);
+
+        return quat(V.X, V.Y, V.Z, std::cos(Angle / 2));
+      } /* Rotate */
+
+      /**
+       * @brief Rotation matrix to quaternion conversion function
+       *
+       * @param M (const mat<component, 4, 4> &) Matrix without scale (upper 3x3 part must be orthonormal)
+       *
+       * @return (quat) Rotation quaternion
+      */
+      static quat FromMatrix( const mat<component, 4, 4> &M )
+      {
+        const component Trace = M.Data[0][0] + M.Data[1][1] + M.Data[2][2];
+
+        if (Trace > 0)
+        {
+          const component S = std::sqrt(Trace + 1) * 2;
+
+          return quat((M.Data[1][2] - M.Data[2][1]) / S, (M.Data[2][0] - M.Data[0][2]) / S, (M.Data[0][1] - M.Data[1][0]) / S, S / 4);
+        }
+        if (M.Data[0][0] > M.Data[1][1] && M.Data[0][0] > M.Data[2][2])
+        {
+          const component S = std::sqrt(1 + M.Data[0][0] - M.Data[1][1] - M.Data[2][2]) * 2;
+
+          return quat(S / 4, (M.Data[0][1] + M.Data[1][0]) / S, (M.Data[2][0] + M.Data[0][2]) / S, (M.Data[1][2] - M.Data[2][1]) / S);
+        }
+        if (M.Data[1][1] > M.Data[2][2])
+        {
+          const component S = std::sqrt(1 + M.Data[1][1] - M.Data[0][0] - M.Data[2][2]) * 2;
+
+          return quat((M.Data[0][1] + M.Data[1][0]) / S, S / 4, (M.Data[1][2] + M.Data[2][1]) / S, (M.Data[2][0] - M.Data[0][2]) / S);
+        }
+
+        const component S = std::sqrt(1 + M.Data[2][2] - M.Data[0][0] - M.Data[1][1]) * 2;
+
+        return quat((M.Data[2][0] + M.Data[0][2]) / S, (M.Data[1][2] + M.Data[2][1]) / S, S / 4, (M.Data[0][1] - M.Data[1][0]) / S);
+      } /* FromMatrix */
+
+      /**
+       * @brief Dot product operator
+       *
+       * @param Rhs (const quat &) Quaternion to get dot product with
+       *
+       * @return (component) Dot product
+      */
+      inline component operator&( const quat &Rhs ) const
+      {
+        return X * Rhs.X + Y * Rhs.Y + Z * Rhs.Z + W * Rhs.W;
+      } /* operator& */
+
+      /**
+       * @brief Quaternion length squared getting function
+       *
+       * @return (component) Quaternion length squared
+      */
+      inline component Length2( VOID ) const
+      {
+        return X * X + Y * Y + Z * Z + W * W;
+      } /* Length2 */
+
+      /**
+       * @brief Quaternion normalization function
+       *
+       * @warning Zero-length quaternions aren't handled for better performance
+       *
+       * @return (quat &) Self reference
+      */
+      inline quat & Normalize( VOID )
+      {
+        component L = 1 / std::sqrt(Length2());
+
+        X *= L;
+        Y *= L;
+        Z *= L;
+        W *= L;
+
+        return *this;
+      } /* Normalize */
+
+      /**
+       * @brief Quaternion normalization function
+       *
+       * @warning Zero-length quaternions aren't handled for better performance
+       *
+       * @return (quat) This quaternion normalized
+      */
+      inline quat Normalized( VOID ) const
+      {
+        return quat(*this).Normalize();
+      } /* Normalized */
+
+      /**
+       * @brief Conjugated (for unit quaternions - inversed) quaternion getting function
+       *
+       * @return (quat) Conjugated quaternion
+      */
+      inline quat Conjugated( VOID ) const
+      {
+        return quat(-X, -Y, -Z, W);
+      } /* Conjugated */
+
+      /**
+       * @brief Rotation composition operator
+       *
+       * @param Rhs (const quat &) Rotation to apply after this one
+       *
+       * @return (quat) Composed rotation
+      */
+      inline quat operator*( const quat &Rhs ) const
+      {
+        // Hamilton product Rhs * this
+        return quat
+        (
+          Rhs.W * X + Rhs.X * W + Rhs.Y * Z - Rhs.Z * Y,
+          Rhs.W * Y - Rhs.X * Z + Rhs.Y * W + Rhs.Z * X,
+          Rhs.W * Z + Rhs.X * Y - Rhs.Y * X + Rhs.Z * W,
+          Rhs.W * W - Rhs.X * X - Rhs.Y * Y - Rhs.Z * Z
+        );
+      } /* operator* */
+
+      /**
+       * @brief Rotation composition with assignment operator
+       *
+       * @param Rhs (const quat &) Rotation to apply after this one
+       *
+       * @return (quat &) Self reference
+      */
+      inline quat & operator*=( const quat &Rhs )
+      {
+        return *this = *this * Rhs;
+      } /* operator*= */
+
+      /**
+       * @brief Vector rotation function
+       *
+       * @param V (const vec<component, 3> &) Vector to rotate
+       *
+       * @return (vec<component, 3>) Rotated vector
+      */
+      vec<component, 3> Rotate( const vec<component, 3> &V ) const
+      {
+        const vec<component, 3> Q(X, Y, Z), T = (Q % V) * 2;
+
+        return V + T * W + Q % T;
+      } /* Rotate */
+
+      /**
+       * @brief Rotation matrix building function
+       *
+       * @return (mat<component, 4, 4>) Rotation matrix
+      */
+      mat<component, 4, 4> ToMatrix( VOID ) const
+      {
+        const component
+          XX = 2 * X * X, YY = 2 * Y * Y, ZZ = 2 * Z * Z,
+          XY = 2 * X * Y, XZ = 2 * X * Z, YZ = 2 * Y * Z,
+          WX = 2 * W * X, WY = 2 * W * Y, WZ = 2 * W * Z;
+
+        return mat<component, 4, 4>
+        {
+          1 - YY - ZZ, XY + WZ,     XZ - WY,     0,
+          XY - WZ,     1 - XX - ZZ, YZ + WX,     0,
+          XZ + WY,     YZ - WX,     1 - XX - YY, 0,
+          0,           0,           0,           1,
+        };
+      } /* ToMatrix */
+
+      /**
+       * @brief Normalized linear interpolation function. Fast, but angular speed isn't constant.
+       *
+       * @param A (const quat &)  Start rotation
+       * @param B (const quat &)  End rotation
+       * @param T (component)     Interpolation parameter in [0, 1] range
+       *
+       * @return (quat) Interpolated rotation (by shortest path)
+      */
+      static quat Nlerp( const quat &A, const quat &B, component T )
+      {
+        const component TB = (A & B) < 0 ? -T : T, TA = 1 - T;
+
+        return quat(A.X * TA + B.X * TB, A.Y * TA + B.Y * TB, A.Z * TA + B.Z * TB, A.W * TA + B.W * TB).Normalize();
+      } /* Nlerp */
+
+      /**
+       * @brief Spherical linear interpolation function
+       *
+       * @param A (const quat &)  Start rotation
+       * @param B (const quat &)  End rotation
+       * @param T (component)     Interpolation parameter in [0, 1] range
+       *
+       * @return (quat) Interpolated rotation (by shortest path)
+      */
+      static quat Slerp( const quat &A, const quat &B, component T )
+      {
+        component Cos = A & B, Sign = 1;
+
+        if (Cos < 0)
+        {
+          Cos = -Cos;
+          Sign = -1;
+        }
+
+        // Nearly equal rotations, sin(Angle) is too small to divide by
+        if (Cos > static_cast<component>(0.9995))
+          return Nlerp(A, B, T);
+
+        const component
+          Angle = std::acos(Cos),
+          InvSin = 1 / std::sin(Angle),
+          TA = std::sin((1 - T) * Angle) * InvSin,
+          TB = std::sin(T * Angle) * InvSin * Sign;
+
+        return quat(A.X * TA + B.X * TB, A.Y * TA + B.Y * TB, A.Z * TA + B.Z * TB, A.W * TA + B.W * TB);
+      } /* Slerp */
+    }; /* struct quat */
+
+  /**
+   * @brief Packed translation-rotation-scale transform, GPU representation (32 bytes).
+   *
+   * Matches GLSL std430 struct { vec4 PositionScaleX; uvec2 Rotation; vec2 ScaleYZ; },
+   * rotation is unpacked by vec4(unpackSnorm2x16(Rotation.x), unpackSnorm2x16(Rotation.y)).
+  */
+  struct packed_trs
+  {
+    FLOAT Position[3]; // Translation
+    FLOAT ScaleX;      // X scale
+    UINT32 Rotation[2]; // Rotation quaternion as 4 snorm16 values (XY, ZW)
+    FLOAT ScaleY;      // Y scale
+    FLOAT ScaleZ;      // Z scale
+  }; /* struct packed_trs */
+
+  static_assert(sizeof(packed_trs) == 32, "packed_trs must match GPU layout");
+
+  /**
+   * @brief Translation-rotation-scale transform class. Represents Scale * Rotate * Translate matrix.
+   *
+   * @tparam component (arithmetic_type) Transform component type
+  */
+  template <arithmetic_type component>
+    struct trs
+    {
+      vec<component, 3> Translation; // Translation
+      quat<component> Rotation;      // Rotation (normalized)
+      vec<component, 3> Scale;       // Per-axis scale
+
+      /**
+       * @brief Transform default constructor
+       *
+       * @warning Components are uninitialized for better performance
+      */
+      trs( VOID )
+      {
+
+      } /* trs( VOID ) */
+
+      /**
+       * @brief Transform from components constructor
+       *
+       * @param Translation (const vec<component, 3> &) Translation
+       * @param Rotation    (const quat<component> &)   Rotation
+       * @param Scale       (const vec<component, 3> &) Per-axis scale
+      */
+      trs( const vec<component, 3> &Translation, const quat<component> &Rotation, const vec<component, 3> &Scale = vec<component, 3>(1) ) :
+        Translation(Translation), Rotation(Rotation), Scale(Scale)
+      {
+
+      } /* trs( const vec<component, 3> &, const quat<component> &, const vec<component, 3> & ) */
+
+      /**
+       * @brief Transform with uniform scale constructor
+       *
+       * @param Translation (const vec<component, 3> &) Translation
+       * @param Rotation    (const quat<component> &)   Rotation
+       * @param Scale       (component)                 Uniform scale
+      */
+      trs( const vec<component, 3> &Translation, const quat<component> &Rotation, component Scale ) :
+        Translation(Translation), Rotation(Rotation), Scale(Scale)
+      {
+
+      } /* trs( const vec<component, 3> &, const quat<component> &, component ) */
+
+      /**
+       * @brief Identity transform building function
+       *
+       * @return (trs) Identity transform
+      */
+      static trs Identity( VOID )
+      {
+        return trs(vec<component, 3>(0), quat<component>::Identity(), vec<component, 3>(1));
+      } /* Identity */
+
+      /**
+       * @brief Transformation matrix decomposition function
+       *
+       * @param M (const mat<component, 4, 4> &) Scale * Rotate * Translate matrix (without shear and projection)
+       *
+       * @return (trs) Transform, mirroring is kept as negative X scale
+      */
+      static trs FromMatrix( const mat<component, 4, 4> &M )
+      {
+        vec<component, 3> Rows[3], Scale;
+
+        for (INT i = 0; i < 3; i++)
+        {
+          Rows[i] = vec<component, 3>(M.Data[i][0], M.Data[i][1], M.Data[i][2]);
+          Scale.Array[i] = Rows[i].Length();
+          if (Scale.Array[i] != 0)
+            Rows[i] = Rows[i] * (1 / Scale.Array[i]);
+        }
+
+        // Rotation matrix must have positive determinant
+        if ((Rows[0] % Rows[1] & Rows[2]) < 0)
+        {
+          Scale.X = -Scale.X;
+          Rows[0] = -Rows[0];
+        }
+
+        const mat<component, 4, 4> Rotation
+        {
+          Rows[0].X, Rows[0].Y, Rows[0].Z, 0,
+          Rows[1].X, Rows[1].Y, Rows[1].Z, 0,
+          Rows[2].X, Rows[2].Y, Rows[2].Z, 0,
+          0,         0,         0,         1,
+        };
+
+        return trs(vec<component, 3>(M.Data[3][0], M.Data[3][1], M.Data[3][2]), quat<component>::FromMatrix(Rotation).Normalize(), Scale);
+      } /* FromMatrix */
+
+      /**
+       * @brief Transformation matrix building function
+       *
+       * @return (mat<component, 4, 4>) Scale * Rotate * Translate matrix
+      */
+      mat<component, 4, 4> ToMatrix( VOID ) const
+      {
+        mat<component, 4, 4> Result = Rotation.ToMatrix();
+
+        for (INT i = 0; i < 3; i++)
+        {
+          Result.Data[0][i] *= Scale.X;
+          Result.Data[1][i] *= Scale.Y;
+          Result.Data[2][i] *= Scale.Z;
+        }
+        Result.Data[3][0] = Translation.X;
+        Result.Data[3][1] = Translation.Y;
+        Result.Data[3][2] = Translation.Z;
+
+        return Result;
+      } /* ToMatrix */
+
+      /**
+       * @brief Point transformation function
+       *
+       * @param P (const vec<component, 3> &) Point to transform
+       *
+       * @return (vec<component, 3>) Transformed point
+      */
+      vec<component, 3> TransformPoint( const vec<component, 3> &P ) const
+      {
+        return Rotation.Rotate(P * Scale) + Translation;
+      } /* TransformPoint */
+
+      /**
+       * @brief Transform interpolation function. Translation and scale are interpolated linearly, rotation - by Nlerp.
+       *
+       * @param A (const trs &) Start transform
+       * @param B (const trs &) End transform
+       * @param T (component)   Interpolation parameter in [0, 1] range
+       *
+       * @return (trs) Interpolated transform
+      */
+      static trs Lerp( const trs &A, const trs &B, component T )
+      {
+        return trs
+        (
+          A.Translation + (B.Translation - A.Translation) * T,
+          quat<component>::Nlerp(A.Rotation, B.Rotation, T),
+          A.Scale + (B.Scale - A.Scale) * T
+        );
+      } /* Lerp */
+
+      /**
+       * @brief GPU representation packing function
+       *
+       * @return (packed_trs) Packed transform
+      */
+      packed_trs Packed( VOID ) const
+      {
+        auto PackSnorm2x16 = []( component Lo, component Hi ) -> UINT32
+        {
+          auto Pack = []( component V ) -> UINT32
+          {
+            return static_cast<UINT16>(static_cast<INT16>(std::round(std::clamp<component>(V, -1, 1) * 32767)));
+          };
+
+          return Pack(Lo) | (Pack(Hi) << 16);
+        };
+
+        return packed_trs
+        {
+          .Position = {static_cast<FLOAT>(Translation.X), static_cast<FLOAT>(Translation.Y), static_cast<FLOAT>(Translation.Z)},
+          .ScaleX = static_cast<FLOAT>(Scale.X),
+          .Rotation = {PackSnorm2x16(Rotation.X, Rotation.Y), PackSnorm2x16(Rotation.Z, Rotation.W)},
+          .ScaleY = static_cast<FLOAT>(Scale.Y),
+          .ScaleZ = static_cast<FLOAT>(Scale.Z),
+        };
+      } /* Packed */
+
+      /**
+       * @brief GPU representation unpacking function
+       *
+       * @param Packed (const packed_trs &) Packed transform
+       *
+       * @return (trs) Unpacked transform (rotation is renormalized)
+      */
+      static trs Unpacked( const packed_trs &Packed )
+      {
+        auto Unpack = []( UINT32 Value ) -> component
+        {
+          return std::max<component>(static_cast<component>(static_cast<INT16>(static_cast<UINT16>(Value))) / 32767, -1);
+        };
+
+        return trs
+        (
+          vec<component, 3>(Packed.Position[0], Packed.Position[1], Packed.Position[2]),
+          quat<component>(Unpack(Packed.Rotation[0]), Unpack(Packed.Rotation[0] >> 16), Unpack(Packed.Rotation[1]), Unpack(Packed.Rotation[1] >> 16)).Normalize(),
+          vec<component, 3>(Packed.ScaleX, Packed.ScaleY, Packed.ScaleZ)
+        );
+      } /* Unpacked */
+    }; /* struct trs */
+} /* namespace anv::math::linalg */
+
+#endif // !defined(ANV_MATH_QUAT_H_)
+
+/* file anv_math_quat.h */
@@ -0,0 +1,371 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/util/math/anv_math_simd.h
+ * @description Math SIMD kernels implementation module
+ * @last_update 18.10.2026
+*/
+
+#ifndef ANV_MATH_SIMD_H_
+#define ANV_MATH_SIMD_H_
+
+#include "anv_common.h"
+
+/* Instruction set selection. ANV_MATH_NO_SIMD forces portable implementation.
+ * SSE2 is x64 baseline and is always used there. AVX kernels are compiled only if whole project is built for AVX
+ * (/arch:AVX or -mavx), which makes the binary require AVX capable CPU, so project configurations keep SSE2 baseline. */
+#ifndef ANV_MATH_NO_SIMD
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define ANV_MATH_SIMD_SSE
+#    include <emmintrin.h>
+#  endif
+#  if defined(ANV_MATH_SIMD_SSE) && defined(__AVX__)
+#    define ANV_MATH_SIMD_AVX
+#    include <immintrin.h>
+#  endif
+#endif // !defined(ANV_MATH_NO_SIMD)
+
+/**
+ * @brief SIMD math kernels namespace. All matrices are row-major FLOAT[16] arrays (as mat<FLOAT, 4, 4>::Array), no alignment is required.
+*/
+namespace anv::math::simd
+{
+#ifdef ANV_MATH_SIMD_SSE
+  /**
+   * @brief Shuffle mask building function
+   * @return _mm_shuffle_ps mask, that selects (X, Y, Z, W) components
+  */
+  consteval INT ShuffleMask( INT X, INT Y, INT Z, INT W )
+  {
+    return X | (Y << 2) | (Z << 4) | (W << 6);
+  } /* ShuffleMask */
+
+  /**
+   * @brief 2x2 row-major matrix product function
+   * @return A * B
+  */
+  inline __m128 Mat2Mul( __m128 A, __m128 B )
+  {
+    return _mm_add_ps(
+      _mm_mul_ps(A, _mm_shuffle_ps(B, B, ShuffleMask(0, 3, 0, 3))),
+      _mm_mul_ps(_mm_shuffle_ps(A, A, ShuffleMask(1, 0, 3, 2)), _mm_shuffle_ps(B, B, ShuffleMask(2, 1, 2, 1)))
+    );
+  } /* Mat2Mul */
+
+  /**
+   * @brief 2x2 row-major matrix adjugate product function
+   * @return adj(A) * B
+  */
+  inline __m128 Mat2AdjMul( __m128 A, __m128 B )
+  {
+    return _mm_sub_ps(
+      _mm_mul_ps(_mm_shuffle_ps(A, A, ShuffleMask(3, 3, 0, 0)), B),
+      _mm_mul_ps(_mm_shuffle_ps(A, A, ShuffleMask(1, 1, 2, 2)), _mm_shuffle_ps(B, B, ShuffleMask(2, 3, 0, 1)))
+    );
+  } /* Mat2AdjMul */
+
+  /**
+   * @brief 2x2 row-major matrix by adjugate product function
+   * @return A * adj(B)
+  */
+  inline __m128 Mat2MulAdj( __m128 A, __m128 B )
+  {
+    return _mm_sub_ps(
+      _mm_mul_ps(A, _mm_shuffle_ps(B, B, ShuffleMask(3, 0, 3, 0))),
+      _mm_mul_ps(_mm_shuffle_ps(A, A, ShuffleMask(1, 0, 3, 2)), _mm_shuffle_ps(B, B, ShuffleMask(2, 1, 2, 1)))
+    );
+  } /* Mat2MulAdj */
+
+  /**
+   * @brief 4x4 matrix inverse function. Matrix is split into 2x2 blocks, inverse is built with block-wise adjugates.
+   * @param Rows Source matrix rows
+   * @param Result Inversed matrix rows (not written if determinant is 0)
+   * @return Determinant, splatted to all components
+  */
+  inline __m128 InverseRows( const __m128 (&Rows)[4], __m128 (&Result)[4] )
+  {
+    // 2x2 blocks (A B)
+    //            (C D)
+    __m128
+      A = _mm_movelh_ps(Rows[0], Rows[1]),
+      B = _mm_movehl_ps(Rows[1], Rows[0]),
+      C = _mm_movelh_ps(Rows[2], Rows[3]),
+      D = _mm_movehl_ps(Rows[3], Rows[2]);
+
+    // Block determinants (|A|, |B|, |C|, |D|)
+    __m128 BlockDeterminants = _mm_sub_ps(
+      _mm_mul_ps(_mm_shuffle_ps(Rows[0], Rows[2], ShuffleMask(0, 2, 0, 2)), _mm_shuffle_ps(Rows[1], Rows[3], ShuffleMask(1, 3, 1, 3))),
+      _mm_mul_ps(_mm_shuffle_ps(Rows[0], Rows[2], ShuffleMask(1, 3, 1, 3)), _mm_shuffle_ps(Rows[1], Rows[3], ShuffleMask(0, 2, 0, 2)))
+    );
+    __m128
+      DetA = _mm_shuffle_ps(BlockDeterminants, BlockDeterminants, ShuffleMask(0, 0, 0, 0)),
+      DetB = _mm_shuffle_ps(BlockDeterminants, BlockDeterminants, ShuffleMask(1, 1, 1, 1)),
+      DetC = _mm_shuffle_ps(BlockDeterminants, BlockDeterminants, ShuffleMask(2, 2, 2, 2)),
+      DetD = _mm_shuffle_ps(BlockDeterminants, BlockDeterminants, ShuffleMask(3, 3, 3, 3));
+
+    __m128
+      AdjDC = Mat2AdjMul(D, C),
+      AdjAB = Mat2AdjMul(A, B);
+
+    __m128
+      X = _mm_sub_ps(_mm_mul_ps(DetD, A), Mat2Mul(B, AdjDC)),
+      W = _mm_sub_ps(_mm_mul_ps(DetA, D), Mat2Mul(C, AdjAB)),
+      Y = _mm_sub_ps(_mm_mul_ps(DetB, C), Mat2MulAdj(D, AdjAB)),
+      Z = _mm_sub_ps(_mm_mul_ps(DetC, B), Mat2MulAdj(A, AdjDC));
+
+    // |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+    __m128 Trace = _mm_mul_ps(AdjAB, _mm_shuffle_ps(AdjDC, AdjDC, ShuffleMask(0, 2, 1, 3)));
+    Trace = _mm_add_ps(Trace, _mm_shuffle_ps(Trace, Trace, ShuffleMask(2, 3, 0, 1)));
+    Trace = _mm_add_ps(Trace, _mm_shuffle_ps(Trace, Trace, ShuffleMask(1, 0, 3, 2)));
+
+    __m128 Det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(DetA, DetD), _mm_mul_ps(DetB, DetC)), Trace);
+
+    if (_mm_cvtss_f32(Det) == 0)
+      return Det;
+
+    __m128 InvDet = _mm_div_ps(_mm_setr_ps(1, -1, -1, 1), Det);
+
+    X = _mm_mul_ps(X, InvDet);
+    Y = _mm_mul_ps(Y, InvDet);
+    Z = _mm_mul_ps(Z, InvDet);
+    W = _mm_mul_ps(W, InvDet);
+
+    Result[0] = _mm_shuffle_ps(X, Y, ShuffleMask(3, 1, 3, 1));
+    Result[1] = _mm_shuffle_ps(X, Y, ShuffleMask(2, 0, 2, 0));
+    Result[2] = _mm_shuffle_ps(Z, W, ShuffleMask(3, 1, 3, 1));
+    Result[3] = _mm_shuffle_ps(Z, W, ShuffleMask(2, 0, 2, 0));
+
+    return Det;
+  } /* InverseRows */
+#endif // defined(ANV_MATH_SIMD_SSE)
+
+  /**
+   * @brief 4x4 matrix product function
+   * @param Lhs Left matrix
+   * @param Rhs Right matrix
+   * @param Result Product matrix (may alias Lhs or Rhs)
+  */
+  inline VOID MatrixMultiply( const FLOAT *Lhs, const FLOAT *Rhs, FLOAT *Result )
+  {
+#if defined(ANV_MATH_SIMD_AVX)
+    // Two result rows per register, every Rhs row is duplicated to both lanes
+    __m256
+      R0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(Rhs + 0)),
+      R1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(Rhs + 4)),
+      R2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(Rhs + 8)),
+      R3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(Rhs + 12));
+    __m256
+      L01 = _mm256_loadu_ps(Lhs + 0),
+      L23 = _mm256_loadu_ps(Lhs + 8);
+
+    __m256 P01 = _mm256_mul_ps(_mm256_shuffle_ps(L01, L01, 0x00), R0);
+    P01 = _mm256_add_ps(P01, _mm256_mul_ps(_mm256_shuffle_ps(L01, L01, 0x55), R1));
+    P01 = _mm256_add_ps(P01, _mm256_mul_ps(_mm256_shuffle_ps(L01, L01, 0xAA), R2));
+    P01 = _mm256_add_ps(P01, _mm256_mul_ps(_mm256_shuffle_ps(L01, L01, 0xFF), R3));
+
+    __m256 P23 = _mm256_mul_ps(_mm256_shuffle_ps(L23, L23, 0x00), R0);
+    P23 = _mm256_add_ps(P23, _mm256_mul_ps(_mm256_shuffle_ps(L23, L23, 0x55), R1));
+    P23 = _mm256_add_ps(P23, _mm256_mul_ps(_mm256_shuffle_ps(L23, L23, 0xAA), R2));
+    P23 = _mm256_add_ps(P23, _mm256_mul_ps(_mm256_shuffle_ps(L23, L23, 0xFF), R3));
+
+    _mm256_storeu_ps(Result + 0, P01);
+    _mm256_storeu_ps(Result + 8, P23);
+#elif defined(ANV_MATH_SIMD_SSE)
+    __m128
+      R0 = _mm_loadu_ps(Rhs + 0),
+      R1 = _mm_loadu_ps(Rhs + 4),
+      R2 = _mm_loadu_ps(Rhs + 8),
+      R3 = _mm_loadu_ps(Rhs + 12);
+    __m128 Products[4];
+
+    for (INT i = 0; i < 4; i++)
+    {
+      __m128 L = _mm_loadu_ps(Lhs + i * 4);
+
+      __m128 P = _mm_mul_ps(_mm_shuffle_ps(L, L, 0x00), R0);
+      P = _mm_add_ps(P, _mm_mul_ps(_mm_shuffle_ps(L, L, 0x55), R1));
+      P = _mm_add_ps(P, _mm_mul_ps(_mm_shuffle_ps(L, L, 0xAA), R2));
+      P = _mm_add_ps(P, _mm_mul_ps(_mm_shuffle_ps(L, L, 0xFF), R3));
+      Products[i] = P;
+    }
+    for (INT i = 0; i < 4; i++)
+      _mm_storeu_ps(Result + i * 4, Products[i]);
+#else
+    FLOAT Products[16];
+
+    for (INT i = 0; i < 4; i++)
+      for (INT j = 0; j < 4; j++)
+        Products[i * 4 + j] =
+          Lhs[i * 4 + 0] * Rhs[0 * 4 + j] +
+          Lhs[i * 4 + 1] * Rhs[1 * 4 + j] +
+          Lhs[i * 4 + 2] * Rhs[2 * 4 + j] +
+          Lhs[i * 4 + 3] * Rhs[3 * 4 + j];
+    std::copy_n(Products, 16, Result);
+#endif
+  } /* MatrixMultiply */
+
+  /**
+   * @brief 4x4 matrix inverse function
+   * @param Matrix Matrix to inverse
+   * @param Result Inversed matrix (may alias Matrix). Not written if determinant is 0.
+   * @return Matrix determinant
+  */
+  inline FLOAT MatrixInverse( const FLOAT *Matrix, FLOAT *Result )
+  {
+#ifdef ANV_MATH_SIMD_SSE
+    __m128 Rows[4]
+    {
+      _mm_loadu_ps(Matrix + 0),
+      _mm_loadu_ps(Matrix + 4),
+      _mm_loadu_ps(Matrix + 8),
+      _mm_loadu_ps(Matrix + 12),
+    };
+    __m128 InversedRows[4];
+    FLOAT Det = _mm_cvtss_f32(InverseRows(Rows, InversedRows));
+
+    if (Det != 0)
+      for (INT i = 0; i < 4; i++)
+        _mm_storeu_ps(Result + i * 4, InversedRows[i]);
+    return Det;
+#else
+    // 2x2 minors of upper (S) and lower (C) row pairs
+    const FLOAT *M = Matrix;
+    FLOAT
+      S0 = M[0] * M[5]  - M[4] * M[1],
+      S1 = M[0] * M[6]  - M[4] * M[2],
+      S2 = M[0] * M[7]  - M[4] * M[3],
+      S3 = M[1] * M[6]  - M[5] * M[2],
+      S4 = M[1] * M[7]  - M[5] * M[3],
+      S5 = M[2] * M[7]  - M[6] * M[3],
+      C5 = M[10] * M[15] - M[14] * M[11],
+      C4 = M[9]  * M[15] - M[13] * M[11],
+      C3 = M[9]  * M[14] - M[13] * M[10],
+      C2 = M[8]  * M[15] - M[12] * M[11],
+      C1 = M[8]  * M[14] - M[12] * M[10],
+      C0 = M[8]  * M[13] - M[12] * M[9];
+
+    FLOAT Det = S0 * C5 - S1 * C4 + S2 * C3 + S3 * C2 - S4 * C1 + S5 * C0;
+    if (Det == 0)
+      return Det;
+
+    FLOAT InvDet = 1 / Det;
+    FLOAT Inversed[16]
+    {
+      ( M[5]  * C5 - M[6]  * C4 + M[7]  * C3) * InvDet,
+      (-M[1]  * C5 + M[2]  * C4 - M[3]  * C3) * InvDet,
+      ( M[13] * S5 - M[14] * S4 + M[15] * S3) * InvDet,
+      (-M[9]  * S5 + M[10] * S4 - M[11] * S3) * InvDet,
+
+      (-M[4]  * C5 + M[6]  * C2 - M[7]  * C1) * InvDet,
+      ( M[0]  * C5 - M[2]  * C2 + M[3]  * C1) * InvDet,
+      (-M[12] * S5 + M[14] * S2 - M[15] * S1) * InvDet,
+      ( M[8]  * S5 - M[10] * S2 + M[11] * S1) * InvDet,
+
+      ( M[4]  * C4 - M[5]  * C2 + M[7]  * C0) * InvDet,
+      (-M[0]  * C4 + M[1]  * C2 - M[3]  * C0) * InvDet,
+      ( M[12] * S4 - M[13] * S2 + M[15] * S0) * InvDet,
+      (-M[8]  * S4 + M[9]  * S2 - M[11] * S0) * InvDet,
+
+      (-M[4]  * C3 + M[5]  * C1 - M[6]  * C0) * InvDet,
+      ( M[0]  * C3 - M[1]  * C1 + M[2]  * C0) * InvDet,
+      (-M[12] * S3 + M[13] * S1 - M[14] * S0) * InvDet,
+      ( M[8]  * S3 - M[9]  * S1 + M[10] * S0) * InvDet,
+    };
+    std::copy_n(Inversed, 16, Result);
+    return Det;
+#endif
+  } /* MatrixInverse */
+
+  /**
+   * @brief 4x4 matrix determinant getting function
+   * @param Matrix Matrix to get determinant of
+   * @return Determinant
+  */
+  inline FLOAT MatrixDeterminant( const FLOAT *Matrix )
+  {
+    const FLOAT *M = Matrix;
+
+#ifdef ANV_MATH_SIMD_SSE
+    // Upper (S) and lower (C) row pair 2x2 minors, computed 4 at once
+    __m128
+      R0 = _mm_loadu_ps(M + 0),
+      R1 = _mm_loadu_ps(M + 4),
+      R2 = _mm_loadu_ps(M + 8),
+      R3 = _mm_loadu_ps(M + 12);
+
+    // S0, S1, S2, S3 and C5, C4, C3, C2
+    __m128 S0123 = _mm_sub_ps(
+      _mm_mul_ps(_mm_shuffle_ps(R0, R0, ShuffleMask(0, 0, 0, 1)), _mm_shuffle_ps(R1, R1, ShuffleMask(1, 2, 3, 2))),
+      _mm_mul_ps(_mm_shuffle_ps(R1, R1, ShuffleMask(0, 0, 0, 1)), _mm_shuffle_ps(R0, R0, ShuffleMask(1, 2, 3, 2)))
+    );
+    __m128 C5432 = _mm_sub_ps(
+      _mm_mul_ps(_mm_shuffle_ps(R2, R2, ShuffleMask(2, 1, 1, 0)), _mm_shuffle_ps(R3, R3, ShuffleMask(3, 3, 2, 3))),
+      _mm_mul_ps(_mm_shuffle_ps(R3, R3, ShuffleMask(2, 1, 1, 0)), _mm_shuffle_ps(R2, R2, ShuffleMask(3, 3, 2, 3)))
+    );
+    __m128 Products = _mm_mul_ps(_mm_mul_ps(S0123, C5432), _mm_setr_ps(1, -1, 1, 1));
+    Products = _mm_add_ps(Products, _mm_shuffle_ps(Products, Products, ShuffleMask(2, 3, 0, 1)));
+    Products = _mm_add_ps(Products, _mm_shuffle_ps(Products, Products, ShuffleMask(1, 0, 3, 2)));
+
+    FLOAT
+      S4 = M[1] * M[7] - M[5] * M[3],
+      S5 = M[2] * M[7] - M[6] * M[3],
+      C1 = M[8] * M[14] - M[12] * M[10],
+      C0 = M[8] * M[13] - M[12] * M[9];
+
+    return _mm_cvtss_f32(Products) - S4 * C1 + S5 * C0;
+#else
+    FLOAT
+      S0 = M[0] * M[5]  - M[4] * M[1],
+      S1 = M[0] * M[6]  - M[4] * M[2],
+      S2 = M[0] * M[7]  - M[4] * M[3],
+      S3 = M[1] * M[6]  - M[5] * M[2],
+      S4 = M[1] * M[7]  - M[5] * M[3],
+      S5 = M[2] * M[7]  - M[6] * M[3],
+      C5 = M[10] * M[15] - M[14] * M[11],
+      C4 = M[9]  * M[15] - M[13] * M[11],
+      C3 = M[9]  * M[14] - M[13] * M[10],
+      C2 = M[8]  * M[15] - M[12] * M[11],
+      C1 = M[8]  * M[14] - M[12] * M[10],
+      C0 = M[8]  * M[13] - M[12] * M[9];
+
+    return S0 * C5 - S1 * C4 + S2 * C3 + S3 * C2 - S4 * C1 + S5 * C0;
+#endif
+  } /* MatrixDeterminant */
+
+  /**
+   * @brief Point by 4x4 matrix transformation function (with perspective division)
+   * @param Matrix Transformation matrix
+   * @param Point Point (X, Y, Z) to transform, W is considered to be 1
+   * @param Result Transformed point (X, Y, Z)
+  */
+  inline VOID TransformPoint4x4( const FLOAT *Matrix, const FLOAT *Point, FLOAT *Result )
+  {
+#ifdef ANV_MATH_SIMD_SSE
+    __m128 P = _mm_add_ps(
+      _mm_add_ps(
+        _mm_mul_ps(_mm_set1_ps(Point[0]), _mm_loadu_ps(Matrix + 0)),
+        _mm_mul_ps(_mm_set1_ps(Point[1]), _mm_loadu_ps(Matrix + 4))
+      ),
+      _mm_add_ps(
+        _mm_mul_ps(_mm_set1_ps(Point[2]), _mm_loadu_ps(Matrix + 8)),
+        _mm_loadu_ps(Matrix + 12)
+      )
+    );
+    P = _mm_div_ps(P, _mm_shuffle_ps(P, P, ShuffleMask(3, 3, 3, 3)));
+
+    alignas(16) FLOAT Transformed[4];
+    _mm_store_ps(Transformed, P);
+    std::copy_n(Transformed, 3, Result);
+#else
+    FLOAT Transformed[4];
+
+    for (INT i = 0; i < 4; i++)
+      Transformed[i] = Point[0] * Matrix[0 * 4 + i] + Point[1] * Matrix[1 * 4 + i] + Point[2] * Matrix[2 * 4 + i] + Matrix[3 * 4 + i];
+    for (INT i = 0; i < 3; i++)
+      Result[i] = Transformed[i] / Transformed[3];
+#endif
+  } /* TransformPoint4x4 */
+} /* namespace anv::math::simd */
+
+#endif // !defined(ANV_MATH_SIMD_H_)
+
+/* file anv_math_simd.h */
@@ -115,6 +115,30 @@ namespace anv::rc
         return LastFreeResourceIndex != 0;
       } /* CollectGarbage */
 
+      /**
+       * @brief Garbage collection with deferred destruction function
+       * @param Defer Callable, that takes resource destroy callback and calls it when resource is unused by anybody (e.g. GPU)
+       * @return TRUE if any resource is left in pool, FALSE otherwise.
+      */
+      template <typename defer_type>
+        BOOL CollectGarbage( defer_type Defer )
+        {
+          UINT32 LastFreeResourceIndex = 0;
+
+          // Resource leaves pool immediately, so it isn't destroyed twice
+          for (resource_type *Resource : Resources)
+          {
+            if (Resource->UseCount <= 0)
+              Defer([Resource]( VOID ) { Resource->OnDestroy(); });
+            else
+              Resources[LastFreeResourceIndex++] = Resource;
+          }
+
+          Resources.resize(LastFreeResourceIndex);
+
+          return LastFreeResourceIndex != 0;
+        } /* CollectGarbage */
+
       /**
        * @brief Resource pool clearing function
        * @return TRUE if cleared, FALSE otherwise.
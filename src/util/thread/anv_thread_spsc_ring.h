@@ -0,0 +1,73 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/util/thread/anv_thread_spsc_ring.h
+ * @description Lock-free single-producer single-consumer ring implementation module
+ * @last_update 18.10.2026
+*/
+
+#ifndef ANV_THREAD_SPSC_RING_H_
+#define ANV_THREAD_SPSC_RING_H_
+
+#include "anv_thread_task_queue.h"
+
+/**
+ * @brief Threading utilities namespace
+*/
+namespace anv::thread
+{
+  /**
+   * @brief Bounded single-producer single-consumer lock-free ring
+   * @tparam value_type Ring element type (must be copy-assignable)
+   * @tparam CAPACITY Ring capacity, must be power of two
+  */
+  template <typename value_type, SIZE_T CAPACITY>
+    requires (CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0)
+    class spsc_ring
+    {
+      value_type Values[CAPACITY];                                              // Ring elements
+      std::atomic<SIZE_T> WritePosition = 0;                                    // Position to write to, owned by producer
+      BYTE WritePositionPadding[CACHE_LINE_SIZE - sizeof(std::atomic<SIZE_T>)]; // Padding between producer and consumer positions
+      std::atomic<SIZE_T> ReadPosition = 0;                                     // Position to read from, owned by consumer
+
+    public:
+      /**
+       * @brief Value pushing function, must be called from producer thread only
+       * @param Value Value to push
+       * @return TRUE if pushed, FALSE if ring is full
+      */
+      BOOL TryPush( const value_type &Value )
+      {
+        SIZE_T Write = WritePosition.load(std::memory_order_relaxed);
+
+        if (Write - ReadPosition.load(std::memory_order_acquire) == CAPACITY)
+          return FALSE;
+
+        Values[Write & (CAPACITY - 1)] = Value;
+        WritePosition.store(Write + 1, std::memory_order_release);
+
+        return TRUE;
+      } /* TryPush */
+
+      /**
+       * @brief Value popping function, must be called from consumer thread only
+       * @param Value Value to pop into
+       * @return TRUE if popped, FALSE if ring is empty
+      */
+      BOOL TryPop( value_type &Value )
+      {
+        SIZE_T Read = ReadPosition.load(std::memory_order_relaxed);
+
+        if (Read == WritePosition.load(std::memory_order_acquire))
+          return FALSE;
+
+        Value = Values[Read & (CAPACITY - 1)];
+        ReadPosition.store(Read + 1, std::memory_order_release);
+
+        return TRUE;
+      } /* TryPop */
+    }; /* class spsc_ring */
+} /* namespace anv::thread */
+
+#endif // !defined(ANV_THREAD_SPSC_RING_H_)
+
+/* file anv_thread_spsc_ring.h */
@@ -0,0 +1,266 @@
+/**
+ * @brief       ANIM-VK Project
+ * @file        src/util/thread/anv_thread_task_queue.h
+ * @description Lock-free task queue implementation module
+ * @last_update 18.10.2026
+*/
+
+#ifndef ANV_THREAD_TASK_QUEUE_H_
+#define ANV_THREAD_TASK_QUEUE_H_
+
+#include "anv_common.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+/**
+ * @brief Threading utilities namespace
+*/
+namespace anv::thread
+{
+  /**
+   * @brief Cache line size, used for false sharing avoidance
+  */
+  inline constexpr SIZE_T CACHE_LINE_SIZE = 64;
+
+  /**
+   * @brief Move-only callable wrapper with in-place storage (never allocates)
+   * @tparam STORAGE_SIZE Size of callable storage in bytes
+  */
+  template <SIZE_T STORAGE_SIZE>
+    class inplace_task
+    {
+      /* Storage management operation */
+      enum class operation
+      {
+        eMove,    // Move-construct Dst from Src, then destroy Src
+        eDestroy, // Destroy Src
+      }; /* enum class operation */
+
+      alignas(std::max_align_t) BYTE Storage[STORAGE_SIZE]; // Callable storage
+
+      VOID (*InvokeFunction)( VOID *Storage ) = nullptr;                           // Stored callable invoke function
+      VOID (*ManageFunction)( operation Operation, VOID *Dst, VOID *Src ) = nullptr; // Stored callable management function
+
+      /**
+       * @brief Stored callable moving function
+       * @param Rhs Task to move callable from
+      */
+      VOID MoveFrom( inplace_task &Rhs ) noexcept
+      {
+        if (Rhs.ManageFunction == nullptr)
+          return;
+
+        Rhs.ManageFunction(operation::eMove, Storage, Rhs.Storage);
+        InvokeFunction = Rhs.InvokeFunction;
+        ManageFunction = Rhs.ManageFunction;
+
+        Rhs.InvokeFunction = nullptr;
+        Rhs.ManageFunction = nullptr;
+      } /* MoveFrom */
+
+    public:
+      /**
+       * @brief Empty task constructor
+      */
+      inplace_task( VOID ) noexcept
+      {
+
+      } /* inplace_task */
+
+      /**
+       * @brief Task from callable constructor
+       * @param Callable Callable to store
+      */
+      template <typename callable_type>
+        requires (!std::is_same_v<std::decay_t<callable_type>, inplace_task> && std::is_invocable_v<std::decay_t<callable_type> &>)
+        inplace_task( callable_type &&Callable )
+        {
+          using stored_type = std::decay_t<callable_type>;
+
+          static_assert(sizeof(stored_type) <= STORAGE_SIZE, "Callable is too large for in-place task storage");
+          static_assert(alignof(stored_type) <= alignof(std::max_align_t), "Callable is overaligned for in-place task storage");
+          static_assert(std::is_nothrow_move_constructible_v<stored_type>, "Callable must be nothrow move constructible");
+
+          std::construct_at(reinterpret_cast<stored_type *>(Storage), std::forward<callable_type>(Callable));
+
+          InvokeFunction = []( VOID *Storage )
+          {
+            (*std::launder(reinterpret_cast<stored_type *>(Storage)))();
+          };
+          ManageFunction = []( operation Operation, VOID *Dst, VOID *Src )
+          {
+            stored_type *SrcCallable = std::launder(reinterpret_cast<stored_type *>(Src));
+
+            if (Operation == operation::eMove)
+              std::construct_at(reinterpret_cast<stored_type *>(Dst), std::move(*SrcCallable));
+            std::destroy_at(SrcCallable);
+          };
+        } /* inplace_task */
+
+      /**
+       * @brief Move constructor
+       * @param Rhs Task to move
+      */
+      inplace_task( inplace_task &&Rhs ) noexcept
+      {
+        MoveFrom(Rhs);
+      } /* inplace_task */
+
+      /**
+       * @brief Move assignment operator
+       * @param Rhs Task to move
+       * @return Self reference
+      */
+      inplace_task & operator=( inplace_task &&Rhs ) noexcept
+      {
+        if (this != &Rhs)
+        {
+          Reset();
+          MoveFrom(Rhs);
+        }
+        return *this;
+      } /* operator= */
+
+      inplace_task( const inplace_task & ) = delete;
+      inplace_task & operator=( const inplace_task & ) = delete;
+
+      /**
+       * @brief Stored callable destroying function
+      */
+      VOID Reset( VOID ) noexcept
+      {
+        if (ManageFunction != nullptr)
+          ManageFunction(operation::eDestroy, nullptr, Storage);
+        InvokeFunction = nullptr;
+        ManageFunction = nullptr;
+      } /* Reset */
+
+      /**
+       * @brief Stored callable invoking operator
+      */
+      VOID operator()( VOID )
+      {
+        InvokeFunction(Storage);
+      } /* operator() */
+
+      /**
+       * @brief Task emptiness check operator
+       * @return TRUE if task holds callable, FALSE otherwise
+      */
+      explicit operator BOOL( VOID ) const noexcept
+      {
+        return InvokeFunction != nullptr;
+      } /* operator BOOL */
+
+      /**
+       * @brief Task destructor
+      */
+      ~inplace_task( VOID )
+      {
+        Reset();
+      } /* ~inplace_task */
+    }; /* class inplace_task */
+
+  /**
+   * @brief Bounded multiple-producer single-consumer lock-free queue
+   * @tparam value_type Queue element type (must be default-constructible and move-assignable)
+   * @tparam CAPACITY Queue capacity, must be power of two
+  */
+  template <typename value_type, SIZE_T CAPACITY>
+    requires (CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0)
+    class mpsc_queue
+    {
+      /* Queue cell */
+      struct cell
+      {
+        std::atomic<SIZE_T> Sequence; // Cell sequence number, shows if cell is free or filled
+        value_type Value;             // Cell value
+      }; /* struct cell */
+
+      cell Cells[CAPACITY];                                                     // Queue cells
+      BYTE CellsPadding[CACHE_LINE_SIZE];                                       // Padding between cells and producer position
+      std::atomic<SIZE_T> EnqueuePosition = 0;                                  // Position to push to, shared by producers
+      BYTE EnqueuePositionPadding[CACHE_LINE_SIZE - sizeof(std::atomic<SIZE_T>)]; // Padding between producer and consumer positions
+      SIZE_T DequeuePosition = 0;                                               // Position to pop from, owned by consumer
+
+    public:
+      /**
+       * @brief Queue constructor
+      */
+      mpsc_queue( VOID )
+      {
+        for (SIZE_T i = 0; i < CAPACITY; i++)
+          Cells[i].Sequence.store(i, std::memory_order_relaxed);
+      } /* mpsc_queue */
+
+      mpsc_queue( const mpsc_queue & ) = delete;
+      mpsc_queue & operator=( const mpsc_queue & ) = delete;
+
+      /**
+       * @brief Value pushing function, may be called from any thread
+       * @param Value Value to push. Moved from only if push succeeded
+       * @return TRUE if pushed, FALSE if queue is full
+      */
+      BOOL TryPush( value_type &Value )
+      {
+        SIZE_T Position = EnqueuePosition.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+          cell &Cell = Cells[Position & (CAPACITY - 1)];
+          SIZE_T Sequence = Cell.Sequence.load(std::memory_order_acquire);
+          SSIZE_T Difference = (SSIZE_T)Sequence - (SSIZE_T)Position;
+
+          if (Difference == 0)
+          {
+            // Cell is free, try to occupy it
+            if (EnqueuePosition.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+            {
+              Cell.Value = std::move(Value);
+              Cell.Sequence.store(Position + 1, std::memory_order_release);
+              return TRUE;
+            }
+          }
+          else if (Difference < 0)
+            return FALSE; // Cell is still not consumed, queue is full
+          else
+            Position = EnqueuePosition.load(std::memory_order_relaxed);
+        }
+      } /* TryPush */
+
+      /**
+       * @brief Value pushing function, spins while queue is full
+       * @param Value Value to push
+      */
+      VOID Push( value_type &&Value )
+      {
+        while (!TryPush(Value))
+          std::this_thread::yield();
+      } /* Push */
+
+      /**
+       * @brief Value popping function, must be called from consumer thread only
+       * @param Value Value to pop into
+       * @return TRUE if popped, FALSE if queue is empty
+      */
+      BOOL TryPop( value_type &Value )
+      {
+        cell &Cell = Cells[DequeuePosition & (CAPACITY - 1)];
+
+        if (Cell.Sequence.load(std::memory_order_acquire) != DequeuePosition + 1)
+          return FALSE;
+
+        Value = std::move(Cell.Value);
+        Cell.Sequence.store(DequeuePosition + CAPACITY, std::memory_order_release);
+        DequeuePosition++;
+
+        return TRUE;
+      } /* TryPop */
+    }; /* class mpsc_queue */
+} /* namespace anv::thread */
+
+#endif // !defined(ANV_THREAD_TASK_QUEUE_H_)
+
+/* file anv_thread_task_queue.h */